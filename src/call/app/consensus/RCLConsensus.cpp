@@ -58,6 +58,15 @@
 
 namespace call {
 
+// Time since the given start, for the close stage timings
+static
+std::chrono::microseconds
+elapsed(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start);
+}
+
 RCLConsensus::RCLConsensus(
     Application& app,
     std::unique_ptr<FeeVote>&& feeVote,
@@ -161,7 +170,8 @@ RCLConsensus::Adaptor::relay(RCLCxPeerPos const& peerPos)
     auto const sig = peerPos.signature();
     prop.set_signature(sig.data(), sig.size());
 
-    app_.overlay().relay(prop, peerPos.suppressionID());
+    app_.overlay().relay(prop, peerPos.suppressionID(),
+        peerPos.publicKey());
 }
 
 void
@@ -177,8 +187,7 @@ RCLConsensus::Adaptor::relay(RCLCxTx const& tx)
         msg.set_status(protocol::tsNEW);
         msg.set_receivetimestamp(
             app_.timeKeeper().now().time_since_epoch().count());
-        app_.overlay().foreach (send_always(
-            std::make_shared<Message>(msg, protocol::mtTRANSACTION)));
+        app_.overlay().relay(msg, {});
     }
     else
     {
@@ -458,6 +467,7 @@ RCLConsensus::Adaptor::doAccept(
     // Put transactions into a deterministic, but unpredictable, order
     CanonicalTXSet retriableTxs{result.set.id()};
 
+    CloseTiming timing;
     auto sharedLCL = buildLCL(
         prevLedger,
         result.set,
@@ -465,7 +475,8 @@ RCLConsensus::Adaptor::doAccept(
         closeTimeCorrect,
         closeResolution,
         result.roundTime.read(),
-        retriableTxs);
+        retriableTxs,
+        timing);
 
     auto const newLCLHash = sharedLCL.id();
     JLOG(j_.debug()) << "Report: NewL  = " << newLCLHash << ":"
@@ -537,6 +548,7 @@ RCLConsensus::Adaptor::doAccept(
         }
 
         // Build new open ledger
+        auto const start = std::chrono::steady_clock::now();
         auto lock = make_lock(app_.getMasterMutex(), std::defer_lock);
         auto sl = make_lock(ledgerMaster_.peekMutex(), std::defer_lock);
         std::lock(lock, sl);
@@ -561,6 +573,8 @@ RCLConsensus::Adaptor::doAccept(
                 return app_.getTxQ().accept(app_, view);
             });
 
+        timing.openLedger = elapsed(start);
+
         // Signal a potential fee change to subscribers after the open ledger
         // is created
         app_.getOPs().reportFeeChange();
@@ -568,7 +582,14 @@ RCLConsensus::Adaptor::doAccept(
 
     //-------------------------------------------------------------------------
     {
+        auto const start = std::chrono::steady_clock::now();
         ledgerMaster_.switchLCL(sharedLCL.ledger_);
+        timing.switchLCL = elapsed(start);
+
+        {
+            std::lock_guard<std::mutex> lock(closeTimingMutex_);
+            closeTiming_ = timing;
+        }
 
         // Do these need to exist?
         assert(ledgerMaster_.getClosedLedger()->info().hash == sharedLCL.id());
@@ -762,7 +783,8 @@ RCLConsensus::Adaptor::buildLCL(
     bool closeTimeCorrect,
     NetClock::duration closeResolution,
     std::chrono::milliseconds roundTime,
-    CanonicalTXSet& retriableTxs)
+    CanonicalTXSet& retriableTxs,
+    CloseTiming& timing)
 {
     auto replay = ledgerMaster_.releaseReplay();
     if (replay)
@@ -794,6 +816,7 @@ RCLConsensus::Adaptor::buildLCL(
     JLOG(j_.debug()) << "Applying consensus set transactions to the"
                      << " last closed ledger";
 
+    auto start = std::chrono::steady_clock::now();
     {
         OpenView accum(&*buildLCL);
         assert(!accum.open());
@@ -822,7 +845,9 @@ RCLConsensus::Adaptor::buildLCL(
     // to the ledger.
 
     buildLCL->updateSkipList();
+    timing.apply = elapsed(start);
 
+    start = std::chrono::steady_clock::now();
     {
         // Write the final version of all modified SHAMap
         // nodes to the node store to preserve the new LCL
@@ -835,8 +860,10 @@ RCLConsensus::Adaptor::buildLCL(
                          << " transaction nodes";
     }
     buildLCL->unshare();
+    timing.flush = elapsed(start);
 
     // Accept ledger
+    start = std::chrono::steady_clock::now();
     buildLCL->setAccepted(
         closeTime, closeResolution, closeTimeCorrect, app_.config());
 
@@ -847,9 +874,30 @@ RCLConsensus::Adaptor::buildLCL(
         JLOG(j_.debug()) << "Consensus built ledger we were acquiring";
     else
         JLOG(j_.debug()) << "Consensus built new ledger";
+    timing.accept = elapsed(start);
+
     return RCLCxLedger{std::move(buildLCL)};
 }
 
+Json::Value
+RCLConsensus::Adaptor::closeTiming() const
+{
+    CloseTiming timing;
+    {
+        std::lock_guard<std::mutex> lock(closeTimingMutex_);
+        timing = closeTiming_;
+    }
+
+    Json::Value ret(Json::objectValue);
+    ret["apply_us"] = static_cast<Json::UInt>(timing.apply.count());
+    ret["flush_us"] = static_cast<Json::UInt>(timing.flush.count());
+    ret["accept_us"] = static_cast<Json::UInt>(timing.accept.count());
+    ret["open_ledger_us"] =
+        static_cast<Json::UInt>(timing.openLedger.count());
+    ret["switch_lcl_us"] = static_cast<Json::UInt>(timing.switchLCL.count());
+    return ret;
+}
+
 void
 RCLConsensus::Adaptor::validate(RCLCxLedger const& ledger, bool proposing)
 {
@@ -910,6 +958,7 @@ RCLConsensus::getJson(bool full) const
       ret = consensus_.getJson(full);
     }
     ret["validating"] = adaptor_.validating();
+    ret["last_close_timing"] = adaptor_.closeTiming();
     return ret;
 }
 
@@ -92,6 +92,25 @@ class RCLConsensus
             std::chrono::milliseconds{0}};
         std::atomic<ConsensusMode> mode_{ConsensusMode::observing};
 
+        // How long each stage of building the last closed ledger took
+        struct CloseTiming
+        {
+            // Consensus transactions applied to the new ledger
+            std::chrono::microseconds apply{0};
+            // Modified SHAMap nodes written to the node store
+            std::chrono::microseconds flush{0};
+            // Ledger hashed, made immutable and stored
+            std::chrono::microseconds accept{0};
+            // New open ledger built on top of it
+            std::chrono::microseconds openLedger{0};
+            // Ledger master switched to it. In standalone mode this
+            // includes saving the ledger to the SQL databases.
+            std::chrono::microseconds switchLCL{0};
+        };
+
+        std::mutex mutable closeTimingMutex_;
+        CloseTiming closeTiming_;
+
     public:
         using Ledger_t = RCLCxLedger;
         using NodeID_t = NodeID;
@@ -133,6 +152,10 @@ class RCLConsensus
             return mode_;
         }
 
+        /** Stage timings of the last ledger built, in microseconds. */
+        Json::Value
+        closeTiming() const;
+
         /** Called before kicking off a new consensus round.
 
             @param prevLedger Ledger that will be prior ledger for next round
@@ -354,6 +377,7 @@ class RCLConsensus
             @param roundTime Duration of this consensus rorund
             @param retriableTxs Populate with transactions to retry in next
                                 round
+            @param timing Populate with the time each stage took
             @return The newly built ledger
       */
         RCLCxLedger
@@ -364,7 +388,8 @@ class RCLConsensus
             bool closeTimeCorrect,
             NetClock::duration closeResolution,
             std::chrono::milliseconds roundTime,
-            CanonicalTXSet& retriableTxs);
+            CanonicalTXSet& retriableTxs,
+            CloseTiming& timing);
 
         /** Validate the given ledger and share with peers as necessary
 
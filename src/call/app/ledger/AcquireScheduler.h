@@ -0,0 +1,291 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of calld: https://github.com/callchain/calld
+    Copyright (c) 2018, 2019 Callchain Fundation.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef CALL_APP_LEDGER_ACQUIRESCHEDULER_H_INCLUDED
+#define CALL_APP_LEDGER_ACQUIRESCHEDULER_H_INCLUDED
+
+#include <call/beast/clock/abstract_clock.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <vector>
+
+namespace call {
+
+namespace acquire {
+
+/** Fewest, first and most nodes asked of a peer in one request */
+std::size_t constexpr minRequestNodes = 8;
+std::size_t constexpr initialRequestNodes = 32;
+std::size_t constexpr maxRequestNodes = 512;
+
+/** Most requests a peer may have in flight */
+std::size_t constexpr maxRequestsInFlight = 3;
+
+/** How long, beyond the peer's fastest round trip, a reply should take */
+std::chrono::milliseconds constexpr targetReplyTime {400};
+
+/** Bounds on how long we wait for a reply */
+std::chrono::milliseconds constexpr minRequestTimeout {500};
+std::chrono::milliseconds constexpr maxRequestTimeout {2500};
+
+} // acquire
+
+/** Spreads the nodes an acquisition is missing over its peers.
+
+    A node is asked of one peer at a time, and each peer may have a few
+    requests in flight. The size of a peer's requests follows the rate
+    at which it answers them, so that a reply takes about the target
+    time beyond the peer's round trip. A request that is not answered
+    in time is taken back so that its nodes can be asked of other
+    peers, and the peer is then allowed a single, smaller request until
+    it answers again.
+
+    @tparam Key Identifies a node, ordered by `operator<`.
+*/
+template <class Key>
+class AcquireScheduler
+{
+public:
+    using clock_type = beast::abstract_clock <std::chrono::steady_clock>;
+    using id_t = std::uint32_t;
+
+    explicit
+    AcquireScheduler (clock_type& clock)
+        : clock_ (clock)
+    {
+    }
+
+    AcquireScheduler (AcquireScheduler const&) = delete;
+    AcquireScheduler& operator= (AcquireScheduler const&) = delete;
+
+    /** Returns `true` if another request may be sent to the peer. */
+    bool
+    canRequest (id_t peer) const
+    {
+        auto const it = peers_.find (peer);
+        if (it == peers_.end())
+            return true;
+        return it->second.inFlight.size() <
+            (it->second.slow ? 1 : acquire::maxRequestsInFlight);
+    }
+
+    /** Choose the nodes of a request to the peer.
+
+        Nodes already asked of a peer are skipped. The chosen nodes are
+        recorded as a request in flight, unless there are none.
+    */
+    std::vector<Key>
+    assign (id_t peer, std::vector<Key> const& candidates)
+    {
+        auto& state = peers_[peer];
+
+        std::vector<Key> keys;
+        for (auto const& key : candidates)
+        {
+            if (keys.size() >= state.size)
+                break;
+            if (outstanding_.emplace (key, peer).second)
+                keys.push_back (key);
+        }
+
+        if (! keys.empty())
+            state.inFlight.push_back ({keys, clock_.now()});
+        return keys;
+    }
+
+    /** Record a reply from the peer.
+
+        The reply answers the oldest request in flight that asked for
+        any of its nodes. Nodes of that request missing from the reply
+        may be asked of any peer again.
+    */
+    void
+    received (id_t peer, std::vector<Key> const& keys)
+    {
+        auto const it = peers_.find (peer);
+        if (it == peers_.end())
+            return;
+
+        auto& state = it->second;
+        auto const answered = std::find_if (
+            state.inFlight.begin(), state.inFlight.end(),
+            [&](Request const& r)
+            {
+                return std::any_of (keys.begin(), keys.end(),
+                    [&](Key const& key)
+                    {
+                        return std::find (r.keys.begin(), r.keys.end(),
+                            key) != r.keys.end();
+                    });
+            });
+        if (answered == state.inFlight.end())
+            return;
+
+        using namespace std::chrono;
+        auto const rtt = std::max<clock_type::duration> (
+            clock_.now() - answered->sent, milliseconds{1});
+        auto const sample = answered->keys.size() /
+            duration_cast<duration<double>> (rtt).count();
+
+        if (state.rate == 0)
+        {
+            state.rate = sample;
+            state.srtt = rtt;
+        }
+        else
+        {
+            state.rate += (sample - state.rate) / 4;
+            state.srtt += (rtt - state.srtt) / 8;
+        }
+        state.minRtt = std::min (state.minRtt, rtt);
+
+        auto const target = duration_cast<duration<double>> (
+            acquire::targetReplyTime + state.minRtt).count();
+        state.size = clamp (std::min<double> (
+            2 * state.size, state.rate * target));
+        state.slow = false;
+
+        release (peer, answered->keys);
+        state.inFlight.erase (answered);
+    }
+
+    /** Take back the requests that were not answered in time.
+
+        @return The number of requests taken back.
+    */
+    std::size_t
+    expire ()
+    {
+        std::size_t expired = 0;
+        auto const now = clock_.now();
+
+        for (auto& p : peers_)
+        {
+            auto& state = p.second;
+            auto const limit = timeout (state);
+            while (! state.inFlight.empty() &&
+                now - state.inFlight.front().sent > limit)
+            {
+                release (p.first, state.inFlight.front().keys);
+                state.inFlight.pop_front();
+                state.size = clamp (state.size / 2);
+                state.slow = true;
+                ++expired;
+            }
+        }
+        return expired;
+    }
+
+    /** Returns the number of nodes the peer is asked for at a time. */
+    std::size_t
+    requestSize (id_t peer) const
+    {
+        auto const it = peers_.find (peer);
+        if (it == peers_.end())
+            return acquire::initialRequestNodes;
+        return it->second.size;
+    }
+
+    /** Returns the number of nodes asked of any peer. */
+    std::size_t
+    outstanding () const
+    {
+        return outstanding_.size();
+    }
+
+private:
+    struct Request
+    {
+        std::vector<Key> keys;
+        clock_type::time_point sent;
+    };
+
+    struct PeerState
+    {
+        std::deque<Request> inFlight;
+        std::size_t size = acquire::initialRequestNodes;
+
+        // Nodes answered per second, and round trip times
+        double rate = 0;
+        clock_type::duration srtt {0};
+        clock_type::duration minRtt = clock_type::duration::max();
+
+        // A request timed out since the last reply
+        bool slow = false;
+    };
+
+    static
+    std::size_t
+    clamp (double size)
+    {
+        return static_cast<std::size_t> (std::max<double> (
+            acquire::minRequestNodes, std::min<double> (
+                acquire::maxRequestNodes, size)));
+    }
+
+    static
+    clock_type::duration
+    timeout (PeerState const& state)
+    {
+        if (state.rate == 0)
+            return acquire::maxRequestTimeout;
+        return std::max<clock_type::duration> (acquire::minRequestTimeout,
+            std::min<clock_type::duration> (acquire::maxRequestTimeout,
+                3 * state.srtt + acquire::targetReplyTime));
+    }
+
+    void
+    release (id_t peer, std::vector<Key> const& keys)
+    {
+        for (auto const& key : keys)
+        {
+            auto const it = outstanding_.find (key);
+            if (it != outstanding_.end() && it->second == peer)
+                outstanding_.erase (it);
+        }
+    }
+
+    clock_type& clock_;
+    std::map<id_t, PeerState> peers_;
+
+    // The peer each node was asked of
+    std::map<Key, id_t> outstanding_;
+};
+
+} // call
+
+#endif
@@ -36,6 +36,7 @@
 #include <call/app/ledger/OrderBookDB.h>
 #include <call/app/misc/NetworkOPs.h>
 #include <call/json/to_string.h>
+#include <vector>
 
 namespace call {
 
@@ -55,28 +56,32 @@ BookListeners::removeSubscriber(std::uint64_t seq)
 
 void
 BookListeners::publish(
-    Json::Value const& jvObj,
+    InfoSub::Event const& event,
     hash_set<std::uint64_t>& havePublished)
 {
-    std::lock_guard<std::recursive_mutex> sl(mLock);
-    auto it = mListeners.cbegin();
-
-    while (it != mListeners.cend())
+    std::vector<InfoSub::pointer> subs;
     {
-        InfoSub::pointer p = it->second.lock();
+        std::lock_guard<std::recursive_mutex> sl(mLock);
+        auto it = mListeners.cbegin();
 
-        if (p)
+        while (it != mListeners.cend())
         {
-            // Only publish jvObj if this is the first occurence
-            if(havePublished.emplace(p->getSeq()).second)
+            InfoSub::pointer p = it->second.lock();
+
+            if (p)
             {
-                p->send(jvObj, true);
+                // Only publish if this is the first occurence
+                if(havePublished.emplace(p->getSeq()).second)
+                    subs.push_back(std::move(p));
+                ++it;
             }
-            ++it;
+            else
+                it = mListeners.erase(it);
         }
-        else
-            it = mListeners.erase(it);
     }
+
+    for (auto const& p : subs)
+        p->send(event, true);
 }
 
 }  // namespace call
@@ -36,6 +36,7 @@
 #define CALL_APP_LEDGER_INBOUNDLEDGER_H_INCLUDED
 
 #include <call/app/main/Application.h>
+#include <call/app/ledger/AcquireScheduler.h>
 #include <call/app/ledger/Ledger.h>
 #include <call/overlay/PeerSet.h>
 #include <call/basics/CountedObject.h>
@@ -111,12 +112,12 @@ private:
         timeout
     };
 
-    void filterNodes (
-        std::vector<std::pair<SHAMapNodeID, uint256>>& nodes,
-        TriggerReason reason);
-
     void trigger (std::shared_ptr<Peer> const&, TriggerReason);
 
+    bool requestNodes (protocol::TMGetLedger& tmGL,
+        protocol::TMLedgerInfoType type,
+        std::vector<std::pair<SHAMapNodeID, uint256>> const& nodes);
+
     std::vector<neededHash_t> getNeededHashes ();
 
     void addPeers ();
@@ -176,7 +177,9 @@ private:
     std::uint32_t      mSeq;
     fcReason           mReason;
 
-    std::set <uint256> mRecentNodes;
+    // The nodes asked of each peer, by map
+    AcquireScheduler <std::pair<
+        protocol::TMLedgerInfoType, SHAMapNodeID>> mScheduler;
 
     SHAMapAddNode      mStats;
 
@@ -43,6 +43,7 @@
 #include <call/app/ledger/PendingSaves.h>
 #include <call/app/ledger/TransactionMaster.h>
 #include <call/app/main/Application.h>
+#include <call/app/misc/AccountTxIndex.h>
 #include <call/app/misc/HashRouter.h>
 #include <call/app/misc/LoadFeeTrack.h>
 #include <call/app/misc/NetworkOPs.h>
@@ -255,6 +256,9 @@ Ledger::Ledger (
 {
     loaded = true;
 
+    txMap_->setShardSeq (info_.seq);
+    stateMap_->setShardSeq (info_.seq);
+
     if (info_.txHash.isNonZero () &&
         !txMap_->fetchRoot (SHAMapHash{info_.txHash}, nullptr))
     {
@@ -335,6 +339,8 @@ Ledger::Ledger (
     , info_ (info)
 {
     info_.hash = calculateLedgerHash (info_);
+    txMap_->setShardSeq (info_.seq);
+    stateMap_->setShardSeq (info_.seq);
 }
 
 Ledger::Ledger (std::uint32_t ledgerSeq,
@@ -467,6 +473,32 @@ Ledger::read (Keylet const& k) const
     return std::move(sle);
 }
 
+boost::optional<STObjectView>
+Ledger::readLazy (Keylet const& k) const
+{
+    if (k.key == zero)
+    {
+        assert(false);
+        return boost::none;
+    }
+    auto const& item =
+        stateMap_->peekItem(k.key);
+    if (! item)
+        return boost::none;
+    // The item keeps the bytes alive
+    STObjectView view(item->slice(), item);
+    auto const type = static_cast<LedgerEntryType>(
+        view.getFieldU16(sfLedgerEntryType));
+    if (! k.check(type))
+        return boost::none;
+    auto const format =
+        LedgerFormats::getInstance().findByType(type);
+    if (format == nullptr)
+        Throw<std::runtime_error> ("invalid ledger entry type");
+    view.setTemplate(format->elements);
+    return view;
+}
+
 //------------------------------------------------------------------------------
 
 auto
@@ -897,12 +929,18 @@ static bool saveValidatedLedger (
     }
 
     {
+        // When an index is configured the affected accounts go there,
+        // all at once, instead of into AccountTransactions.
+        auto const index = app.getAccountTxIndex ();
+        std::vector<AccountTxIndex::Entry> indexEntries;
+
         auto db = app.getTxnDB ().checkoutDb ();
 
         soci::transaction tr(*db);
 
         *db << boost::str (deleteTrans1 % seq);
-        *db << boost::str (deleteTrans2 % seq);
+        if (! index)
+            *db << boost::str (deleteTrans2 % seq);
 
         std::string const ledgerSeq (std::to_string (seq));
 
@@ -916,11 +954,18 @@ static bool saveValidatedLedger (
             std::string const txnId (to_string (transactionID));
             std::string const txnSeq (std::to_string (vt.second->getTxnSeq ()));
 
-            *db << boost::str (deleteAcctTrans % transactionID);
+            if (! index)
+                *db << boost::str (deleteAcctTrans % transactionID);
 
             auto const& accts = vt.second->getAffected ();
 
-            if (!accts.empty ())
+            if (!accts.empty () && index)
+            {
+                for (auto const& account : accts)
+                    indexEntries.push_back ({account, seq,
+                        vt.second->getTxnSeq (), transactionID});
+            }
+            else if (!accts.empty ())
             {
                 std::string sql (
                     "INSERT INTO AccountTransactions "
@@ -971,6 +1016,9 @@ static bool saveValidatedLedger (
         }
 
         tr.commit ();
+
+        if (index)
+            index->saveLedger (seq, indexEntries);
     }
 
     {
@@ -53,6 +53,7 @@
 #include <call/protocol/Protocol.h>
 #include <call/beast/utility/PropertyStream.h>
 #include <mutex>
+#include <set>
 
 #include "call.pb.h"
 
@@ -289,6 +290,17 @@ private:
 
     void updatePaths(Job& job);
 
+    // Copy complete ledgers which aren't in the history shards yet,
+    // with a job for each shard.
+    void storeShards();
+    void storeShard(
+        std::uint32_t shardIndex,
+        RangeSet<std::uint32_t> const& seqs);
+
+    // Load an old ledger which is only held in the history shards.
+    std::shared_ptr<Ledger const>
+    getShardLedger(uint256 const& hash, std::uint32_t seq);
+
     // Returns true if work started.  Always called with m_mutex locked.
     // The passed ScopedLockType is a reminder to callers.
     bool newPFWork(const char *name, ScopedLockType&);
@@ -339,6 +351,10 @@ private:
     bool                        mAdvanceWork {false};
     int                         mFillInProgress {0};
 
+    // History shards a job is copying ledgers into.
+    std::mutex mShardMutex;
+    std::set<std::uint32_t> mShardsFilling;
+
     int     mPathFindThread {0};    // Pathfinder jobs dispatched
     bool    mPathFindNewRequest {false};
 
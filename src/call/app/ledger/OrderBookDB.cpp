@@ -40,13 +40,52 @@
 #include <call/core/Config.h>
 #include <call/core/JobQueue.h>
 #include <call/protocol/Indexes.h>
+#include <algorithm>
 
 namespace call {
 
-OrderBookDB::OrderBookDB (Application& app, Stoppable& parent)
+static
+uint160
+getBookField (STObject const& obj, SField const& field)
+{
+    // Metadata omits fields holding their default value, such as the
+    // CALL currency and issuer.
+    if (obj.isFieldPresent (field))
+        return obj.getFieldH160 (field);
+    return {};
+}
+
+static
+Book
+getBookFromDir (STObject const& dir)
+{
+    Book book;
+    book.in.currency.copyFrom (getBookField (dir, sfTakerPaysCurrency));
+    book.in.account.copyFrom (getBookField (dir, sfTakerPaysIssuer));
+    book.out.account.copyFrom (getBookField (dir, sfTakerGetsIssuer));
+    book.out.currency.copyFrom (getBookField (dir, sfTakerGetsCurrency));
+    return book;
+}
+
+OrderBookDB::Setup
+setup_OrderBookDB (Config const& config)
+{
+    // Books are maintained from each ledger's metadata, so the periodic
+    // rebuild is only a consistency check.
+    OrderBookDB::Setup setup;
+    setup.standalone = config.standalone();
+    return setup;
+}
+
+OrderBookDB::OrderBookDB (Application& app, Stoppable& parent,
+        Setup const& setup)
     : Stoppable ("OrderBookDB", parent)
     , app_ (app)
+    , setup_ (setup)
     , mSeq (0)
+    , mLastSeq (0)
+    , mUpdating (false)
+    , mResync (false)
     , j_ (app.journal ("OrderBookDB"))
 {
 }
@@ -55,21 +94,34 @@ void OrderBookDB::invalidate ()
 {
     std::lock_guard <std::recursive_mutex> sl (mLock);
     mSeq = 0;
+    if (mUpdating)
+        mResync = true;
 }
 
 void OrderBookDB::setup(
     std::shared_ptr<ReadView const> const& ledger)
 {
+    if (app_.config().PATH_SEARCH_MAX == 0)
+    {
+        // nothing to do
+        return;
+    }
+
     {
         std::lock_guard <std::recursive_mutex> sl (mLock);
         auto seq = ledger->info().seq;
 
-        // Do a full update every 256 ledgers
+        // A rebuild in flight already covers this ledger or will be
+        // followed by the changes applied after it.
+        if (mUpdating)
+            return;
+
+        // Do a full update every fullUpdateInterval ledgers
         if (mSeq != 0)
         {
             if (seq == mSeq)
                 return;
-            if ((seq > mSeq) && ((seq - mSeq) < 256))
+            if ((seq > mSeq) && ((seq - mSeq) < setup_.fullUpdateInterval))
                 return;
             if ((seq < mSeq) && ((mSeq - seq) < 16))
                 return;
@@ -79,13 +131,11 @@ void OrderBookDB::setup(
             << "Advancing from " << mSeq << " to " << seq;
 
         mSeq = seq;
+        mLastSeq = seq;
+        mUpdating = true;
     }
 
-    if (app_.config().PATH_SEARCH_MAX == 0)
-    {
-        // nothing to do
-    }
-    else if (app_.config().standalone())
+    if (setup_.standalone)
         update(ledger);
     else
         app_.getJobQueue().addJob(
@@ -103,9 +153,19 @@ void OrderBookDB::update(
 
     JLOG (j_.debug()) << "OrderBookDB::update>";
 
+    auto abandon = [this]
+    {
+        std::lock_guard <std::recursive_mutex> sl (mLock);
+        mSeq = 0;
+        mUpdating = false;
+        mResync = false;
+        mPending.clear();
+    };
+
     if (app_.config().PATH_SEARCH_MAX == 0)
     {
         // pathfinding has been disabled
+        abandon();
         return;
     }
 
@@ -120,8 +180,7 @@ void OrderBookDB::update(
             {
                 JLOG (j_.info())
                     << "OrderBookDB::update exiting due to isStopping";
-                std::lock_guard <std::recursive_mutex> sl (mLock);
-                mSeq = 0;
+                abandon();
                 return;
             }
 
@@ -129,15 +188,7 @@ void OrderBookDB::update(
                 sle->isFieldPresent (sfExchangeRate) &&
                 sle->getFieldH256 (sfRootIndex) == sle->key())
             {
-                Book book;
-                book.in.currency.copyFrom(sle->getFieldH160(
-                    sfTakerPaysCurrency));
-                book.in.account.copyFrom(sle->getFieldH160 (
-                    sfTakerPaysIssuer));
-                book.out.account.copyFrom(sle->getFieldH160(
-                    sfTakerGetsIssuer));
-                book.out.currency.copyFrom (sle->getFieldH160(
-                    sfTakerGetsCurrency));
+                Book const book = getBookFromDir (*sle);
 
                 uint256 index = getBookBase (book);
                 if (seen.insert (index).second)
@@ -156,8 +207,7 @@ void OrderBookDB::update(
     {
         JLOG (j_.info())
             << "OrderBookDB::update encountered a missing node";
-        std::lock_guard <std::recursive_mutex> sl (mLock);
-        mSeq = 0;
+        abandon();
         return;
     }
 
@@ -169,14 +219,174 @@ void OrderBookDB::update(
         mCALLBooks.swap(CALLBooks);
         mSourceMap.swap(sourceMap);
         mDestMap.swap(destMap);
+
+        // Replay the changes from ledgers published during the rebuild
+        auto const seq = ledger->info().seq;
+        for (auto const& change : mPending)
+        {
+            if (change.seq > seq)
+                applyBookChange (change);
+        }
+        mPending.clear();
+        mUpdating = false;
+
+        if (mResync)
+        {
+            // A ledger was skipped while rebuilding
+            mResync = false;
+            mSeq = 0;
+        }
     }
     app_.getLedgerMaster().newOrderBookDB();
 }
 
+void OrderBookDB::processLedger (
+    std::shared_ptr<ReadView const> const& ledger)
+{
+    if (app_.config().PATH_SEARCH_MAX == 0)
+        return;
+
+    auto const seq = ledger->info().seq;
+
+    std::vector<BookChange> changes;
+    try
+    {
+        changes = findBookChanges (*ledger);
+    }
+    catch (const SHAMapMissingNode&)
+    {
+        JLOG (j_.info())
+            << "OrderBookDB::processLedger encountered a missing node";
+        invalidate();
+        return;
+    }
+
+    bool rebuild;
+    {
+        std::lock_guard <std::recursive_mutex> sl (mLock);
+
+        if (seq <= mLastSeq)
+            return;
+
+        bool const gap = (mLastSeq == 0) || (seq != mLastSeq + 1);
+        mLastSeq = seq;
+
+        for (auto const& change : changes)
+        {
+            applyBookChange (change);
+            if (mUpdating)
+                mPending.push_back (change);
+        }
+
+        if (gap)
+        {
+            JLOG (j_.debug())
+                << "OrderBookDB::processLedger missed ledgers before " << seq;
+            invalidate();
+        }
+
+        rebuild = ! mUpdating && ((mSeq == 0) ||
+            ((seq > mSeq) && ((seq - mSeq) >= setup_.fullUpdateInterval)));
+    }
+
+    if (! changes.empty())
+    {
+        JLOG (j_.debug())
+            << "OrderBookDB::processLedger " << changes.size() <<
+            " book changes in " << seq;
+        app_.getLedgerMaster().newOrderBookDB();
+    }
+
+    if (rebuild)
+        setup (ledger);
+}
+
+std::vector<OrderBookDB::BookChange>
+OrderBookDB::findBookChanges (ReadView const& ledger) const
+{
+    auto const seq = ledger.info().seq;
+
+    // Books whose root directories were created or deleted, keyed by
+    // book base so each book is examined once.
+    hash_map<uint256, Book> created;
+    hash_map<uint256, Book> deleted;
+
+    for (auto const& item : ledger.txs)
+    {
+        if (! item.second)
+            continue;
+
+        for (auto const& node : item.second->getFieldArray (sfAffectedNodes))
+        {
+            if (node.getFieldU16 (sfLedgerEntryType) != ltDIR_NODE)
+                continue;
+
+            auto const index = node.getFieldH256 (sfLedgerIndex);
+
+            if (node.getFName () == sfCreatedNode)
+            {
+                // The directory may have been removed later in the ledger
+                auto const sle = ledger.read (keylet::page (index));
+                if (sle &&
+                    sle->isFieldPresent (sfExchangeRate) &&
+                    sle->getFieldH256 (sfRootIndex) == index)
+                {
+                    Book const book = getBookFromDir (*sle);
+                    created.emplace (getBookBase (book), book);
+                }
+            }
+            else if (node.getFName () == sfDeletedNode)
+            {
+                auto const fields = dynamic_cast<STObject const*> (
+                    node.peekAtPField (sfFinalFields));
+                if (fields &&
+                    fields->isFieldPresent (sfExchangeRate) &&
+                    fields->isFieldPresent (sfRootIndex) &&
+                    fields->getFieldH256 (sfRootIndex) == index)
+                {
+                    Book const book = getBookFromDir (*fields);
+                    deleted.emplace (getBookBase (book), book);
+                }
+            }
+        }
+    }
+
+    std::vector<BookChange> changes;
+    changes.reserve (created.size () + deleted.size ());
+
+    for (auto const& entry : created)
+        changes.push_back ({seq, entry.second, true});
+
+    for (auto const& entry : deleted)
+    {
+        // A book survives as long as a directory at any quality remains
+        if (created.count (entry.first) ||
+            ledger.succ (entry.first, getQualityNext (entry.first)))
+            continue;
+
+        changes.push_back ({seq, entry.second, false});
+    }
+
+    return changes;
+}
+
+void OrderBookDB::applyBookChange (BookChange const& change)
+{
+    if (change.added)
+        rawAddBook (change.book);
+    else
+        rawRemoveBook (change.book);
+}
+
 void OrderBookDB::addOrderBook(Book const& book)
 {
-    bool toCALL = isCALL (book.out);
     std::lock_guard <std::recursive_mutex> sl (mLock);
+    rawAddBook (book);
+}
+
+void OrderBookDB::rawAddBook(Book const& book)
+{
+    bool toCALL = isCALL (book.out);
 
     if (toCALL)
     {
@@ -208,6 +418,34 @@ void OrderBookDB::addOrderBook(Book const& book)
         mCALLBooks.insert(book.in);
 }
 
+void OrderBookDB::rawRemoveBook(Book const& book)
+{
+    uint256 const index = getBookBase(book);
+
+    auto remove = [&index](IssueToOrderBook& map, Issue const& issue)
+    {
+        auto it = map.find (issue);
+        if (it == map.end ())
+            return;
+
+        auto& list = it->second;
+        list.erase (std::remove_if (list.begin (), list.end (),
+            [&index](OrderBook::pointer const& ob)
+            {
+                return ob->getBookBase () == index;
+            }), list.end ());
+
+        if (list.empty ())
+            map.erase (it);
+    };
+
+    remove (mSourceMap, book.in);
+    remove (mDestMap, book.out);
+
+    if (isCALL (book.out))
+        mCALLBooks.erase (book.in);
+}
+
 // return list of all orderbooks that want this issuerID and currencyID
 OrderBook::List OrderBookDB::getBooksByTakerPays (Issue const& issue)
 {
@@ -260,9 +498,10 @@ BookListeners::pointer OrderBookDB::getBookListeners (Book const& book)
 // We need to determine which streams a given meta effects.
 void OrderBookDB::processTxn (
     std::shared_ptr<ReadView const> const& ledger,
-        const AcceptedLedgerTx& alTx, Json::Value const& jvObj)
+        const AcceptedLedgerTx& alTx, InfoSub::Event const& event)
 {
-    std::lock_guard <std::recursive_mutex> sl (mLock);
+    // getBookListeners locks, so subscribers are sent to without
+    // holding the lock.
     if (alTx.getResult () == tesSUCCESS)
     {
         // For this particular transaction, maintain the set of unique
@@ -308,7 +547,7 @@ void OrderBookDB::processTxn (
                             auto listeners = getBookListeners(b);
                             if (listeners)
                             {
-                                listeners->publish(jvObj, havePublished);
+                                listeners->publish(event, havePublished);
                             }
                         }
                     }
@@ -39,7 +39,9 @@
 #include <call/app/ledger/BookListeners.h>
 #include <call/app/main/Application.h>
 #include <call/app/misc/OrderBook.h>
+#include <call/core/Config.h>
 #include <mutex>
+#include <vector>
 
 namespace call {
 
@@ -47,12 +49,29 @@ class OrderBookDB
     : public Stoppable
 {
 public:
-    OrderBookDB (Application& app, Stoppable& parent);
+    struct Setup
+    {
+        // Ledgers between full rebuilds of the book maps
+        std::uint32_t fullUpdateInterval = 16384;
+
+        // Rebuild on the calling thread instead of the job queue
+        bool standalone = false;
+    };
+
+    OrderBookDB (Application& app, Stoppable& parent, Setup const& setup);
 
     void setup (std::shared_ptr<ReadView const> const& ledger);
     void update (std::shared_ptr<ReadView const> const& ledger);
     void invalidate ();
 
+    /** Apply the book directories created or deleted by an accepted ledger.
+
+        Called for each published ledger, in order. A full rebuild is only
+        scheduled when a ledger was skipped or as a periodic consistency
+        check.
+    */
+    void processLedger (std::shared_ptr<ReadView const> const& ledger);
+
     void addOrderBook(Book const&);
 
     /** @return a list of all orderbooks that want this issuerID and currencyID.
@@ -71,14 +90,27 @@ public:
     // see if this txn effects any orderbook
     void processTxn (
         std::shared_ptr<ReadView const> const& ledger,
-        const AcceptedLedgerTx& alTx, Json::Value const& jvObj);
+        const AcceptedLedgerTx& alTx, InfoSub::Event const& event);
 
     using IssueToOrderBook = hash_map <Issue, OrderBook::List>;
 
 private:
-    void rawAddBook(Book const&);
+    struct BookChange
+    {
+        std::uint32_t seq;
+        Book book;
+        bool added;
+    };
+
+    std::vector<BookChange> findBookChanges (ReadView const& ledger) const;
+
+    // Must be called with mLock held
+    void rawAddBook (Book const&);
+    void rawRemoveBook (Book const&);
+    void applyBookChange (BookChange const&);
 
     Application& app_;
+    Setup const setup_;
 
     // by ci/ii
     IssueToOrderBook mSourceMap;
@@ -95,11 +127,24 @@ private:
 
     BookToListenersMap mListeners;
 
+    // ledger the book maps were last fully rebuilt from
     std::uint32_t mSeq;
 
+    // last ledger whose book changes were applied
+    std::uint32_t mLastSeq;
+
+    // a full rebuild is in flight; changes applied meanwhile are kept so
+    // they can be replayed on top of the rebuilt maps
+    bool mUpdating;
+    bool mResync;
+    std::vector<BookChange> mPending;
+
     beast::Journal j_;
 };
 
+OrderBookDB::Setup
+setup_OrderBookDB (Config const& config);
+
 } // call
 
 #endif
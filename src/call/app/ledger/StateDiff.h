@@ -0,0 +1,92 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of calld: https://github.com/callchain/calld
+    Copyright (c) 2018, 2019 Callchain Fundation.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef CALL_APP_LEDGER_STATEDIFF_H_INCLUDED
+#define CALL_APP_LEDGER_STATEDIFF_H_INCLUDED
+
+#include <call/app/ledger/Ledger.h>
+#include <call/json/json_value.h>
+#include <call/shamap/SHAMap.h>
+
+namespace call {
+
+/** The account state entries that differ between two ledgers.
+
+    The state maps are compared with SHAMap::compare, which only
+    descends into subtrees whose hashes differ, so the work is
+    proportional to the size of the change rather than the size
+    of the state, and nodes already cached by either map are reused.
+*/
+class StateDiff
+{
+public:
+    /** Compare the state of `ledger` against the state of `base`.
+
+        The diff is incomplete if it would hold more than `limit`
+        entries or a node needed for the comparison is missing.
+    */
+    StateDiff (Ledger const& base, Ledger const& ledger, int limit);
+
+    /** Returns `true` if every changed entry was collected. */
+    bool
+    complete () const
+    {
+        return complete_;
+    }
+
+    /** Returns the number of changed entries. */
+    std::size_t
+    size () const
+    {
+        return delta_.size();
+    }
+
+    /** Add the created, modified and deleted entries to `json`.
+
+        Created and modified entries are given as they are in the
+        ledger, deleted entries as they were in the base. In binary
+        form each entry is the serialized object, which is copied
+        from the map without parsing it.
+    */
+    void
+    addJson (Json::Value& json, bool binary) const;
+
+private:
+    SHAMap::Delta delta_;
+    bool complete_ = false;
+};
+
+} // call
+
+#endif
@@ -48,6 +48,7 @@
 #include <call/protocol/HashPrefix.h>
 #include <call/protocol/JsonFields.h>
 #include <call/nodestore/Database.h>
+#include <call/nodestore/DatabaseShard.h>
 #include <algorithm>
 
 namespace call {
@@ -68,14 +69,9 @@ enum
     // how many timeouts before we get aggressive
     ,ledgerBecomeAggressiveThreshold = 6
 
-    // Number of nodes to find initially
+    // Fewest and most missing nodes to look for at a time
     ,missingNodesFind = 256
-
-    // Number of nodes to request for a reply
-    ,reqNodesReply = 128
-
-    // Number of nodes to request blindly
-    ,reqNodes = 8
+    ,missingNodesMax = 4096
 };
 
 // millisecond for each ledger timeout
@@ -92,6 +88,7 @@ InboundLedger::InboundLedger (
     , mByHash (true)
     , mSeq (seq)
     , mReason (reason)
+    , mScheduler (clock)
     , mReceiveDispatched (false)
 {
     JLOG (m_journal.trace()) <<
@@ -260,6 +257,12 @@ bool InboundLedger::tryLocal ()
         // Nothing we can do without the ledger header
         auto node = app_.getNodeStore ().fetch (mHash);
 
+        if (!node && mSeq != 0)
+        {
+            if (auto shards = app_.getShardStore ())
+                node = shards->fetch (mHash, mSeq);
+        }
+
         if (!node)
         {
             auto data = app_.getLedgerMaster().getFetchPack(mHash);
@@ -365,8 +368,6 @@ bool InboundLedger::tryLocal ()
 */
 void InboundLedger::onTimer (bool wasProgress, ScopedLockType&)
 {
-    mRecentNodes.clear ();
-
     if (isDone())
     {
         JLOG (m_journal.info()) <<
@@ -471,6 +472,8 @@ void InboundLedger::done ()
 }
 
 /** Request more nodes, perhaps from a specific peer
+    Header and root requests go to the peer, or to all peers if none is
+    given. Requests for other nodes are spread over all peers.
 */
 void InboundLedger::trigger (std::shared_ptr<Peer> const& peer, TriggerReason reason)
 {
@@ -603,6 +606,23 @@ void InboundLedger::trigger (std::shared_ptr<Peer> const& peer, TriggerReason re
     else
         tmGL.set_querydepth (1);
 
+    if (auto const expired = mScheduler.expire ())
+    {
+        JLOG (m_journal.debug()) <<
+            expired << " node requests timed out acquiring " << mHash;
+    }
+
+    // Look for enough missing nodes to fill every peer's requests
+    std::size_t wanted = mScheduler.outstanding ();
+    for (auto id : mPeers)
+    {
+        if (mScheduler.canRequest (id))
+            wanted += acquire::maxRequestsInFlight *
+                mScheduler.requestSize (id);
+    }
+    wanted = std::min<std::size_t> (missingNodesMax,
+        std::max<std::size_t> (missingNodesFind, wanted));
+
     // Get the state data first because it's the most likely to be useful
     // if we wind up abandoning this fetch.
     if (mHaveHeader && !mHaveState && !mFailed)
@@ -632,7 +652,7 @@ void InboundLedger::trigger (std::shared_ptr<Peer> const& peer, TriggerReason re
             // Release the lock while we process the large state map
             sl.unlock();
             auto nodes = mLedger->stateMap().getMissingNodes (
-                missingNodesFind, &filter);
+                wanted, &filter);
             sl.lock();
 
             // Make sure nothing happened while we released the lock
@@ -650,30 +670,14 @@ void InboundLedger::trigger (std::shared_ptr<Peer> const& peer, TriggerReason re
                             mComplete = true;
                     }
                 }
+                else if (requestNodes (tmGL, protocol::liAS_NODE, nodes))
+                {
+                    return;
+                }
                 else
                 {
-                    filterNodes (nodes, reason);
-
-                    if (!nodes.empty ())
-                    {
-                        tmGL.set_itype (protocol::liAS_NODE);
-                        for (auto const& id : nodes)
-                        {
-                            * (tmGL.add_nodeids ()) = id.first.getRawString ();
-                        }
-
-                        JLOG (m_journal.trace()) <<
-                            "Sending AS node request (" <<
-                            nodes.size () << ") to " <<
-                            (peer ? "selected peer" : "all peers");
-                        sendRequest (tmGL, peer);
-                        return;
-                    }
-                    else
-                    {
-                        JLOG (m_journal.trace()) <<
-                            "All AS nodes filtered";
-                    }
+                    JLOG (m_journal.trace()) <<
+                        "All AS nodes requested";
                 }
             }
         }
@@ -704,7 +708,7 @@ void InboundLedger::trigger (std::shared_ptr<Peer> const& peer, TriggerReason re
                 app_.getLedgerMaster());
 
             auto nodes = mLedger->txMap().getMissingNodes (
-                missingNodesFind, &filter);
+                wanted, &filter);
 
             if (nodes.empty ())
             {
@@ -718,29 +722,14 @@ void InboundLedger::trigger (std::shared_ptr<Peer> const& peer, TriggerReason re
                         mComplete = true;
                 }
             }
+            else if (requestNodes (tmGL, protocol::liTX_NODE, nodes))
+            {
+                return;
+            }
             else
             {
-                filterNodes (nodes, reason);
-
-                if (!nodes.empty ())
-                {
-                    tmGL.set_itype (protocol::liTX_NODE);
-                    for (auto const& n : nodes)
-                    {
-                        * (tmGL.add_nodeids ()) = n.first.getRawString ();
-                    }
-                    JLOG (m_journal.trace()) <<
-                        "Sending TX node request (" <<
-                        nodes.size () << ") to " <<
-                        (peer ? "selected peer" : "all peers");
-                    sendRequest (tmGL, peer);
-                    return;
-                }
-                else
-                {
-                    JLOG (m_journal.trace()) <<
-                        "All TX nodes filtered";
-                }
+                JLOG (m_journal.trace()) <<
+                    "All TX nodes requested";
             }
         }
     }
@@ -756,50 +745,53 @@ void InboundLedger::trigger (std::shared_ptr<Peer> const& peer, TriggerReason re
     }
 }
 
-void InboundLedger::filterNodes (
-    std::vector<std::pair<SHAMapNodeID, uint256>>& nodes,
-    TriggerReason reason)
+/** Spread missing nodes of one map over the peers
+    Each peer gets as many requests as it may have in flight, and no
+    node is asked of two peers. Returns `true` if any request was sent.
+    Call with a lock
+*/
+bool InboundLedger::requestNodes (protocol::TMGetLedger& tmGL,
+    protocol::TMLedgerInfoType type,
+    std::vector<std::pair<SHAMapNodeID, uint256>> const& nodes)
 {
-    // Sort nodes so that the ones we haven't recently
-    // requested come before the ones we have.
-    auto dup = std::stable_partition (
-        nodes.begin(), nodes.end(),
-        [this](auto const& item)
-        {
-            return mRecentNodes.count (item.second) == 0;
-        });
+    std::vector<std::pair<protocol::TMLedgerInfoType, SHAMapNodeID>> candidates;
+    candidates.reserve (nodes.size ());
+    for (auto const& n : nodes)
+        candidates.emplace_back (type, n.first);
 
-    // If everything is a duplicate we don't want to send
-    // any query at all except on a timeout where we need
-    // to query everyone:
-    if (dup == nodes.begin ())
+    tmGL.set_itype (type);
+
+    std::size_t requests = 0;
+    std::size_t requested = 0;
+    for (auto id : mPeers)
     {
-        JLOG (m_journal.trace()) <<
-            "filterNodes: all duplicates";
+        auto peer = app_.overlay ().findPeerByShortID (id);
+        if (!peer)
+            continue;
 
-        if (reason != TriggerReason::timeout)
+        while (mScheduler.canRequest (id))
         {
-            nodes.clear ();
-            return;
-        }
-    }
-    else
-    {
-        JLOG (m_journal.trace()) <<
-            "filterNodes: pruning duplicates";
+            auto const keys = mScheduler.assign (id, candidates);
+            if (keys.empty ())
+                break;
 
-        nodes.erase (dup, nodes.end());
-    }
+            tmGL.clear_nodeids ();
+            for (auto const& key : keys)
+                * (tmGL.add_nodeids ()) = key.second.getRawString ();
 
-    std::size_t const limit = (reason == TriggerReason::reply)
-        ? reqNodesReply
-        : reqNodes;
+            peer->send (std::make_shared<Message> (
+                tmGL, protocol::mtGET_LEDGER));
+            ++requests;
+            requested += keys.size ();
+        }
+    }
 
-    if (nodes.size () > limit)
-        nodes.resize (limit);
+    JLOG (m_journal.trace()) <<
+        "Sending " << requests << " " <<
+        (type == protocol::liAS_NODE ? "AS" : "TX") <<
+        " node requests (" << requested << ")";
 
-    for (auto const& n : nodes)
-        mRecentNodes.insert (n.second);
+    return requests != 0;
 }
 
 /** Take ledger header data
@@ -1190,6 +1182,15 @@ int InboundLedger::processData (std::shared_ptr<Peer> peer,
                 node.nodedata ().end ()));
         }
 
+        {
+            std::vector<std::pair<
+                protocol::TMLedgerInfoType, SHAMapNodeID>> keys;
+            keys.reserve (nodeIDs.size ());
+            for (auto const& id : nodeIDs)
+                keys.emplace_back (packet.type (), id);
+            mScheduler.received (peer->id (), keys);
+        }
+
         SHAMapAddNode san;
 
         if (packet.type () == protocol::liTX_NODE)
@@ -55,6 +55,7 @@
 #include <call/basics/TaggedCache.h>
 #include <call/basics/UptimeTimer.h>
 #include <call/core/TimeKeeper.h>
+#include <call/nodestore/DatabaseShard.h>
 #include <call/overlay/Overlay.h>
 #include <call/overlay/Peer.h>
 #include <call/protocol/digest.h>
@@ -62,6 +63,7 @@
 #include <call/resource/Fees.h>
 #include <algorithm>
 #include <cassert>
+#include <map>
 #include <memory>
 #include <vector>
 
@@ -220,6 +222,8 @@ LedgerMaster::setValidLedger(
         signTime = l->info().closeTime;
     }
 
+    auto const prior = mValidLedger.get ();
+
     mValidLedger.set (l);
     mValidLedgerSign = signTime.time_since_epoch().count();
     assert (mValidLedgerSeq ||
@@ -233,6 +237,26 @@ LedgerMaster::setValidLedger(
     app_.getSHAMapStore().onLedgerClosed (getValidatedLedger());
     mLedgerHistory.validatedLedger (l);
     app_.getAmendmentTable().doValidatedLedger (l);
+
+    // Peers catching up will ask for this ledger's nodes next. Only
+    // the nodes that changed since the prior ledger need serializing.
+    if (! standalone_ && prior &&
+        prior->info().seq + 1 == l->info().seq)
+    {
+        app_.getJobQueue ().addJob (
+            jtLEDGER_REQ, "WireNodeCache",
+            [this, l, prior] (Job&)
+            {
+                auto& cache = app_.getWireNodeCache ();
+                auto const count =
+                    l->stateMap().cacheWireNodes (cache, &prior->stateMap()) +
+                    l->txMap().cacheWireNodes (cache, nullptr);
+                JLOG (m_journal.trace()) <<
+                    "Cached " << count << " wire nodes of ledger " <<
+                    l->info().seq;
+            });
+    }
+
     if (!app_.getOPs().isAmendmentBlocked() &&
         app_.getAmendmentTable().hasUnsupportedEnabled ())
     {
@@ -676,6 +700,173 @@ LedgerMaster::setFullLedger (
             }
         }
     }
+
+    storeShards ();
+}
+
+// Store a ledger's header and nodes in its history shard. When the
+// previous ledger is in the shard, only the state nodes which changed
+// since then are copied.
+static
+bool
+copyToShard (
+    NodeStore::DatabaseShard& shards,
+    Ledger const& ledger,
+    Ledger const* prev,
+    beast::Journal j)
+{
+    auto const seq = ledger.info().seq;
+
+    auto const store = [&shards, seq] (NodeObjectType type)
+    {
+        return [&shards, seq, type] (SHAMapAbstractNode& node)
+        {
+            Serializer s;
+            node.addRaw (s, snfPREFIX);
+            shards.store (type, std::move (s.modData ()),
+                node.getNodeHash ().as_uint256 (), seq);
+            return true;
+        };
+    };
+
+    try
+    {
+        ledger.stateMap().visitDifferences (
+            prev ? &prev->stateMap() : nullptr, store (hotACCOUNT_NODE));
+        ledger.txMap().visitDifferences (
+            nullptr, store (hotTRANSACTION_NODE));
+    }
+    catch (SHAMapMissingNode const& e)
+    {
+        JLOG (j.warn()) <<
+            "Ledger " << seq << " not stored in its shard: " << e;
+        return false;
+    }
+
+    Serializer s (128);
+    s.add32 (HashPrefix::ledgerMaster);
+    addRaw (ledger.info(), s);
+    shards.store (hotLEDGER, std::move (s.modData ()),
+        ledger.info().hash, seq);
+
+    shards.setStored (seq);
+    return true;
+}
+
+void
+LedgerMaster::storeShards ()
+{
+    auto const shards = app_.getShardStore ();
+    if (! shards)
+        return;
+
+    // Only ledgers we still have locally can be copied
+    RangeSet<std::uint32_t> missing;
+    {
+        ScopedLockType ml (mCompleteLock);
+        missing = mCompleteLedgers;
+    }
+    missing -= shards->getStored ();
+
+    std::map<std::uint32_t, RangeSet<std::uint32_t>> work;
+    for (auto const& interval : missing)
+    {
+        auto first = interval.first ();
+        for (;;)
+        {
+            auto const index = shards->seqToShardIndex (first);
+            auto const last = std::min (
+                interval.last (), shards->lastSeq (index));
+            work[index].insert (range (first, last));
+            if (last == interval.last ())
+                break;
+            first = last + 1;
+        }
+    }
+
+    // Shards are independent, so they are filled in parallel
+    std::lock_guard<std::mutex> lock (mShardMutex);
+    for (auto& entry : work)
+    {
+        auto const index = entry.first;
+        if (! mShardsFilling.insert (index).second)
+            continue;
+
+        if (! app_.getJobQueue ().addJob (
+            jtSHARD, "LedgerMaster::storeShard",
+            [this, index, seqs = std::move (entry.second)] (Job&)
+            {
+                storeShard (index, seqs);
+            }))
+        {
+            mShardsFilling.erase (index);
+        }
+    }
+}
+
+void
+LedgerMaster::storeShard (
+    std::uint32_t shardIndex,
+    RangeSet<std::uint32_t> const& seqs)
+{
+    auto& shards = *app_.getShardStore ();
+    std::shared_ptr<Ledger const> prev;
+    int stored = 0;
+
+    for (auto const& interval : seqs)
+    {
+        for (auto seq = interval.first ();
+            seq <= interval.last () && ! isStopping (); ++seq)
+        {
+            if (shards.hasLedger (seq))
+                continue;
+
+            auto const ledger = getLedgerBySeq (seq);
+            if (! ledger)
+            {
+                prev.reset ();
+                continue;
+            }
+
+            if (! prev || prev->info().seq + 1 != seq)
+            {
+                prev.reset ();
+                if (seq != shards.firstSeq (shardIndex) &&
+                        shards.hasLedger (seq - 1))
+                    prev = getLedgerBySeq (seq - 1);
+            }
+            if (prev && prev->info().hash != ledger->info().parentHash)
+                prev.reset ();
+
+            if (copyToShard (shards, *ledger, prev.get (), m_journal))
+            {
+                prev = ledger;
+                ++stored;
+            }
+            else
+            {
+                prev.reset ();
+            }
+        }
+    }
+
+    JLOG (m_journal.debug()) <<
+        "Stored " << stored << " ledgers in shard " << shardIndex;
+
+    std::lock_guard<std::mutex> lock (mShardMutex);
+    mShardsFilling.erase (shardIndex);
+}
+
+std::shared_ptr<Ledger const>
+LedgerMaster::getShardLedger (uint256 const& hash, std::uint32_t seq)
+{
+    auto const shards = app_.getShardStore ();
+    if (! shards || ! shards->hasLedger (seq))
+        return {};
+
+    // Every node is local, so this completes without asking peers
+    return app_.getInboundLedgers ().acquire (
+        hash, seq, InboundLedger::fcGENERIC);
 }
 
 void
@@ -1407,7 +1598,11 @@ LedgerMaster::getLedgerBySeq (std::uint32_t index)
                 auto const hash = hashOfSeq(*valid, index, m_journal);
 
                 if (hash)
-                    return mLedgerHistory.getLedgerByHash (*hash);
+                {
+                    if (auto ledger = mLedgerHistory.getLedgerByHash (*hash))
+                        return ledger;
+                    return getShardLedger (*hash, index);
+                }
             }
             catch (std::exception const&)
             {
@@ -1713,6 +1908,7 @@ void LedgerMaster::doAdvance (ScopedLockType& sl)
 
                 {
                     ScopedUnlockType sul(m_mutex);
+                    app_.getOrderBookDB().processLedger(ledger);
                     app_.getOPs().pubLedger(ledger);
                 }
             }
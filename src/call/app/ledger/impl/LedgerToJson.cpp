@@ -267,6 +267,17 @@ void addJson (Json::Value& json, LedgerFill const& fill)
         fillJsonQueue(json, fill);
 }
 
+void addJson (Json::Object& json, LedgerFill const& fill)
+{
+    {
+        auto&& object = Json::addObject (json, jss::ledger);
+        fillJson (object, fill);
+    }
+
+    if ((fill.options & LedgerFill::dumpQueue) && !fill.txQueue.empty())
+        fillJsonQueue(json, fill);
+}
+
 Json::Value getJson (LedgerFill const& fill)
 {
     Json::Value json;
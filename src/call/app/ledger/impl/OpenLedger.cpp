@@ -41,7 +41,6 @@
 #include <call/ledger/CachedView.h>
 #include <call/overlay/Message.h>
 #include <call/overlay/Overlay.h>
-#include <call/overlay/predicates.h>
 #include <call/protocol/Feature.h>
 #include <boost/range/adaptor/transformed.hpp>
 
@@ -173,9 +172,7 @@ OpenLedger::accept(Application& app, Rules const& rules,
             msg.set_status(protocol::tsNEW);
             msg.set_receivetimestamp(
                 app.timeKeeper().now().time_since_epoch().count());
-            app.overlay().foreach(send_if_not(
-                std::make_shared<Message>(msg, protocol::mtTRANSACTION),
-                peer_in_set(*toSkip)));
+            app.overlay().relay(msg, *toSkip);
         }
     }
 
@@ -0,0 +1,98 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of calld: https://github.com/callchain/calld
+    Copyright (c) 2018, 2019 Callchain Fundation.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <call/app/ledger/StateDiff.h>
+#include <call/basics/StringUtilities.h>
+#include <call/protocol/JsonFields.h>
+#include <call/protocol/STLedgerEntry.h>
+#include <call/shamap/SHAMapMissingNode.h>
+
+namespace call {
+
+StateDiff::StateDiff (Ledger const& base, Ledger const& ledger, int limit)
+{
+    try
+    {
+        complete_ = ledger.stateMap().compare (
+            base.stateMap(), delta_, limit);
+    }
+    catch (SHAMapMissingNode const&)
+    {
+        complete_ = false;
+    }
+}
+
+static
+Json::Value
+entryJson (SHAMapItem const& item, bool binary)
+{
+    if (binary)
+    {
+        Json::Value entry (Json::objectValue);
+        entry[jss::data] = strHex (item.peekData());
+        entry[jss::index] = to_string (item.key());
+        return entry;
+    }
+
+    SerialIter sit (item.slice());
+    auto entry = STLedgerEntry (sit, item.key()).getJson (0);
+    entry[jss::index] = to_string (item.key());
+    return entry;
+}
+
+void
+StateDiff::addJson (Json::Value& json, bool binary) const
+{
+    auto& created = json[jss::created] = Json::arrayValue;
+    auto& modified = json[jss::modified] = Json::arrayValue;
+    auto& deleted = json[jss::deleted] = Json::arrayValue;
+
+    // Each delta item pairs the entry in the ledger with the
+    // entry in the base.
+    for (auto const& d : delta_)
+    {
+        auto const& item = d.second.first;
+        auto const& prior = d.second.second;
+
+        if (item && prior)
+            modified.append (entryJson (*item, binary));
+        else if (item)
+            created.append (entryJson (*item, binary));
+        else if (prior)
+            deleted.append (entryJson (*prior, binary));
+    }
+}
+
+} // call
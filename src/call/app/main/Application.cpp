@@ -51,6 +51,8 @@
 #include <call/app/main/NodeIdentity.h>
 #include <call/app/main/NodeStoreScheduler.h>
 #include <call/app/misc/AmendmentTable.h>
+#include <call/app/misc/AccountTxIndex.h>
+#include <call/app/misc/BatchVerifier.h>
 #include <call/app/misc/HashRouter.h>
 #include <call/app/misc/LoadFeeTrack.h>
 #include <call/app/misc/NetworkOPs.h>
@@ -63,6 +65,7 @@
 #include <call/basics/ResolverAsio.h>
 #include <call/basics/Sustain.h>
 #include <call/json/json_reader.h>
+#include <call/nodestore/DatabaseShard.h>
 #include <call/nodestore/DummyScheduler.h>
 #include <call/overlay/Cluster.h>
 #include <call/overlay/make_Overlay.h>
@@ -217,6 +220,28 @@ public:
     {
         acquire (hash, 0);
     }
+
+    bool
+    dispatch (std::function<void()> work) override
+    {
+        if (! app_.config().PARALLEL_FLUSH)
+            return false;
+
+        return app_.getJobQueue().addJob (jtFLUSH, "SHAMap::flush",
+            [work = std::move (work)](Job&) { work(); });
+    }
+
+    int
+    readAhead () const override
+    {
+        return app_.config().READ_AHEAD;
+    }
+
+    NodeStore::DatabaseShard*
+    shardStore () override
+    {
+        return app_.getShardStore ();
+    }
 };
 
 
@@ -244,6 +269,7 @@ private:
     private:
         beast::insight::Event m_event;
         beast::Journal m_journal;
+        std::string m_name;
         beast::io_latency_probe <std::chrono::steady_clock> m_probe;
         std::atomic<std::chrono::milliseconds> lastSample_;
 
@@ -251,10 +277,12 @@ private:
         io_latency_sampler (
             beast::insight::Event ev,
             beast::Journal journal,
+            std::string name,
             std::chrono::milliseconds interval,
             boost::asio::io_service& ios)
             : m_event (ev)
             , m_journal (journal)
+            , m_name (std::move (name))
             , m_probe (interval, ios)
             , lastSample_ {}
         {
@@ -279,7 +307,7 @@ private:
             if (ms.count() >= 500)
             {
                 JLOG(m_journal.warn()) <<
-                    "io_service latency = " << ms.count();
+                    m_name << " latency = " << ms.count();
             }
         }
 
@@ -320,6 +348,7 @@ public:
 
     // These are not Stoppable-derived
     NodeCache m_tempNodeCache;
+    WireNodeCache m_wireNodeCache;
     std::unique_ptr <CollectorManager> m_collectorManager;
     CachedSLEs cachedSLEs_;
     std::pair<PublicKey, SecretKey> nodeIdentity_;
@@ -330,6 +359,7 @@ public:
     // These are Stoppable-related
     std::unique_ptr <JobQueue> m_jobQueue;
     std::unique_ptr <NodeStore::Database> m_nodeStore;
+    std::unique_ptr <NodeStore::DatabaseShard> m_shardStore;
     detail::AppFamily family_;
     // VFALCO TODO Make OrderBookDB abstract
     OrderBookDB m_orderBookDB;
@@ -348,6 +378,7 @@ public:
     std::unique_ptr <AmendmentTable> m_amendmentTable;
     std::unique_ptr <LoadFeeTrack> mFeeTrack;
     std::unique_ptr <HashRouter> mHashRouter;
+    std::unique_ptr <BatchVerifier> m_batchVerifier;
     RCLValidations mValidations;
     std::unique_ptr <LoadManager> m_loadManager;
     std::unique_ptr <TxQ> txQ_;
@@ -357,6 +388,7 @@ public:
     bool startTimers_;
 
     std::unique_ptr <DatabaseCon> mTxnDB;
+    std::unique_ptr <AccountTxIndex> m_accountTxIndex;
     std::unique_ptr <DatabaseCon> mLedgerDB;
     std::unique_ptr <DatabaseCon> mWalletDB;
     std::unique_ptr <Overlay> m_overlay;
@@ -369,7 +401,10 @@ public:
 
     std::unique_ptr <ResolverAsio> m_resolver;
 
+    // One for each IOPool
     io_latency_sampler m_io_latency_sampler;
+    io_latency_sampler m_peer_io_latency_sampler;
+    io_latency_sampler m_client_io_latency_sampler;
 
     //--------------------------------------------------------------------------
 
@@ -384,6 +419,34 @@ public:
     #endif
     }
 
+    // The thread pools, in the order of IOPool
+    static
+    std::vector<std::pair<std::string, std::size_t>>
+    ioPools(Config const& config)
+    {
+    #if CALL_SINGLE_IO_SERVICE_THREAD
+        return {{"io_service", 1}};
+    #else
+        // Peers and clients share the general pool unless configured,
+        // so an unchanged config runs the same number of threads.
+        auto general = numberOfThreads (config);
+        std::size_t peer = 0;
+        std::size_t client = 0;
+
+        auto const& section = config.section (SECTION_IO_THREADS);
+        get_if_exists (section, "general", general);
+        get_if_exists (section, "peer", peer);
+        get_if_exists (section, "client", client);
+
+        if (general == 0)
+            Throw<std::runtime_error> (
+                "[" SECTION_IO_THREADS "] general must be at least 1");
+
+        return {{"io_service", general},
+            {"peer io", peer}, {"client io", client}};
+    #endif
+    }
+
     //--------------------------------------------------------------------------
 
     ApplicationImp (
@@ -391,7 +454,7 @@ public:
             std::unique_ptr<Logs> logs,
             std::unique_ptr<TimeKeeper> timeKeeper)
         : RootStoppable ("Application")
-        , BasicApp (numberOfThreads(*config))
+        , BasicApp (ioPools(*config))
         , config_ (std::move(config))
         , logs_ (std::move(logs))
         , timeKeeper_ (std::move(timeKeeper))
@@ -412,6 +475,10 @@ public:
         , m_tempNodeCache ("NodeCache", 16384, 90, stopwatch(),
             logs_->journal("TaggedCache"))
 
+        , m_wireNodeCache ("WireNodeCache", wireNodeCacheTargetSize,
+            wireNodeCacheExpirationSeconds, stopwatch(),
+                logs_->journal("TaggedCache"))
+
         , m_collectorManager (CollectorManager::New (
             config_->section (SECTION_INSIGHT), logs_->journal("Collector")))
         , cachedSLEs_ (std::chrono::minutes(1), stopwatch())
@@ -435,7 +502,7 @@ public:
 
         , family_ (*this, *m_nodeStore, *m_collectorManager)
 
-        , m_orderBookDB (*this, *m_jobQueue)
+        , m_orderBookDB (*this, *m_jobQueue, setup_OrderBookDB (*config_))
 
         , m_pathRequests (std::make_unique<PathRequests> (
             *this, logs_->journal("PathRequest"), m_collectorManager->collector ()))
@@ -484,7 +551,8 @@ public:
         , validatorSites_ (std::make_unique<ValidatorSite> (
             get_io_service (), *validators_, logs_->journal("ValidatorSite")))
 
-        , serverHandler_ (make_ServerHandler (*this, *m_networkOPs, get_io_service (),
+        , serverHandler_ (make_ServerHandler (*this, *m_networkOPs,
+            getIOService (IOPool::client), getIOService (IOPool::peer),
             *m_jobQueue, *m_networkOPs, *m_resourceManager, *m_collectorManager))
 
         , mFeeTrack (std::make_unique<LoadFeeTrack>(logs_->journal("LoadManager")))
@@ -493,6 +561,9 @@ public:
             stopwatch(), HashRouter::getDefaultHoldTime (),
             HashRouter::getDefaultRecoverLimit ()))
 
+        , m_batchVerifier (std::make_unique<BatchVerifier> (
+            *this, *m_jobQueue, logs_->journal("BatchVerifier")))
+
         , mValidations (ValidationParms(),stopwatch(), logs_->journal("Validations"),
             *this)
 
@@ -513,7 +584,16 @@ public:
         , m_resolver (ResolverAsio::New (get_io_service(), logs_->journal("Resolver")))
 
         , m_io_latency_sampler (m_collectorManager->collector()->make_event ("ios_latency"),
-            logs_->journal("Application"), std::chrono::milliseconds (100), get_io_service())
+            logs_->journal("Application"), "io_service",
+            std::chrono::milliseconds (100), get_io_service())
+
+        , m_peer_io_latency_sampler (m_collectorManager->collector()->make_event ("ios_latency_peer"),
+            logs_->journal("Application"), "peer io_service",
+            std::chrono::milliseconds (100), getIOService (IOPool::peer))
+
+        , m_client_io_latency_sampler (m_collectorManager->collector()->make_event ("ios_latency_client"),
+            logs_->journal("Application"), "client io_service",
+            std::chrono::milliseconds (100), getIOService (IOPool::client))
     {
         add (m_resourceManager.get ());
 
@@ -608,11 +688,29 @@ public:
         return get_io_service();
     }
 
+    boost::asio::io_service& getIOService (IOPool pool) override
+    {
+        return get_io_service (static_cast<std::size_t> (pool));
+    }
+
     std::chrono::milliseconds getIOLatency () override
     {
         return m_io_latency_sampler.get ();
     }
 
+    std::chrono::milliseconds getIOLatency (IOPool pool) override
+    {
+        switch (pool)
+        {
+        case IOPool::peer:
+            return m_peer_io_latency_sampler.get ();
+        case IOPool::client:
+            return m_client_io_latency_sampler.get ();
+        default:
+            return m_io_latency_sampler.get ();
+        }
+    }
+
     LedgerMaster& getLedgerMaster () override
     {
         return *m_ledgerMaster;
@@ -649,11 +747,21 @@ public:
         return m_tempNodeCache;
     }
 
+    WireNodeCache& getWireNodeCache () override
+    {
+        return m_wireNodeCache;
+    }
+
     NodeStore::Database& getNodeStore () override
     {
         return *m_nodeStore;
     }
 
+    NodeStore::DatabaseShard* getShardStore () override
+    {
+        return m_shardStore.get();
+    }
+
     Application::MutexType& getMasterMutex () override
     {
         return m_masterMutex;
@@ -700,6 +808,11 @@ public:
         return *mHashRouter;
     }
 
+    BatchVerifier& getBatchVerifier () override
+    {
+        return *m_batchVerifier;
+    }
+
     RCLValidations& getValidations () override
     {
         return mValidations;
@@ -774,6 +887,10 @@ public:
         assert (mTxnDB.get() != nullptr);
         return *mTxnDB;
     }
+    AccountTxIndex* getAccountTxIndex () override
+    {
+        return m_accountTxIndex.get();
+    }
     DatabaseCon& getLedgerDB () override
     {
         assert (mLedgerDB.get() != nullptr);
@@ -851,6 +968,8 @@ public:
         }
 
         m_io_latency_sampler.start();
+        m_peer_io_latency_sampler.start();
+        m_client_io_latency_sampler.start();
 
         m_resolver->start ();
     }
@@ -861,6 +980,8 @@ public:
         JLOG(m_journal.debug()) << "Application stopping";
 
         m_io_latency_sampler.cancel_async ();
+        m_peer_io_latency_sampler.cancel_async ();
+        m_client_io_latency_sampler.cancel_async ();
 
         // VFALCO Enormous hack, we have to force the probe to cancel
         //        before we stop the io_service queue or else it never
@@ -869,6 +990,8 @@ public:
         //        naturally return from io_service::run() instead of
         //        forcing a call to io_service::stop()
         m_io_latency_sampler.cancel ();
+        m_peer_io_latency_sampler.cancel ();
+        m_client_io_latency_sampler.cancel ();
 
         m_resolver->stop_async ();
 
@@ -1015,6 +1138,7 @@ public:
         getNodeStore().sweep();
         getLedgerMaster().sweep();
         getTempNodeCache().sweep();
+        getWireNodeCache().sweep();
         getValidations().expire();
         getInboundLedgers().sweep();
         m_acceptedLedgerCache.sweep();
@@ -1101,6 +1225,27 @@ bool ApplicationImp::setup()
         return false;
     }
 
+    m_accountTxIndex = make_AccountTxIndex (
+        config_->section (ConfigSection::accountTxIndex ()),
+        logs_->journal ("AccountTxIndex"));
+
+    if (m_accountTxIndex)
+    {
+        JLOG(m_journal.info()) <<
+            "Account transactions indexed in " << m_accountTxIndex->getName ();
+    }
+
+    if (! config_->section (ConfigSection::shardDatabase ()).empty ())
+    {
+        m_shardStore = NodeStore::make_DatabaseShard (
+            config_->section (ConfigSection::shardDatabase ()),
+            m_nodeStoreScheduler, logs_->journal ("NodeObject"));
+
+        JLOG(m_journal.info()) <<
+            "Ledger history sharded in " << m_shardStore->getName () <<
+            ", complete shards: " << m_shardStore->getCompleteShards ();
+    }
+
     if (validatorKeys_.publicKey.size())
         setMaxDisallowedLedger();
 
@@ -1235,8 +1380,8 @@ bool ApplicationImp::setup()
     //
     //             if (!config_.standalone())
     m_overlay = make_Overlay (*this, setup_Overlay(*config_), *m_jobQueue,
-        *serverHandler_, *m_resourceManager, *m_resolver, get_io_service(),
-        *config_);
+        *serverHandler_, *m_resourceManager, *m_resolver,
+        getIOService (IOPool::peer), *config_);
     add (*m_overlay); // add to PropertyStream
 
     validatorSites_->start ();
@@ -1381,6 +1526,10 @@ int ApplicationImp::fdlimit() const
     // doubled if online delete is enabled).
     needed += std::max(5, m_shaMapStore->fdlimit());
 
+    // the history shards, if any
+    if (m_shardStore)
+        needed += m_shardStore->fdlimit();
+
     // One fd per incoming connection a port can accept, or
     // if no limit is set, assume it'll handle 256 clients.
     for(auto const& p : serverHandler_->setup().ports)
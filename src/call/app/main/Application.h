@@ -37,6 +37,7 @@
 
 #include <call/shamap/FullBelowCache.h>
 #include <call/shamap/TreeNodeCache.h>
+#include <call/shamap/WireNodeCache.h>
 #include <call/basics/TaggedCache.h>
 #include <call/core/Config.h>
 #include <call/protocol/Protocol.h>
@@ -50,14 +51,16 @@ namespace call {
 
 namespace unl { class Manager; }
 namespace Resource { class Manager; }
-namespace NodeStore { class Database; }
+namespace NodeStore { class Database; class DatabaseShard; }
 
 // VFALCO TODO Fix forward declares required for header dependency loops
+class AccountTxIndex;
 class AmendmentTable;
 class CachedSLEs;
 class CollectorManager;
 class Family;
 class HashRouter;
+class BatchVerifier;
 class Logs;
 class LoadFeeTrack;
 class JobQueue;
@@ -97,6 +100,19 @@ class RCLValidationsPolicy;
 using RCLValidations =
     Validations<RCLValidationsPolicy, RCLValidation, std::mutex>;
 
+/** The pools of threads performing asynchronous I/O.
+
+    Peer and client traffic are served by separate pools, so a burst of
+    client requests does not delay the reading of peer messages. Timers
+    and other internal work run on the general pool.
+*/
+enum class IOPool
+{
+    general,
+    peer,
+    client
+};
+
 class Application : public beast::PropertyStream::Source
 {
 public:
@@ -134,14 +150,17 @@ public:
     virtual Logs& logs() = 0;
     virtual Config& config() = 0;
     virtual boost::asio::io_service& getIOService () = 0;
+    virtual boost::asio::io_service& getIOService (IOPool pool) = 0;
     virtual CollectorManager&       getCollectorManager () = 0;
     virtual Family&                 family() = 0;
     virtual TimeKeeper&             timeKeeper() = 0;
     virtual JobQueue&               getJobQueue () = 0;
     virtual NodeCache&              getTempNodeCache () = 0;
+    virtual WireNodeCache&          getWireNodeCache () = 0;
     virtual CachedSLEs&             cachedSLEs() = 0;
     virtual AmendmentTable&         getAmendmentTable() = 0;
     virtual HashRouter&             getHashRouter () = 0;
+    virtual BatchVerifier&          getBatchVerifier () = 0;
     virtual LoadFeeTrack&           getFeeTrack () = 0;
     virtual LoadManager&            getLoadManager () = 0;
     virtual Overlay&                overlay () = 0;
@@ -153,6 +172,8 @@ public:
     virtual Cluster&                cluster () = 0;
     virtual RCLValidations&         getValidations () = 0;
     virtual NodeStore::Database&    getNodeStore () = 0;
+    /** The historical shards, or `nullptr` if not configured. */
+    virtual NodeStore::DatabaseShard* getShardStore () = 0;
     virtual InboundLedgers&         getInboundLedgers () = 0;
     virtual InboundTransactions&    getInboundTransactions () = 0;
     virtual TaggedCache <uint256, AcceptedLedger>&
@@ -178,9 +199,13 @@ public:
     virtual OpenLedger&             openLedger() = 0;
     virtual OpenLedger const&       openLedger() const = 0;
     virtual DatabaseCon& getTxnDB () = 0;
+    /** The account transaction index, or `nullptr` if not configured. */
+    virtual AccountTxIndex* getAccountTxIndex () = 0;
     virtual DatabaseCon& getLedgerDB () = 0;
 
+    /** The latency of the general I/O pool. */
     virtual std::chrono::milliseconds getIOLatency () = 0;
+    virtual std::chrono::milliseconds getIOLatency (IOPool pool) = 0;
 
     virtual bool serverOkay (std::string& reason) = 0;
 
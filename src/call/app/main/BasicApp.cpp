@@ -37,23 +37,43 @@
 #include <call/beast/core/CurrentThreadName.h>
 
 BasicApp::BasicApp(std::size_t numberOfThreads)
+    : BasicApp({{"io_service", numberOfThreads}})
 {
-    work_.emplace (io_service_);
-    threads_.reserve(numberOfThreads);
-    while(numberOfThreads--)
-        threads_.emplace_back(
-            [this, numberOfThreads]()
-            {
-                beast::setCurrentThreadName(
-                    std::string("io_service #") +
-                        std::to_string(numberOfThreads));
-                this->io_service_.run();
-            });
+}
+
+BasicApp::BasicApp(
+    std::vector<std::pair<std::string, std::size_t>> const& pools)
+{
+    pools_.reserve(pools.size());
+    for (auto const& p : pools)
+    {
+        if (p.second == 0 && ! pools_.empty())
+        {
+            pools_.emplace_back();
+            continue;
+        }
+
+        pools_.emplace_back(std::make_unique<Pool>());
+        auto& pool = *pools_.back();
+        pool.work.emplace (pool.io_service);
+        pool.threads.reserve(p.second);
+        for (auto n = p.second; n--;)
+            pool.threads.emplace_back(
+                [&pool, name = p.first + " #" + std::to_string(n)]()
+                {
+                    beast::setCurrentThreadName(name);
+                    pool.io_service.run();
+                });
+    }
 }
 
 BasicApp::~BasicApp()
 {
-    work_ = boost::none;
-    for (auto& _ : threads_)
-        _.join();
+    for (auto& pool : pools_)
+        if (pool)
+            pool->work = boost::none;
+    for (auto& pool : pools_)
+        if (pool)
+            for (auto& _ : pool->threads)
+                _.join();
 }
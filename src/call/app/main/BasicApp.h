@@ -37,26 +37,45 @@
 
 #include <boost/asio/io_service.hpp>
 #include <boost/optional.hpp>
+#include <memory>
+#include <string>
 #include <thread>
+#include <utility>
 #include <vector>
 
 // This is so that the io_service can outlive all the children
 class BasicApp
 {
 private:
-    boost::optional<boost::asio::io_service::work> work_;
-    std::vector<std::thread> threads_;
-    boost::asio::io_service io_service_;
+    // An io_service and the threads that run it
+    struct Pool
+    {
+        boost::asio::io_service io_service;
+        boost::optional<boost::asio::io_service::work> work;
+        std::vector<std::thread> threads;
+    };
+
+    std::vector<std::unique_ptr<Pool>> pools_;
 
 protected:
     BasicApp(std::size_t numberOfThreads);
+
+    /** Run several io_services, each on its own threads.
+
+        Each pool is given as the name of its threads and their number.
+        A pool with no threads is served by the first pool.
+    */
+    BasicApp(std::vector<std::pair<std::string, std::size_t>> const& pools);
+
     ~BasicApp();
 
 public:
     boost::asio::io_service&
-    get_io_service()
+    get_io_service(std::size_t pool = 0)
     {
-        return io_service_;
+        if (pool < pools_.size() && pools_[pool])
+            return pools_[pool]->io_service;
+        return pools_.front()->io_service;
     }
 };
 
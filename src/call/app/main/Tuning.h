@@ -41,6 +41,8 @@ enum
 {
      fullBelowTargetSize = 524288
     ,fullBelowExpirationSeconds = 600
+    ,wireNodeCacheTargetSize = 65536
+    ,wireNodeCacheExpirationSeconds = 120
 };
 
 }
@@ -0,0 +1,117 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of calld: https://github.com/callchain/calld
+    Copyright (c) 2018, 2019 Callchain Fundation.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef CALL_APP_MISC_ACCOUNTTXINDEX_H_INCLUDED
+#define CALL_APP_MISC_ACCOUNTTXINDEX_H_INCLUDED
+
+#include <call/basics/BasicConfig.h>
+#include <call/basics/base_uint.h>
+#include <call/beast/utility/Journal.h>
+#include <call/protocol/AccountID.h>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace call {
+
+/** An ordered index of the transactions which affected each account.
+
+    When configured, this takes the place of the AccountTransactions
+    table in the transaction database. Entries are kept in (account,
+    ledger sequence, transaction sequence) order, so a page of an
+    account's history is a single range scan, and all the entries of
+    a ledger are written together.
+
+    The index only holds transaction IDs; the transactions themselves
+    stay in the transaction database.
+*/
+class AccountTxIndex
+{
+public:
+    /** A position in an account's history: ledger and transaction seq. */
+    using Position = std::pair<std::uint32_t, std::uint32_t>;
+
+    struct Entry
+    {
+        AccountID account;
+        std::uint32_t ledgerSeq;
+        std::uint32_t txnSeq;
+        uint256 txID;
+    };
+
+    virtual ~AccountTxIndex () = default;
+
+    /** Returns a human readable name for the index. */
+    virtual
+    std::string
+    getName () const = 0;
+
+    /** Replace the entries of a ledger in a single write. */
+    virtual
+    void
+    saveLedger (std::uint32_t ledgerSeq,
+        std::vector<Entry> const& entries) = 0;
+
+    /** Remove the entries of every ledger before `ledgerSeq`. */
+    virtual
+    void
+    deleteBefore (std::uint32_t ledgerSeq) = 0;
+
+    /** Visit an account's entries between two positions, inclusive.
+
+        Entries are visited in ascending order when `forward` is set
+        and descending order otherwise. The walk ends early when the
+        callback returns `false`.
+    */
+    virtual
+    void
+    forEach (AccountID const& account, Position const& first,
+        Position const& last, bool forward,
+        std::function<bool (Entry const&)> const& f) const = 0;
+};
+
+/** Create the account transaction index.
+
+    Returns `nullptr` when the section has no `type`, in which case
+    the AccountTransactions table is used.
+*/
+std::unique_ptr<AccountTxIndex>
+make_AccountTxIndex (Section const& section, beast::Journal journal);
+
+} // call
+
+#endif
@@ -0,0 +1,99 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of calld: https://github.com/callchain/calld
+    Copyright (c) 2018, 2019 Callchain Fundation.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef CALL_APP_MISC_BATCHVERIFIER_H_INCLUDED
+#define CALL_APP_MISC_BATCHVERIFIER_H_INCLUDED
+
+#include <call/protocol/STTx.h>
+#include <call/beast/utility/Journal.h>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace call {
+
+class Application;
+class JobQueue;
+
+/** Verifies transaction signatures in batches.
+
+    Ed25519-signed transactions from peers and from consensus
+    are queued here instead of being verified as they arrive.
+    A single job checks the queued signatures a batch at a time;
+    whatever arrives while a batch is being checked joins the next
+    one. The results go into the HashRouter, so the checkValidity
+    call that follows does not check the signature again.
+*/
+class BatchVerifier final
+{
+public:
+    /** The most signatures checked together. */
+    static std::size_t constexpr maxBatchSize = 64;
+
+    BatchVerifier (Application& app, JobQueue& jobQueue,
+        beast::Journal journal);
+
+    BatchVerifier (BatchVerifier const&) = delete;
+    BatchVerifier& operator= (BatchVerifier const&) = delete;
+
+    /** Verify a transaction's signature, then call `then`.
+
+        Transactions which are not signed with Ed25519 gain nothing
+        from batching, so `then` is called right away. Otherwise it
+        is called on a job thread once the signature state is cached.
+    */
+    void
+    add (std::shared_ptr<STTx const> const& tx,
+        std::function<void()> then);
+
+private:
+    void verify ();
+
+    using Entry = std::pair<std::shared_ptr<STTx const>,
+        std::function<void()>>;
+
+    Application& app_;
+    JobQueue& jobQueue_;
+    beast::Journal j_;
+
+    std::mutex mutex_;
+    std::vector<Entry> pending_;
+    bool scheduled_ = false;
+};
+
+} // call
+
+#endif
@@ -34,52 +34,97 @@
 
 #include <BeastConfig.h>
 #include <call/app/misc/HashRouter.h>
+#include <cstring>
 
 namespace call {
 
 auto
-HashRouter::emplace (uint256 const& key)
+HashRouter::getShard (uint256 const& key)
+    -> Shard&
+{
+    // The keys are hashes, so any of their bits will do
+    std::size_t index;
+    std::memcpy (&index, key.data (), sizeof (index));
+    return *shards_[index % shardCount];
+}
+
+void
+HashRouter::sweep (Shard& shard, Stopwatch::time_point when)
+{
+    if (when <= shard.swept)
+        return;
+
+    shard.swept = when;
+
+    auto& map = shard.suppressionMap;
+    auto const expired = when - holdTime_;
+    for (auto iter = map.chronological.cbegin ();
+        iter != map.chronological.cend () && iter.when () <= expired;)
+    {
+        iter = map.erase (iter);
+    }
+}
+
+auto
+HashRouter::emplace (Shard& shard, uint256 const& key)
     -> std::pair<Entry&, bool>
 {
-    auto iter = suppressionMap_.find (key);
+    auto& map = shard.suppressionMap;
+
+    // Apply a sweep triggered by an insertion into another shard
+    sweep (shard, Stopwatch::time_point (
+        Stopwatch::duration (sweepTime_.load ())));
 
-    if (iter != suppressionMap_.end ())
+    auto iter = map.find (key);
+
+    if (iter != map.end ())
     {
-        suppressionMap_.touch(iter);
+        map.touch(iter);
         return std::make_pair(
             std::ref(iter->second), false);
     }
 
-    // See if any supressions need to be expired
-    expire(suppressionMap_, holdTime_);
+    // See if any supressions need to be expired. The other shards
+    // pick this up when they are next used.
+    auto const now = map.clock ().now ();
+    auto const ticks = now.time_since_epoch ().count ();
+    auto latest = sweepTime_.load ();
+    while (latest < ticks &&
+        ! sweepTime_.compare_exchange_weak (latest, ticks))
+    {
+    }
+    sweep (shard, now);
 
     return std::make_pair(std::ref(
-        suppressionMap_.emplace (
+        map.emplace (
             key, Entry ()).first->second),
                 true);
 }
 
 void HashRouter::addSuppression (uint256 const& key)
 {
-    std::lock_guard <std::mutex> lock (mutex_);
+    auto& shard = getShard (key);
+    std::lock_guard <std::mutex> lock (shard.mutex);
 
-    emplace (key);
+    emplace (shard, key);
 }
 
 bool HashRouter::addSuppressionPeer (uint256 const& key, PeerShortID peer)
 {
-    std::lock_guard <std::mutex> lock (mutex_);
+    auto& shard = getShard (key);
+    std::lock_guard <std::mutex> lock (shard.mutex);
 
-    auto result = emplace(key);
+    auto result = emplace(shard, key);
     result.first.addPeer(peer);
     return result.second;
 }
 
 bool HashRouter::addSuppressionPeer (uint256 const& key, PeerShortID peer, int& flags)
 {
-    std::lock_guard <std::mutex> lock (mutex_);
+    auto& shard = getShard (key);
+    std::lock_guard <std::mutex> lock (shard.mutex);
 
-    auto result = emplace(key);
+    auto result = emplace(shard, key);
     auto& s = result.first;
     s.addPeer (peer);
     flags = s.getFlags ();
@@ -89,9 +134,10 @@ bool HashRouter::addSuppressionPeer (uint256 const& key, PeerShortID peer, int&
 bool HashRouter::shouldProcess (uint256 const& key, PeerShortID peer, int& flags,
     Stopwatch::time_point now, std::chrono::seconds interval)
 {
-    std::lock_guard <std::mutex> lock (mutex_);
+    auto& shard = getShard (key);
+    std::lock_guard <std::mutex> lock (shard.mutex);
 
-    auto result = emplace(key);
+    auto result = emplace(shard, key);
     auto& s = result.first;
     s.addPeer (peer);
     flags = s.getFlags ();
@@ -100,18 +146,20 @@ bool HashRouter::shouldProcess (uint256 const& key, PeerShortID peer, int& flags
 
 int HashRouter::getFlags (uint256 const& key)
 {
-    std::lock_guard <std::mutex> lock (mutex_);
+    auto& shard = getShard (key);
+    std::lock_guard <std::mutex> lock (shard.mutex);
 
-    return emplace(key).first.getFlags ();
+    return emplace(shard, key).first.getFlags ();
 }
 
 bool HashRouter::setFlags (uint256 const& key, int flags)
 {
     assert (flags != 0);
 
-    std::lock_guard <std::mutex> lock (mutex_);
+    auto& shard = getShard (key);
+    std::lock_guard <std::mutex> lock (shard.mutex);
 
-    auto& s = emplace(key).first;
+    auto& s = emplace(shard, key).first;
 
     if ((s.getFlags () & flags) == flags)
         return false;
@@ -124,11 +172,12 @@ auto
 HashRouter::shouldRelay (uint256 const& key)
     -> boost::optional<std::set<PeerShortID>>
 {
-    std::lock_guard <std::mutex> lock (mutex_);
+    auto& shard = getShard (key);
+    std::lock_guard <std::mutex> lock (shard.mutex);
 
-    auto& s = emplace(key).first;
+    auto& s = emplace(shard, key).first;
 
-    if (!s.shouldRelay(suppressionMap_.clock().now(), holdTime_))
+    if (!s.shouldRelay(shard.suppressionMap.clock().now(), holdTime_))
         return boost::none;
 
     return s.releasePeerSet();
@@ -137,9 +186,10 @@ HashRouter::shouldRelay (uint256 const& key)
 bool
 HashRouter::shouldRecover(uint256 const& key)
 {
-    std::lock_guard <std::mutex> lock(mutex_);
+    auto& shard = getShard (key);
+    std::lock_guard <std::mutex> lock (shard.mutex);
 
-    auto& s = emplace(key).first;
+    auto& s = emplace(shard, key).first;
 
     return s.shouldRecover(recoverLimit_);
 }
@@ -41,6 +41,10 @@
 #include <call/basics/UnorderedContainers.h>
 #include <call/beast/container/aged_unordered_map.h>
 #include <boost/optional.hpp>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
 
 namespace call {
 
@@ -64,6 +68,12 @@ namespace call {
     This table keeps track of which hashes have been received by which peers.
     It is used to manage the routing and broadcasting of messages in the peer
     to peer overlay.
+
+    The table is split into shards selected by bits of the hash, each with
+    its own lock, so messages for different hashes don't contend. Inserting
+    a new hash expires stale entries in every shard, as a single table
+    would: the insertion time is published and each shard applies the
+    sweep, under its own lock, the next time it is used.
 */
 class HashRouter
 {
@@ -166,10 +176,13 @@ public:
 
     HashRouter (Stopwatch& clock, std::chrono::seconds entryHoldTimeInSeconds,
         std::uint32_t recoverLimit)
-        : suppressionMap_(clock)
-        , holdTime_ (entryHoldTimeInSeconds)
+        : holdTime_ (entryHoldTimeInSeconds)
         , recoverLimit_ (recoverLimit + 1u)
+        , sweepTime_ (Stopwatch::duration::zero ().count ())
     {
+        shards_.reserve (shardCount);
+        for (std::size_t i = 0; i < shardCount; ++i)
+            shards_.push_back (std::make_unique<Shard> (clock));
     }
 
     HashRouter& operator= (HashRouter const&) = delete;
@@ -218,18 +231,44 @@ public:
     bool shouldRecover(uint256 const& key);
 
 private:
+    static std::size_t const shardCount = 16;
+
+    struct Shard
+    {
+        explicit Shard (Stopwatch& clock)
+            : suppressionMap (clock)
+        {
+        }
+
+        std::mutex mutex;
+
+        // Stores the suppressed hashes of this shard and their
+        // expiration time
+        beast::aged_unordered_map<uint256, Entry, Stopwatch::clock_type,
+            hardened_hash<strong_hash>> suppressionMap;
+
+        // Latest insertion time whose sweep has been applied here
+        Stopwatch::time_point swept;
+    };
+
+    Shard& getShard (uint256 const& key);
+
+    // Must be called with shard.mutex held.
     // pair.second indicates whether the entry was created
-    std::pair<Entry&, bool> emplace (uint256 const&);
+    std::pair<Entry&, bool> emplace (Shard& shard, uint256 const&);
 
-    std::mutex mutable mutex_;
+    // Expire the entries of a shard that were stale at the given time.
+    // Must be called with shard.mutex held.
+    void sweep (Shard& shard, Stopwatch::time_point when);
 
-    // Stores all suppressed hashes and their expiration time
-    beast::aged_unordered_map<uint256, Entry, Stopwatch::clock_type,
-        hardened_hash<strong_hash>> suppressionMap_;
+    std::vector<std::unique_ptr<Shard>> shards_;
 
     std::chrono::seconds const holdTime_;
 
     std::uint32_t const recoverLimit_;
+
+    // Time of the latest insertion, in clock ticks
+    std::atomic<Stopwatch::duration::rep> sweepTime_;
 };
 
 } // call
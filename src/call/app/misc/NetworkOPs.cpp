@@ -45,8 +45,11 @@
 #include <call/app/ledger/LocalTxs.h>
 #include <call/app/ledger/OpenLedger.h>
 #include <call/app/ledger/OrderBookDB.h>
+#include <call/app/ledger/StateDiff.h>
 #include <call/app/ledger/TransactionMaster.h>
 #include <call/app/main/LoadManager.h>
+#include <call/app/misc/AccountTxIndex.h>
+#include <call/app/misc/BatchVerifier.h>
 #include <call/app/misc/HashRouter.h>
 #include <call/app/misc/LoadFeeTrack.h>
 #include <call/app/misc/Transaction.h>
@@ -61,11 +64,13 @@
 #include <call/crypto/csprng.h>
 #include <call/crypto/RFC1751.h>
 #include <call/json/to_string.h>
+#include <call/nodestore/DatabaseShard.h>
 #include <call/overlay/Cluster.h>
 #include <call/overlay/Overlay.h>
 #include <call/overlay/predicates.h>
 #include <call/protocol/BuildInfo.h>
 #include <call/resource/ResourceManager.h>
+#include <call/rpc/impl/Tuning.h>
 #include <call/beast/rfc2616.h>
 #include <call/beast/core/LexicalCast.h>
 #include <call/beast/core/SystemStats.h>
@@ -73,6 +78,7 @@
 #include <call/basics/make_lock.h>
 #include <beast/core/detail/base64.hpp>
 #include <boost/asio/steady_timer.hpp>
+#include <deque>
 
 namespace call {
 
@@ -330,6 +336,9 @@ public:
 
     // Used for the "jump" case.
 private:
+    // The rest of submitTransaction, once the signature is checked.
+    void submitVerified (std::shared_ptr<STTx const> const& trans);
+
     void switchLastClosedLedger (
         std::shared_ptr<Ledger const> const& newLCL);
     bool checkLastClosedLedger (
@@ -396,6 +405,15 @@ public:
         bool descending, std::uint32_t offset, int limit,
         bool binary, bool count, bool bUnlimited);
 
+    // Visits the transactions that query would select, using the index.
+    void indexedTransactions (
+        AccountTxIndex const& index, AccountID const& account,
+        std::int32_t minLedger, std::int32_t maxLedger,
+        bool descending, std::uint32_t offset, int limit,
+        bool binary, bool bUnlimited,
+        std::function<void (std::uint32_t, std::string const&,
+            Blob const&, Blob const&)> const& f);
+
     // Client information retrieval functions.
     using NetworkOPs::AccountTxs;
     AccountTxs getAccountTxs (
@@ -456,6 +474,9 @@ public:
     bool subLedger (InfoSub::ref ispListener, Json::Value& jvResult) override;
     bool unsubLedger (std::uint64_t uListener) override;
 
+    bool subLedgerState (InfoSub::ref ispListener, bool binary) override;
+    bool unsubLedgerState (std::uint64_t uListener) override;
+
     bool subServer (
         InfoSub::ref ispListener, Json::Value& jvResult, bool admin) override;
     bool unsubServer (std::uint64_t uListener) override;
@@ -540,6 +561,10 @@ private:
 
     void pubServer ();
 
+    // Publish the state changes of accepted ledgers on a job, in order
+    void queueLedgerState (std::shared_ptr<ReadView const> const& lpAccepted);
+    void pubLedgerState (std::shared_ptr<ReadView const> const& lpAccepted);
+
     std::string getHostId (bool forAdmin);
 
 private:
@@ -550,6 +575,14 @@ private:
     // XXX Split into more locks.
     using ScopedLockType = std::lock_guard <std::recursive_mutex>;
 
+    // Append the live subscribers in a map to subs, forgetting the
+    // ones which have gone away. Called with mSubLock held.
+    static
+    void
+    collectSubscribers (
+        SubMapType& subMap,
+        std::vector<InfoSub::pointer>& subs);
+
     Application& app_;
     clock_type& m_clock;
     beast::Journal m_journal;
@@ -586,9 +619,11 @@ private:
         sRTTransactions,            // All proposed and accepted transactions.
         sValidations,               // Received validations.
         sPeerStatus,                // Peer status changes.
+        sLedgerState,               // State changes of validated ledgers.
+        sLedgerStateBinary,         // The same, as serialized entries.
 
-        sLastEntry = sPeerStatus    // as this name implies, any new entry must
-                                    // be ADDED ABOVE this one
+        sLastEntry = sLedgerStateBinary // as this name implies, any new
+                                        // entry must be ADDED ABOVE this one
     };
     std::array<SubMapType, SubTypes::sLastEntry+1> mStreamMaps;
 
@@ -609,6 +644,12 @@ private:
     DispatchState mDispatchState = DispatchState::none;
     std::vector <TransactionStatus> mTransactions;
 
+    // Ledgers whose state changes are waiting to be published, oldest
+    // first, and whether a job is publishing them.
+    std::mutex mLedgerStateMutex;
+    std::deque <std::shared_ptr<ReadView const>> mLedgerStates;
+    bool mPublishingLedgerStates = false;
+
     StateAccounting accounting_ {};
 };
 
@@ -862,6 +903,14 @@ void NetworkOPsImp::submitTransaction (std::shared_ptr<STTx const> const& iTrans
         return;
     }
 
+    app_.getBatchVerifier ().add (trans,
+        [this, trans] { submitVerified (trans); });
+}
+
+void NetworkOPsImp::submitVerified (std::shared_ptr<STTx const> const& trans)
+{
+    auto const txid = trans->getTransactionID ();
+
     try
     {
         auto const validity = checkValidity(
@@ -1169,9 +1218,7 @@ void NetworkOPsImp::apply (std::unique_lock<std::mutex>& batchLock)
                     tx.set_receivetimestamp (app_.timeKeeper().now().time_since_epoch().count());
                     tx.set_deferred(e.result == terQUEUED);
                     // FIXME: This should be when we received it
-                    app_.overlay().foreach (send_if_not (
-                        std::make_shared<Message> (tx, protocol::mtTRANSACTION),
-                        peer_in_set(*toSkip)));
+                    app_.overlay().relay (tx, *toSkip);
                 }
             }
         }
@@ -1519,7 +1566,8 @@ void NetworkOPsImp::processTrustedProposal (
     if (mConsensus.peerProposal(
             app_.timeKeeper().closeTime(), peerPos))
     {
-        app_.overlay().relay(*set, peerPos.suppressionID());
+        app_.overlay().relay(*set, peerPos.suppressionID(),
+            peerPos.publicKey());
     }
     else
         JLOG(m_journal.info()) << "Not relaying trusted proposal";
@@ -1605,12 +1653,45 @@ void NetworkOPsImp::consensusViewChange ()
         setMode (omCONNECTED);
 }
 
+void NetworkOPsImp::collectSubscribers (
+    SubMapType& subMap,
+    std::vector<InfoSub::pointer>& subs)
+{
+    for (auto i = subMap.begin (); i != subMap.end (); )
+    {
+        if (auto p = i->second.lock ())
+        {
+            subs.push_back (std::move (p));
+            ++i;
+        }
+        else
+        {
+            i = subMap.erase (i);
+        }
+    }
+}
+
+// Send an event to subscribers, serializing it only once.
+static
+void
+sendToAll (
+    std::vector<InfoSub::pointer> const& subs,
+    Json::Value const& jvObj)
+{
+    InfoSub::Event const event (jvObj);
+    for (auto const& p : subs)
+        p->send (event, true);
+}
+
 void NetworkOPsImp::pubManifest (Manifest const& mo)
 {
-    // VFALCO consider std::shared_mutex
-    ScopedLockType sl (mSubLock);
+    std::vector<InfoSub::pointer> subs;
+    {
+        ScopedLockType sl (mSubLock);
+        collectSubscribers (mStreamMaps[sManifests], subs);
+    }
 
-    if (!mStreamMaps[sManifests].empty ())
+    if (!subs.empty ())
     {
         Json::Value jvObj (Json::objectValue);
 
@@ -1623,19 +1704,7 @@ void NetworkOPsImp::pubManifest (Manifest const& mo)
         jvObj [jss::signature]        = strHex (mo.getSignature ());
         jvObj [jss::master_signature] = strHex (mo.getMasterSignature ());
 
-        for (auto i = mStreamMaps[sManifests].begin ();
-            i != mStreamMaps[sManifests].end (); )
-        {
-            if (auto p = i->second.lock())
-            {
-                p->send (jvObj, true);
-                ++i;
-            }
-            else
-            {
-                i = mStreamMaps[sManifests].erase (i);
-            }
-        }
+        sendToAll (subs, jvObj);
     }
 }
 
@@ -1673,15 +1742,14 @@ NetworkOPsImp::ServerFeeSummary::operator !=(NetworkOPsImp::ServerFeeSummary con
 
 void NetworkOPsImp::pubServer ()
 {
-    // VFALCO TODO Don't hold the lock across calls to send...make a copy of the
-    //             list into a local array while holding the lock then release the
-    //             lock and call send on everyone.
-    //
-    ScopedLockType sl (mSubLock);
-
-    if (!mStreamMaps[sServer].empty ())
+    std::vector<InfoSub::pointer> subs;
+    Json::Value jvObj (Json::objectValue);
     {
-        Json::Value jvObj (Json::objectValue);
+        ScopedLockType sl (mSubLock);
+
+        collectSubscribers (mStreamMaps[sServer], subs);
+        if (subs.empty ())
+            return;
 
         ServerFeeSummary f{app_.openLedger().current()->fees().base,
             app_.getTxQ().getMetrics(*app_.openLedger().current()),
@@ -1721,35 +1789,21 @@ void NetworkOPsImp::pubServer ()
             jvObj [jss::load_factor] = f.loadFactorServer;
 
         mLastFeeSummary = f;
-
-        for (auto i = mStreamMaps[sServer].begin ();
-            i != mStreamMaps[sServer].end (); )
-        {
-            InfoSub::pointer p = i->second.lock ();
-
-            // VFALCO TODO research the possibility of using thread queues and
-            //             linearizing the deletion of subscribers with the
-            //             sending of JSON data.
-            if (p)
-            {
-                p->send (jvObj, true);
-                ++i;
-            }
-            else
-            {
-                i = mStreamMaps[sServer].erase (i);
-            }
-        }
     }
+
+    sendToAll (subs, jvObj);
 }
 
 
 void NetworkOPsImp::pubValidation (STValidation::ref val)
 {
-    // VFALCO consider std::shared_mutex
-    ScopedLockType sl (mSubLock);
+    std::vector<InfoSub::pointer> subs;
+    {
+        ScopedLockType sl (mSubLock);
+        collectSubscribers (mStreamMaps[sValidations], subs);
+    }
 
-    if (!mStreamMaps[sValidations].empty ())
+    if (!subs.empty ())
     {
         Json::Value jvObj (Json::objectValue);
 
@@ -1788,48 +1842,26 @@ void NetworkOPsImp::pubValidation (STValidation::ref val)
         if (auto const reserveInc = (*val)[~sfReserveIncrement])
             jvObj [jss::reserve_inc] = *reserveInc;
 
-        for (auto i = mStreamMaps[sValidations].begin ();
-            i != mStreamMaps[sValidations].end (); )
-        {
-            if (auto p = i->second.lock())
-            {
-                p->send (jvObj, true);
-                ++i;
-            }
-            else
-            {
-                i = mStreamMaps[sValidations].erase (i);
-            }
-        }
+        sendToAll (subs, jvObj);
     }
 }
 
 void NetworkOPsImp::pubPeerStatus (
     std::function<Json::Value(void)> const& func)
 {
-    ScopedLockType sl (mSubLock);
+    std::vector<InfoSub::pointer> subs;
+    {
+        ScopedLockType sl (mSubLock);
+        collectSubscribers (mStreamMaps[sPeerStatus], subs);
+    }
 
-    if (!mStreamMaps[sPeerStatus].empty ())
+    if (!subs.empty ())
     {
         Json::Value jvObj (func());
 
         jvObj [jss::type]                  = "peerStatusChange";
 
-        for (auto i = mStreamMaps[sPeerStatus].begin ();
-            i != mStreamMaps[sPeerStatus].end (); )
-        {
-            InfoSub::pointer p = i->second.lock ();
-
-            if (p)
-            {
-                p->send (jvObj, true);
-                ++i;
-            }
-            else
-            {
-                i = mStreamMaps[sPeerStatus].erase (i);
-            }
-        }
+        sendToAll (subs, jvObj);
     }
 }
 
@@ -1861,12 +1893,10 @@ void NetworkOPsImp::setMode (OperatingMode om)
 }
 
 
-std::string
-NetworkOPsImp::transactionsSQL (
-    std::string selection, AccountID const& account,
-    std::int32_t minLedger, std::int32_t maxLedger, bool descending,
-    std::uint32_t offset, int limit,
-    bool binary, bool count, bool bUnlimited)
+// The number of transactions an offset based account_tx query returns
+static
+std::uint32_t
+accountTxResults (int limit, bool binary, bool count, bool bUnlimited)
 {
     std::uint32_t NONBINARY_PAGE_LENGTH = 200;
     std::uint32_t BINARY_PAGE_LENGTH = 500;
@@ -1892,6 +1922,19 @@ NetworkOPsImp::transactionsSQL (
         numberOfResults = limit;
     }
 
+    return numberOfResults;
+}
+
+std::string
+NetworkOPsImp::transactionsSQL (
+    std::string selection, AccountID const& account,
+    std::int32_t minLedger, std::int32_t maxLedger, bool descending,
+    std::uint32_t offset, int limit,
+    bool binary, bool count, bool bUnlimited)
+{
+    std::uint32_t const numberOfResults =
+        accountTxResults (limit, binary, count, bUnlimited);
+
     std::string maxClause = "";
     std::string minClause = "";
 
@@ -1945,6 +1988,41 @@ NetworkOPsImp::transactionsSQL (
     return sql;
 }
 
+void
+NetworkOPsImp::indexedTransactions (
+    AccountTxIndex const& index, AccountID const& account,
+    std::int32_t minLedger, std::int32_t maxLedger, bool descending,
+    std::uint32_t offset, int limit, bool binary, bool bUnlimited,
+    std::function<void (std::uint32_t, std::string const&,
+        Blob const&, Blob const&)> const& f)
+{
+    // Like the LIMIT of the SQL query: the offset entries are skipped
+    // in the index and at most a page of transactions is loaded.
+    auto const maxVisited =
+        accountTxResults (limit, binary, false, bUnlimited);
+    std::uint32_t visited = 0;
+
+    // -1 leaves that end of the ledger range open
+    auto const maxSeq = std::numeric_limits<std::uint32_t>::max ();
+    AccountTxIndex::Position const first (
+        minLedger == -1 ? 0 : minLedger, 0);
+    AccountTxIndex::Position const last (
+        maxLedger == -1 ? maxSeq : maxLedger, maxSeq);
+
+    forEachAccountTx (index, app_.getTxnDB (), account,
+        first, last, !descending, offset,
+        [&](std::uint32_t ledgerSeq, std::uint32_t,
+            std::string const& status, Blob const& rawTxn,
+            Blob const& rawMeta)
+        {
+            if (++visited > maxVisited)
+                return false;
+
+            f (ledgerSeq, status, rawTxn, rawMeta);
+            return visited != maxVisited;
+        });
+}
+
 NetworkOPs::AccountTxs NetworkOPsImp::getAccountTxs (
     AccountID const& account,
     std::int32_t minLedger, std::int32_t maxLedger, bool descending,
@@ -1953,6 +2031,23 @@ NetworkOPs::AccountTxs NetworkOPsImp::getAccountTxs (
     // can be called with no locks
     AccountTxs ret;
 
+    if (auto const index = app_.getAccountTxIndex ())
+    {
+        indexedTransactions (*index, account, minLedger, maxLedger,
+            descending, offset, limit, false, bUnlimited,
+            [&](std::uint32_t ledgerSeq, std::string const& status,
+                Blob const& rawTxn, Blob const& txnMeta)
+            {
+                // Work around a bug that could leave the metadata missing
+                if (txnMeta.empty ())
+                    saveLedgerAsync (app_, ledgerSeq);
+
+                convertBlobsToTxResult (
+                    ret, ledgerSeq, status, rawTxn, txnMeta, app_);
+            });
+        return ret;
+    }
+
     std::string sql = transactionsSQL (
         "AccountTransactions.LedgerSeq,Status,RawTxn,TxnMeta", account,
         minLedger, maxLedger, descending, offset, limit, false, false,
@@ -2021,6 +2116,19 @@ std::vector<NetworkOPsImp::txnMetaLedgerType> NetworkOPsImp::getAccountTxsB (
     // can be called with no locks
     std::vector<txnMetaLedgerType> ret;
 
+    if (auto const index = app_.getAccountTxIndex ())
+    {
+        indexedTransactions (*index, account, minLedger, maxLedger,
+            descending, offset, limit, true/*binary*/, bUnlimited,
+            [&ret](std::uint32_t ledgerSeq, std::string const&,
+                Blob const& rawTxn, Blob const& txnMeta)
+            {
+                ret.emplace_back (
+                    strHex (rawTxn), strHex (txnMeta), ledgerSeq);
+            });
+        return ret;
+    }
+
     std::string sql = transactionsSQL (
         "AccountTransactions.LedgerSeq,Status,RawTxn,TxnMeta", account,
         minLedger, maxLedger, descending, offset, limit, true/*binary*/, false,
@@ -2083,11 +2191,18 @@ NetworkOPsImp::getTxsAccount (
             ret, ledger_index, status, rawTxn, rawMeta, app);
     };
 
-    accountTxPage(app_.getTxnDB (), app_.accountIDCache(),
-        std::bind(saveLedgerAsync, std::ref(app_),
-            std::placeholders::_1), bound, account, minLedger,
-                maxLedger, forward, token, limit, bUnlimited,
-                    page_length);
+    if (auto const index = app_.getAccountTxIndex ())
+        accountTxPage(*index, app_.getTxnDB (),
+            std::bind(saveLedgerAsync, std::ref(app_),
+                std::placeholders::_1), bound, account, minLedger,
+                    maxLedger, forward, token, limit, bUnlimited,
+                        page_length);
+    else
+        accountTxPage(app_.getTxnDB (), app_.accountIDCache(),
+            std::bind(saveLedgerAsync, std::ref(app_),
+                std::placeholders::_1), bound, account, minLedger,
+                    maxLedger, forward, token, limit, bUnlimited,
+                        page_length);
 
     return ret;
 }
@@ -2111,11 +2226,18 @@ NetworkOPsImp::getTxsAccountB (
         ret.emplace_back (strHex(rawTxn), strHex (rawMeta), ledgerIndex);
     };
 
-    accountTxPage(app_.getTxnDB (), app_.accountIDCache(),
-        std::bind(saveLedgerAsync, std::ref(app_),
-            std::placeholders::_1), bound, account, minLedger,
-                maxLedger, forward, token, limit, bUnlimited,
-                    page_length);
+    if (auto const index = app_.getAccountTxIndex ())
+        accountTxPage(*index, app_.getTxnDB (),
+            std::bind(saveLedgerAsync, std::ref(app_),
+                std::placeholders::_1), bound, account, minLedger,
+                    maxLedger, forward, token, limit, bUnlimited,
+                        page_length);
+    else
+        accountTxPage(app_.getTxnDB (), app_.accountIDCache(),
+            std::bind(saveLedgerAsync, std::ref(app_),
+                std::placeholders::_1), bound, account, minLedger,
+                    maxLedger, forward, token, limit, bUnlimited,
+                        page_length);
     return ret;
 }
 
@@ -2176,6 +2298,10 @@ Json::Value NetworkOPsImp::getServerInfo (bool human, bool admin)
     }
     info[jss::io_latency_ms] = static_cast<Json::UInt> (
         app_.getIOLatency().count());
+    info[jss::peer_io_latency_ms] = static_cast<Json::UInt> (
+        app_.getIOLatency(IOPool::peer).count());
+    info[jss::client_io_latency_ms] = static_cast<Json::UInt> (
+        app_.getIOLatency(IOPool::client).count());
 
     if (admin)
     {
@@ -2198,6 +2324,9 @@ Json::Value NetworkOPsImp::getServerInfo (bool human, bool admin)
     info[jss::complete_ledgers] =
             app_.getLedgerMaster ().getCompleteLedgers ();
 
+    if (auto shards = app_.getShardStore ())
+        info[jss::complete_shards] = shards->getCompleteShards ();
+
     if (amendmentBlocked_)
         info[jss::amendment_blocked] = true;
 
@@ -2402,25 +2531,13 @@ void NetworkOPsImp::pubProposedTransaction (
 {
     Json::Value jvObj   = transJson (*stTxn, terResult, false, lpCurrent);
 
+    std::vector<InfoSub::pointer> subs;
     {
         ScopedLockType sl (mSubLock);
-
-        auto it = mStreamMaps[sRTTransactions].begin ();
-        while (it != mStreamMaps[sRTTransactions].end ())
-        {
-            InfoSub::pointer p = it->second.lock ();
-
-            if (p)
-            {
-                p->send (jvObj, true);
-                ++it;
-            }
-            else
-            {
-                it = mStreamMaps[sRTTransactions].erase (it);
-            }
-        }
+        collectSubscribers (mStreamMaps[sRTTransactions], subs);
     }
+    sendToAll (subs, jvObj);
+
     AcceptedLedgerTx alt (lpCurrent, stTxn, terResult,
         app_.accountIDCache(), app_.logs());
     JLOG(m_journal.trace()) << "pubProposed: " << alt.getJson ();
@@ -2443,53 +2560,161 @@ void NetworkOPsImp::pubLedger (
             lpAccepted->info().hash, alpAccepted);
     }
 
+    std::vector<InfoSub::pointer> subs;
     {
         ScopedLockType sl (mSubLock);
+        collectSubscribers (mStreamMaps[sLedger], subs);
+    }
 
-        if (!mStreamMaps[sLedger].empty ())
-        {
-            Json::Value jvObj (Json::objectValue);
+    if (!subs.empty ())
+    {
+        Json::Value jvObj (Json::objectValue);
 
-            jvObj[jss::type] = "ledgerClosed";
-            jvObj[jss::ledger_index] = lpAccepted->info().seq;
-            jvObj[jss::ledger_hash] = to_string (lpAccepted->info().hash);
-            jvObj[jss::ledger_time]
-                    = Json::Value::UInt (lpAccepted->info().closeTime.time_since_epoch().count());
+        jvObj[jss::type] = "ledgerClosed";
+        jvObj[jss::ledger_index] = lpAccepted->info().seq;
+        jvObj[jss::ledger_hash] = to_string (lpAccepted->info().hash);
+        jvObj[jss::ledger_time]
+                = Json::Value::UInt (lpAccepted->info().closeTime.time_since_epoch().count());
 	    jvObj[jss::Fee] = Json::Value::UInt(lpAccepted->info().fees.drops());
-            jvObj[jss::fee_ref]
-                    = Json::UInt (lpAccepted->fees().units);
-            jvObj[jss::fee_base] = Json::UInt (lpAccepted->fees().base);
-            jvObj[jss::reserve_base] = Json::UInt (lpAccepted->fees().accountReserve(0).drops());
-            jvObj[jss::reserve_inc] = Json::UInt (lpAccepted->fees().increment);
-            jvObj[jss::Fee] = Json::Value::UInt(lpAccepted->info().fees.drops());
-            jvObj[jss::txn_count] = Json::UInt (alpAccepted->getTxnCount ());
-
-            if (mMode >= omSYNCING)
-            {
-                jvObj[jss::validated_ledgers]
-                        = app_.getLedgerMaster ().getCompleteLedgers ();
-            }
+        jvObj[jss::fee_ref]
+                = Json::UInt (lpAccepted->fees().units);
+        jvObj[jss::fee_base] = Json::UInt (lpAccepted->fees().base);
+        jvObj[jss::reserve_base] = Json::UInt (lpAccepted->fees().accountReserve(0).drops());
+        jvObj[jss::reserve_inc] = Json::UInt (lpAccepted->fees().increment);
+        jvObj[jss::Fee] = Json::Value::UInt(lpAccepted->info().fees.drops());
+        jvObj[jss::txn_count] = Json::UInt (alpAccepted->getTxnCount ());
+
+        if (mMode >= omSYNCING)
+        {
+            jvObj[jss::validated_ledgers]
+                    = app_.getLedgerMaster ().getCompleteLedgers ();
+        }
+
+        sendToAll (subs, jvObj);
+    }
+
+    queueLedgerState (lpAccepted);
+
+    // Don't lock since pubAcceptedTransaction is locking.
+    for (auto const& vt : alpAccepted->getMap ())
+    {
+        JLOG(m_journal.trace()) << "pubAccepted: " << vt.second->getJson ();
+        pubValidatedTransaction (lpAccepted, *vt.second);
+    }
+}
 
-            auto it = mStreamMaps[sLedger].begin ();
-            while (it != mStreamMaps[sLedger].end ())
+void NetworkOPsImp::queueLedgerState (
+    std::shared_ptr<ReadView const> const& lpAccepted)
+{
+    {
+        ScopedLockType sl (mSubLock);
+        if (mStreamMaps[sLedgerState].empty () &&
+                mStreamMaps[sLedgerStateBinary].empty ())
+            return;
+    }
+
+    {
+        std::lock_guard <std::mutex> lock (mLedgerStateMutex);
+        mLedgerStates.push_back (lpAccepted);
+        if (mPublishingLedgerStates)
+            return;
+        mPublishingLedgerStates = true;
+    }
+
+    // Comparing the state maps can take a while for a large change, so
+    // it is kept off the thread publishing ledgers. One job at a time
+    // publishes the queued ledgers so events arrive in ledger order.
+    auto const added = m_job_queue.addJob (
+        jtCLIENT, "pubLedgerState",
+        [this] (Job&)
+        {
+            while (true)
             {
-                InfoSub::pointer p = it->second.lock ();
-                if (p)
+                std::shared_ptr<ReadView const> ledger;
                 {
-                    p->send (jvObj, true);
-                    ++it;
+                    std::lock_guard <std::mutex> lock (mLedgerStateMutex);
+                    if (mLedgerStates.empty ())
+                    {
+                        mPublishingLedgerStates = false;
+                        return;
+                    }
+                    ledger = std::move (mLedgerStates.front ());
+                    mLedgerStates.pop_front ();
                 }
-                else
-                    it = mStreamMaps[sLedger].erase (it);
+                pubLedgerState (ledger);
             }
+        });
+
+    if (! added)
+    {
+        std::lock_guard <std::mutex> lock (mLedgerStateMutex);
+        mLedgerStates.clear ();
+        mPublishingLedgerStates = false;
+    }
+}
+
+void NetworkOPsImp::pubLedgerState (
+    std::shared_ptr<ReadView const> const& lpAccepted)
+{
+    std::vector<InfoSub::pointer> subs;
+    std::vector<InfoSub::pointer> binarySubs;
+    {
+        ScopedLockType sl (mSubLock);
+        collectSubscribers (mStreamMaps[sLedgerState], subs);
+        collectSubscribers (mStreamMaps[sLedgerStateBinary], binarySubs);
+    }
+
+    if (subs.empty () && binarySubs.empty ())
+        return;
+
+    auto const& info = lpAccepted->info();
+
+    Json::Value jvObj (Json::objectValue);
+    jvObj[jss::type] = "ledgerState";
+    jvObj[jss::ledger_index] = info.seq;
+    jvObj[jss::ledger_hash] = to_string (info.hash);
+    jvObj[jss::parent_hash] = to_string (info.parentHash);
+
+    // Each event is the change from the parent ledger, so applying the
+    // events in order keeps a copy of the state current. If the change
+    // can't be computed the event is marked incomplete, and subscribers
+    // must read the state of that ledger to catch up.
+    boost::optional<StateDiff> diff;
+    if (auto const ledger = std::dynamic_pointer_cast<Ledger const> (
+            lpAccepted))
+    {
+        if (auto const parent =
+                m_ledgerMaster.getLedgerByHash (info.parentHash))
+        {
+            // Larger diffs are not published; subscribers read the
+            // state instead.
+            diff.emplace (*parent, *ledger, RPC::Tuning::maxStateDiff);
         }
     }
 
-    // Don't lock since pubAcceptedTransaction is locking.
-    for (auto const& vt : alpAccepted->getMap ())
+    if (! diff || ! diff->complete ())
     {
-        JLOG(m_journal.trace()) << "pubAccepted: " << vt.second->getJson ();
-        pubValidatedTransaction (lpAccepted, *vt.second);
+        JLOG(m_journal.warn()) <<
+            "pubLedgerState: no state diff for ledger " << info.seq;
+        jvObj[jss::complete] = false;
+        sendToAll (subs, jvObj);
+        sendToAll (binarySubs, jvObj);
+        return;
+    }
+
+    jvObj[jss::complete] = true;
+
+    if (! subs.empty ())
+    {
+        Json::Value jv (jvObj);
+        diff->addJson (jv, false);
+        sendToAll (subs, jv);
+    }
+
+    if (! binarySubs.empty ())
+    {
+        diff->addJson (jvObj, true);
+        sendToAll (binarySubs, jvObj);
     }
 }
 
@@ -2570,39 +2795,20 @@ void NetworkOPsImp::pubValidatedTransaction (
         *alTx.getTxn (), alTx.getResult (), true, alAccepted);
     jvObj[jss::meta] = alTx.getMeta ()->getJson (0);
 
+    std::vector<InfoSub::pointer> subs;
     {
         ScopedLockType sl (mSubLock);
+        collectSubscribers (mStreamMaps[sTransactions], subs);
+        collectSubscribers (mStreamMaps[sRTTransactions], subs);
+    }
 
-        auto it = mStreamMaps[sTransactions].begin ();
-        while (it != mStreamMaps[sTransactions].end ())
-        {
-            InfoSub::pointer p = it->second.lock ();
-
-            if (p)
-            {
-                p->send (jvObj, true);
-                ++it;
-            }
-            else
-                it = mStreamMaps[sTransactions].erase (it);
-        }
-
-        it = mStreamMaps[sRTTransactions].begin ();
-
-        while (it != mStreamMaps[sRTTransactions].end ())
-        {
-            InfoSub::pointer p = it->second.lock ();
+    // The book streams publish the same object, so all of them
+    // share one serialization.
+    InfoSub::Event const event (jvObj);
+    for (auto const& p : subs)
+        p->send (event, true);
 
-            if (p)
-            {
-                p->send (jvObj, true);
-                ++it;
-            }
-            else
-                it = mStreamMaps[sRTTransactions].erase (it);
-        }
-    }
-    app_.getOrderBookDB ().processTxn (alAccepted, alTx, jvObj);
+    app_.getOrderBookDB ().processTxn (alAccepted, alTx, event);
     pubAccountTransaction (alAccepted, alTx, true);
 }
 
@@ -2682,8 +2888,9 @@ void NetworkOPsImp::pubAccountTransaction (
         if (alTx.isApplied ())
             jvObj[jss::meta] = alTx.getMeta ()->getJson (0);
 
+        InfoSub::Event const event (jvObj);
         for (InfoSub::ref isrListener : notify)
-            isrListener->send (jvObj, true);
+            isrListener->send (event, true);
     }
 }
 
@@ -2839,6 +3046,26 @@ bool NetworkOPsImp::unsubLedger (std::uint64_t uSeq)
     return mStreamMaps[sLedger].erase (uSeq);
 }
 
+// <-- bool: true=added, false=already there
+bool NetworkOPsImp::subLedgerState (InfoSub::ref isrListener, bool binary)
+{
+    ScopedLockType sl (mSubLock);
+
+    // A subscriber gets one form of the stream, the last one asked for.
+    mStreamMaps[binary ? sLedgerState : sLedgerStateBinary].erase (
+        isrListener->getSeq ());
+    return mStreamMaps[binary ? sLedgerStateBinary : sLedgerState].emplace (
+        isrListener->getSeq (), isrListener).second;
+}
+
+// <-- bool: true=erased, false=was not there
+bool NetworkOPsImp::unsubLedgerState (std::uint64_t uSeq)
+{
+    ScopedLockType sl (mSubLock);
+    auto const erased = mStreamMaps[sLedgerState].erase (uSeq);
+    return mStreamMaps[sLedgerStateBinary].erase (uSeq) || erased;
+}
+
 // <-- bool: true=added, false=already there
 bool NetworkOPsImp::subManifests (InfoSub::ref isrListener)
 {
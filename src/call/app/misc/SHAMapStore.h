@@ -57,6 +57,7 @@ public:
         bool standalone = false;
         std::uint32_t deleteInterval = 0;
         bool advisoryDelete = false;
+        bool generational = false;
         std::uint32_t ledgerHistory = 0;
         Section nodeDatabase;
         std::string databasePath;
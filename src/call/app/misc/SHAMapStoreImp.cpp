@@ -36,6 +36,7 @@
 
 #include <call/app/misc/SHAMapStoreImp.h>
 #include <call/app/ledger/TransactionMaster.h>
+#include <call/app/misc/AccountTxIndex.h>
 #include <call/app/misc/NetworkOPs.h>
 #include <call/core/ConfigSections.h>
 #include <call/beast/core/CurrentThreadName.h>
@@ -212,7 +213,10 @@ SHAMapStoreImp::SHAMapStoreImp (
 
         state_db_.init (config, dbName_);
 
-        dbPaths();
+        // The generational node store lives directly in the configured
+        // path rather than in rotating subdirectories.
+        if (! setup_.generational)
+            dbPaths();
     }
 }
 
@@ -222,7 +226,29 @@ SHAMapStoreImp::makeDatabase (std::string const& name,
 {
     std::unique_ptr <NodeStore::Database> db;
 
-    if (setup_.deleteInterval)
+    if (setup_.deleteInterval && setup_.generational)
+    {
+        Section parameters = setup_.nodeDatabase;
+        parameters.set ("generational", "1");
+
+        auto backend = NodeStore::Manager::instance().make_Backend (
+            parameters, scheduler_, nodeStoreJournal_);
+
+        generational_ = dynamic_cast <NodeStore::GenerationalBackend*> (
+            backend.get());
+        if (! generational_)
+        {
+            Throw<std::runtime_error> (
+                "online_delete_mode=generational requires the RocksDB "
+                "node database");
+        }
+        generational_->setGeneration (generational_->getTracked() + 1);
+
+        db = NodeStore::Manager::instance().make_Database (name, scheduler_,
+            readThreads, parent, std::move (backend), nodeStoreJournal_);
+        fdlimit_ = db->fdlimit();
+    }
+    else if (setup_.deleteInterval)
     {
         SavedState state = state_db_.getState();
 
@@ -303,6 +329,103 @@ SHAMapStoreImp::copyNode (std::uint64_t& nodeCount,
     return false;
 }
 
+bool
+SHAMapStoreImp::trackChanges (std::shared_ptr<Ledger const> const& prior,
+    Ledger const& ledger)
+{
+    LedgerIndex const seq = ledger.info().seq;
+
+    std::vector<uint256> born;
+    std::vector<uint256> died;
+    std::vector<uint256> referenced;
+
+    auto collect = [](std::vector<uint256>& hashes)
+    {
+        return [&hashes](SHAMapAbstractNode& node)
+        {
+            hashes.push_back (node.getNodeHash().as_uint256());
+            return true;
+        };
+    };
+
+    try
+    {
+        if (prior)
+        {
+            // Only the paths that changed are visited, so this costs
+            // about as much as the ledger's own writes did.
+            ledger.stateMap().visitDifferences (
+                &prior->stateMap(), collect (born));
+            prior->stateMap().visitDifferences (
+                &ledger.stateMap(), collect (died));
+        }
+        else
+        {
+            // Without a baseline every node of this ledger is new
+            ledger.stateMap().visitDifferences (nullptr, collect (born));
+        }
+
+        // The header and transaction tree were stored while the ledger
+        // was built, before it was validated, so under an older generation
+        referenced.push_back (ledger.info().hash);
+        ledger.txMap().visitDifferences (nullptr, collect (referenced));
+    }
+    catch (SHAMapMissingNode const& e)
+    {
+        JLOG(journal_.warn()) << "unable to track ledger " << seq <<
+            ": " << e;
+        return false;
+    }
+
+    generational_->recordChanges (seq, born, died, referenced);
+    JLOG(journal_.trace()) << "tracked ledger " << seq << " born " <<
+        born.size() << " died " << died.size();
+    return true;
+}
+
+void
+SHAMapStoreImp::trackLedger (std::shared_ptr<Ledger const> const& ledger)
+{
+    LedgerIndex const seq = ledger->info().seq;
+
+    // Anything stored from now on belongs to a ledger after this one
+    generational_->setGeneration (seq + 1);
+
+    LedgerIndex const tracked = generational_->getTracked();
+    if (seq <= tracked)
+        return;
+
+    std::shared_ptr<Ledger const> prior;
+    if (tracked)
+    {
+        prior = ledgerMaster_->getLedgerBySeq (tracked);
+        if (! prior)
+        {
+            JLOG(journal_.warn()) << "tracked ledger " << tracked <<
+                " is not available; nodes only it referenced will not"
+                " be reclaimed";
+        }
+    }
+
+    // Ledgers validated in between are tracked too: nodes only they
+    // hold are protected, and their headers and transactions retagged.
+    // After a long gap the intermediate ledgers are not worth looking up.
+    LedgerIndex next = seq;
+    if (prior && (seq - tracked <= setup_.deleteInterval))
+        next = tracked + 1;
+
+    for (; next < seq; ++next)
+    {
+        if (auto const between = ledgerMaster_->getLedgerBySeq (next))
+        {
+            if (trackChanges (prior, *between))
+                prior = between;
+        }
+    }
+
+    trackChanges (prior, *ledger);
+}
+
 void
 SHAMapStoreImp::run()
 {
@@ -348,6 +471,9 @@ SHAMapStoreImp::run()
             state_db_.setLastRotated (lastRotated);
         }
 
+        if (generational_)
+            trackLedger (validatedLedger);
+
         // will delete up to (not including) lastRotated)
         if (validatedSeq >= lastRotated + setup_.deleteInterval
                 && canDelete_ >= lastRotated - 1)
@@ -381,6 +507,33 @@ SHAMapStoreImp::run()
                     ;
             }
 
+            if (generational_)
+            {
+                // Nothing live is copied: objects that no retained ledger
+                // can reach are erased where they are.
+                auto const erased = generational_->erase (lastRotated,
+                    [this] { return health() != Health::ok; });
+                JLOG(journal_.debug()) << "erased " << erased <<
+                    " nodes before ledger " << lastRotated;
+                switch (health())
+                {
+                    case Health::stopping:
+                        stopped();
+                        return;
+                    case Health::unhealthy:
+                        continue;
+                    case Health::ok:
+                    default:
+                        ;
+                }
+
+                clearCaches (validatedSeq);
+                lastRotated = validatedSeq;
+                state_db_.setLastRotated (lastRotated);
+                JLOG(journal_.debug()) << "finished rotation " << validatedSeq;
+                continue;
+            }
+
             std::uint64_t nodeCount = 0;
             validatedLedger->stateMap().snapShot (
                     false)->visitNodes (
@@ -745,6 +898,9 @@ SHAMapStoreImp::clearPrior (LedgerIndex lastRotated)
         "DELETE FROM AccountTransactions WHERE LedgerSeq < %u;");
     if (health())
         return;
+
+    if (auto const index = app_.getAccountTxIndex ())
+        index->deleteBefore (lastRotated);
 }
 
 SHAMapStoreImp::Health
@@ -831,8 +987,20 @@ setup_SHAMapStore (Config const& c)
     get_if_exists (setup.nodeDatabase, "online_delete", setup.deleteInterval);
 
     if (setup.deleteInterval)
+    {
         get_if_exists (setup.nodeDatabase, "advisory_delete", setup.advisoryDelete);
 
+        std::string mode;
+        if (get_if_exists (setup.nodeDatabase, "online_delete_mode", mode))
+        {
+            if (mode == "generational")
+                setup.generational = true;
+            else if (mode != "rotate")
+                Throw<std::runtime_error> (
+                    "online_delete_mode must be 'rotate' or 'generational'");
+        }
+    }
+
     setup.ledgerHistory = c.LEDGER_HISTORY;
     setup.databasePath = c.legacy("database_path");
 
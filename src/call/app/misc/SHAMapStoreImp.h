@@ -39,6 +39,7 @@
 #include <call/app/ledger/LedgerMaster.h>
 #include <call/core/DatabaseCon.h>
 #include <call/nodestore/DatabaseRotating.h>
+#include <call/nodestore/GenerationalBackend.h>
 #include <condition_variable>
 #include <thread>
 
@@ -103,6 +104,8 @@ private:
     beast::Journal journal_;
     beast::Journal nodeStoreJournal_;
     NodeStore::DatabaseRotating* database_ = nullptr;
+    // set instead of database_ when online_delete_mode=generational
+    NodeStore::GenerationalBackend* generational_ = nullptr;
     SavedStateDB state_db_;
     std::thread thread_;
     bool stop_ = false;
@@ -190,6 +193,10 @@ private:
     // callback for visitNodes
     bool copyNode (std::uint64_t& nodeCount, SHAMapAbstractNode const &node);
     void run();
+    // record which state nodes the validated ledger added and removed
+    void trackLedger (std::shared_ptr<Ledger const> const& ledger);
+    bool trackChanges (std::shared_ptr<Ledger const> const& prior,
+        Ledger const& ledger);
     void dbPaths();
     std::shared_ptr <NodeStore::Backend> makeBackendRotating (
             std::string path = std::string());
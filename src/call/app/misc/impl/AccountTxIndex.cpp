@@ -0,0 +1,421 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of calld: https://github.com/callchain/calld
+    Copyright (c) 2018, 2019 Callchain Fundation.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <call/app/misc/AccountTxIndex.h>
+#include <call/basics/Log.h>
+#include <call/basics/contract.h>
+#include <call/unity/rocksdb.h>
+#include <boost/algorithm/string/predicate.hpp>
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <tuple>
+
+namespace call {
+
+namespace {
+
+/** Keeps the index in memory. Used by the unit tests. */
+class MemoryAccountTxIndex : public AccountTxIndex
+{
+    using Key = std::tuple<AccountID, std::uint32_t, std::uint32_t>;
+
+    std::mutex mutable mutex_;
+    std::map<Key, uint256> byAccount_;
+    std::map<std::uint32_t, std::vector<Key>> byLedger_;
+
+public:
+    std::string
+    getName () const override
+    {
+        return "memory";
+    }
+
+    void
+    saveLedger (std::uint32_t ledgerSeq,
+        std::vector<Entry> const& entries) override
+    {
+        std::lock_guard<std::mutex> lock (mutex_);
+
+        auto& keys = byLedger_[ledgerSeq];
+        for (auto const& key : keys)
+            byAccount_.erase (key);
+        keys.clear ();
+
+        for (auto const& e : entries)
+        {
+            Key key (e.account, ledgerSeq, e.txnSeq);
+            byAccount_[key] = e.txID;
+            keys.push_back (key);
+        }
+    }
+
+    void
+    deleteBefore (std::uint32_t ledgerSeq) override
+    {
+        std::lock_guard<std::mutex> lock (mutex_);
+
+        auto const end = byLedger_.lower_bound (ledgerSeq);
+        for (auto it = byLedger_.begin (); it != end; ++it)
+        {
+            for (auto const& key : it->second)
+                byAccount_.erase (key);
+        }
+        byLedger_.erase (byLedger_.begin (), end);
+    }
+
+    void
+    forEach (AccountID const& account, Position const& first,
+        Position const& last, bool forward,
+        std::function<bool (Entry const&)> const& f) const override
+    {
+        std::vector<Entry> entries;
+        {
+            std::lock_guard<std::mutex> lock (mutex_);
+
+            auto const begin = byAccount_.lower_bound (
+                Key (account, first.first, first.second));
+            auto const end = byAccount_.upper_bound (
+                Key (account, last.first, last.second));
+            for (auto it = begin; it != end; ++it)
+                entries.push_back ({account, std::get<1> (it->first),
+                    std::get<2> (it->first), it->second});
+        }
+
+        if (! forward)
+            std::reverse (entries.begin (), entries.end ());
+
+        for (auto const& e : entries)
+        {
+            if (! f (e))
+                break;
+        }
+    }
+};
+
+//------------------------------------------------------------------------------
+
+#if CALL_ROCKSDB_AVAILABLE
+
+/** Keeps the index in RocksDB.
+
+    Two kinds of key are written for each entry:
+
+        'A' account ledgerSeq txnSeq  ->  transaction ID
+        'L' ledgerSeq account txnSeq  ->  (empty)
+
+    Integers are stored big-endian so that the byte order of the keys
+    is the order of the entries. The first kind serves the queries;
+    the second finds the entries of a ledger when it is replaced or
+    deleted.
+*/
+class RocksDBAccountTxIndex : public AccountTxIndex
+{
+    static char constexpr accountPrefix = 'A';
+    static char constexpr ledgerPrefix = 'L';
+
+    // prefix + account + ledgerSeq + txnSeq
+    static std::size_t constexpr keyBytes = 1 + 20 + 4 + 4;
+
+    beast::Journal j_;
+    std::string path_;
+    std::unique_ptr<rocksdb::DB> db_;
+
+    // Serializes writers, so saveLedger and deleteBefore never
+    // see each other's half-built batches.
+    std::mutex writeMutex_;
+
+    static
+    void
+    putInt (std::string& s, std::uint32_t v)
+    {
+        s.push_back (static_cast<char> (v >> 24));
+        s.push_back (static_cast<char> (v >> 16));
+        s.push_back (static_cast<char> (v >> 8));
+        s.push_back (static_cast<char> (v));
+    }
+
+    static
+    std::uint32_t
+    getInt (char const* p)
+    {
+        auto const u = reinterpret_cast<unsigned char const*> (p);
+        return (std::uint32_t (u[0]) << 24) | (std::uint32_t (u[1]) << 16) |
+            (std::uint32_t (u[2]) << 8) | std::uint32_t (u[3]);
+    }
+
+    static
+    std::string
+    accountKey (AccountID const& account,
+        std::uint32_t ledgerSeq, std::uint32_t txnSeq)
+    {
+        std::string s;
+        s.reserve (keyBytes);
+        s.push_back (accountPrefix);
+        s.append (reinterpret_cast<char const*> (account.data ()),
+            account.size ());
+        putInt (s, ledgerSeq);
+        putInt (s, txnSeq);
+        return s;
+    }
+
+    static
+    std::string
+    ledgerKey (std::uint32_t ledgerSeq,
+        AccountID const& account, std::uint32_t txnSeq)
+    {
+        std::string s;
+        s.reserve (keyBytes);
+        s.push_back (ledgerPrefix);
+        putInt (s, ledgerSeq);
+        s.append (reinterpret_cast<char const*> (account.data ()),
+            account.size ());
+        putInt (s, txnSeq);
+        return s;
+    }
+
+    static
+    std::string
+    ledgerPrefixKey (std::uint32_t ledgerSeq)
+    {
+        std::string s;
+        s.push_back (ledgerPrefix);
+        putInt (s, ledgerSeq);
+        return s;
+    }
+
+    // Add deletions for both keys of the entry named by a ledger key
+    static
+    void
+    eraseEntry (rocksdb::WriteBatch& batch, rocksdb::Slice const& key)
+    {
+        AccountID account;
+        std::memcpy (account.data (), key.data () + 5, account.size ());
+        auto const ledgerSeq = getInt (key.data () + 1);
+        auto const txnSeq = getInt (key.data () + 25);
+
+        batch.Delete (accountKey (account, ledgerSeq, txnSeq));
+        batch.Delete (key);
+    }
+
+    void
+    write (rocksdb::WriteBatch& batch)
+    {
+        auto const status = db_->Write (rocksdb::WriteOptions (), &batch);
+        if (! status.ok ())
+            Throw<std::runtime_error> (
+                "AccountTxIndex write failed: " + status.ToString ());
+    }
+
+public:
+    RocksDBAccountTxIndex (Section const& section, beast::Journal journal)
+        : j_ (journal)
+    {
+        if (! get_if_exists (section, "path", path_))
+            Throw<std::runtime_error> (
+                "Missing path in [account_tx_index]");
+
+        rocksdb::Options options;
+        rocksdb::BlockBasedTableOptions table_options;
+        options.create_if_missing = true;
+
+        if (section.exists ("cache_mb"))
+            table_options.block_cache = rocksdb::NewLRUCache (
+                get<int>(section, "cache_mb") * 1024L * 1024L);
+
+        get_if_exists (section, "open_files", options.max_open_files);
+
+        options.table_factory.reset (
+            NewBlockBasedTableFactory (table_options));
+
+        rocksdb::DB* db = nullptr;
+        auto const status = rocksdb::DB::Open (options, path_, &db);
+        if (! status.ok () || ! db)
+            Throw<std::runtime_error> (
+                "Unable to open/create RocksDB: " + status.ToString ());
+
+        db_.reset (db);
+    }
+
+    std::string
+    getName () const override
+    {
+        return path_;
+    }
+
+    void
+    saveLedger (std::uint32_t ledgerSeq,
+        std::vector<Entry> const& entries) override
+    {
+        std::lock_guard<std::mutex> lock (writeMutex_);
+        rocksdb::WriteBatch batch;
+
+        // Drop whatever a previous save of this ledger left behind
+        {
+            auto const prefix = ledgerPrefixKey (ledgerSeq);
+            std::unique_ptr<rocksdb::Iterator> it (
+                db_->NewIterator (rocksdb::ReadOptions ()));
+            for (it->Seek (prefix); it->Valid () &&
+                it->key ().starts_with (prefix); it->Next ())
+            {
+                eraseEntry (batch, it->key ());
+            }
+        }
+
+        for (auto const& e : entries)
+        {
+            batch.Put (accountKey (e.account, ledgerSeq, e.txnSeq),
+                rocksdb::Slice (reinterpret_cast<char const*> (
+                    e.txID.data ()), e.txID.size ()));
+            batch.Put (ledgerKey (ledgerSeq, e.account, e.txnSeq),
+                rocksdb::Slice ());
+        }
+
+        write (batch);
+    }
+
+    void
+    deleteBefore (std::uint32_t ledgerSeq) override
+    {
+        // Delete in bounded batches so a large backlog does not
+        // build one enormous write.
+        static std::size_t constexpr batchEntries = 10000;
+
+        std::lock_guard<std::mutex> lock (writeMutex_);
+
+        auto const last = ledgerPrefixKey (ledgerSeq);
+        std::unique_ptr<rocksdb::Iterator> it (
+            db_->NewIterator (rocksdb::ReadOptions ()));
+
+        rocksdb::WriteBatch batch;
+        std::size_t count = 0;
+        for (it->Seek (std::string (1, ledgerPrefix)); it->Valid () &&
+            it->key ().compare (last) < 0; it->Next ())
+        {
+            eraseEntry (batch, it->key ());
+            if (++count == batchEntries)
+            {
+                write (batch);
+                batch.Clear ();
+                count = 0;
+            }
+        }
+
+        if (count != 0)
+            write (batch);
+
+        JLOG (j_.debug()) <<
+            "Deleted account transactions before ledger " << ledgerSeq;
+    }
+
+    void
+    forEach (AccountID const& account, Position const& first,
+        Position const& last, bool forward,
+        std::function<bool (Entry const&)> const& f) const override
+    {
+        auto const lo = accountKey (account, first.first, first.second);
+        auto const hi = accountKey (account, last.first, last.second);
+
+        std::unique_ptr<rocksdb::Iterator> it (
+            db_->NewIterator (rocksdb::ReadOptions ()));
+
+        auto visit = [&]()
+        {
+            auto const key = it->key ();
+            auto const value = it->value ();
+            if (key.size () != keyBytes || value.size () != uint256::bytes)
+                return true;
+
+            Entry e;
+            e.account = account;
+            e.ledgerSeq = getInt (key.data () + 21);
+            e.txnSeq = getInt (key.data () + 25);
+            std::memcpy (e.txID.data (), value.data (), value.size ());
+            return f (e);
+        };
+
+        if (forward)
+        {
+            for (it->Seek (lo); it->Valid () &&
+                it->key ().compare (hi) <= 0; it->Next ())
+            {
+                if (! visit ())
+                    break;
+            }
+        }
+        else
+        {
+            // Position on the last key not above `hi`
+            it->Seek (hi);
+            if (! it->Valid ())
+                it->SeekToLast ();
+            while (it->Valid () && it->key ().compare (hi) > 0)
+                it->Prev ();
+
+            for (; it->Valid () && it->key ().compare (lo) >= 0; it->Prev ())
+            {
+                if (! visit ())
+                    break;
+            }
+        }
+    }
+};
+
+#endif
+
+} // namespace
+
+std::unique_ptr<AccountTxIndex>
+make_AccountTxIndex (Section const& section, beast::Journal journal)
+{
+    std::string type;
+    if (! get_if_exists (section, "type", type) || type.empty ())
+        return nullptr;
+
+    if (boost::iequals (type, "memory"))
+        return std::make_unique<MemoryAccountTxIndex> ();
+
+#if CALL_ROCKSDB_AVAILABLE
+    if (boost::iequals (type, "rocksdb"))
+        return std::make_unique<RocksDBAccountTxIndex> (section, journal);
+#endif
+
+    Throw<std::runtime_error> (
+        "Unknown [account_tx_index] type '" + type + "'");
+    return nullptr;
+}
+
+} // call
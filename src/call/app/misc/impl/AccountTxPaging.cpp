@@ -36,6 +36,7 @@
 #include <call/app/ledger/LedgerToJson.h>
 #include <call/app/ledger/LedgerMaster.h>
 #include <call/app/main/Application.h>
+#include <call/app/misc/AccountTxIndex.h>
 #include <call/app/misc/Transaction.h>
 #include <call/app/misc/impl/AccountTxPaging.h>
 #include <call/protocol/Serializer.h>
@@ -76,59 +77,83 @@ saveLedgerAsync (Application& app, std::uint32_t seq)
         pendSaveValidated(app, l, false, false);
 }
 
-void
-accountTxPage (
-    DatabaseCon& connection,
-    AccountIDCache const& idCache,
-    std::function<void (std::uint32_t)> const& onUnsavedLedger,
-    std::function<void (std::uint32_t,
-                        std::string const&,
-                        Blob const&,
-                        Blob const&)> const& onTransaction,
-    AccountID const& account,
-    std::int32_t minLedger,
-    std::int32_t maxLedger,
-    bool forward,
+// Reads the page size and the marker of an account_tx request. Returns
+// false if the marker is malformed, in which case there is no page.
+static
+bool
+pageParameters (
     Json::Value& token,
     int limit,
     bool bAdmin,
-    std::uint32_t page_length)
+    std::uint32_t page_length,
+    bool& lookingForMarker,
+    std::uint32_t& numberOfResults,
+    std::uint32_t& findLedger,
+    std::uint32_t& findSeq)
 {
-    bool lookingForMarker =  !token.isNull() && token.isObject();
-
-    std::uint32_t numberOfResults;
+    lookingForMarker =  !token.isNull() && token.isObject();
 
     if (limit <= 0 || (limit > page_length && !bAdmin))
         numberOfResults = page_length;
     else
         numberOfResults = limit;
 
-    // As an account can have many thousands of transactions, there is a limit
-    // placed on the amount of transactions returned. If the limit is reached
-    // before the result set has been exhausted (we always query for one more
-    // than the limit), then we return an opaque marker that can be supplied in
-    // a subsequent query.
-    std::uint32_t queryLimit = numberOfResults + 1;
-    std::uint32_t findLedger = 0, findSeq = 0;
+    findLedger = 0;
+    findSeq = 0;
 
     if (lookingForMarker)
     {
         try
         {
             if (!token.isMember(jss::ledger) || !token.isMember(jss::seq))
-                return;
+                return false;
             findLedger = token[jss::ledger].asInt();
             findSeq = token[jss::seq].asInt();
         }
         catch (std::exception const&)
         {
-            return;
+            return false;
         }
     }
 
     // We're using the token reference both for passing inputs and outputs, so
     // we need to clear it in between.
     token = Json::nullValue;
+    return true;
+}
+
+void
+accountTxPage (
+    DatabaseCon& connection,
+    AccountIDCache const& idCache,
+    std::function<void (std::uint32_t)> const& onUnsavedLedger,
+    std::function<void (std::uint32_t,
+                        std::string const&,
+                        Blob const&,
+                        Blob const&)> const& onTransaction,
+    AccountID const& account,
+    std::int32_t minLedger,
+    std::int32_t maxLedger,
+    bool forward,
+    Json::Value& token,
+    int limit,
+    bool bAdmin,
+    std::uint32_t page_length)
+{
+    bool lookingForMarker;
+    std::uint32_t numberOfResults;
+    std::uint32_t findLedger, findSeq;
+
+    if (! pageParameters (token, limit, bAdmin, page_length,
+            lookingForMarker, numberOfResults, findLedger, findSeq))
+        return;
+
+    // As an account can have many thousands of transactions, there is a limit
+    // placed on the amount of transactions returned. If the limit is reached
+    // before the result set has been exhausted (we always query for one more
+    // than the limit), then we return an opaque marker that can be supplied in
+    // a subsequent query.
+    std::uint32_t queryLimit = numberOfResults + 1;
 
     static std::string const prefix (
         R"(SELECT AccountTransactions.LedgerSeq,AccountTransactions.TxnSeq,
@@ -277,4 +302,158 @@ accountTxPage (
     return;
 }
 
+void
+forEachAccountTx (
+    AccountTxIndex const& index,
+    DatabaseCon& connection,
+    AccountID const& account,
+    AccountTxIndex::Position const& first,
+    AccountTxIndex::Position const& last,
+    bool forward,
+    std::uint32_t skip,
+    std::function<bool (std::uint32_t,
+                        std::uint32_t,
+                        std::string const&,
+                        Blob const&,
+                        Blob const&)> const& f)
+{
+    auto db (connection.checkoutDb());
+
+    Blob rawData;
+    Blob rawMeta;
+
+    std::string txID;
+    boost::optional<std::uint64_t> ledgerSeq;
+    boost::optional<std::string> status;
+    soci::blob txnData (*db);
+    soci::blob txnMeta (*db);
+    soci::indicator dataPresent, metaPresent;
+
+    soci::statement st = (db->prepare <<
+        "SELECT LedgerSeq,Status,RawTxn,TxnMeta FROM Transactions "
+        "WHERE TransID = :txID;",
+        soci::into (ledgerSeq),
+        soci::into (status),
+        soci::into (txnData, dataPresent),
+        soci::into (txnMeta, metaPresent),
+        soci::use (txID));
+
+    index.forEach (account, first, last, forward,
+        [&](AccountTxIndex::Entry const& entry)
+        {
+            if (skip != 0)
+            {
+                --skip;
+                return true;
+            }
+
+            txID = to_string (entry.txID);
+            ledgerSeq.reset ();
+
+            // Entries are not removed when a transaction is saved again
+            // in a different ledger, so skip those that no longer match.
+            if (! st.execute (true) ||
+                    ledgerSeq.value_or (0) != entry.ledgerSeq)
+                return true;
+
+            if (dataPresent == soci::i_ok)
+                convert (txnData, rawData);
+            else
+                rawData.clear ();
+
+            if (metaPresent == soci::i_ok)
+                convert (txnMeta, rawMeta);
+            else
+                rawMeta.clear ();
+
+            return f (entry.ledgerSeq, entry.txnSeq,
+                status.value_or (""), rawData, rawMeta);
+        });
+}
+
+void
+accountTxPage (
+    AccountTxIndex const& index,
+    DatabaseCon& connection,
+    std::function<void (std::uint32_t)> const& onUnsavedLedger,
+    std::function<void (std::uint32_t,
+                        std::string const&,
+                        Blob const&,
+                        Blob const&)> const& onTransaction,
+    AccountID const& account,
+    std::int32_t minLedger,
+    std::int32_t maxLedger,
+    bool forward,
+    Json::Value& token,
+    int limit,
+    bool bAdmin,
+    std::uint32_t page_length)
+{
+    bool lookingForMarker;
+    std::uint32_t numberOfResults;
+    std::uint32_t findLedger, findSeq;
+
+    if (! pageParameters (token, limit, bAdmin, page_length,
+            lookingForMarker, numberOfResults, findLedger, findSeq))
+        return;
+
+    // The same range the SQL query above would select: the marker,
+    // when there is one, replaces the near end of the ledger range.
+    auto const maxSeq = std::numeric_limits<std::uint32_t>::max ();
+    AccountTxIndex::Position first (
+        static_cast<std::uint32_t> (std::max (minLedger, 0)), 0);
+    AccountTxIndex::Position last (
+        static_cast<std::uint32_t> (std::max (maxLedger, 0)), maxSeq);
+
+    if (findLedger != 0)
+    {
+        if (forward)
+            first = {findLedger, findSeq};
+        else
+            last = {findLedger, findSeq};
+    }
+
+    // Like the LIMIT of the SQL query: the marker, a page of results
+    // and the entry after them, which becomes the next marker.
+    auto const maxVisited = numberOfResults + 2;
+    std::uint32_t visited = 0;
+
+    forEachAccountTx (index, connection, account, first, last, forward, 0,
+        [&](std::uint32_t ledgerSeq, std::uint32_t txnSeq,
+            std::string const& status, Blob const& rawData,
+            Blob const& rawMeta)
+        {
+            if (++visited > maxVisited)
+                return false;
+
+            if (lookingForMarker)
+            {
+                // The range starts at the marker, so if the first entry
+                // is not the marker then the marker is stale or forged.
+                if (findLedger != ledgerSeq || findSeq != txnSeq)
+                    return false;
+                lookingForMarker = false;
+            }
+            else if (numberOfResults == 0)
+            {
+                token = Json::objectValue;
+                token[jss::ledger] = ledgerSeq;
+                token[jss::seq] = txnSeq;
+                return false;
+            }
+
+            if (!lookingForMarker)
+            {
+                // Work around a bug that could leave the metadata missing
+                if (rawMeta.size() == 0)
+                    onUnsavedLedger(ledgerSeq);
+
+                onTransaction(ledgerSeq, status, rawData, rawMeta);
+                --numberOfResults;
+            }
+
+            return true;
+        });
+}
+
 }
@@ -36,6 +36,7 @@
 #define CALL_APP_MISC_IMPL_ACCOUNTTXPAGING_H_INCLUDED
 
 #include <call/core/DatabaseCon.h>
+#include <call/app/misc/AccountTxIndex.h>
 #include <call/app/misc/NetworkOPs.h>
 #include <cstdint>
 #include <string>
@@ -76,6 +77,49 @@ accountTxPage (
     bool bAdmin,
     std::uint32_t pageLength);
 
+/** Visit an account's transactions in an AccountTxIndex.
+
+    Each transaction is loaded from the transaction database and passed
+    to `f` with its ledger and transaction sequence. The walk ends when
+    `f` returns false. The first `skip` entries are passed over without
+    being loaded.
+*/
+void
+forEachAccountTx (
+    AccountTxIndex const& index,
+    DatabaseCon& database,
+    AccountID const& account,
+    AccountTxIndex::Position const& first,
+    AccountTxIndex::Position const& last,
+    bool forward,
+    std::uint32_t skip,
+    std::function<bool (std::uint32_t,
+                        std::uint32_t,
+                        std::string const&,
+                        Blob const&,
+                        Blob const&)> const& f);
+
+/** Page through an account's history using an AccountTxIndex
+    instead of the AccountTransactions table.
+*/
+void
+accountTxPage (
+    AccountTxIndex const& index,
+    DatabaseCon& database,
+    std::function<void (std::uint32_t)> const& onUnsavedLedger,
+    std::function<void (std::uint32_t,
+                        std::string const&,
+                        Blob const&,
+                        Blob const&)> const&,
+    AccountID const& account,
+    std::int32_t minLedger,
+    std::int32_t maxLedger,
+    bool forward,
+    Json::Value& token,
+    int limit,
+    bool bAdmin,
+    std::uint32_t pageLength);
+
 }
 
 #endif
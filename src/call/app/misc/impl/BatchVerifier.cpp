@@ -0,0 +1,114 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of calld: https://github.com/callchain/calld
+    Copyright (c) 2018, 2019 Callchain Fundation.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <call/app/misc/BatchVerifier.h>
+#include <call/app/ledger/LedgerMaster.h>
+#include <call/app/main/Application.h>
+#include <call/app/misc/HashRouter.h>
+#include <call/app/tx/apply.h>
+#include <call/basics/Log.h>
+#include <call/core/JobQueue.h>
+#include <algorithm>
+#include <iterator>
+
+namespace call {
+
+BatchVerifier::BatchVerifier (Application& app, JobQueue& jobQueue,
+        beast::Journal journal)
+    : app_ (app)
+    , jobQueue_ (jobQueue)
+    , j_ (journal)
+{
+}
+
+void
+BatchVerifier::add (std::shared_ptr<STTx const> const& tx,
+    std::function<void()> then)
+{
+    if (publicKeyType (makeSlice (tx->getSigningPubKey ())) !=
+        KeyType::ed25519)
+    {
+        then ();
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock (mutex_);
+    pending_.emplace_back (tx, std::move (then));
+
+    if (! scheduled_)
+    {
+        scheduled_ = jobQueue_.addJob (
+            jtTRANSACTION, "verifyTransactions",
+            [this] (Job&) { verify (); });
+    }
+}
+
+void
+BatchVerifier::verify ()
+{
+    while (true)
+    {
+        std::vector<Entry> batch;
+        {
+            std::lock_guard<std::mutex> lock (mutex_);
+            if (pending_.empty ())
+            {
+                scheduled_ = false;
+                return;
+            }
+
+            auto const last = pending_.begin () +
+                std::min (pending_.size (), maxBatchSize);
+            batch.assign (std::make_move_iterator (pending_.begin ()),
+                std::make_move_iterator (last));
+            pending_.erase (pending_.begin (), last);
+        }
+
+        std::vector<std::shared_ptr<STTx const>> txs;
+        txs.reserve (batch.size ());
+        for (auto const& entry : batch)
+            txs.push_back (entry.first);
+
+        JLOG (j_.trace()) << "Verifying " << txs.size () << " signatures";
+
+        checkSignatures (app_.getHashRouter (), txs,
+            app_.getLedgerMaster ().getValidatedRules ());
+
+        for (auto& entry : batch)
+            entry.second ();
+    }
+}
+
+} // call
@@ -927,7 +927,8 @@ TxQ::apply(Application& app, OpenView& view,
                 }
 
                 // Create the test view from the current view
-                multiTxn->applyView.emplace(&view, flags);
+                multiTxn->applyView.emplace(
+                    &view, flags, view.applyArena());
                 multiTxn->openView.emplace(&*multiTxn->applyView);
 
                 auto const sleBump = multiTxn->applyView->peek(
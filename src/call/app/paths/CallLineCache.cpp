@@ -52,16 +52,23 @@ CallLineCache::getCallLines (AccountID const& accountID)
 {
     AccountKey key (accountID, hasher_ (accountID));
 
-    std::lock_guard <std::mutex> sl (mLock);
+    {
+        std::lock_guard <std::mutex> sl (mLock);
+
+        auto it = lines_.find (key);
+        if (it != lines_.end ())
+            return it->second;
+    }
 
-    auto it = lines_.emplace (key,
-        std::vector<CallState::pointer>());
+    // Path requests are updated from several threads at once, so the
+    // lines are read without holding the lock. If two threads race on
+    // the same account, the first result inserted wins; references to
+    // map values stay valid across rehashes.
+    auto items = getCallStateItems (accountID, *mLedger);
 
-    if (it.second)
-        it.first->second = getCallStateItems (
-            accountID, *mLedger);
+    std::lock_guard <std::mutex> sl (mLock);
 
-    return it.first->second;
+    return lines_.emplace (key, std::move (items)).first->second;
 }
 
 } // call
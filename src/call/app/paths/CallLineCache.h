@@ -45,7 +45,8 @@
 
 namespace call {
 
-// Used by Pathfinder
+// Used by Pathfinder. Shared by the jobs updating path requests, so
+// lookups may come from several threads.
 class CallLineCache
 {
 public:
@@ -49,24 +49,38 @@ CallState::makeItem (
     // VFALCO Does this ever happen in practice?
     if (! sle || sle->getType () != ltCALL_STATE)
         return {};
+    auto const key = sle->key();
     return std::make_shared<CallState>(
-        std::move(sle), accountID);
+        key, STObjectView(std::move(sle)), accountID);
+}
+
+CallState::pointer
+CallState::makeItem (
+    AccountID const& accountID,
+        uint256 const& key,
+            STObjectView const& sle)
+{
+    if (sle.getFieldU16 (sfLedgerEntryType) != ltCALL_STATE)
+        return {};
+    return std::make_shared<CallState>(
+        key, sle, accountID);
 }
 
 CallState::CallState (
-    std::shared_ptr<SLE const>&& sle,
-        AccountID const& viewAccount)
-    : sle_ (std::move(sle))
-    , mFlags (sle_->getFieldU32 (sfFlags))
-    , mLowLimit (sle_->getFieldAmount (sfLowLimit))
-    , mHighLimit (sle_->getFieldAmount (sfHighLimit))
+    uint256 const& key,
+        STObjectView const& sle,
+            AccountID const& viewAccount)
+    : key_ (key)
+    , mFlags (sle.getFieldU32 (sfFlags))
+    , mLowLimit (sle.getFieldAmount (sfLowLimit))
+    , mHighLimit (sle.getFieldAmount (sfHighLimit))
     , mLowID (mLowLimit.getIssuer ())
     , mHighID (mHighLimit.getIssuer ())
-    , lowQualityIn_ (sle_->getFieldU32 (sfLowQualityIn))
-    , lowQualityOut_ (sle_->getFieldU32 (sfLowQualityOut))
-    , highQualityIn_ (sle_->getFieldU32 (sfHighQualityIn))
-    , highQualityOut_ (sle_->getFieldU32 (sfHighQualityOut))
-    , mBalance (sle_->getFieldAmount (sfBalance))
+    , lowQualityIn_ (sle.getFieldU32 (sfLowQualityIn))
+    , lowQualityOut_ (sle.getFieldU32 (sfLowQualityOut))
+    , highQualityIn_ (sle.getFieldU32 (sfHighQualityIn))
+    , highQualityOut_ (sle.getFieldU32 (sfHighQualityOut))
+    , mBalance (sle.getFieldAmount (sfBalance))
 {
     mViewLowest = (mLowID == viewAccount);
 
@@ -87,14 +101,29 @@ getCallStateItems (AccountID const& accountID,
     ReadView const& view)
 {
     std::vector <CallState::pointer> items;
-    forEachItem(view, accountID,
-        [&items,&accountID](
-        std::shared_ptr<SLE const> const&sleCur)
+
+    // Only a handful of fields of each line are needed, so the
+    // directory and the lines are read without deserializing them.
+    auto const root = keylet::ownerDir(accountID);
+    auto pos = root;
+    for (;;)
+    {
+        auto const dir = view.readLazy(pos);
+        if (! dir)
+            break;
+        for (auto const& key : dir->getFieldV256(sfIndexes))
         {
-             auto ret = CallState::makeItem (accountID, sleCur);
-             if (ret)
-                items.push_back (ret);
-        });
+            if (auto const sle = view.readLazy(keylet::child(key)))
+            {
+                if (auto ret = CallState::makeItem (accountID, key, *sle))
+                    items.push_back (std::move(ret));
+            }
+        }
+        auto const next = dir->getFieldU64(sfIndexNext);
+        if (! next)
+            break;
+        pos = keylet::page(root, next);
+    }
 
     return items;
 }
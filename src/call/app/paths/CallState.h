@@ -39,6 +39,7 @@
 #include <call/protocol/Rate.h>
 #include <call/protocol/STAmount.h>
 #include <call/protocol/STLedgerEntry.h>
+#include <call/protocol/STObjectView.h>
 #include <cstdint>
 #include <memory> // <memory>
 
@@ -66,15 +67,21 @@ public:
         AccountID const& accountID,
         std::shared_ptr<SLE const> sle);
 
+    static CallState::pointer makeItem(
+        AccountID const& accountID,
+        uint256 const& key,
+        STObjectView const& sle);
+
     // Must be public, for make_shared
-    CallState (std::shared_ptr<SLE const>&& sle,
+    CallState (uint256 const& key,
+        STObjectView const& sle,
         AccountID const& viewAccount);
 
     /** Returns the state map key for the ledger entry. */
-    uint256
+    uint256 const&
     key() const
     {
-        return sle_->key();
+        return key_;
     }
 
     // VFALCO Take off the "get" from each function name
@@ -152,17 +159,17 @@ public:
     Json::Value getJson (int);
 
 private:
-    std::shared_ptr<SLE const> sle_;
+    uint256                         key_;
 
     bool                            mViewLowest;
 
     std::uint32_t                   mFlags;
 
-    STAmount const&                 mLowLimit;
-    STAmount const&                 mHighLimit;
+    STAmount                        mLowLimit;
+    STAmount                        mHighLimit;
 
-    AccountID const&                  mLowID;
-    AccountID const&                  mHighID;
+    AccountID                       mLowID;
+    AccountID                       mHighID;
 
     Rate lowQualityIn_;
     Rate lowQualityOut_;
@@ -135,6 +135,12 @@ bool PathRequest::isNew ()
     return mLastIndex == 0;
 }
 
+LedgerIndex PathRequest::lastIndex ()
+{
+    ScopedLockType sl (mIndexLock);
+    return mLastIndex;
+}
+
 bool PathRequest::needsUpdate (bool newOnly, LedgerIndex index)
 {
     ScopedLockType sl (mIndexLock);
@@ -97,6 +97,9 @@ public:
     ~PathRequest ();
 
     bool isNew ();
+
+    /** The ledger this request was last updated for, or zero. */
+    LedgerIndex lastIndex ();
     bool needsUpdate (bool newOnly, LedgerIndex index);
 
     // Called when the PathRequest update is complete.
@@ -43,6 +43,9 @@
 #include <call/protocol/JsonFields.h>
 #include <call/resource/Fees.h>
 #include <algorithm>
+#include <condition_variable>
+#include <exception>
+#include <thread>
 
 namespace call {
 
@@ -69,6 +72,231 @@ PathRequests::getLineCache (
     return mLineCache;
 }
 
+namespace {
+
+// One pass over the path requests, shared by the jobs working on it.
+struct UpdatePass
+{
+    UpdatePass (Application& app_,
+            std::shared_ptr<CallLineCache> cache_,
+            std::vector<PathRequest::wptr> requests_,
+            Job::CancelCallback shouldCancel_,
+            bool newRequests_)
+        : app (app_)
+        , cache (std::move (cache_))
+        , requests (std::move (requests_))
+        , shouldCancel (std::move (shouldCancel_))
+        , newRequests (newRequests_)
+    {
+    }
+
+    Application& app;
+    std::shared_ptr<CallLineCache> const cache;
+
+    // Ordered so the requests due soonest are taken first
+    std::vector<PathRequest::wptr> const requests;
+    Job::CancelCallback const shouldCancel;
+    bool const newRequests;
+
+    std::atomic<std::size_t> next {0};
+    std::atomic<int> processed {0};
+    std::atomic<bool> mustBreak {false};
+    std::atomic<bool> failed {false};
+
+    std::mutex mutex;
+    std::condition_variable cond;
+    int active = 0;
+    bool done = false;
+
+    // First exception thrown by a worker, rethrown by the coordinator
+    std::exception_ptr error;
+
+    // Requests to drop from the list once the pass completes
+    std::vector<PathRequest::pointer> remove;
+    bool removeDead = false;
+};
+
+void
+runRequests (UpdatePass& pass)
+{
+    auto const seq = pass.cache->getLedger()->seq();
+
+    while (! pass.mustBreak && ! pass.failed && ! pass.shouldCancel ())
+    {
+        auto const i = pass.next++;
+        if (i >= pass.requests.size())
+            break;
+
+        auto request = pass.requests[i].lock ();
+        bool remove = true;
+
+        if (request)
+        {
+            if (!request->needsUpdate (pass.newRequests, seq))
+                remove = false;
+            else
+            {
+                if (auto ipSub = request->getSubscriber ())
+                {
+                    if (!ipSub->getConsumer ().warn ())
+                    {
+                        Json::Value update =
+                            request->doUpdate (pass.cache, false);
+                        request->updateComplete ();
+                        update[jss::type] = "path_find";
+                        ipSub->send (update, false);
+                        remove = false;
+                        ++pass.processed;
+                    }
+                }
+                else if (request->hasCompletion ())
+                {
+                    // One-shot request with completion function
+                    request->doUpdate (pass.cache, false);
+                    request->updateComplete();
+                    ++pass.processed;
+                }
+            }
+        }
+
+        if (remove)
+        {
+            std::lock_guard<std::mutex> lock (pass.mutex);
+            if (request)
+                pass.remove.push_back (std::move (request));
+            else
+                pass.removeDead = true;
+        }
+
+        // We weren't handling new requests and then
+        // there was a new request
+        if (!pass.newRequests &&
+            pass.app.getLedgerMaster().isNewPathRequest())
+        {
+            pass.mustBreak = true;
+        }
+    }
+}
+
+void
+runPass (UpdatePass& pass)
+{
+    try
+    {
+        runRequests (pass);
+    }
+    catch (...)
+    {
+        std::lock_guard<std::mutex> lock (pass.mutex);
+        if (! pass.error)
+            pass.error = std::current_exception ();
+        pass.failed = true;
+    }
+}
+
+} // anonymous namespace
+
+std::size_t
+PathRequests::maxWorkers () const
+{
+    if (auto const workers = maxWorkers_.load ())
+        return workers;
+
+    // Leave half the cores for transactions and consensus
+    return std::max (1u, std::thread::hardware_concurrency () / 2);
+}
+
+int
+PathRequests::runUpdatePass (
+    std::vector<PathRequest::wptr> requests,
+    std::shared_ptr<CallLineCache> const& cache,
+    Job::CancelCallback const& shouldCancel,
+    bool newRequests,
+    bool& mustBreak,
+    int& removed)
+{
+    // Requests that have never been served come first, then the ones
+    // with the oldest results.
+    {
+        std::vector<std::pair<LedgerIndex, PathRequest::wptr>> keyed;
+        keyed.reserve (requests.size());
+        for (auto& wr : requests)
+        {
+            auto r = wr.lock();
+            keyed.emplace_back (r ? r->lastIndex () : 0, std::move (wr));
+        }
+        std::stable_sort (keyed.begin(), keyed.end(),
+            [](auto const& lhs, auto const& rhs)
+            {
+                return lhs.first < rhs.first;
+            });
+        for (std::size_t i = 0; i < keyed.size(); ++i)
+            requests[i] = std::move (keyed[i].second);
+    }
+
+    auto const workers = std::min (requests.size(), maxWorkers ());
+
+    auto pass = std::make_shared<UpdatePass> (app_, cache,
+        std::move (requests), shouldCancel, newRequests);
+
+    // This thread works on the pass too, so it completes even if no
+    // helper job gets a thread. Helpers that start after the pass is
+    // done return at once.
+    for (std::size_t i = 1; i < workers; ++i)
+    {
+        app_.getJobQueue().addJob (
+            jtUPDATE_PF, "PathRequest::update",
+            [pass] (Job&)
+            {
+                {
+                    std::lock_guard<std::mutex> lock (pass->mutex);
+                    if (pass->done)
+                        return;
+                    ++pass->active;
+                }
+
+                runPass (*pass);
+
+                std::lock_guard<std::mutex> lock (pass->mutex);
+                if (--pass->active == 0)
+                    pass->cond.notify_all();
+            });
+    }
+
+    runPass (*pass);
+
+    std::unique_lock<std::mutex> lock (pass->mutex);
+    pass->done = true;
+    pass->cond.wait (lock, [&pass] { return pass->active == 0; });
+
+    // Such as SHAMapMissingNode, which our caller handles
+    if (pass->error)
+        std::rethrow_exception (pass->error);
+
+    if (pass->removeDead || !pass->remove.empty())
+    {
+        ScopedLockType sl (mLock);
+
+        // Remove any dangling weak pointers or weak
+        // pointers that refer to removed path requests.
+        auto ret = std::remove_if (
+            requests_.begin(), requests_.end(),
+            [&pass](auto const& wl)
+            {
+                auto r = wl.lock();
+
+                return !r || std::find (pass->remove.begin(),
+                    pass->remove.end(), r) != pass->remove.end();
+            });
+
+        removed += std::distance (ret, requests_.end());
+        requests_.erase (ret, requests_.end());
+    }
+
+    mustBreak = pass->mustBreak;
+    return pass->processed;
+}
+
 void PathRequests::updateAll (std::shared_ptr <ReadView const> const& inLedger,
                               Job::CancelCallback shouldCancel)
 {
@@ -97,72 +325,8 @@ void PathRequests::updateAll (std::shared_ptr <ReadView const> const& inLedger,
 
     do
     {
-        for (auto const& wr : requests)
-        {
-            if (shouldCancel())
-                break;
-
-            auto request = wr.lock ();
-            bool remove = true;
-
-            if (request)
-            {
-                if (!request->needsUpdate (newRequests, cache->getLedger()->seq()))
-                    remove = false;
-                else
-                {
-                    if (auto ipSub = request->getSubscriber ())
-                    {
-                        if (!ipSub->getConsumer ().warn ())
-                        {
-                            Json::Value update = request->doUpdate (cache, false);
-                            request->updateComplete ();
-                            update[jss::type] = "path_find";
-                            ipSub->send (update, false);
-                            remove = false;
-                            ++processed;
-                        }
-                    }
-                    else if (request->hasCompletion ())
-                    {
-                        // One-shot request with completion function
-                        request->doUpdate (cache, false);
-                        request->updateComplete();
-                        ++processed;
-                    }
-                }
-            }
-
-            if (remove)
-            {
-                ScopedLockType sl (mLock);
-
-                // Remove any dangling weak pointers or weak
-                // pointers that refer to this path request.
-                auto ret = std::remove_if (
-                    requests_.begin(), requests_.end(),
-                    [&removed,&request](auto const& wl)
-                    {
-                        auto r = wl.lock();
-
-                        if (r && r != request)
-                            return false;
-                        ++removed;
-                        return true;
-                    });
-
-                requests_.erase (ret, requests_.end());
-            }
-
-            mustBreak = !newRequests &&
-                app_.getLedgerMaster().isNewPathRequest();
-
-            // We weren't handling new requests and then
-            // there was a new request
-            if (mustBreak)
-                break;
-
-        }
+        processed += runUpdatePass (std::move (requests), cache,
+            shouldCancel, newRequests, mustBreak, removed);
 
         if (mustBreak)
         { // a new request came in while we were working
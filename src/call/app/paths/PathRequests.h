@@ -61,6 +61,10 @@ public:
 
     /** Update all of the contained PathRequest instances.
 
+        The requests are spread over several jobs sharing one line cache.
+        Requests that have never been served, then those with the oldest
+        results, are taken first.
+
         @param ledger Ledger we are pathfinding in.
         @param shouldCancel Invocable that returns whether to cancel.
      */
@@ -94,6 +98,15 @@ public:
         std::shared_ptr<ReadView const> const& inLedger,
         Json::Value const& request);
 
+    /** Set how many jobs may work on one update pass.
+
+        Zero, the default, uses half the hardware threads.
+    */
+    void setMaxWorkers (std::size_t workers)
+    {
+        maxWorkers_ = workers;
+    }
+
     void reportFast (std::chrono::milliseconds ms)
     {
         mFast.notify (ms);
@@ -107,6 +120,17 @@ public:
 private:
     void insertPathRequest (PathRequest::pointer const&);
 
+    std::size_t maxWorkers () const;
+
+    // Returns the number of requests processed
+    int runUpdatePass (
+        std::vector<PathRequest::wptr> requests,
+        std::shared_ptr<CallLineCache> const& cache,
+        Job::CancelCallback const& shouldCancel,
+        bool newRequests,
+        bool& mustBreak,
+        int& removed);
+
     Application& app_;
     beast::Journal                   mJournal;
 
@@ -121,6 +145,8 @@ private:
 
     std::atomic<int>                 mLastIdentifier;
 
+    std::atomic<std::size_t>         maxWorkers_ {0};
+
     using ScopedLockType = std::lock_guard <std::recursive_mutex>;
     std::recursive_mutex mLock;
 
@@ -42,6 +42,7 @@
 #include <call/beast/utility/Journal.h>
 #include <memory>
 #include <utility>
+#include <vector>
 
 namespace call {
 
@@ -80,6 +81,18 @@ checkValidity(HashRouter& router,
     STTx const& tx, Rules const& rules,
         Config const& config);
 
+/** Checks the signatures of several transactions together.
+
+    Transactions whose signature state is not yet cached are
+    verified as a batch, and the results are cached for a later
+    `checkValidity`. Local checks are not done.
+
+    @see checkValidity, checkSignBatch
+*/
+void
+checkSignatures(HashRouter& router,
+    std::vector<std::shared_ptr<STTx const>> const& txs,
+        Rules const& rules);
 
 /** Sets the validity of a given transaction in the cache.
 
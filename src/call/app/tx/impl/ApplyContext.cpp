@@ -56,13 +56,13 @@ ApplyContext::ApplyContext(Application& app_,
     , base_ (base)
     , flags_(flags)
 {
-    view_.emplace(&base_, flags_);
+    view_.emplace(&base_, flags_, base_.applyArena());
 }
 
 void
 ApplyContext::discard()
 {
-    view_.emplace(&base_, flags_);
+    view_.emplace(&base_, flags_, base_.applyArena());
 }
 
 void
@@ -97,6 +97,33 @@ checkValidity(HashRouter& router,
     return {Validity::Valid, ""};
 }
 
+void
+checkSignatures(HashRouter& router,
+    std::vector<std::shared_ptr<STTx const>> const& txs,
+        Rules const& rules)
+{
+    std::vector<std::shared_ptr<STTx const>> unknown;
+    unknown.reserve(txs.size());
+    for (auto const& tx : txs)
+    {
+        if (!(router.getFlags(tx->getTransactionID()) &
+                (SF_SIGBAD | SF_SIGGOOD)))
+            unknown.push_back(tx);
+    }
+
+    if (unknown.empty())
+        return;
+
+    auto const results = checkSignBatch(unknown,
+        rules.enabled(featureMultiSign));
+
+    for (std::size_t i = 0; i < unknown.size(); ++i)
+    {
+        router.setFlags(unknown[i]->getTransactionID(),
+            results[i].first ? SF_SIGGOOD : SF_SIGBAD);
+    }
+}
+
 void
 forceValidity(HashRouter& router, uint256 const& txid,
     Validity validity)
@@ -0,0 +1,250 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of calld: https://github.com/callchain/calld
+    Copyright (c) 2018, 2019 Callchain Fundation.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef CALL_BASICS_PARTITIONEDKEYCACHE_H_INCLUDED
+#define CALL_BASICS_PARTITIONEDKEYCACHE_H_INCLUDED
+
+#include <call/basics/KeyCache.h>
+#include <atomic>
+#include <cassert>
+#include <memory>
+#include <vector>
+
+namespace call {
+
+/** A KeyCache split into independently locked partitions.
+
+    Keys are assigned to a partition by hash. Each partition is a
+    complete KeyCache with its own lock and sweep, and receives an
+    equal share of the target size.
+
+    @see PartitionedTaggedCache
+*/
+template <
+    class Key,
+    class Hash = hardened_hash <>,
+    class KeyEqual = std::equal_to <Key>,
+    class Mutex = std::mutex
+>
+class PartitionedKeyCache
+{
+public:
+    using partition_type = KeyCache <Key, Hash, KeyEqual, Mutex>;
+    using key_type = Key;
+    using size_type = typename partition_type::size_type;
+    using clock_type = beast::abstract_clock <std::chrono::steady_clock>;
+
+    enum
+    {
+        defaultPartitions = 16
+    };
+
+private:
+    struct Stats
+    {
+        template <class Handler>
+        Stats (std::string const& prefix, Handler const& handler,
+            beast::insight::Collector::ptr const& collector)
+            : hook (collector->make_hook (handler))
+            , size (collector->make_gauge (prefix, "size"))
+            , hit_rate (collector->make_gauge (prefix, "hit_rate"))
+            , hits (0)
+            , misses (0)
+            { }
+
+        beast::insight::Hook hook;
+        beast::insight::Gauge size;
+        beast::insight::Gauge hit_rate;
+
+        std::atomic <std::size_t> hits;
+        std::atomic <std::size_t> misses;
+    };
+
+    clock_type& m_clock;
+    std::string const m_name;
+    Hash m_hash;
+    std::vector <std::unique_ptr <partition_type>> m_partitions;
+    Stats mutable m_stats;
+
+public:
+    /** Construct with the specified name.
+
+        @param size The initial target size, across all partitions.
+        @param age  The initial expiration time.
+        @param partitions The number of independently locked partitions.
+    */
+    PartitionedKeyCache (std::string const& name, clock_type& clock,
+        beast::insight::Collector::ptr const& collector, size_type target_size = 0,
+            clock_type::rep expiration_seconds = 120,
+                std::size_t partitions = defaultPartitions)
+        : m_clock (clock)
+        , m_name (name)
+        , m_stats (name,
+            std::bind (&PartitionedKeyCache::collect_metrics, this),
+                collector)
+    {
+        assert (partitions > 0);
+        m_partitions.reserve (partitions);
+        for (std::size_t i = 0; i < partitions; ++i)
+            m_partitions.push_back (std::make_unique <partition_type> (
+                name, clock, partitionSize (target_size, partitions),
+                    expiration_seconds));
+    }
+
+    //--------------------------------------------------------------------------
+
+    /** Retrieve the name of this object. */
+    std::string const& name () const
+    {
+        return m_name;
+    }
+
+    /** Return the clock associated with the cache. */
+    clock_type& clock ()
+    {
+        return m_clock;
+    }
+
+    std::size_t partitions () const
+    {
+        return m_partitions.size ();
+    }
+
+    /** Returns the number of items in the container. */
+    size_type size () const
+    {
+        size_type n = 0;
+        for (auto const& p : m_partitions)
+            n += p->size ();
+        return n;
+    }
+
+    /** Empty the cache */
+    void clear ()
+    {
+        for (auto& p : m_partitions)
+            p->clear ();
+    }
+
+    void setTargetSize (size_type s)
+    {
+        for (auto& p : m_partitions)
+            p->setTargetSize (partitionSize (s, m_partitions.size ()));
+    }
+
+    void setTargetAge (size_type s)
+    {
+        for (auto& p : m_partitions)
+            p->setTargetAge (s);
+    }
+
+    /** Returns `true` if the key was found.
+        Does not update the last access time.
+    */
+    bool exists (key_type const& key) const
+    {
+        return record (partition (key).exists (key));
+    }
+
+    /** Insert the specified key.
+        The last access time is refreshed in all cases.
+        @return `true` If the key was newly inserted.
+    */
+    bool insert (key_type const& key)
+    {
+        return partition (key).insert (key);
+    }
+
+    /** Refresh the last access time on a key if present.
+        @return `true` If the key was found.
+    */
+    bool touch_if_exists (key_type const& key)
+    {
+        return record (partition (key).touch_if_exists (key));
+    }
+
+    /** Remove the specified cache entry.
+        @param key The key to remove.
+        @return `false` If the key was not found.
+    */
+    bool erase (key_type const& key)
+    {
+        return record (partition (key).erase (key));
+    }
+
+    /** Remove stale entries from the cache.
+        Only one partition is locked at a time.
+    */
+    void sweep ()
+    {
+        for (auto& p : m_partitions)
+            p->sweep ();
+    }
+
+private:
+    partition_type& partition (key_type const& key) const
+    {
+        return *m_partitions[m_hash (key) % m_partitions.size ()];
+    }
+
+    bool record (bool hit) const
+    {
+        if (hit)
+            ++m_stats.hits;
+        else
+            ++m_stats.misses;
+        return hit;
+    }
+
+    static size_type partitionSize (size_type size, std::size_t partitions)
+    {
+        return (size + partitions - 1) / partitions;
+    }
+
+    void collect_metrics ()
+    {
+        m_stats.size.set (size ());
+
+        std::size_t const hits = m_stats.hits;
+        std::size_t const total = hits + m_stats.misses;
+        beast::insight::Gauge::value_type hit_rate (0);
+        if (total != 0)
+            hit_rate = (hits * 100) / total;
+        m_stats.hit_rate.set (hit_rate);
+    }
+};
+
+}
+
+#endif
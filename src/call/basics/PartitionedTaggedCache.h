@@ -0,0 +1,285 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of calld: https://github.com/callchain/calld
+    Copyright (c) 2018, 2019 Callchain Fundation.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef CALL_BASICS_PARTITIONEDTAGGEDCACHE_H_INCLUDED
+#define CALL_BASICS_PARTITIONEDTAGGEDCACHE_H_INCLUDED
+
+#include <call/basics/TaggedCache.h>
+#include <atomic>
+#include <cassert>
+#include <memory>
+
+namespace call {
+
+/** A TaggedCache split into independently locked partitions.
+
+    Keys are assigned to a partition by hash, and each partition is a
+    complete TaggedCache with its own lock, map and sweep. Threads which
+    touch different keys rarely contend, at the cost of per-partition
+    rather than global aging: the target size is divided evenly among
+    the partitions, and each one ages its entries on its own.
+
+    The interface mirrors TaggedCache, except that there is no single
+    mutex to expose through peekMutex.
+*/
+template <
+    class Key,
+    class T,
+    class Hash = hardened_hash <>,
+    class KeyEqual = std::equal_to <Key>,
+    class Mutex = std::recursive_mutex
+>
+class PartitionedTaggedCache
+{
+public:
+    using partition_type = TaggedCache <Key, T, Hash, KeyEqual, Mutex>;
+    using key_type = Key;
+    using mapped_type = T;
+    using weak_mapped_ptr = std::weak_ptr <mapped_type>;
+    using mapped_ptr = std::shared_ptr <mapped_type>;
+    using clock_type = beast::abstract_clock <std::chrono::steady_clock>;
+
+    enum
+    {
+        defaultPartitions = 16
+    };
+
+public:
+    PartitionedTaggedCache (std::string const& name, int size,
+        clock_type::rep expiration_seconds, clock_type& clock, beast::Journal journal,
+            beast::insight::Collector::ptr const& collector = beast::insight::NullCollector::New (),
+                std::size_t partitions = defaultPartitions)
+        : m_clock (clock)
+        , m_stats (name,
+            std::bind (&PartitionedTaggedCache::collect_metrics, this),
+                collector)
+        , m_target_size (size)
+    {
+        assert (partitions > 0);
+        m_partitions.reserve (partitions);
+        for (std::size_t i = 0; i < partitions; ++i)
+            m_partitions.push_back (std::make_unique <partition_type> (
+                name, partitionSize (size, partitions), expiration_seconds,
+                    clock, journal));
+    }
+
+public:
+    /** Return the clock associated with the cache. */
+    clock_type& clock ()
+    {
+        return m_clock;
+    }
+
+    std::size_t partitions () const
+    {
+        return m_partitions.size ();
+    }
+
+    int getTargetSize () const
+    {
+        return m_target_size;
+    }
+
+    void setTargetSize (int s)
+    {
+        m_target_size = s;
+        for (auto& p : m_partitions)
+            p->setTargetSize (partitionSize (s, m_partitions.size ()));
+    }
+
+    clock_type::rep getTargetAge () const
+    {
+        return m_partitions.front ()->getTargetAge ();
+    }
+
+    void setTargetAge (clock_type::rep s)
+    {
+        for (auto& p : m_partitions)
+            p->setTargetAge (s);
+    }
+
+    int getCacheSize () const
+    {
+        int size = 0;
+        for (auto const& p : m_partitions)
+            size += p->getCacheSize ();
+        return size;
+    }
+
+    int getTrackSize () const
+    {
+        int size = 0;
+        for (auto const& p : m_partitions)
+            size += p->getTrackSize ();
+        return size;
+    }
+
+    float getHitRate ()
+    {
+        auto const counts = getHitsAndMisses ();
+        auto const total = static_cast<float> (counts.first + counts.second);
+        return counts.first * (100.0f / std::max (1.0f, total));
+    }
+
+    std::pair <std::uint64_t, std::uint64_t> getHitsAndMisses () const
+    {
+        std::pair <std::uint64_t, std::uint64_t> counts {0, 0};
+        for (auto const& p : m_partitions)
+        {
+            auto const c = p->getHitsAndMisses ();
+            counts.first += c.first;
+            counts.second += c.second;
+        }
+        return counts;
+    }
+
+    void clearStats ()
+    {
+        for (auto& p : m_partitions)
+            p->clearStats ();
+    }
+
+    void clear ()
+    {
+        for (auto& p : m_partitions)
+            p->clear ();
+    }
+
+    /** Sweep each partition in turn.
+        Only one partition is locked at a time.
+    */
+    void sweep ()
+    {
+        for (auto& p : m_partitions)
+            p->sweep ();
+    }
+
+    bool del (key_type const& key, bool valid)
+    {
+        return partition (key).del (key, valid);
+    }
+
+    /** Replace aliased objects with originals.
+        @see TaggedCache::canonicalize
+    */
+    bool canonicalize (key_type const& key, std::shared_ptr<T>& data, bool replace = false)
+    {
+        return partition (key).canonicalize (key, data, replace);
+    }
+
+    std::shared_ptr<T> fetch (key_type const& key)
+    {
+        return partition (key).fetch (key);
+    }
+
+    bool insert (key_type const& key, T const& value)
+    {
+        return partition (key).insert (key, value);
+    }
+
+    bool retrieve (key_type const& key, T& data)
+    {
+        return partition (key).retrieve (key, data);
+    }
+
+    bool refreshIfPresent (key_type const& key)
+    {
+        return partition (key).refreshIfPresent (key);
+    }
+
+    std::vector <key_type> getKeys ()
+    {
+        std::vector <key_type> v;
+        for (auto& p : m_partitions)
+        {
+            auto keys = p->getKeys ();
+            v.insert (v.end (), keys.begin (), keys.end ());
+        }
+        return v;
+    }
+
+private:
+    partition_type& partition (key_type const& key)
+    {
+        return *m_partitions[m_hash (key) % m_partitions.size ()];
+    }
+
+    static int partitionSize (int size, std::size_t partitions)
+    {
+        if (size <= 0)
+            return 0;
+        auto const n = static_cast<int> (partitions);
+        return (size + n - 1) / n;
+    }
+
+    void collect_metrics ()
+    {
+        m_stats.size.set (getCacheSize ());
+
+        auto const counts = getHitsAndMisses ();
+        auto const total (counts.first + counts.second);
+        beast::insight::Gauge::value_type hit_rate (0);
+        if (total != 0)
+            hit_rate = (counts.first * 100) / total;
+        m_stats.hit_rate.set (hit_rate);
+    }
+
+private:
+    struct Stats
+    {
+        template <class Handler>
+        Stats (std::string const& prefix, Handler const& handler,
+            beast::insight::Collector::ptr const& collector)
+            : hook (collector->make_hook (handler))
+            , size (collector->make_gauge (prefix, "size"))
+            , hit_rate (collector->make_gauge (prefix, "hit_rate"))
+            { }
+
+        beast::insight::Hook hook;
+        beast::insight::Gauge size;
+        beast::insight::Gauge hit_rate;
+    };
+
+    clock_type& m_clock;
+    Hash m_hash;
+    std::vector <std::unique_ptr <partition_type>> m_partitions;
+    Stats m_stats;
+
+    // Desired number of cache entries across all partitions (0 = ignore)
+    std::atomic <int> m_target_size;
+};
+
+}
+
+#endif
@@ -161,6 +161,13 @@ public:
         return m_hits * (100.0f / std::max (1.0f, total));
     }
 
+    /** Return the number of hits and misses since the last clearStats. */
+    std::pair <std::uint64_t, std::uint64_t> getHitsAndMisses () const
+    {
+        lock_guard lock (m_mutex);
+        return { m_hits, m_misses };
+    }
+
     void clearStats ()
     {
         lock_guard lock (m_mutex);
@@ -37,6 +37,7 @@
 
 #include <call/basics/contract.h>
 #include <boost/intrusive/list.hpp>
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
 #include <cstdlib>
@@ -48,6 +49,21 @@
 
 namespace call {
 
+/** Allocation counts shared by a group of qalloc arenas.
+
+    Each arena adds its allocations when it is destroyed, and each
+    block it takes from the heap when the block is allocated.
+*/
+struct qalloc_stats
+{
+    // Allocations served by the arenas, and their total size
+    std::atomic<std::uint64_t> allocations {0};
+    std::atomic<std::uint64_t> bytes {0};
+
+    // Blocks taken from the heap
+    std::atomic<std::uint64_t> blocks {0};
+};
+
 namespace detail {
 
 template <class = void>
@@ -80,6 +96,9 @@ private:
 
     block* used_ = nullptr;
     block* free_ = nullptr;
+    qalloc_stats* stats_ = nullptr;
+    std::uint64_t allocations_ = 0;
+    std::uint64_t bytes_ = 0;
 
 public:
     enum
@@ -88,6 +107,13 @@ public:
     };
 
     qalloc_impl() = default;
+
+    explicit
+    qalloc_impl (qalloc_stats* stats)
+        : stats_ (stats)
+    {
+    }
+
     qalloc_impl (qalloc_impl const&) = delete;
     qalloc_impl& operator= (qalloc_impl const&) = delete;
 
@@ -136,6 +162,17 @@ public:
 
     qalloc_type();
 
+    /** Create an allocator for a new arena which reports to `stats`. */
+    explicit
+    qalloc_type (qalloc_stats& stats);
+
+    /** Create an allocator without an arena.
+
+        Memory comes directly from the heap.
+    */
+    explicit
+    qalloc_type (std::nullptr_t);
+
     template <class U>
     qalloc_type (qalloc_type<U, ShareOnCopy> const& u);
 
@@ -244,6 +281,13 @@ qalloc_impl<_>::block::deallocate()
 template <class _>
 qalloc_impl<_>::~qalloc_impl()
 {
+    if (stats_)
+    {
+        stats_->allocations.fetch_add (
+            allocations_, std::memory_order_relaxed);
+        stats_->bytes.fetch_add (
+            bytes_, std::memory_order_relaxed);
+    }
     if (used_)
     {
         used_->~block();
@@ -263,6 +307,8 @@ void*
 qalloc_impl<_>::allocate(
     std::size_t bytes, std::size_t align)
 {
+    ++allocations_;
+    bytes_ += bytes;
     if (used_)
     {
         auto const p =
@@ -292,6 +338,8 @@ qalloc_impl<_>::allocate(
         new(std::malloc(n)) block(n);
     if (! b)
         Throw<std::bad_alloc> ();
+    if (stats_)
+        stats_->blocks.fetch_add (1, std::memory_order_relaxed);
     used_ = b;
     // VFALCO This has to succeed
     return used_->allocate(bytes, align);
@@ -323,6 +371,18 @@ qalloc_type<T, ShareOnCopy>::qalloc_type()
 {
 }
 
+template <class T, bool ShareOnCopy>
+qalloc_type<T, ShareOnCopy>::qalloc_type (qalloc_stats& stats)
+    : impl_ (std::make_shared<
+        detail::qalloc_impl<>>(&stats))
+{
+}
+
+template <class T, bool ShareOnCopy>
+qalloc_type<T, ShareOnCopy>::qalloc_type (std::nullptr_t)
+{
+}
+
 template <class T, bool ShareOnCopy>
 template <class U>
 qalloc_type<T, ShareOnCopy>::qalloc_type(
@@ -340,6 +400,8 @@ qalloc_type<T, ShareOnCopy>::alloc (std::size_t n)
             std::size_t>::max() / sizeof(U))
         Throw<std::bad_alloc> ();
     auto const bytes = n * sizeof(U);
+    if (! impl_)
+        return static_cast<U*>(::operator new (bytes));
     return static_cast<U*>(
         impl_->allocate(bytes,
             std::alignment_of<U>::value));
@@ -352,7 +414,10 @@ void
 qalloc_type<T, ShareOnCopy>::dealloc(
     U* p, std::size_t n)
 {
-    impl_->deallocate(p);
+    if (impl_)
+        impl_->deallocate(p);
+    else
+        ::operator delete (p);
 }
 
 template <class T, bool ShareOnCopy>
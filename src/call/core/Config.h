@@ -191,6 +191,12 @@ public:
     // Thread pool configuration
     std::size_t                 WORKERS = 0;
 
+    // Flush the subtrees of a closed ledger on multiple job queue threads
+    bool                        PARALLEL_FLUSH = false;
+
+    // Nodes a full walk of a SHAMap reads ahead of its position
+    int                         READ_AHEAD = 128;
+
     // These override the command line client settings
     boost::optional<boost::asio::ip::address_v4> rpc_ip;
     boost::optional<std::uint16_t> rpc_port;
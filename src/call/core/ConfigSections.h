@@ -44,6 +44,8 @@ struct ConfigSection
 {
     static std::string nodeDatabase ()       { return "node_db"; }
     static std::string importNodeDatabase () { return "import_db"; }
+    static std::string shardDatabase ()      { return "shard_db"; }
+    static std::string accountTxIndex ()     { return "account_tx_index"; }
 };
 
 // VFALCO TODO Rename and replace these macros with variables.
@@ -58,17 +60,20 @@ struct ConfigSection
 #define SECTION_FETCH_DEPTH             "fetch_depth"
 #define SECTION_LEDGER_HISTORY          "ledger_history"
 #define SECTION_INSIGHT                 "insight"
+#define SECTION_IO_THREADS              "io_threads"
 #define SECTION_IPS                     "ips"
 #define SECTION_IPS_FIXED               "ips_fixed"
 #define SECTION_NETWORK_QUORUM          "network_quorum"
 #define SECTION_NODE_SEED               "node_seed"
 #define SECTION_NODE_SIZE               "node_size"
+#define SECTION_PARALLEL_FLUSH          "parallel_flush"
 #define SECTION_PATH_SEARCH_OLD         "path_search_old"
 #define SECTION_PATH_SEARCH             "path_search"
 #define SECTION_PATH_SEARCH_FAST        "path_search_fast"
 #define SECTION_PATH_SEARCH_MAX         "path_search_max"
 #define SECTION_PEER_PRIVATE            "peer_private"
 #define SECTION_PEERS_MAX               "peers_max"
+#define SECTION_READ_AHEAD              "read_ahead"
 #define SECTION_RPC_STARTUP             "rpc_startup"
 #define SECTION_SNTP                    "sntp_servers"
 #define SECTION_SSL_VERIFY              "ssl_verify"
@@ -55,6 +55,7 @@ enum JobType
     // insert a job at a specific priority, simply add it at the right location.
 
     jtPACK,          // Make a fetch pack for a peer
+    jtSHARD,         // Copy validated ledgers into a history shard
     jtPUBOLDLEDGER,  // An old ledger has been accepted
     jtVALIDATION_ut, // A validation from an untrusted source
     jtTRANSACTION_l, // A local transaction
@@ -72,6 +73,7 @@ enum JobType
     jtWAL,           // Write-ahead logging
     jtVALIDATION_t,  // A validation from a trusted source
     jtWRITE,         // Write out hashed objects
+    jtFLUSH,         // Flush part of a ledger's SHAMap
     jtACCEPT,        // Accept a consensus ledger
     jtPROPOSAL_t,    // A proposal from a trusted source
     jtSWEEP,         // Sweep for stale structures
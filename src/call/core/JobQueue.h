@@ -43,6 +43,8 @@
 #include <call/core/impl/Workers.h>
 #include <call/json/json_value.h>
 #include <boost/coroutine/all.hpp>
+#include <atomic>
+#include <vector>
 
 namespace call {
 
@@ -222,14 +224,22 @@ private:
     using JobDataMap = std::map <JobType, JobTypeData>;
 
     beast::Journal m_journal;
+
+    // Guards stopping, rendezvous and suspended coroutines. Jobs are
+    // queued and dequeued under the lock of their JobTypeData only.
     mutable std::mutex m_mutex;
-    std::uint64_t m_lastJob;
-    std::set <Job> m_jobSet;
+    std::atomic <std::uint64_t> m_lastJob;
     JobDataMap m_jobData;
     JobTypeData m_invalidJobData;
 
+    // Every JobTypeData, highest priority first
+    std::vector <JobTypeData*> m_byPriority;
+
+    // The number of jobs waiting across all types
+    std::atomic <int> m_jobCount;
+
     // The number of jobs currently in processTask()
-    int m_processCount;
+    std::atomic <int> m_processCount;
 
     // The number of suspended coroutines
     int nSuspend_ = 0;
@@ -272,7 +282,7 @@ private:
     //
     // Pre-conditions:
     //  The JobType must be valid.
-    //  The Job must exist in mJobSet.
+    //  The Job must be at the back of data.jobs.
     //  The Job must not have previously been queued.
     //
     // Post-conditions:
@@ -280,32 +290,33 @@ private:
     //  If JobQueue exists, and has at least one thread, Job will eventually run.
     //
     // Invariants:
-    //  The calling thread owns the JobLock
-    void queueJob (Job const& job, std::lock_guard <std::mutex> const& lock);
+    //  The calling thread owns data.mutex
+    void queueJob (JobTypeData& data, std::lock_guard <std::mutex> const& lock);
 
-    // Returns the next Job we should run now.
+    // Takes the next Job we should run now.
     //
     // RunnableJob:
-    //  A Job in the JobSet whose slots count for its type is greater than zero.
+    //  A waiting Job whose slots count for its type is greater than zero.
     //
-    // Pre-conditions:
-    //  mJobSet must not be empty.
-    //  mJobSet holds at least one RunnableJob
+    // Types are visited from the highest priority down, locking only the
+    // type being examined. Returns false if no RunnableJob was found,
+    // which can happen transiently while other threads take or finish
+    // jobs of the types already visited.
     //
     // Post-conditions:
+    //  If true is returned:
     //  job is a valid Job object.
-    //  job is removed from mJobQueue.
+    //  job is removed from the queue of its type.
     //  Waiting job count of its type is decremented
     //  Running job count of its type is incremented
     //
     // Invariants:
-    //  The calling thread owns the JobLock
-    void getNextJob (Job& job);
+    //  <none>
+    bool getNextJob (Job& job);
 
     // Indicates that a running Job has completed its task.
     //
     // Pre-conditions:
-    //  Job must not exist in mJobSet.
     //  The JobType must not be invalid.
     //
     // Post-conditions:
@@ -327,7 +338,8 @@ private:
     // Runs the next appropriate waiting Job.
     //
     // Pre-conditions:
-    //  A RunnableJob must exist in the JobSet
+    //  A RunnableJob must exist, or become available once concurrent
+    //  calls to getNextJob or finishJob complete
     //
     // Post-conditions:
     //  The chosen RunnableJob will have Job::doJob() called.
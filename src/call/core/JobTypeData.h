@@ -36,8 +36,12 @@
 #define CALL_CORE_JOBTYPEDATA_H_INCLUDED
 
 #include <call/basics/Log.h>
+#include <call/core/Job.h>
 #include <call/core/JobTypeInfo.h>
 #include <call/beast/insight/Collector.h>
+#include <atomic>
+#include <deque>
+#include <mutex>
 
 namespace call
 {
@@ -54,14 +58,21 @@ public:
     /* The job category which we represent */
     JobTypeInfo const& info;
 
+    /* Guards jobs. The counters below are only changed while holding
+       it, but may be read without it. */
+    std::mutex mutex;
+
+    /* Jobs of this type waiting to run, oldest first */
+    std::deque <Job> jobs;
+
     /* The number of jobs waiting */
-    int waiting;
+    std::atomic <int> waiting;
 
     /* The number presently running */
-    int running;
+    std::atomic <int> running;
 
     /* And the number we deferred executing because of job limits */
-    int deferred;
+    std::atomic <int> deferred;
 
     /* Notification callbacks */
     beast::insight::Event dequeue;
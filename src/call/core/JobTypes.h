@@ -54,6 +54,7 @@ public:
         int maxLimit = std::numeric_limits <int>::max ();
 
 add(    jtPACK,          "makeFetchPack",           1,        false, 0,     0);
+add(    jtSHARD,         "storeShard",              4,        false, 0,     0);
 add(    jtPUBOLDLEDGER,  "publishAcqLedger",        2,        false, 10000, 15000);
 add(    jtVALIDATION_ut, "untrustedValidation",     maxLimit, false, 2000,  5000);
 add(    jtTRANSACTION_l, "localTransaction",        maxLimit, false, 100,   500);
@@ -71,6 +72,7 @@ add(    jtTXN_DATA,      "fetchTxnData",            1,        false, 0,     0);
 add(    jtWAL,           "writeAhead",              maxLimit, false, 1000,  2500);
 add(    jtVALIDATION_t,  "trustedValidation",       maxLimit, false, 500,  1500);
 add(    jtWRITE,         "writeObjects",            maxLimit, false, 1750,  2500);
+add(    jtFLUSH,         "flushMap",                maxLimit, false, 0,     0);
 add(    jtACCEPT,        "acceptLedger",            maxLimit, false, 0,     0);
 add(    jtPROPOSAL_t,    "trustedProposal",         maxLimit, false, 100,   500);
 add(    jtSWEEP,         "sweep",                   maxLimit, false, 0,     0);
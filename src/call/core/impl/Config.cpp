@@ -431,6 +431,12 @@ void Config::loadFromString (std::string const& fileContents)
     if (getSingleSection (secConfig, SECTION_WORKERS, strTemp, j_))
         WORKERS      = beast::lexicalCastThrow <std::size_t> (strTemp);
 
+    if (getSingleSection (secConfig, SECTION_PARALLEL_FLUSH, strTemp, j_))
+        PARALLEL_FLUSH = beast::lexicalCastThrow <bool> (strTemp);
+
+    if (getSingleSection (secConfig, SECTION_READ_AHEAD, strTemp, j_))
+        READ_AHEAD = std::max (0, beast::lexicalCastThrow <int> (strTemp));
+
     // Do not load trusted validator configuration for standalone mode
     if (! RUN_STANDALONE)
     {
@@ -35,6 +35,7 @@
 #include <BeastConfig.h>
 #include <call/core/JobQueue.h>
 #include <call/basics/contract.h>
+#include <thread>
 
 namespace call {
 
@@ -44,6 +45,7 @@ JobQueue::JobQueue (beast::insight::Collector::ptr const& collector,
     , m_journal (journal)
     , m_lastJob (0)
     , m_invalidJobData (getJobTypes ().getInvalid (), collector, logs)
+    , m_jobCount (0)
     , m_processCount (0)
     , m_workers (*this, "JobQueue", 0)
     , m_cancelCallback (std::bind (&Stoppable::isStopping, this))
@@ -66,6 +68,10 @@ JobQueue::JobQueue (beast::insight::Collector::ptr const& collector,
             assert (result.second == true);
             (void) result.second;
         }
+
+        // Higher job types run first
+        for (auto iter = m_jobData.rbegin (); iter != m_jobData.rend (); ++iter)
+            m_byPriority.push_back (&iter->second);
     }
 }
 
@@ -78,8 +84,7 @@ JobQueue::~JobQueue ()
 void
 JobQueue::collect ()
 {
-    std::lock_guard <std::mutex> lock (m_mutex);
-    job_count = m_jobSet.size ();
+    job_count = m_jobCount.load ();
 }
 
 bool
@@ -99,29 +104,31 @@ JobQueue::addRefCountedJob (JobType type, std::string const& name,
     // do not add jobs to a queue with no threads
     assert (type == jtCLIENT || m_workers.getNumberOfThreads () > 0);
 
-    {
-        std::lock_guard <std::mutex> lock (m_mutex);
+    // If this goes off it means that a child didn't follow
+    // the Stoppable API rules. A job may only be added if:
+    //
+    //  - The JobQueue has NOT stopped
+    //          AND
+    //      * We are currently processing jobs
+    //          OR
+    //      * We have have pending jobs
+    //          OR
+    //      * Not all children are stopped
+    //
+    assert (! isStopped() && (
+        m_processCount>0 ||
+        m_jobCount>0 ||
+        ! areChildrenStopped()));
 
-        // If this goes off it means that a child didn't follow
-        // the Stoppable API rules. A job may only be added if:
-        //
-        //  - The JobQueue has NOT stopped
-        //          AND
-        //      * We are currently processing jobs
-        //          OR
-        //      * We have have pending jobs
-        //          OR
-        //      * Not all children are stopped
-        //
-        assert (! isStopped() && (
-            m_processCount>0 ||
-            ! m_jobSet.empty () ||
-            ! areChildrenStopped()));
-
-        std::pair <std::set <Job>::iterator, bool> result (
-            m_jobSet.insert (Job (type, name, ++m_lastJob,
-                data.load (), func, m_cancelCallback)));
-        queueJob (*result.first, lock);
+    {
+        // Only jobs of the same type contend for this lock, and the
+        // queue is FIFO so there is no ordered insert.
+        std::lock_guard <std::mutex> lock (data.mutex);
+
+        data.jobs.emplace_back (type, name, ++m_lastJob,
+            data.load (), func, m_cancelCallback);
+        ++m_jobCount;
+        queueJob (data, lock);
     }
     return true;
 }
@@ -129,20 +136,16 @@ JobQueue::addRefCountedJob (JobType type, std::string const& name,
 int
 JobQueue::getJobCount (JobType t) const
 {
-    std::lock_guard <std::mutex> lock (m_mutex);
-
     JobDataMap::const_iterator c = m_jobData.find (t);
 
     return (c == m_jobData.end ())
         ? 0
-        : c->second.waiting;
+        : c->second.waiting.load ();
 }
 
 int
 JobQueue::getJobCountTotal (JobType t) const
 {
-    std::lock_guard <std::mutex> lock (m_mutex);
-
     JobDataMap::const_iterator c = m_jobData.find (t);
 
     return (c == m_jobData.end ())
@@ -156,8 +159,6 @@ JobQueue::getJobCountGE (JobType t) const
     // return the number of jobs at this priority level or greater
     int ret = 0;
 
-    std::lock_guard <std::mutex> lock (m_mutex);
-
     for (auto const& x : m_jobData)
     {
         if (x.first >= t)
@@ -237,8 +238,6 @@ JobQueue::getJson (int c)
 
     Json::Value priorities = Json::arrayValue;
 
-    std::lock_guard <std::mutex> lock (m_mutex);
-
     for (auto& x : m_jobData)
     {
         assert (x.first != jtINVALID);
@@ -292,7 +291,7 @@ JobQueue::rendezvous()
     cv_.wait(lock, [&]
     {
         return m_processCount == 0 &&
-            m_jobSet.empty();
+            m_jobCount == 0;
     });
 }
 
@@ -331,7 +330,7 @@ JobQueue::checkStopped (std::lock_guard <std::mutex> const& lock)
     if (isStopping() &&
         areChildrenStopped() &&
         (m_processCount == 0) &&
-        m_jobSet.empty() &&
+        (m_jobCount == 0) &&
         nSuspend_ == 0)
     {
         stopped();
@@ -339,15 +338,12 @@ JobQueue::checkStopped (std::lock_guard <std::mutex> const& lock)
 }
 
 void
-JobQueue::queueJob (Job const& job, std::lock_guard <std::mutex> const& lock)
+JobQueue::queueJob (JobTypeData& data, std::lock_guard <std::mutex> const&)
 {
-    JobType const type (job.getType ());
-    assert (type != jtINVALID);
-    assert (m_jobSet.find (job) != m_jobSet.end ());
-
-    JobTypeData& data (getJobTypeData (type));
+    assert (data.type () != jtINVALID);
+    assert (! data.jobs.empty ());
 
-    if (data.waiting + data.running < getJobLimit (type))
+    if (data.waiting + data.running < getJobLimit (data.type ()))
     {
         m_workers.addTask ();
     }
@@ -360,38 +356,39 @@ JobQueue::queueJob (Job const& job, std::lock_guard <std::mutex> const& lock)
     ++data.waiting;
 }
 
-void
+bool
 JobQueue::getNextJob (Job& job)
 {
-    assert (! m_jobSet.empty ());
-
-    std::set <Job>::const_iterator iter;
-    for (iter = m_jobSet.begin (); iter != m_jobSet.end (); ++iter)
+    for (auto data : m_byPriority)
     {
-        JobTypeData& data (getJobTypeData (iter->getType ()));
+        // Cheap check so idle types are skipped without locking. A job
+        // added after this read has its own task signaled.
+        if (data->waiting == 0)
+            continue;
+
+        std::lock_guard <std::mutex> lock (data->mutex);
 
-        assert (data.running <= getJobLimit (data.type ()));
+        assert (data->running <= getJobLimit (data->type ()));
 
         // Run this job if we're running below the limit.
-        if (data.running < getJobLimit (data.type ()))
+        if (data->jobs.empty () ||
+            data->running >= getJobLimit (data->type ()))
         {
-            assert (data.waiting > 0);
-            break;
+            continue;
         }
-    }
 
-    assert (iter != m_jobSet.end ());
+        assert (data->waiting > 0);
 
-    JobType const type = iter->getType ();
-    JobTypeData& data (getJobTypeData (type));
+        job = std::move (data->jobs.front ());
+        data->jobs.pop_front ();
 
-    assert (type != jtINVALID);
-
-    job = *iter;
-    m_jobSet.erase (iter);
+        --data->waiting;
+        ++data->running;
+        --m_jobCount;
+        return true;
+    }
 
-    --data.waiting;
-    ++data.running;
+    return false;
 }
 
 void
@@ -401,6 +398,8 @@ JobQueue::finishJob (JobType type)
 
     JobTypeData& data = getJobTypeData (type);
 
+    std::lock_guard <std::mutex> lock (data.mutex);
+
     // Queue a deferred task if possible
     if (data.deferred > 0)
     {
@@ -445,11 +444,16 @@ JobQueue::processTask ()
             Job::clock_type::now());
         {
             Job job;
-            {
-                std::lock_guard <std::mutex> lock (m_mutex);
-                getNextJob (job);
-                ++m_processCount;
-            }
+
+            // Counted before the job leaves its queue, so rendezvous and
+            // checkStopped can't see it in neither place.
+            ++m_processCount;
+
+            // Our task guarantees a runnable job, but another thread may
+            // be between taking one and finishing one of a limited type.
+            while (! getNextJob (job))
+                std::this_thread::yield ();
+
             type = job.getType();
             JobTypeData& data(getJobTypeData(type));
             JLOG(m_journal.trace()) << "Doing " << data.name () << " job";
@@ -459,14 +463,20 @@ JobQueue::processTask ()
         on_execute(type, Job::clock_type::now() - start_time);
     }
 
+    // Job should be destroyed before calling checkStopped
+    // otherwise destructors with side effects can access
+    // parent objects that are already destroyed.
+    finishJob (type);
+
+    if (--m_processCount == 0 && m_jobCount == 0)
+    {
+        std::lock_guard <std::mutex> lock (m_mutex);
+        cv_.notify_all();
+    }
+
+    if (isStopping ())
     {
         std::lock_guard <std::mutex> lock (m_mutex);
-        // Job should be destroyed before calling checkStopped
-        // otherwise destructors with side effects can access
-        // parent objects that are already destroyed.
-        finishJob (type);
-        if(--m_processCount == 0 && m_jobSet.empty())
-            cv_.notify_all();
         checkStopped (lock);
     }
 
@@ -35,20 +35,34 @@
 #ifndef CALL_CORE_SEMAPHORE_H_INCLUDED
 #define CALL_CORE_SEMAPHORE_H_INCLUDED
 
+#include <atomic>
 #include <condition_variable>
+#include <cstddef>
 #include <mutex>
 
 namespace call {
 
+/** A counting semaphore whose uncontended operations take no lock.
+
+    The count goes negative while threads are blocked in wait. The mutex
+    and condition variable are only used to hand a unit to a blocked
+    thread, so producers posting work to busy consumers (the common case
+    for the JobQueue) never touch them.
+*/
 template <class Mutex, class CondVar>
 class basic_semaphore
 {
 private:
     using scoped_lock = std::unique_lock <Mutex>;
 
+    // Units available; when negative, the number of blocked waiters
+    std::atomic <std::ptrdiff_t> m_count;
+
     Mutex m_mutex;
     CondVar m_cond;
-    std::size_t m_count;
+
+    // Units handed to blocked waiters but not yet claimed
+    std::size_t m_wakeups;
 
 public:
     using size_type = std::size_t;
@@ -57,25 +71,32 @@ public:
         If unspecified, the initial count is zero.
     */
     explicit basic_semaphore (size_type count = 0)
-        : m_count (count)
+        : m_count (static_cast<std::ptrdiff_t> (count))
+        , m_wakeups (0)
     {
     }
 
     /** Increment the count and unblock one waiting thread. */
     void notify ()
     {
+        if (m_count.fetch_add (1) >= 0)
+            return;
+
         scoped_lock lock (m_mutex);
-        ++m_count;
+        ++m_wakeups;
         m_cond.notify_one ();
     }
 
     /** Block until notify is called. */
     void wait ()
     {
+        if (m_count.fetch_sub (1) > 0)
+            return;
+
         scoped_lock lock (m_mutex);
-        while (m_count == 0)
+        while (m_wakeups == 0)
             m_cond.wait (lock);
-        --m_count;
+        --m_wakeups;
     }
 
     /** Perform a non-blocking wait.
@@ -83,11 +104,13 @@ public:
     */
     bool try_wait ()
     {
-        scoped_lock lock (m_mutex);
-        if (m_count == 0)
-            return false;
-        --m_count;
-        return true;
+        auto count = m_count.load ();
+        while (count > 0)
+        {
+            if (m_count.compare_exchange_weak (count, count - 1))
+                return true;
+        }
+        return false;
     }
 };
 
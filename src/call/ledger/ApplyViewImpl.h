@@ -62,6 +62,15 @@ public:
     ApplyViewImpl(
         ReadView const* base, ApplyFlags flags);
 
+    /** Create a view whose state table allocates from `alloc`.
+
+        Pass the apply arena of an OpenView only when applying a
+        transaction to that view, which no other thread may use.
+    */
+    ApplyViewImpl(
+        ReadView const* base, ApplyFlags flags,
+            qalloc const& alloc);
+
     /** Apply the transaction.
 
         After a call to `apply`, the only valid
@@ -83,6 +83,9 @@ private:
     std::shared_ptr<void const> hold_;
     bool open_ = true;
 
+    // Memory for the views built while applying transactions
+    qalloc applyAlloc_;
+
 public:
     OpenView() = delete;
     OpenView& operator= (OpenView&&) = delete;
@@ -101,8 +104,10 @@ public:
         not duplicated but shared between instances.
         Since the SLEs are immutable, calls on the
         RawView interface cannot break invariants.
+
+        The copy gets its own apply arena.
     */
-    OpenView (OpenView const&) = default;
+    OpenView (OpenView const&);
 
     /** Construct an open ledger view.
 
@@ -169,6 +174,32 @@ public:
     void
     apply (TxsRawView& to) const;
 
+    /** Return the arena for applying transactions to this view.
+
+        The code applying a transaction passes this arena to the
+        ApplyView it builds, and every sandbox stacked on that view
+        shares it. Their memory is released when the transaction is
+        done and reused by the next one, so a batch of transactions
+        and their retries rarely reach the heap.
+
+        Views built on an OpenView without being given the arena,
+        such as path finding sandboxes, use the heap.
+
+        @note The arena may not be used concurrently. Only use it
+              while applying to this view, which no other thread
+              may be using.
+    */
+    qalloc
+    applyArena() const
+    {
+        return applyAlloc_;
+    }
+
+    /** Return the allocation statistics of every apply arena. */
+    static
+    qalloc_stats&
+    applyArenaStats();
+
     // ReadView
 
     LedgerInfo const&
@@ -190,6 +221,9 @@ public:
     std::shared_ptr<SLE const>
     read (Keylet const& k) const override;
 
+    boost::optional<STObjectView>
+    readLazy (Keylet const& k) const override;
+
     std::unique_ptr<sles_type::iter_base>
     slesBegin() const override;
 
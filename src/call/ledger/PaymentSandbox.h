@@ -35,6 +35,7 @@
 #ifndef CALL_LEDGER_PAYMENTSANDBOX_H_INCLUDED
 #define CALL_LEDGER_PAYMENTSANDBOX_H_INCLUDED
 
+#include <call/basics/qalloc.h>
 #include <call/ledger/RawView.h>
 #include <call/ledger/Sandbox.h>
 #include <call/ledger/detail/ApplyViewBase.h>
@@ -51,6 +52,13 @@ namespace detail {
 class DeferredCredits
 {
 public:
+    explicit
+    DeferredCredits (qalloc const& alloc)
+        : credits_ (alloc)
+        , ownerCounts_ (alloc)
+    {
+    }
+
     struct Adjustment
     {
         Adjustment (STAmount const& d, STAmount const& c, STAmount const& b)
@@ -100,8 +108,11 @@ private:
         AccountID const& a2,
             Currency const& c);
 
-    std::map<Key, Value> credits_;
-    std::map<AccountID, std::uint32_t> ownerCounts_;
+    std::map<Key, Value, std::less<Key>,
+        qalloc_type<std::pair<Key const, Value>, true>> credits_;
+    std::map<AccountID, std::uint32_t, std::less<AccountID>,
+        qalloc_type<std::pair<AccountID const, std::uint32_t>, true>>
+            ownerCounts_;
 };
 
 } // detail
@@ -133,11 +144,13 @@ public:
 
     PaymentSandbox (ReadView const* base, ApplyFlags flags)
         : ApplyViewBase (base, flags)
+        , tab_ (items_.alloc())
     {
     }
 
     PaymentSandbox (ApplyView const* base)
         : ApplyViewBase (base, base->flags())
+        , tab_ (items_.alloc())
     {
     }
 
@@ -158,6 +171,7 @@ public:
     explicit
     PaymentSandbox (PaymentSandbox const* base)
         : ApplyViewBase(base, base->flags())
+        , tab_ (items_.alloc())
         , ps_ (base)
     {
     }
@@ -165,6 +179,7 @@ public:
     explicit
     PaymentSandbox (PaymentSandbox* base)
         : ApplyViewBase(base, base->flags())
+        , tab_ (items_.alloc())
         , ps_ (base)
     {
     }
@@ -41,6 +41,7 @@
 #include <call/protocol/IOUAmount.h>
 #include <call/protocol/Protocol.h>
 #include <call/protocol/STLedgerEntry.h>
+#include <call/protocol/STObjectView.h>
 #include <call/protocol/STTx.h>
 #include <call/protocol/CALLAmount.h>
 #include <call/beast/hash/uhash.h>
@@ -321,6 +322,20 @@ public:
     std::shared_ptr<SLE const>
     read (Keylet const& k) const = 0;
 
+    /** Return a lazily parsed view of a state item.
+
+        This is meant for callers that look at a few fields of an
+        entry, such as a balance or a sequence number. Views backed by
+        serialized state only deserialize the fields that are read;
+        the default wraps the result of read.
+
+        @return boost::none if the key is not present or
+                if the type does not match.
+    */
+    virtual
+    boost::optional<STObjectView>
+    readLazy (Keylet const& k) const;
+
     // Accounts in a payment are not allowed to use assets acquired during that
     // payment. The PaymentSandbox tracks the debits, credits, and owner count
     // changes that accounts make during a payment. `balanceHook` adjusts balances
@@ -39,6 +39,7 @@
 #include <call/ledger/RawView.h>
 #include <call/ledger/ReadView.h>
 #include <call/ledger/TxMeta.h>
+#include <call/basics/qalloc.h>
 #include <call/protocol/TER.h>
 #include <call/protocol/CALLAmount.h>
 #include <call/beast/utility/Journal.h>
@@ -63,13 +64,21 @@ private:
     };
 
     using items_t = std::map<key_type,
-        std::pair<Action, std::shared_ptr<SLE>>>;
+        std::pair<Action, std::shared_ptr<SLE>>,
+        std::less<key_type>, qalloc_type<std::pair<key_type const,
+        std::pair<Action, std::shared_ptr<SLE>>>, true>>;
 
     items_t items_;
     CALLAmount dropsDestroyed_ = 0;
 
 public:
-    ApplyStateTable() = default;
+    /** Create a table whose items are allocated from `alloc`. */
+    explicit
+    ApplyStateTable (qalloc const& alloc)
+        : items_ (alloc)
+    {
+    }
+
     ApplyStateTable (ApplyStateTable&&) = default;
 
     ApplyStateTable (ApplyStateTable const&) = delete;
@@ -98,6 +107,10 @@ public:
     read (ReadView const& base,
         Keylet const& k) const;
 
+    boost::optional<STObjectView>
+    readLazy (ReadView const& base,
+        Keylet const& k) const;
+
     std::shared_ptr<SLE>
     peek (ReadView const& base,
         Keylet const& k);
@@ -105,6 +118,13 @@ public:
     std::size_t
     size () const;
 
+    /** Return the allocator of the table's items. */
+    qalloc
+    alloc () const
+    {
+        return items_.get_allocator ();
+    }
+
     void
     visit (ReadView const& base,
         std::function <void (
@@ -61,6 +61,11 @@ public:
     ApplyViewBase(
         ReadView const* base, ApplyFlags flags);
 
+    /** Create a view whose state table allocates from `alloc`. */
+    ApplyViewBase(
+        ReadView const* base, ApplyFlags flags,
+            qalloc const& alloc);
+
     // ReadView
     bool
     open() const override;
@@ -84,6 +89,9 @@ public:
     std::shared_ptr<SLE const>
     read (Keylet const& k) const override;
 
+    boost::optional<STObjectView>
+    readLazy (Keylet const& k) const override;
+
     std::unique_ptr<sles_type::iter_base>
     slesBegin() const override;
 
@@ -149,6 +157,12 @@ public:
         CashFilter rhsFilter, ApplyViewBase const& rhs);
 
 protected:
+    // The arena of `base` if it is itself an apply view or sandbox.
+    // Any other base is shared, so its views use the heap.
+    static
+    qalloc
+    applyArena (ReadView const* base);
+
     ApplyFlags flags_;
     ReadView const* base_;
     detail::ApplyStateTable items_;
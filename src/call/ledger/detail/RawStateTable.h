@@ -82,6 +82,10 @@ public:
     read (ReadView const& base,
         Keylet const& k) const;
 
+    boost::optional<STObjectView>
+    readLazy (ReadView const& base,
+        Keylet const& k) const;
+
     void
     destroyCALL (CALLAmount const& fee);
 
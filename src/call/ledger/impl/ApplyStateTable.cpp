@@ -356,6 +356,29 @@ ApplyStateTable::read (ReadView const& base,
     return sle;
 }
 
+boost::optional<STObjectView>
+ApplyStateTable::readLazy (ReadView const& base,
+    Keylet const& k) const
+{
+    auto const iter = items_.find(k.key);
+    if (iter == items_.end())
+        return base.readLazy(k);
+    auto const& item = iter->second;
+    auto const& sle = item.second;
+    switch (item.first)
+    {
+    case Action::erase:
+        return boost::none;
+    case Action::cache:
+    case Action::insert:
+    case Action::modify:
+        break;
+    };
+    if (! k.check(*sle))
+        return boost::none;
+    return STObjectView(sle);
+}
+
 std::shared_ptr<SLE>
 ApplyStateTable::peek (ReadView const& base,
     Keylet const& k)
@@ -44,9 +44,30 @@ ApplyViewBase::ApplyViewBase(
     ReadView const* base, ApplyFlags flags)
     : flags_ (flags)
     , base_ (base)
+    , items_ (applyArena (base))
 {
 }
 
+ApplyViewBase::ApplyViewBase(
+    ReadView const* base, ApplyFlags flags,
+        qalloc const& alloc)
+    : flags_ (flags)
+    , base_ (base)
+    , items_ (alloc)
+{
+}
+
+qalloc
+ApplyViewBase::applyArena (ReadView const* base)
+{
+    // Sandboxes stacked on an apply view share its arena. An open
+    // view's arena is only handed out explicitly, by the code that
+    // applies transactions to it, because the view may be shared.
+    if (auto const view = dynamic_cast<ApplyViewBase const*> (base))
+        return view->items_.alloc ();
+    return qalloc (nullptr);
+}
+
 //---
 
 bool
@@ -93,6 +114,12 @@ ApplyViewBase::read (Keylet const& k) const
     return items_.read(*base_, k);
 }
 
+boost::optional<STObjectView>
+ApplyViewBase::readLazy (Keylet const& k) const
+{
+    return items_.readLazy(*base_, k);
+}
+
 auto
 ApplyViewBase::slesBegin() const ->
     std::unique_ptr<sles_type::iter_base>
@@ -45,6 +45,13 @@ ApplyViewImpl::ApplyViewImpl(
 {
 }
 
+ApplyViewImpl::ApplyViewImpl(
+    ReadView const* base, ApplyFlags flags,
+        qalloc const& alloc)
+    : ApplyViewBase (base, flags, alloc)
+{
+}
+
 void
 ApplyViewImpl::apply (OpenView& to,
     STTx const& tx, TER ter,
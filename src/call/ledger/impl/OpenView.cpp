@@ -108,6 +108,7 @@ OpenView::OpenView (open_ledger_t,
     , info_ (base->info())
     , base_ (base)
     , hold_ (std::move(hold))
+    , applyAlloc_ (applyArenaStats())
 {
     info_.validated = false;
     info_.accepted = false;
@@ -123,9 +124,29 @@ OpenView::OpenView (ReadView const* base,
     , base_ (base)
     , hold_ (std::move(hold))
     , open_ (base->open())
+    , applyAlloc_ (applyArenaStats())
 {
 }
 
+OpenView::OpenView (OpenView const& rhs)
+    : rules_ (rhs.rules_)
+    , txs_ (rhs.txs_)
+    , info_ (rhs.info_)
+    , base_ (rhs.base_)
+    , items_ (rhs.items_)
+    , hold_ (rhs.hold_)
+    , open_ (rhs.open_)
+    , applyAlloc_ (applyArenaStats())
+{
+}
+
+qalloc_stats&
+OpenView::applyArenaStats()
+{
+    static qalloc_stats stats;
+    return stats;
+}
+
 std::size_t
 OpenView::txCount() const
 {
@@ -182,6 +203,12 @@ OpenView::read (Keylet const& k) const
     return items_.read(*base_, k);
 }
 
+boost::optional<STObjectView>
+OpenView::readLazy (Keylet const& k) const
+{
+    return items_.readLazy(*base_, k);
+}
+
 auto
 OpenView::slesBegin() const ->
     std::unique_ptr<sles_type::iter_base>
@@ -347,6 +347,22 @@ RawStateTable::read (ReadView const& base,
     return sle;
 }
 
+boost::optional<STObjectView>
+RawStateTable::readLazy (ReadView const& base,
+    Keylet const& k) const
+{
+    auto const iter =
+        items_.find(k.key);
+    if (iter == items_.end())
+        return base.readLazy(k);
+    auto const& item = iter->second;
+    if (item.first == Action::erase)
+        return boost::none;
+    if (! k.check(*item.second))
+        return boost::none;
+    return STObjectView(item.second);
+}
+
 void
 RawStateTable::destroyCALL(CALLAmount const& fee)
 {
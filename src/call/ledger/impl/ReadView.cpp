@@ -185,6 +185,15 @@ ReadView::txs_type::empty() const
     return begin() == end();
 }
 
+boost::optional<STObjectView>
+ReadView::readLazy (Keylet const& k) const
+{
+    auto sle = read(k);
+    if (! sle)
+        return boost::none;
+    return STObjectView(std::move(sle));
+}
+
 auto
 ReadView::txs_type::begin() const ->
     iterator
@@ -159,13 +159,13 @@ isFrozen(ReadView const &view, AccountID const &account,
 {
     if (isCALL(currency))
         return false;
-    auto sle = view.read(keylet::account(issuer));
+    auto sle = view.readLazy(keylet::account(issuer));
     if (sle && sle->isFlag(lsfGlobalFreeze))
         return true;
     if (issuer != account)
     {
         // Check if the issuer froze the line
-        sle = view.read(keylet::line(account, issuer, currency));
+        sle = view.readLazy(keylet::line(account, issuer, currency));
         if (sle && sle->isFlag((issuer > account) ? lsfHighFreeze : lsfLowFreeze))
             return true;
     }
@@ -185,7 +185,7 @@ accountHolds(ReadView const &view,
     }
 
     // IOU: Return balance on trust line modulo freeze
-    auto const sle = view.read(keylet::line(account, issuer, currency));
+    auto const sle = view.readLazy(keylet::line(account, issuer, currency));
     if (!sle)
     {
         amount.clear({currency, issuer});
@@ -219,7 +219,7 @@ accountFunds(ReadView const &view, AccountID const &id,
 
     if (!saDefault.native() && saDefault.getIssuer() == id)
     {
-        auto sleIssueRoot = view.read(keylet::issuet(id, saDefault.getCurrency()));
+        auto sleIssueRoot = view.readLazy(keylet::issuet(id, saDefault.getCurrency()));
         if (!sleIssueRoot)
         {
             saFunds = zero;
@@ -310,8 +310,8 @@ CALLAmount
 callLiquid(ReadView const &view, AccountID const &id,
         std::int32_t ownerCountAdj, beast::Journal j)
 {
-    auto const sle = view.read(keylet::account(id));
-    if (sle == nullptr)
+    auto const sle = view.readLazy(keylet::account(id));
+    if (! sle)
         return zero;
 
     // Return balance minus reserve
@@ -367,7 +367,7 @@ void forEachItem(ReadView const &view, AccountID const &id,
     auto pos = root;
     for (;;)
     {
-        auto sle = view.read(pos);
+        auto sle = view.readLazy(pos);
         if (!sle)
             return;
         // VFALCO NOTE We aren't checking field exists?
@@ -479,7 +479,7 @@ TER accountFundCheck(ReadView const &view, AccountID const &id, STAmount const &
 
 Rate transferRate (ReadView const &view, AccountID const &issuer)
 {
-    auto const sle = view.read(keylet::account(issuer));
+    auto const sle = view.readLazy(keylet::account(issuer));
 
     if (sle && sle->isFieldPresent(sfTransferRate))
         return Rate{sle->getFieldU32(sfTransferRate)};
@@ -492,7 +492,7 @@ Rate transferRate (ReadView const &view, AccountID const &issuer)
  */
 Rate transferRate (ReadView const& view, AccountID const& issuer, Currency const& currency)
 {
-    auto const sle = view.read(keylet::issuet(issuer, currency));
+    auto const sle = view.readLazy(keylet::issuet(issuer, currency));
     if (sle)
     {
         std::uint32_t const uIssueFlags = sle->getFieldU32(sfFlags);
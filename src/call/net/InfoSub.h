@@ -41,7 +41,9 @@
 #include <call/resource/Consumer.h>
 #include <call/protocol/Book.h>
 #include <call/core/Stoppable.h>
+#include <memory>
 #include <mutex>
+#include <string>
 
 namespace call {
 
@@ -68,6 +70,36 @@ public:
     using Consumer = Resource::Consumer;
 
 public:
+    /** An event published to many subscribers.
+
+        The JSON is serialized on first use and the text is shared by
+        every subscriber the event is sent to, so a stream with many
+        clients serializes each event once. The event refers to the
+        JSON, which must outlive it.
+    */
+    class Event
+    {
+    public:
+        explicit Event (Json::Value const& jv);
+        Event (Event const&) = delete;
+        Event& operator= (Event const&) = delete;
+
+        Json::Value const&
+        json () const
+        {
+            return jv_;
+        }
+
+        /** The compact serialization of the JSON. */
+        std::shared_ptr<std::string const> const&
+        text () const;
+
+    private:
+        Json::Value const& jv_;
+        mutable std::once_flag once_;
+        mutable std::shared_ptr<std::string const> text_;
+    };
+
     /** Abstracts the source of subscription data.
     */
     class Source : public Stoppable
@@ -100,6 +132,10 @@ public:
         virtual bool subLedger (ref ispListener, Json::Value& jvResult) = 0;
         virtual bool unsubLedger (std::uint64_t uListener) = 0;
 
+        /** Subscribe to the state changes of each validated ledger. */
+        virtual bool subLedgerState (ref ispListener, bool binary) = 0;
+        virtual bool unsubLedgerState (std::uint64_t uListener) = 0;
+
         virtual bool subManifests (ref ispListener) = 0;
         virtual bool unsubManifests (std::uint64_t uListener) = 0;
         virtual void pubManifest (Manifest const&) = 0;
@@ -143,6 +179,11 @@ public:
 
     virtual void send (Json::Value const& jvObj, bool broadcast) = 0;
 
+    /** Send an event shared with other subscribers.
+        The default sends the event's JSON.
+    */
+    virtual void send (Event const& event, bool broadcast);
+
     std::uint64_t getSeq ();
 
     void onSendEmpty ();
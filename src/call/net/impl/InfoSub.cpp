@@ -58,6 +58,29 @@ InfoSub::Source::Source (char const* name, Stoppable& parent)
 
 //------------------------------------------------------------------------------
 
+InfoSub::Event::Event (Json::Value const& jv)
+    : jv_ (jv)
+{
+}
+
+std::shared_ptr<std::string const> const&
+InfoSub::Event::text () const
+{
+    std::call_once (once_, [this]
+    {
+        std::string text;
+        stream (jv_,
+            [&text](void const* data, std::size_t n)
+            {
+                text.append (static_cast<char const*> (data), n);
+            });
+        text_ = std::make_shared<std::string const> (std::move (text));
+    });
+    return text_;
+}
+
+//------------------------------------------------------------------------------
+
 InfoSub::InfoSub(Source& source)
     : m_source(source)
     , mSeq(assign_id())
@@ -76,6 +99,7 @@ InfoSub::~InfoSub ()
     m_source.unsubTransactions (mSeq);
     m_source.unsubRTTransactions (mSeq);
     m_source.unsubLedger (mSeq);
+    m_source.unsubLedgerState (mSeq);
     m_source.unsubManifests (mSeq);
     m_source.unsubServer (mSeq);
     m_source.unsubValidations (mSeq);
@@ -97,6 +121,11 @@ Resource::Consumer& InfoSub::getConsumer()
     return m_consumer;
 }
 
+void InfoSub::send (Event const& event, bool broadcast)
+{
+    send (event.json (), broadcast);
+}
+
 std::uint64_t InfoSub::getSeq ()
 {
     return mSeq;
@@ -85,7 +85,15 @@ public:
     bool
     canFetchBatch() = 0;
 
-    /** Fetch a batch synchronously. */
+    /** Fetch a batch synchronously.
+        The returned vector has one entry per key, in the same order as
+        the keys. Objects which are not found or fail to decode are
+        returned as `nullptr`.
+        @note This will be called concurrently.
+        @param n The number of keys.
+        @param keys An array of `n` pointers to key data.
+        @return The fetched objects.
+    */
     virtual
     std::vector<std::shared_ptr<NodeObject>>
     fetchBatch (std::size_t n, void const* const* keys) = 0;
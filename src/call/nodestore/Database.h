@@ -35,7 +35,7 @@
 #ifndef CALL_NODESTORE_DATABASE_H_INCLUDED
 #define CALL_NODESTORE_DATABASE_H_INCLUDED
 
-#include <call/basics/TaggedCache.h>
+#include <call/basics/PartitionedTaggedCache.h>
 #include <call/core/Stoppable.h>
 #include <call/nodestore/NodeObject.h>
 #include <call/nodestore/Backend.h>
@@ -93,6 +93,18 @@ public:
     */
     virtual std::shared_ptr<NodeObject> fetch (uint256 const& hash) = 0;
 
+    /** Fetch a group of objects.
+        Objects which are not in the cache are read from the backend
+        together, which lets backends that support it coalesce the I/O.
+
+        @note This can be called concurrently.
+        @param hashes The keys of the objects to retrieve.
+        @return One entry per key, in the same order as `hashes`, set to
+                `nullptr` for objects which couldn't be retrieved.
+    */
+    virtual std::vector<std::shared_ptr<NodeObject>>
+    fetchBatch (std::vector<uint256> const& hashes) = 0;
+
     /** Fetch an object without waiting.
         If I/O is required to determine whether or not the object is present,
         `false` is returned. Otherwise, `true` is returned and `object` is set
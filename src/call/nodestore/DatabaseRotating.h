@@ -50,7 +50,7 @@ class DatabaseRotating
 public:
     virtual ~DatabaseRotating() = default;
 
-    virtual TaggedCache <uint256, NodeObject>& getPositiveCache() = 0;
+    virtual PartitionedTaggedCache <uint256, NodeObject>& getPositiveCache() = 0;
 
     virtual std::mutex& peekMutex() const = 0;
 
@@ -0,0 +1,144 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of calld: https://github.com/callchain/calld
+    Copyright (c) 2018, 2019 Callchain Fundation.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef CALL_NODESTORE_DATABASESHARD_H_INCLUDED
+#define CALL_NODESTORE_DATABASESHARD_H_INCLUDED
+
+#include <call/basics/BasicConfig.h>
+#include <call/basics/RangeSet.h>
+#include <call/nodestore/NodeObject.h>
+#include <call/nodestore/Scheduler.h>
+#include <call/beast/utility/Journal.h>
+#include <cassert>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace call {
+namespace NodeStore {
+
+/** Historical ledger data split into shards.
+
+    Each shard holds every node of a fixed range of consecutive ledgers
+    in its own NuDB database. A shard is written until it holds all of
+    the ledgers in its range. It is then finalized, and from then on it
+    is only read.
+
+    The node store keeps serving the recent ledgers; the shards are
+    consulted by ledger sequence when it does not have a node.
+*/
+class DatabaseShard
+{
+public:
+    virtual ~DatabaseShard() = default;
+
+    /** Retrieve the name associated with this store, for diagnostics. */
+    virtual std::string getName () const = 0;
+
+    /** The number of ledgers in each shard. */
+    virtual std::uint32_t ledgersPerShard () const = 0;
+
+    /** The index of the shard holding a ledger. */
+    std::uint32_t
+    seqToShardIndex (std::uint32_t seq) const
+    {
+        assert (seq != 0);
+        return (seq - 1) / ledgersPerShard ();
+    }
+
+    /** The first ledger sequence of a shard. */
+    std::uint32_t
+    firstSeq (std::uint32_t shardIndex) const
+    {
+        return 1 + shardIndex * ledgersPerShard ();
+    }
+
+    /** The last ledger sequence of a shard. */
+    std::uint32_t
+    lastSeq (std::uint32_t shardIndex) const
+    {
+        return (shardIndex + 1) * ledgersPerShard ();
+    }
+
+    /** Fetch an object from the shard holding a ledger.
+
+        @note This can be called concurrently.
+        @param hash The key of the object to retrieve.
+        @param seq The sequence of a ledger the object appears in.
+        @return The object, or nullptr if it couldn't be retrieved.
+    */
+    virtual std::shared_ptr<NodeObject>
+    fetch (uint256 const& hash, std::uint32_t seq) = 0;
+
+    /** Store an object in the shard holding a ledger.
+        Objects for a finalized shard are ignored.
+
+        @note This can be called concurrently.
+    */
+    virtual void
+    store (NodeObjectType type, Blob&& data,
+        uint256 const& hash, std::uint32_t seq) = 0;
+
+    /** Returns `true` if every node of the ledger has been stored. */
+    virtual bool hasLedger (std::uint32_t seq) = 0;
+
+    /** Record that every node of the ledger has been stored.
+        The shard is finalized once all of its ledgers are stored.
+    */
+    virtual void setStored (std::uint32_t seq) = 0;
+
+    /** The sequences of all the ledgers held in shards. */
+    virtual RangeSet<std::uint32_t> getStored () = 0;
+
+    /** The indexes of the finalized shards, e.g. "0-4,7". */
+    virtual std::string getCompleteShards () = 0;
+
+    /** Returns the number of file handles the shards expect to need. */
+    virtual int fdlimit () const = 0;
+};
+
+/** Create a shard store from a [shard_db] section.
+
+    The section must contain `path`, the directory holding one
+    subdirectory per shard. `ledgers_per_shard` may set the size of
+    the shards; it can't change once shards have been written.
+*/
+std::unique_ptr<DatabaseShard>
+make_DatabaseShard (Section const& config,
+    Scheduler& scheduler, beast::Journal journal);
+
+}
+}
+
+#endif
@@ -0,0 +1,115 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of calld: https://github.com/callchain/calld
+    Copyright (c) 2018, 2019 Callchain Fundation.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef CALL_NODESTORE_GENERATIONALBACKEND_H_INCLUDED
+#define CALL_NODESTORE_GENERATIONALBACKEND_H_INCLUDED
+
+#include <call/basics/base_uint.h>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace call {
+namespace NodeStore {
+
+/** Backend support for deleting unreachable objects in place.
+
+    Online delete normally rotates between two backends and copies the
+    whole state tree of the validated ledger into the fresh one before
+    dropping the old one. A generational backend instead remembers the
+    ledger sequence each object was last written in and the sequence at
+    which state nodes entered or left the validated state tree, so that
+    objects no longer reachable from a retained ledger can be erased
+    directly, without visiting the live state.
+
+    Objects that never become part of a tracked state tree (transaction
+    trees, ledger headers, nodes of ledgers that were never validated)
+    are reclaimed by the sequence they were written in. A ledger is
+    written before it is validated, so the header and transaction tree
+    of each tracked ledger are tagged again with its own sequence.
+
+    Only objects stored while the backend is generational are known to
+    it; anything already in the database before is never reclaimed.
+*/
+class GenerationalBackend
+{
+public:
+    virtual ~GenerationalBackend() = default;
+
+    /** Tag objects stored from now on with the given ledger sequence. */
+    virtual
+    void
+    setGeneration (std::uint32_t seq) = 0;
+
+    /** Return the sequence of the last ledger passed to recordChanges,
+        or zero if no ledger has been tracked yet.
+    */
+    virtual
+    std::uint32_t
+    getTracked () = 0;
+
+    /** Record how the validated state tree changed.
+
+        @param seq The sequence of the newly tracked ledger.
+        @param born Nodes present in this ledger but not the last tracked.
+        @param died Nodes present in the last tracked ledger but not this.
+        @param referenced Other objects the ledger needs, its header and
+                          transaction tree, which are kept as if written
+                          at `seq`.
+    */
+    virtual
+    void
+    recordChanges (std::uint32_t seq,
+        std::vector<uint256> const& born,
+            std::vector<uint256> const& died,
+                std::vector<uint256> const& referenced) = 0;
+
+    /** Erase objects no ledger at or after `cutoff` can reach.
+
+        The work is committed in batches, so an interrupted call can
+        simply be repeated later.
+
+        @param cutoff The oldest ledger sequence that must be kept.
+        @param stop Polled between batches; return `true` to give up.
+        @return The number of objects erased.
+    */
+    virtual
+    std::uint64_t
+    erase (std::uint32_t cutoff, std::function<bool()> const& stop) = 0;
+};
+
+}
+}
+
+#endif
@@ -103,6 +103,18 @@ public:
             Section const& backendParameters,
                 beast::Journal journal) = 0;
 
+    /** Construct a NodeStore database over an already opened backend.
+
+        This lets the caller keep a view of the backend, for example to
+        use capabilities beyond the Backend interface.
+    */
+    virtual
+    std::unique_ptr <Database>
+    make_Database (std::string const& name, Scheduler& scheduler,
+        int readThreads, Stoppable& parent,
+            std::unique_ptr <Backend> backend,
+                beast::Journal journal) = 0;
+
     virtual
     std::unique_ptr <DatabaseRotating>
     make_DatabaseRotating (std::string const& name,
@@ -41,7 +41,10 @@
 #include <call/nodestore/impl/DecodedBlob.h>
 #include <call/nodestore/impl/EncodedBlob.h>
 #include <nudb/nudb.hpp>
+#include <nudb/detail/bucket.hpp>
+#include <nudb/detail/format.hpp>
 #include <boost/filesystem.hpp>
+#include <algorithm>
 #include <cassert>
 #include <chrono>
 #include <cstdio>
@@ -72,6 +75,11 @@ public:
     std::atomic <bool> deletePath_;
     Scheduler& scheduler_;
 
+    // Key file layout, used to order batch fetches by bucket
+    std::uint64_t salt_ = 0;
+    nudb::nbuck_t buckets_ = 0;
+    nudb::nbuck_t modulus_ = 0;
+
     NuDBBackend (int keyBytes, Section const& keyValues,
         Scheduler& scheduler, beast::Journal journal)
         : journal_ (journal)
@@ -103,6 +111,7 @@ public:
                 Throw<nudb::system_error>(ec);
             if (db_.appnum() != currentType)
                 Throw<std::runtime_error> ("nodestore: unknown appnum");
+            loadBucketLayout (kp);
         }
         catch (std::exception const& e)
         {
@@ -170,14 +179,61 @@ public:
     bool
     canFetchBatch() override
     {
-        return false;
+        return true;
     }
 
     std::vector<std::shared_ptr<NodeObject>>
     fetchBatch (std::size_t n, void const* const* keys) override
     {
-        Throw<std::runtime_error> ("pure virtual called");
-        return {};
+        // Visit the keys in key file order so that the
+        // bucket reads sweep the file instead of seeking.
+        std::vector<std::pair<nudb::nbuck_t, std::size_t>> order;
+        order.reserve (n);
+        for (std::size_t i = 0; i < n; ++i)
+            order.emplace_back (bucketOf (keys[i]), i);
+        std::sort (order.begin(), order.end());
+
+        std::vector<std::shared_ptr<NodeObject>> results (n);
+        for (auto const& e : order)
+        {
+            if (fetch (keys[e.second], &results[e.second]) == dataCorrupt)
+            {
+                JLOG(journal_.fatal()) <<
+                    "Corrupt NodeObject #" <<
+                        uint256::fromVoid (keys[e.second]);
+            }
+        }
+        return results;
+    }
+
+    // Returns the bucket holding `key` as of when the database was
+    // opened. Buckets split as the key file grows, so this is only
+    // an ordering hint and never affects which object is returned.
+    nudb::nbuck_t
+    bucketOf (void const* key) const
+    {
+        if (buckets_ == 0)
+            return 0;
+        return nudb::detail::bucket_index (
+            nudb::detail::hash<nudb::xxhasher> (key, keyBytes_, salt_),
+                buckets_, modulus_);
+    }
+
+    void
+    loadBucketLayout (std::string const& kp)
+    {
+        nudb::error_code ec;
+        nudb::native_file kf;
+        kf.open (nudb::file_mode::read, kp, ec);
+        if(ec)
+            Throw<nudb::system_error>(ec);
+        nudb::detail::key_file_header kh;
+        nudb::detail::read (kf, kh, ec);
+        if(ec)
+            Throw<nudb::system_error>(ec);
+        salt_ = kh.salt;
+        buckets_ = kh.buckets;
+        modulus_ = kh.modulus;
     }
 
     void
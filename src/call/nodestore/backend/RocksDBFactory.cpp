@@ -41,13 +41,16 @@
 #include <call/basics/contract.h>
 #include <call/core/Config.h> // VFALCO Bad dependency
 #include <call/nodestore/Factory.h>
+#include <call/nodestore/GenerationalBackend.h>
 #include <call/nodestore/Manager.h>
 #include <call/nodestore/impl/BatchWriter.h>
 #include <call/nodestore/impl/DecodedBlob.h>
 #include <call/nodestore/impl/EncodedBlob.h>
 #include <call/beast/core/CurrentThreadName.h>
+#include <boost/optional.hpp>
 #include <atomic>
 #include <memory>
+#include <mutex>
 
 namespace call {
 namespace NodeStore {
@@ -102,11 +105,39 @@ public:
 
 class RocksDBBackend
     : public Backend
+    , public GenerationalBackend
     , public BatchWriter::Callback
 {
 private:
     std::atomic <bool> m_deletePath;
 
+    // Key prefixes in the liveness column family, which exists only
+    // when the backend is opened with 'generational' set:
+    //
+    //  'w' seq hash    object written while seq was the generation
+    //  'd' seq hash    state node left the state tree at ledger seq
+    //  'g' hash        -> generation the object was last written in
+    //  's' hash        -> ledger the state node left the tree, 0 if live
+    //  't'             -> last ledger passed to recordChanges
+    //
+    // Sequences in keys are big-endian so that each log is ordered by
+    // sequence and a dead generation is a contiguous range.
+    static char const writtenLog = 'w';
+    static char const diedLog = 'd';
+    static char const written = 'g';
+    static char const state = 's';
+    static char const tracked = 't';
+
+    // Entries examined between commits when erasing
+    static std::size_t const eraseBatch = 1000;
+
+    rocksdb::ColumnFamilyHandle* m_liveness = nullptr;
+    std::vector <rocksdb::ColumnFamilyHandle*> m_handles;
+    std::atomic <std::uint32_t> m_generation;
+    // Makes the liveness checks and deletes of erase atomic with respect
+    // to storeBatch, so that an object stored again is never deleted.
+    std::mutex m_writeMutex;
+
 public:
     beast::Journal m_journal;
     size_t const m_keyBytes;
@@ -119,6 +150,7 @@ public:
     RocksDBBackend (int keyBytes, Section const& keyValues,
         Scheduler& scheduler, beast::Journal journal, RocksDBEnv* env)
         : m_deletePath (false)
+        , m_generation (0)
         , m_journal (journal)
         , m_keyBytes (keyBytes)
         , m_scheduler (scheduler)
@@ -187,7 +219,27 @@ public:
         options.table_factory.reset(NewBlockBasedTableFactory(table_options));
 
         rocksdb::DB* db = nullptr;
-        rocksdb::Status status = rocksdb::DB::Open (options, m_name, &db);
+        rocksdb::Status status;
+
+        if (keyValues.exists ("generational") &&
+            (get<int>(keyValues, "generational") != 0))
+        {
+            options.create_missing_column_families = true;
+
+            std::vector <rocksdb::ColumnFamilyDescriptor> families;
+            families.emplace_back (rocksdb::kDefaultColumnFamilyName, options);
+            families.emplace_back ("liveness", rocksdb::ColumnFamilyOptions ());
+
+            status = rocksdb::DB::Open (options, m_name, families,
+                &m_handles, &db);
+            if (status.ok () && db)
+                m_liveness = m_handles[1];
+        }
+        else
+        {
+            status = rocksdb::DB::Open (options, m_name, &db);
+        }
+
         if (! status.ok () || ! db)
             Throw<std::runtime_error> (
                 std::string("Unable to open/create RocksDB: ") + status.ToString());
@@ -205,6 +257,10 @@ public:
     {
         if (m_db)
         {
+            for (auto handle : m_handles)
+                delete handle;
+            m_handles.clear();
+            m_liveness = nullptr;
             m_db.reset();
             if (m_deletePath)
             {
@@ -275,14 +331,43 @@ public:
     bool
     canFetchBatch() override
     {
-        return false;
+        return true;
     }
 
     std::vector<std::shared_ptr<NodeObject>>
     fetchBatch (std::size_t n, void const* const* keys) override
     {
-        Throw<std::runtime_error> ("pure virtual called");
-        return {};
+        std::vector<rocksdb::Slice> slices;
+        slices.reserve (n);
+        for (std::size_t i = 0; i < n; ++i)
+            slices.emplace_back (static_cast <char const*> (keys[i]), m_keyBytes);
+
+        rocksdb::ReadOptions const options;
+        std::vector<std::string> values;
+        auto const statuses = m_db->MultiGet (options, slices, &values);
+
+        std::vector<std::shared_ptr<NodeObject>> results (n);
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            if (statuses[i].ok ())
+            {
+                DecodedBlob decoded (keys[i],
+                    values[i].data (), values[i].size ());
+
+                if (decoded.wasOk ())
+                    results[i] = decoded.createObject ();
+                else
+                    JLOG(m_journal.fatal()) <<
+                        "Corrupt NodeObject #" <<
+                            uint256::fromVoid (keys[i]);
+            }
+            else if (! statuses[i].IsNotFound ())
+            {
+                JLOG(m_journal.error()) << statuses[i].ToString ();
+            }
+        }
+
+        return results;
     }
 
     void
@@ -311,6 +396,27 @@ public:
 
         rocksdb::WriteOptions const options;
 
+        if (! m_liveness)
+        {
+            auto ret = m_db->Write (options, &wb);
+
+            if (! ret.ok ())
+                Throw<std::runtime_error> ("storeBatch failed: " + ret.ToString());
+            return;
+        }
+
+        std::lock_guard <std::mutex> lock (m_writeMutex);
+
+        auto const generation = m_generation.load ();
+        for (auto const& e : batch)
+        {
+            auto const& hash = e->getHash ();
+            wb.Put (m_liveness, logKey (writtenLog, generation, hash),
+                rocksdb::Slice ());
+            wb.Put (m_liveness, hashKey (written, hash),
+                encodeSeq (generation));
+        }
+
         auto ret = m_db->Write (options, &wb);
 
         if (! ret.ok ())
@@ -385,6 +491,205 @@ public:
     {
         return fdlimit_;
     }
+
+    //--------------------------------------------------------------------------
+
+    void
+    setGeneration (std::uint32_t seq) override
+    {
+        m_generation = seq;
+    }
+
+    std::uint32_t
+    getTracked () override
+    {
+        return getSeq (std::string (1, tracked)).value_or (0);
+    }
+
+    void
+    recordChanges (std::uint32_t seq,
+        std::vector<uint256> const& born,
+            std::vector<uint256> const& died,
+                std::vector<uint256> const& referenced) override
+    {
+        requireLiveness ();
+
+        rocksdb::WriteBatch wb;
+
+        // Deaths go first so that a node reported both ways stays live
+        for (auto const& hash : died)
+        {
+            wb.Put (m_liveness, logKey (diedLog, seq, hash), rocksdb::Slice ());
+            wb.Put (m_liveness, hashKey (state, hash), encodeSeq (seq));
+        }
+
+        for (auto const& hash : born)
+            wb.Put (m_liveness, hashKey (state, hash), encodeSeq (0));
+
+        wb.Put (m_liveness, std::string (1, tracked), encodeSeq (seq));
+
+        std::lock_guard <std::mutex> lock (m_writeMutex);
+
+        // The ledger was written while an earlier generation was current.
+        // Never lower the generation of an object stored again since.
+        for (auto const& hash : referenced)
+        {
+            if (getSeq (hashKey (written, hash)).value_or (0) >= seq)
+                continue;
+            wb.Put (m_liveness, logKey (writtenLog, seq, hash),
+                rocksdb::Slice ());
+            wb.Put (m_liveness, hashKey (written, hash), encodeSeq (seq));
+        }
+
+        auto ret = m_db->Write (rocksdb::WriteOptions (), &wb);
+
+        if (! ret.ok ())
+            Throw<std::runtime_error> ("recordChanges failed: " + ret.ToString());
+    }
+
+    std::uint64_t
+    erase (std::uint32_t cutoff, std::function<bool()> const& stop) override
+    {
+        requireLiveness ();
+
+        std::uint64_t erased = 0;
+
+        for (auto const prefix : { diedLog, writtenLog })
+        {
+            auto const last = logKey (prefix, cutoff, uint256 ());
+            bool more = true;
+
+            while (more)
+            {
+                if (stop ())
+                    return erased;
+
+                std::lock_guard <std::mutex> lock (m_writeMutex);
+
+                std::unique_ptr <rocksdb::Iterator> it (m_db->NewIterator (
+                    rocksdb::ReadOptions (), m_liveness));
+                rocksdb::WriteBatch wb;
+                std::size_t examined = 0;
+
+                for (it->Seek (rocksdb::Slice (&prefix, 1));
+                    it->Valid () && (it->key ().compare (last) < 0);
+                        it->Next ())
+                {
+                    if (examined++ == eraseBatch)
+                        break;
+
+                    auto const key = it->key ();
+                    auto const hash = uint256::fromVoid (key.data () + 5);
+
+                    if (isUnreachable (hash, cutoff))
+                    {
+                        wb.Delete (rocksdb::Slice (
+                            reinterpret_cast <char const*> (hash.data ()),
+                                m_keyBytes));
+                        wb.Delete (m_liveness, hashKey (written, hash));
+                        wb.Delete (m_liveness, hashKey (state, hash));
+                        ++erased;
+                    }
+
+                    wb.Delete (m_liveness, key);
+                }
+
+                more = examined > eraseBatch;
+
+                if (! it->status ().ok ())
+                    Throw<std::runtime_error> (
+                        "erase failed: " + it->status ().ToString());
+
+                auto ret = m_db->Write (rocksdb::WriteOptions (), &wb);
+
+                if (! ret.ok ())
+                    Throw<std::runtime_error> ("erase failed: " + ret.ToString());
+            }
+        }
+
+        JLOG(m_journal.debug()) << m_name << " erased " << erased <<
+            " objects before ledger " << cutoff;
+
+        return erased;
+    }
+
+private:
+    void
+    requireLiveness () const
+    {
+        if (! m_liveness)
+            LogicError ("RocksDB backend was not opened as generational");
+    }
+
+    static
+    std::string
+    encodeSeq (std::uint32_t seq)
+    {
+        std::string result (4, '\0');
+        for (int i = 3; i >= 0; --i, seq >>= 8)
+            result[i] = static_cast <char> (seq & 0xff);
+        return result;
+    }
+
+    static
+    std::string
+    hashKey (char prefix, uint256 const& hash)
+    {
+        std::string result (1, prefix);
+        result.append (reinterpret_cast <char const*> (hash.data ()),
+            hash.size ());
+        return result;
+    }
+
+    static
+    std::string
+    logKey (char prefix, std::uint32_t seq, uint256 const& hash)
+    {
+        std::string result (1, prefix);
+        result += encodeSeq (seq);
+        result.append (reinterpret_cast <char const*> (hash.data ()),
+            hash.size ());
+        return result;
+    }
+
+    boost::optional <std::uint32_t>
+    getSeq (std::string const& key)
+    {
+        if (! m_liveness)
+            return boost::none;
+
+        std::string value;
+        auto const status = m_db->Get (
+            rocksdb::ReadOptions (), m_liveness, key, &value);
+
+        if (status.IsNotFound ())
+            return boost::none;
+
+        if (! status.ok () || value.size () != 4)
+            Throw<std::runtime_error> (
+                "Corrupt liveness record: " + status.ToString ());
+
+        std::uint32_t seq = 0;
+        for (auto const c : value)
+            seq = (seq << 8) | static_cast <std::uint8_t> (c);
+        return seq;
+    }
+
+    // An object may go once it is not in the current state tree, did not
+    // leave it at or after the cutoff (so no retained ledger holds it)
+    // and was not written at or after the cutoff (so it is not part of a
+    // ledger still being built or acquired).
+    bool
+    isUnreachable (uint256 const& hash, std::uint32_t cutoff)
+    {
+        if (auto const died = getSeq (hashKey (state, hash)))
+        {
+            if (*died == 0 || *died >= cutoff)
+                return false;
+        }
+
+        return getSeq (hashKey (written, hash)).value_or (0) < cutoff;
+    }
 };
 
 //------------------------------------------------------------------------------
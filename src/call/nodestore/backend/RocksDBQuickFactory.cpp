@@ -273,7 +273,7 @@ public:
     bool
     canFetchBatch() override
     {
-        return false;
+        return true;
     }
 
     void
@@ -285,8 +285,37 @@ public:
     std::vector<std::shared_ptr<NodeObject>>
     fetchBatch (std::size_t n, void const* const* keys) override
     {
-        Throw<std::runtime_error> ("pure virtual called");
-        return {};
+        std::vector<rocksdb::Slice> slices;
+        slices.reserve (n);
+        for (std::size_t i = 0; i < n; ++i)
+            slices.emplace_back (static_cast <char const*> (keys[i]), m_keyBytes);
+
+        rocksdb::ReadOptions const options;
+        std::vector<std::string> values;
+        auto const statuses = m_db->MultiGet (options, slices, &values);
+
+        std::vector<std::shared_ptr<NodeObject>> results (n);
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            if (statuses[i].ok ())
+            {
+                DecodedBlob decoded (keys[i],
+                    values[i].data (), values[i].size ());
+
+                if (decoded.wasOk ())
+                    results[i] = decoded.createObject ();
+                else
+                    JLOG(m_journal.fatal()) <<
+                        "Corrupt NodeObject #" <<
+                            uint256::fromVoid (keys[i]);
+            }
+            else if (! statuses[i].IsNotFound ())
+            {
+                JLOG(m_journal.error()) << statuses[i].ToString ();
+            }
+        }
+
+        return results;
     }
 
     void
@@ -55,7 +55,7 @@ private:
     std::unique_ptr <Backend> m_backend;
 protected:
     // Positive cache
-    TaggedCache <uint256, NodeObject> m_cache;
+    PartitionedTaggedCache <uint256, NodeObject> m_cache;
 
     // Negative cache
     KeyCache <uint256> m_negCache;
@@ -169,6 +169,12 @@ public:
         return doTimedFetch (hash, false);
     }
 
+    std::vector<std::shared_ptr<NodeObject>>
+    fetchBatch (std::vector<uint256> const& hashes) override
+    {
+        return doTimedFetchBatch (hashes, false);
+    }
+
     /** Perform a fetch and report the time it took */
     std::shared_ptr<NodeObject> doTimedFetch (uint256 const& hash, bool isAsync)
     {
@@ -240,11 +246,124 @@ public:
         return obj;
     }
 
+    /** Perform a batch fetch and report the time it took
+
+        Cache hits are resolved individually; everything else goes
+        to the backend in a single call. The elapsed time of the
+        backend call is spread evenly over the objects it read.
+    */
+    std::vector<std::shared_ptr<NodeObject>>
+    doTimedFetchBatch (std::vector<uint256> const& hashes, bool isAsync)
+    {
+        std::vector<std::shared_ptr<NodeObject>> results (hashes.size());
+        std::vector<uint256> missing;
+        std::vector<std::size_t> slots;
+
+        FetchReport report;
+        report.isAsync = isAsync;
+        report.wentToDisk = false;
+        report.elapsed = std::chrono::milliseconds {0};
+
+        for (std::size_t i = 0; i < hashes.size(); ++i)
+        {
+            results[i] = m_cache.fetch (hashes[i]);
+
+            if (results[i] == nullptr &&
+                ! m_negCache.touch_if_exists (hashes[i]))
+            {
+                missing.push_back (hashes[i]);
+                slots.push_back (i);
+                continue;
+            }
+
+            report.wasFound = (results[i] != nullptr);
+            m_scheduler.onFetch (report);
+        }
+
+        if (missing.empty())
+            return results;
+
+        auto const before = std::chrono::steady_clock::now();
+        auto objects = fetchBatchFrom (missing);
+        m_fetchTotalCount += missing.size();
+
+        report.wentToDisk = true;
+        report.elapsed = std::chrono::duration_cast <std::chrono::milliseconds>
+            (std::chrono::steady_clock::now() - before) / missing.size();
+
+        for (std::size_t i = 0; i < missing.size(); ++i)
+        {
+            auto& obj = objects[i];
+
+            if (obj == nullptr)
+            {
+                // Just in case a write occurred
+                obj = m_cache.fetch (missing[i]);
+
+                if (obj == nullptr)
+                    m_negCache.insert (missing[i]);
+            }
+            else
+            {
+                // Ensure all threads get the same object
+                m_cache.canonicalize (missing[i], obj);
+            }
+
+            report.wasFound = (obj != nullptr);
+            m_scheduler.onFetch (report);
+
+            results[slots[i]] = std::move (obj);
+        }
+
+        JLOG(m_journal.trace()) <<
+            "HOS: batch of " << missing.size() << " fetched from db";
+
+        return results;
+    }
+
     virtual std::shared_ptr<NodeObject> fetchFrom (uint256 const& hash)
     {
         return fetchInternal (*m_backend, hash);
     }
 
+    virtual std::vector<std::shared_ptr<NodeObject>>
+    fetchBatchFrom (std::vector<uint256> const& hashes)
+    {
+        return fetchBatchInternal (*m_backend, hashes);
+    }
+
+    std::vector<std::shared_ptr<NodeObject>> fetchBatchInternal (
+        Backend& backend, std::vector<uint256> const& hashes)
+    {
+        std::vector<std::shared_ptr<NodeObject>> objects;
+
+        if (! backend.canFetchBatch ())
+        {
+            objects.reserve (hashes.size());
+            for (auto const& hash : hashes)
+                objects.push_back (fetchInternal (backend, hash));
+            return objects;
+        }
+
+        std::vector<void const*> keys;
+        keys.reserve (hashes.size());
+        for (auto const& hash : hashes)
+            keys.push_back (hash.begin ());
+
+        objects = backend.fetchBatch (keys.size(), keys.data());
+
+        for (auto const& object : objects)
+        {
+            if (object)
+            {
+                ++m_fetchHitCount;
+                m_fetchSize += object->getData().size();
+            }
+        }
+
+        return objects;
+    }
+
     std::shared_ptr<NodeObject> fetchInternal (Backend& backend,
         uint256 const& hash)
     {
@@ -340,9 +459,12 @@ public:
     void threadEntry ()
     {
         beast::setCurrentThreadName ("prefetch");
+        std::vector<uint256> hashes;
+        hashes.reserve (asyncReadBatchSize);
+
         while (1)
         {
-            uint256 hash;
+            hashes.clear ();
 
             {
                 std::unique_lock <std::mutex> lock (m_readLock);
@@ -368,13 +490,22 @@ public:
                     m_readGenCondVar.notify_all ();
                 }
 
-                hash = *it;
-                m_readSet.erase (it);
-                m_readLast = hash;
+                // Take a run of consecutive keys so the
+                // backend can service them with one request
+                while (it != m_readSet.end () &&
+                    hashes.size () < asyncReadBatchSize)
+                {
+                    hashes.push_back (*it);
+                    it = m_readSet.erase (it);
+                }
+                m_readLast = hashes.back ();
             }
 
-            // Perform the read
-            doTimedFetch (hash, true);
+            // Perform the reads
+            if (hashes.size () == 1)
+                doTimedFetch (hashes.front (), true);
+            else
+                doTimedFetchBatch (hashes, true);
          }
      }
 
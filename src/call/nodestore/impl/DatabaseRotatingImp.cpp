@@ -65,6 +65,40 @@ std::shared_ptr<NodeObject> DatabaseRotatingImp::fetchFrom (uint256 const& hash)
 
     return object;
 }
+
+std::vector<std::shared_ptr<NodeObject>> DatabaseRotatingImp::fetchBatchFrom (
+    std::vector<uint256> const& hashes)
+{
+    Backends b = getBackends();
+    auto objects = fetchBatchInternal (*b.writableBackend, hashes);
+
+    std::vector<uint256> missing;
+    std::vector<std::size_t> slots;
+    for (std::size_t i = 0; i < objects.size(); ++i)
+    {
+        if (! objects[i])
+        {
+            missing.push_back (hashes[i]);
+            slots.push_back (i);
+        }
+    }
+
+    if (missing.empty())
+        return objects;
+
+    auto archived = fetchBatchInternal (*b.archiveBackend, missing);
+    for (std::size_t i = 0; i < archived.size(); ++i)
+    {
+        if (archived[i])
+        {
+            getWritableBackend()->store (archived[i]);
+            m_negCache.erase (missing[i]);
+            objects[slots[i]] = std::move (archived[i]);
+        }
+    }
+
+    return objects;
+}
 }
 
 }
@@ -0,0 +1,220 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of calld: https://github.com/callchain/calld
+    Copyright (c) 2018, 2019 Callchain Fundation.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <call/nodestore/impl/DatabaseShardImp.h>
+#include <call/nodestore/impl/Tuning.h>
+#include <call/basics/contract.h>
+#include <call/basics/Log.h>
+#include <boost/filesystem/fstream.hpp>
+#include <algorithm>
+#include <cctype>
+
+namespace call {
+namespace NodeStore {
+
+DatabaseShardImp::DatabaseShardImp (Section const& config,
+    Scheduler& scheduler, beast::Journal journal)
+    : config_ (config)
+    , scheduler_ (scheduler)
+    , j_ (journal)
+    , dir_ (get<std::string> (config, "path"))
+    , ledgersPerShard_ (get<std::uint32_t> (
+        config, "ledgers_per_shard", ledgersPerShardDefault))
+{
+    using namespace boost::filesystem;
+
+    if (dir_.empty ())
+        Throw<std::runtime_error> (
+            "shard_db: Missing path");
+    if (ledgersPerShard_ == 0)
+        Throw<std::runtime_error> (
+            "shard_db: ledgers_per_shard must be positive");
+
+    create_directories (dir_);
+
+    // The shard size is fixed by the first run: every shard on disk
+    // was laid out with it.
+    auto const settings = dir_ / "ledgers_per_shard";
+    if (exists (settings))
+    {
+        std::uint32_t onDisk = 0;
+        ifstream in (settings);
+        in >> onDisk;
+        if (onDisk != ledgersPerShard_)
+            Throw<std::runtime_error> (
+                "shard_db: ledgers_per_shard is " +
+                    std::to_string (ledgersPerShard_) + " but the shards in " +
+                        dir_.string () + " hold " + std::to_string (onDisk));
+    }
+    else
+    {
+        ofstream out (settings);
+        out << ledgersPerShard_ << "\n";
+    }
+
+    for (auto const& entry : directory_iterator (dir_))
+    {
+        if (! is_directory (entry.status ()))
+            continue;
+
+        auto const name = entry.path ().filename ().string ();
+        if (name.empty () || ! std::all_of (name.begin (), name.end (),
+                [](unsigned char c) { return std::isdigit (c); }))
+            continue;
+
+        auto const index = std::stoul (name);
+        shards_.emplace (index, makeShard (index));
+    }
+
+    JLOG (j_.info()) <<
+        shards_.size () << " shards in " << dir_.string () <<
+            ", complete: " << getCompleteShards ();
+}
+
+std::shared_ptr<Shard>
+DatabaseShardImp::makeShard (std::uint32_t index)
+{
+    Section section (config_);
+    section.set ("type", "nudb");
+    section.set ("path", (dir_ / std::to_string (index)).string ());
+
+    auto shard = std::make_shared<Shard> (index,
+        firstSeq (index), lastSeq (index), section, scheduler_, j_);
+    shard->open ();
+    return shard;
+}
+
+std::shared_ptr<Shard>
+DatabaseShardImp::getShard (std::uint32_t seq, bool create)
+{
+    if (seq == 0)
+        return {};
+
+    auto const index = seqToShardIndex (seq);
+
+    std::lock_guard<std::mutex> lock (mutex_);
+    auto const iter = shards_.find (index);
+    if (iter != shards_.end ())
+        return iter->second;
+    if (! create)
+        return {};
+
+    auto shard = makeShard (index);
+    shards_.emplace (index, shard);
+
+    JLOG (j_.info()) <<
+        "shard " << index << ": created for ledgers " <<
+            firstSeq (index) << "-" << lastSeq (index);
+    return shard;
+}
+
+std::shared_ptr<NodeObject>
+DatabaseShardImp::fetch (uint256 const& hash, std::uint32_t seq)
+{
+    if (auto const shard = getShard (seq, false))
+        return shard->fetch (hash);
+    return {};
+}
+
+void
+DatabaseShardImp::store (NodeObjectType type, Blob&& data,
+    uint256 const& hash, std::uint32_t seq)
+{
+    if (auto const shard = getShard (seq, true))
+        shard->store (NodeObject::createObject (type, std::move (data), hash));
+}
+
+bool
+DatabaseShardImp::hasLedger (std::uint32_t seq)
+{
+    if (auto const shard = getShard (seq, false))
+        return shard->hasLedger (seq);
+    return false;
+}
+
+void
+DatabaseShardImp::setStored (std::uint32_t seq)
+{
+    if (auto const shard = getShard (seq, true))
+        shard->setStored (seq);
+}
+
+RangeSet<std::uint32_t>
+DatabaseShardImp::getStored ()
+{
+    RangeSet<std::uint32_t> result;
+    std::lock_guard<std::mutex> lock (mutex_);
+    for (auto const& shard : shards_)
+        result += shard.second->stored ();
+    return result;
+}
+
+std::string
+DatabaseShardImp::getCompleteShards ()
+{
+    RangeSet<std::uint32_t> complete;
+    std::lock_guard<std::mutex> lock (mutex_);
+    for (auto const& shard : shards_)
+        if (shard.second->complete ())
+            complete.insert (shard.first);
+    return to_string (complete);
+}
+
+int
+DatabaseShardImp::fdlimit () const
+{
+    std::lock_guard<std::mutex> lock (mutex_);
+
+    // Finalized shards open their database on first use, so
+    // assume every shard, and the next one, will be open.
+    int const perShard = 3;
+    int needed = perShard;
+    for (auto const& shard : shards_)
+        needed += std::max (perShard, shard.second->fdlimit ());
+    return needed;
+}
+
+//------------------------------------------------------------------------------
+
+std::unique_ptr<DatabaseShard>
+make_DatabaseShard (Section const& config,
+    Scheduler& scheduler, beast::Journal journal)
+{
+    return std::make_unique<DatabaseShardImp> (
+        config, scheduler, journal);
+}
+
+}
+}
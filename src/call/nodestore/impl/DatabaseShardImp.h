@@ -0,0 +1,108 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of calld: https://github.com/callchain/calld
+    Copyright (c) 2018, 2019 Callchain Fundation.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef CALL_NODESTORE_DATABASESHARDIMP_H_INCLUDED
+#define CALL_NODESTORE_DATABASESHARDIMP_H_INCLUDED
+
+#include <call/nodestore/DatabaseShard.h>
+#include <call/nodestore/impl/Shard.h>
+#include <boost/filesystem.hpp>
+#include <map>
+#include <mutex>
+
+namespace call {
+namespace NodeStore {
+
+class DatabaseShardImp : public DatabaseShard
+{
+public:
+    DatabaseShardImp (Section const& config,
+        Scheduler& scheduler, beast::Journal journal);
+
+    std::string
+    getName () const override
+    {
+        return dir_.string ();
+    }
+
+    std::uint32_t
+    ledgersPerShard () const override
+    {
+        return ledgersPerShard_;
+    }
+
+    std::shared_ptr<NodeObject>
+    fetch (uint256 const& hash, std::uint32_t seq) override;
+
+    void
+    store (NodeObjectType type, Blob&& data,
+        uint256 const& hash, std::uint32_t seq) override;
+
+    bool
+    hasLedger (std::uint32_t seq) override;
+
+    void
+    setStored (std::uint32_t seq) override;
+
+    RangeSet<std::uint32_t>
+    getStored () override;
+
+    std::string
+    getCompleteShards () override;
+
+    int
+    fdlimit () const override;
+
+private:
+    std::shared_ptr<Shard>
+    makeShard (std::uint32_t index);
+
+    // Returns the shard holding a ledger, creating it if requested
+    std::shared_ptr<Shard>
+    getShard (std::uint32_t seq, bool create);
+
+    Section const config_;
+    Scheduler& scheduler_;
+    beast::Journal j_;
+    boost::filesystem::path const dir_;
+    std::uint32_t const ledgersPerShard_;
+
+    mutable std::mutex mutex_;
+    std::map<std::uint32_t, std::shared_ptr<Shard>> shards_;
+};
+
+}
+}
+
+#endif
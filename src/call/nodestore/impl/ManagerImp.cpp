@@ -104,7 +104,7 @@ ManagerImp::make_Database (
     Section const& backendParameters,
     beast::Journal journal)
 {
-    return std::make_unique <DatabaseImp> (
+    return make_Database (
         name,
         scheduler,
         readThreads,
@@ -116,6 +116,24 @@ ManagerImp::make_Database (
         journal);
 }
 
+std::unique_ptr <Database>
+ManagerImp::make_Database (
+    std::string const& name,
+    Scheduler& scheduler,
+    int readThreads,
+    Stoppable& parent,
+    std::unique_ptr <Backend> backend,
+    beast::Journal journal)
+{
+    return std::make_unique <DatabaseImp> (
+        name,
+        scheduler,
+        readThreads,
+        parent,
+        std::move (backend),
+        journal);
+}
+
 std::unique_ptr <DatabaseRotating>
 ManagerImp::make_DatabaseRotating (
         std::string const& name,
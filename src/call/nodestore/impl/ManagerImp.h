@@ -83,6 +83,15 @@ public:
         Section const& backendParameters,
         beast::Journal journal) override;
 
+    std::unique_ptr <Database>
+    make_Database (
+        std::string const& name,
+        Scheduler& scheduler,
+        int readThreads,
+        Stoppable& parent,
+        std::unique_ptr <Backend> backend,
+        beast::Journal journal) override;
+
     std::unique_ptr <DatabaseRotating>
     make_DatabaseRotating (
         std::string const& name,
@@ -0,0 +1,304 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of calld: https://github.com/callchain/calld
+    Copyright (c) 2018, 2019 Callchain Fundation.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <call/nodestore/impl/Shard.h>
+#include <call/nodestore/impl/Tuning.h>
+#include <call/nodestore/Manager.h>
+#include <call/basics/contract.h>
+#include <call/basics/Log.h>
+#include <boost/algorithm/string.hpp>
+#include <boost/filesystem/fstream.hpp>
+#include <boost/lexical_cast.hpp>
+#include <string>
+#include <vector>
+
+namespace call {
+namespace NodeStore {
+
+Shard::Shard (std::uint32_t index, std::uint32_t firstSeq,
+    std::uint32_t lastSeq, Section const& config,
+        Scheduler& scheduler, beast::Journal journal)
+    : index_ (index)
+    , firstSeq_ (firstSeq)
+    , lastSeq_ (lastSeq)
+    , config_ (config)
+    , scheduler_ (scheduler)
+    , j_ (journal)
+    , dir_ (get<std::string> (config, "path"))
+    , control_ (dir_ / "control.txt")
+    , marker_ (dir_ / "complete")
+{
+}
+
+Shard::~Shard ()
+{
+    std::lock_guard<std::mutex> lock (mutex_);
+    try
+    {
+        if (complete_ && ! boost::filesystem::exists (marker_))
+        {
+            finalize ();
+        }
+        else if (unsaved_ && backend_)
+        {
+            backend_->close ();
+            saveControl ();
+        }
+    }
+    catch (std::exception const& e)
+    {
+        JLOG (j_.error()) <<
+            "shard " << index_ << ": " << e.what ();
+    }
+}
+
+void
+Shard::open ()
+{
+    using namespace boost::filesystem;
+
+    std::lock_guard<std::mutex> lock (mutex_);
+
+    if (exists (marker_))
+    {
+        stored_.insert (range (firstSeq_, lastSeq_));
+        complete_ = true;
+        return;
+    }
+
+    if (exists (control_))
+    {
+        // One "first-last" interval per line
+        ifstream in (control_);
+        std::string line;
+        while (std::getline (in, line))
+        {
+            boost::algorithm::trim (line);
+            if (line.empty ())
+                continue;
+
+            std::vector<std::string> bounds;
+            boost::algorithm::split (bounds, line,
+                boost::algorithm::is_any_of ("-"));
+            try
+            {
+                auto const first =
+                    boost::lexical_cast<std::uint32_t> (bounds.front ());
+                auto const last =
+                    boost::lexical_cast<std::uint32_t> (bounds.back ());
+                if (bounds.size () > 2 || first > last ||
+                        first < firstSeq_ || last > lastSeq_)
+                    Throw<std::runtime_error> ("bad range");
+                stored_.insert (range (first, last));
+            }
+            catch (std::exception const&)
+            {
+                Throw<std::runtime_error> (
+                    "shard " + std::to_string (index_) +
+                        ": invalid control file " + control_.string ());
+            }
+        }
+    }
+
+    if (boost::icl::length (stored_) == lastSeq_ - firstSeq_ + 1)
+    {
+        // Completed before the last shutdown. The database was closed
+        // or has been recovered by now, so finalize it.
+        backend_ = Manager::instance ().make_Backend (
+            config_, scheduler_, j_);
+        finalize ();
+        complete_ = true;
+        return;
+    }
+
+    backend_ = Manager::instance ().make_Backend (
+        config_, scheduler_, j_);
+}
+
+bool
+Shard::hasLedger (std::uint32_t seq) const
+{
+    if (seq < firstSeq_ || seq > lastSeq_)
+        return false;
+    if (complete_)
+        return true;
+    std::lock_guard<std::mutex> lock (mutex_);
+    return boost::icl::contains (stored_, seq);
+}
+
+RangeSet<std::uint32_t>
+Shard::stored () const
+{
+    std::lock_guard<std::mutex> lock (mutex_);
+    return stored_;
+}
+
+std::shared_ptr<Backend>
+Shard::backend ()
+{
+    std::lock_guard<std::mutex> lock (mutex_);
+    if (! backend_)
+    {
+        JLOG (j_.debug()) <<
+            "shard " << index_ << ": opening " << dir_.string ();
+        backend_ = Manager::instance ().make_Backend (
+            config_, scheduler_, j_);
+    }
+    return backend_;
+}
+
+std::shared_ptr<NodeObject>
+Shard::fetch (uint256 const& hash)
+{
+    std::shared_ptr<NodeObject> object;
+    Status const status = backend ()->fetch (hash.begin (), &object);
+
+    if (status != ok && status != notFound)
+    {
+        JLOG (j_.warn()) <<
+            "shard " << index_ << ": fetch of " << hash <<
+                " failed with status " << status;
+        return {};
+    }
+    return object;
+}
+
+void
+Shard::store (std::shared_ptr<NodeObject> const& object)
+{
+    if (complete_)
+        return;
+    backend ()->store (object);
+}
+
+bool
+Shard::setStored (std::uint32_t seq)
+{
+    assert (seq >= firstSeq_ && seq <= lastSeq_);
+
+    std::lock_guard<std::mutex> lock (mutex_);
+    if (complete_ || boost::icl::contains (stored_, seq))
+        return false;
+
+    stored_.insert (seq);
+    ++unsaved_;
+
+    if (boost::icl::length (stored_) < lastSeq_ - firstSeq_ + 1)
+    {
+        if (unsaved_ >= shardCheckpointInterval)
+            checkpoint ();
+        return false;
+    }
+
+    // No more writes. The marker is written once the database
+    // has been closed, which commits everything inserted so far.
+    complete_ = true;
+
+    JLOG (j_.info()) <<
+        "shard " << index_ << ": all ledgers stored " <<
+            firstSeq_ << "-" << lastSeq_;
+    return true;
+}
+
+void
+Shard::finalize ()
+{
+    if (backend_)
+    {
+        backend_->close ();
+        backend_.reset ();
+    }
+
+    {
+        boost::filesystem::ofstream out (marker_);
+        out << firstSeq_ << "-" << lastSeq_ << "\n";
+        if (! out)
+            Throw<std::runtime_error> (
+                "shard " + std::to_string (index_) +
+                    ": unable to write " + marker_.string ());
+    }
+    boost::system::error_code ec;
+    boost::filesystem::remove (control_, ec);
+
+    JLOG (j_.info()) <<
+        "shard " << index_ << ": finalized";
+}
+
+void
+Shard::saveControl ()
+{
+    // Write a new file and rename it over the old one so that
+    // a crash leaves either the old progress or the new one.
+    auto const temp = dir_ / "control.tmp";
+    {
+        boost::filesystem::ofstream out (temp, std::ios::trunc);
+        for (auto const& interval : stored_)
+            out << interval.first () << "-" << interval.last () << "\n";
+        if (! out)
+            Throw<std::runtime_error> (
+                "shard " + std::to_string (index_) +
+                    ": unable to write " + temp.string ());
+    }
+    boost::filesystem::rename (temp, control_);
+}
+
+void
+Shard::checkpoint ()
+{
+    // Closing the database commits everything inserted so far. Only
+    // do it when no other thread is using it; callers get the backend
+    // from backend(), under our lock, so none can start meanwhile.
+    // Otherwise the next ledger stored tries again.
+    if (! backend_ || backend_.use_count () > 1)
+        return;
+
+    backend_->close ();
+    backend_.reset ();
+    saveControl ();
+    unsaved_ = 0;
+
+    backend_ = Manager::instance ().make_Backend (
+        config_, scheduler_, j_);
+}
+
+int
+Shard::fdlimit () const
+{
+    std::lock_guard<std::mutex> lock (mutex_);
+    return backend_ ? backend_->fdlimit () : 0;
+}
+
+}
+}
@@ -0,0 +1,146 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of calld: https://github.com/callchain/calld
+    Copyright (c) 2018, 2019 Callchain Fundation.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef CALL_NODESTORE_SHARD_H_INCLUDED
+#define CALL_NODESTORE_SHARD_H_INCLUDED
+
+#include <call/basics/BasicConfig.h>
+#include <call/basics/RangeSet.h>
+#include <call/nodestore/Backend.h>
+#include <call/nodestore/Scheduler.h>
+#include <call/beast/utility/Journal.h>
+#include <boost/filesystem.hpp>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+
+namespace call {
+namespace NodeStore {
+
+/** The nodes of a range of consecutive ledgers, in one NuDB database.
+
+    Until every ledger of the range is stored, the ledgers stored so far
+    are recorded in a control file next to the database. NuDB commits
+    inserts in the background, so a ledger is only recorded there once
+    the database has been closed since it was stored; after a crash the
+    ledgers stored since are simply stored again. Once the last one is
+    stored the shard takes no more writes; when its database is next
+    closed the control file is replaced by a marker and the shard is
+    final. A finalized shard only opens its database when it is first
+    read.
+*/
+class Shard
+{
+public:
+    Shard (std::uint32_t index, std::uint32_t firstSeq,
+        std::uint32_t lastSeq, Section const& config,
+            Scheduler& scheduler, beast::Journal journal);
+
+    ~Shard ();
+
+    /** Load the progress of the shard from disk.
+        The database of an incomplete shard is opened.
+    */
+    void
+    open ();
+
+    std::uint32_t
+    index () const
+    {
+        return index_;
+    }
+
+    bool
+    complete () const
+    {
+        return complete_;
+    }
+
+    bool
+    hasLedger (std::uint32_t seq) const;
+
+    RangeSet<std::uint32_t>
+    stored () const;
+
+    std::shared_ptr<NodeObject>
+    fetch (uint256 const& hash);
+
+    void
+    store (std::shared_ptr<NodeObject> const& object);
+
+    /** Record a ledger as stored.
+        @return `true` if this completed the shard.
+    */
+    bool
+    setStored (std::uint32_t seq);
+
+    int
+    fdlimit () const;
+
+private:
+    std::shared_ptr<Backend>
+    backend ();
+
+    void
+    saveControl ();
+
+    void
+    checkpoint ();
+
+    void
+    finalize ();
+
+    std::uint32_t const index_;
+    std::uint32_t const firstSeq_;
+    std::uint32_t const lastSeq_;
+    Section config_;
+    Scheduler& scheduler_;
+    beast::Journal j_;
+    boost::filesystem::path const dir_;
+    boost::filesystem::path const control_;
+    boost::filesystem::path const marker_;
+
+    mutable std::mutex mutex_;
+    std::shared_ptr<Backend> backend_;
+    RangeSet<std::uint32_t> stored_;
+    // Ledgers in stored_ which the control file doesn't list yet
+    std::uint32_t unsaved_ = 0;
+    std::atomic<bool> complete_ {false};
+};
+
+}
+}
+
+#endif
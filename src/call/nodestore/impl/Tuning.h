@@ -48,6 +48,15 @@ enum
 
     // Fraction of the cache one query source can take
     ,asyncDivider = 8
+
+    // Maximum number of queued async reads one thread issues at once
+    ,asyncReadBatchSize = 64
+
+    // Default number of ledgers in a history shard
+    ,ledgersPerShardDefault = 16384
+
+    // Ledgers a shard stores between commits of its progress
+    ,shardCheckpointInterval = 256
 };
 
 }
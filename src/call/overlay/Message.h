@@ -42,6 +42,7 @@
 #include <cstdint>
 #include <iterator>
 #include <memory>
+#include <mutex>
 #include <type_traits>
 
 namespace call {
@@ -58,6 +59,11 @@ namespace call {
 // a string prepended by a header specifying the message length.
 // MessageType should be a Message class generated by the protobuf compiler.
 //
+// Large messages of some types may also be packed as an LZ4 compressed
+// frame, for peers that negotiated compression during the handshake. A
+// compressed frame has the high bit of the length set and its payload
+// starts with the uncompressed size.
+//
 
 class Message : public std::enable_shared_from_this <Message>
 {
@@ -69,8 +75,14 @@ public:
     */
     static size_t const kHeaderBytes = 6;
 
+    /** Bit in the first header byte marking a compressed payload. */
+    static std::uint8_t const kCompressedBit = 0x80;
+
     Message (::google::protobuf::Message const& message, int type);
 
+    Message (Message const&) = delete;
+    Message& operator= (Message const&) = delete;
+
     /** Retrieve the packed message data. */
     std::vector <uint8_t> const&
     getBuffer () const
@@ -78,6 +90,15 @@ public:
         return mBuffer;
     }
 
+    /** Retrieve the packed message data, compressed if requested.
+
+        The compressed frame is built on first use and shared by every
+        peer the message is sent to. If the message is not worth
+        compressing the uncompressed data is returned.
+    */
+    std::vector <uint8_t> const&
+    getBuffer (bool compressed) const;
+
     /** Get the traffic category */
     int
     getCategory () const
@@ -102,7 +123,7 @@ public:
                 Message::kHeaderBytes)
             return 0;
         std::size_t n;
-        n  = std::size_t{*first++} << 24;
+        n  = std::size_t{*first++ & 0x7Fu} << 24; // skip kCompressedBit
         n += std::size_t{*first++} << 16;
         n += std::size_t{*first++} <<  8;
         n += std::size_t{*first};
@@ -119,6 +140,30 @@ public:
     }
     /** @} */
 
+    /** Determine whether a packed message is compressed. */
+    /** @{ */
+    template <class FwdIter>
+    static
+    std::enable_if_t<std::is_same<typename
+        FwdIter::value_type, std::uint8_t>::value, bool>
+    compressed (FwdIter first, FwdIter last)
+    {
+        if (std::distance(first, last) <
+                Message::kHeaderBytes)
+            return false;
+        return (*first & kCompressedBit) != 0;
+    }
+
+    template <class BufferSequence>
+    static
+    bool
+    compressed (BufferSequence const& buffers)
+    {
+        return compressed(buffers_begin(buffers),
+            buffers_end(buffers));
+    }
+    /** @} */
+
     /** Determine the type of a packed message. */
     /** @{ */
     static int getType (std::vector <uint8_t> const& buf);
@@ -165,13 +210,21 @@ private:
             BufferSequence, Value>::end (buffers);
     }
 
-        // Encodes the size and type into a header at the beginning of buf
+    // Encodes the size and type into a header at the beginning of buf
+    //
+    static void encodeHeader (std::vector <uint8_t>& buf,
+        unsigned size, int type, bool compressed);
+
+    // Builds mBufferCompressed if the message is worth compressing
     //
-    void encodeHeader (unsigned size, int type);
+    void compress () const;
 
     std::vector <uint8_t> mBuffer;
+    std::vector <uint8_t> mutable mBufferCompressed;
+    std::once_flag mutable mCompressOnce;
 
     int mCategory;
+    int mType;
 };
 
 }
@@ -44,6 +44,7 @@
 #include <call/core/Stoppable.h>
 #include <call/beast/utility/PropertyStream.h>
 #include <memory>
+#include <set>
 #include <type_traits>
 #include <boost/asio/buffer.hpp>
 #include <boost/asio/ip/tcp.hpp>
@@ -83,6 +84,9 @@ public:
         bool expire = false;
         beast::IP::Address public_ip;
         int ipLimit = 0;
+        bool compression = true;
+        bool squelch = true;
+        bool txBatch = true;
     };
 
     using PeerSequence = std::vector <std::shared_ptr<Peer>>;
@@ -164,17 +168,30 @@ public:
     void
     send (protocol::TMValidation& m) = 0;
 
-    /** Relay a proposal. */
+    /** Relay a proposal.
+        Peers that squelched the validator are skipped.
+    */
     virtual
     void
     relay (protocol::TMProposeSet& m,
-        uint256 const& uid) = 0;
+        uint256 const& uid, PublicKey const& validator) = 0;
 
-    /** Relay a validation. */
+    /** Relay a validation.
+        Peers that squelched the validator are skipped.
+    */
     virtual
     void
     relay (protocol::TMValidation& m,
-        uint256 const& uid) = 0;
+        uint256 const& uid, PublicKey const& validator) = 0;
+
+    /** Relay a transaction to the peers not in toSkip.
+        Peers that accept batches receive it together with the other
+        transactions relayed around the same time.
+    */
+    virtual
+    void
+    relay (protocol::TMTransaction& m,
+        std::set<Peer::id_t> const& toSkip) = 0;
 
     /** Visit every active peer and return a value
         The functor must:
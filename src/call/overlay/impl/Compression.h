@@ -0,0 +1,120 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of calld: https://github.com/callchain/calld
+    Copyright (c) 2018, 2019 Callchain Fundation.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef CALL_OVERLAY_COMPRESSION_H_INCLUDED
+#define CALL_OVERLAY_COMPRESSION_H_INCLUDED
+
+#include <lz4/lib/lz4.h>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace call {
+
+namespace compression {
+
+/** Number of bytes used to store the uncompressed payload size. */
+std::size_t constexpr lz4PrefixBytes = 4;
+
+/** Compress a protocol message payload with LZ4.
+
+    The uncompressed size, as a four byte big endian integer, followed
+    by the LZ4 block is appended to `out`.
+
+    @return `false` if compression failed or did not make the payload
+            smaller, in which case `out` is left unchanged.
+*/
+inline
+bool
+lz4Compress (std::uint8_t const* in, std::size_t inSize,
+    std::vector <std::uint8_t>& out)
+{
+    if (inSize == 0 || inSize > LZ4_MAX_INPUT_SIZE)
+        return false;
+    auto const bound = LZ4_compressBound (static_cast<int>(inSize));
+    auto const offset = out.size ();
+    out.resize (offset + lz4PrefixBytes + bound);
+    auto p = &out[offset];
+    p[0] = static_cast<std::uint8_t> ((inSize >> 24) & 0xFF);
+    p[1] = static_cast<std::uint8_t> ((inSize >> 16) & 0xFF);
+    p[2] = static_cast<std::uint8_t> ((inSize >> 8) & 0xFF);
+    p[3] = static_cast<std::uint8_t> (inSize & 0xFF);
+    auto const n = LZ4_compress_default (
+        reinterpret_cast<char const*>(in),
+        reinterpret_cast<char*>(p + lz4PrefixBytes),
+        static_cast<int>(inSize), bound);
+    if (n <= 0 || lz4PrefixBytes + n >= inSize)
+    {
+        out.resize (offset);
+        return false;
+    }
+    out.resize (offset + lz4PrefixBytes + n);
+    return true;
+}
+
+/** Decompress a payload produced by lz4Compress.
+
+    The input comes from the network, so the decoded size is checked
+    against `maxSize` before any memory is allocated.
+
+    @return `false` if the payload is malformed.
+*/
+inline
+bool
+lz4Decompress (std::uint8_t const* in, std::size_t inSize,
+    std::vector <std::uint8_t>& out, std::size_t maxSize)
+{
+    if (inSize <= lz4PrefixBytes)
+        return false;
+    std::size_t size;
+    size  = std::size_t{in[0]} << 24;
+    size += std::size_t{in[1]} << 16;
+    size += std::size_t{in[2]} <<  8;
+    size += std::size_t{in[3]};
+    if (size == 0 || size > maxSize || size > LZ4_MAX_INPUT_SIZE)
+        return false;
+    out.resize (size);
+    auto const n = LZ4_decompress_safe (
+        reinterpret_cast<char const*>(in + lz4PrefixBytes),
+        reinterpret_cast<char*>(out.data()),
+        static_cast<int>(inSize - lz4PrefixBytes),
+        static_cast<int>(size));
+    return n >= 0 && static_cast<std::size_t>(n) == size;
+}
+
+} // compression
+
+} // call
+
+#endif
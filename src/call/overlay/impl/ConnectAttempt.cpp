@@ -226,7 +226,8 @@ ConnectAttempt::onHandshake (error_code ec)
         return close(); // makeSharedValue logs
 
     req_ = makeRequest(! overlay_.peerFinder().config().peerPrivate,
-        remote_endpoint_.address());
+        overlay_.setup().compression, overlay_.setup().squelch,
+            overlay_.setup().txBatch, remote_endpoint_.address());
     auto const hello = buildHello (
         *sharedValue,
         overlay_.setup().public_ip,
@@ -296,8 +297,8 @@ ConnectAttempt::onShutdown (error_code ec)
 //--------------------------------------------------------------------------
 
 auto
-ConnectAttempt::makeRequest (bool crawl,
-    boost::asio::ip::address const& remote_address) ->
+ConnectAttempt::makeRequest (bool crawl, bool compression, bool squelch,
+    bool txBatch, boost::asio::ip::address const& remote_address) ->
         request_type
 {
     request_type m;
@@ -310,6 +311,11 @@ ConnectAttempt::makeRequest (bool crawl,
     m.insert ("Connection", "Upgrade");
     m.insert ("Connect-As", "Peer");
     m.insert ("Crawl", crawl ? "public" : "private");
+    if (compression)
+        m.insert ("Accept-Encoding", "lz4");
+    if (squelch || txBatch)
+        m.insert ("Reduce-Relay",
+            OverlayImpl::makeReduceRelay (squelch, txBatch));
     return m;
 }
 
@@ -104,8 +104,8 @@ private:
 
     static
     request_type
-    makeRequest (bool crawl,
-        boost::asio::ip::address const& remote_address);
+    makeRequest (bool crawl, bool compression, bool squelch,
+        bool txBatch, boost::asio::ip::address const& remote_address);
 
     void processResponse();
 
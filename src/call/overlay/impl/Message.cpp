@@ -34,12 +34,15 @@
 
 #include <BeastConfig.h>
 #include <call/overlay/Message.h>
+#include <call/overlay/impl/Compression.h>
 #include <call/overlay/impl/TrafficCount.h>
+#include <call/overlay/impl/Tuning.h>
 #include <cstdint>
 
 namespace call {
 
 Message::Message (::google::protobuf::Message const& message, int type)
+    : mType (type)
 {
     unsigned const messageBytes = message.ByteSize ();
 
@@ -47,7 +50,7 @@ Message::Message (::google::protobuf::Message const& message, int type)
 
     mBuffer.resize (kHeaderBytes + messageBytes);
 
-    encodeHeader (messageBytes, type);
+    encodeHeader (mBuffer, messageBytes, type, false);
 
     if (messageBytes != 0)
     {
@@ -58,6 +61,45 @@ Message::Message (::google::protobuf::Message const& message, int type)
         (message, type, false));
 }
 
+std::vector <uint8_t> const&
+Message::getBuffer (bool compressed) const
+{
+    if (! compressed)
+        return mBuffer;
+
+    std::call_once (mCompressOnce, [this]{ compress (); });
+
+    if (mBufferCompressed.empty ())
+        return mBuffer;
+    return mBufferCompressed;
+}
+
+void Message::compress () const
+{
+    switch (mType)
+    {
+    case protocol::mtTRANSACTION:
+    case protocol::mtTRANSACTIONS:
+    case protocol::mtLEDGER_DATA:
+    case protocol::mtGET_OBJECTS:
+        break;
+    default:
+        return;
+    }
+
+    auto const messageBytes = mBuffer.size () - kHeaderBytes;
+    if (messageBytes < Tuning::compressionThreshold)
+        return;
+
+    std::vector <uint8_t> buf (kHeaderBytes);
+    if (! compression::lz4Compress (
+            &mBuffer[kHeaderBytes], messageBytes, buf))
+        return;
+
+    encodeHeader (buf, buf.size () - kHeaderBytes, mType, true);
+    mBufferCompressed = std::move (buf);
+}
+
 bool Message::operator== (Message const& other) const
 {
     return mBuffer == other.mBuffer;
@@ -69,7 +111,7 @@ unsigned Message::getLength (std::vector <uint8_t> const& buf)
 
     if (buf.size () >= Message::kHeaderBytes)
     {
-        result = buf [0];
+        result = buf [0] & ~kCompressedBit;
         result <<= 8;
         result |= buf [1];
         result <<= 8;
@@ -96,15 +138,19 @@ int Message::getType (std::vector<uint8_t> const& buf)
     return ret;
 }
 
-void Message::encodeHeader (unsigned size, int type)
+void Message::encodeHeader (std::vector <uint8_t>& buf,
+    unsigned size, int type, bool compressed)
 {
-    assert (mBuffer.size () >= Message::kHeaderBytes);
-    mBuffer[0] = static_cast<std::uint8_t> ((size >> 24) & 0xFF);
-    mBuffer[1] = static_cast<std::uint8_t> ((size >> 16) & 0xFF);
-    mBuffer[2] = static_cast<std::uint8_t> ((size >> 8) & 0xFF);
-    mBuffer[3] = static_cast<std::uint8_t> (size & 0xFF);
-    mBuffer[4] = static_cast<std::uint8_t> ((type >> 8) & 0xFF);
-    mBuffer[5] = static_cast<std::uint8_t> (type & 0xFF);
+    assert (buf.size () >= Message::kHeaderBytes);
+    assert ((size >> 24) < kCompressedBit);
+    buf[0] = static_cast<std::uint8_t> ((size >> 24) & 0xFF);
+    buf[1] = static_cast<std::uint8_t> ((size >> 16) & 0xFF);
+    buf[2] = static_cast<std::uint8_t> ((size >> 8) & 0xFF);
+    buf[3] = static_cast<std::uint8_t> (size & 0xFF);
+    buf[4] = static_cast<std::uint8_t> ((type >> 8) & 0xFF);
+    buf[5] = static_cast<std::uint8_t> (type & 0xFF);
+    if (compressed)
+        buf[0] |= kCompressedBit;
 }
 
 }
@@ -128,6 +128,9 @@ OverlayImpl::Timer::on_timer (error_code ec)
     if ((++overlay_.timer_count_ % Tuning::checkSeconds) == 0)
         overlay_.check();
 
+    if (overlay_.setup_.squelch)
+        overlay_.squelch (overlay_.slots_.expire());
+
     timer_.expires_from_now (std::chrono::seconds(1));
     timer_.async_wait(overlay_.strand_.wrap(std::bind(
         &Timer::on_timer, shared_from_this(),
@@ -159,6 +162,7 @@ OverlayImpl::OverlayImpl (
     , m_resolver (resolver)
     , next_id_(1)
     , timer_count_(0)
+    , slots_(stopwatch())
 {
     beast::PropertyStream::Source::add (m_peerFinder.get());
 }
@@ -317,6 +321,38 @@ OverlayImpl::onHandoff (std::unique_ptr <beast::asio::ssl_bundle>&& ssl_bundle,
 
 //------------------------------------------------------------------------------
 
+bool
+OverlayImpl::acceptsCompression (beast::http::fields const& headers)
+{
+    return beast::http::token_list{
+        headers["Accept-Encoding"]}.exists("lz4");
+}
+
+bool
+OverlayImpl::acceptsSquelch (beast::http::fields const& headers)
+{
+    return beast::http::token_list{
+        headers["Reduce-Relay"]}.exists("squelch");
+}
+
+bool
+OverlayImpl::acceptsTxBatch (beast::http::fields const& headers)
+{
+    return beast::http::token_list{
+        headers["Reduce-Relay"]}.exists("txbatch");
+}
+
+std::string
+OverlayImpl::makeReduceRelay (bool squelch, bool txBatch)
+{
+    std::string s;
+    if (squelch)
+        s = "squelch";
+    if (txBatch)
+        s += s.empty() ? "txbatch" : ", txbatch";
+    return s;
+}
+
 bool
 OverlayImpl::isPeerUpgrade(http_request_type const& request)
 {
@@ -596,6 +632,21 @@ OverlayImpl::onWrite (beast::PropertyStream::Map& stream)
         item["messages_out"] =
             beast::lexicalCast<std::string>
                 (i.second.messagesOut.load());
+        if (i.second.compressedBytesIn || i.second.compressedBytesOut)
+        {
+            item["compressed_bytes_in"] =
+                beast::lexicalCast<std::string>
+                    (i.second.compressedBytesIn.load());
+            item["uncompressed_bytes_in"] =
+                beast::lexicalCast<std::string>
+                    (i.second.uncompressedBytesIn.load());
+            item["compressed_bytes_out"] =
+                beast::lexicalCast<std::string>
+                    (i.second.compressedBytesOut.load());
+            item["uncompressed_bytes_out"] =
+                beast::lexicalCast<std::string>
+                    (i.second.uncompressedBytesOut.load());
+        }
     }
 }
 
@@ -633,8 +684,54 @@ OverlayImpl::activate (std::shared_ptr<PeerImp> const& peer)
 void
 OverlayImpl::onPeerDeactivate (Peer::id_t id)
 {
-    std::lock_guard <decltype(mutex_)> lock (mutex_);
-    ids_.erase(id);
+    {
+        std::lock_guard <decltype(mutex_)> lock (mutex_);
+        ids_.erase(id);
+    }
+
+    if (setup_.squelch)
+        squelch (slots_.deletePeer (id));
+}
+
+void
+OverlayImpl::updateSlots (PublicKey const& validator, PeerImp const& peer)
+{
+    if (! setup_.squelch)
+        return;
+
+    // Our own messages are never squelched, and untrusted
+    // validators are relayed by the usual rules.
+    if (! app_.validators().trusted (validator) ||
+            validator == app_.getValidationPublicKey())
+        return;
+
+    squelch (slots_.update (validator, peer.id(), peer.supportsSquelch()));
+}
+
+void
+OverlayImpl::squelch (std::vector<squelch::Slots::Action> const& actions)
+{
+    for (auto const& action : actions)
+    {
+        auto const peer = findPeerByShortID (action.peer);
+        if (! peer)
+            continue;
+
+        protocol::TMSquelch m;
+        m.set_squelch (action.duration.count() != 0);
+        m.set_validatorpubkey (
+            action.validator.data(), action.validator.size());
+        if (m.squelch())
+            m.set_squelchduration (
+                static_cast<std::uint32_t>(action.duration.count()));
+
+        JLOG(journal_.debug()) <<
+            (m.squelch() ? "Squelch " : "Unsquelch ") <<
+            toBase58 (TokenType::TOKEN_NODE_PUBLIC, action.validator) <<
+            " on peer " << action.peer;
+
+        peer->send (std::make_shared<Message> (m, protocol::mtSQUELCH));
+    }
 }
 
 void
@@ -714,9 +811,10 @@ void
 OverlayImpl::reportTraffic (
     TrafficCount::category cat,
     bool isInbound,
-    int number)
+    int number,
+    int uncompressed)
 {
-    m_traffic.addCount (cat, isInbound, number);
+    m_traffic.addCount (cat, isInbound, number, uncompressed);
 }
 
 std::size_t
@@ -908,7 +1006,7 @@ OverlayImpl::send (protocol::TMValidation& m)
 
 void
 OverlayImpl::relay (protocol::TMProposeSet& m,
-    uint256 const& uid)
+    uint256 const& uid, PublicKey const& validator)
 {
     if (m.has_hops() && m.hops() >= maxTTL)
         return;
@@ -921,6 +1019,8 @@ OverlayImpl::relay (protocol::TMProposeSet& m,
     {
         if (toSkip->find(p->id()) != toSkip->end())
             return;
+        if (p->isSquelched(validator))
+            return;
         if (! m.has_hops() || p->hopsAware())
             p->send(sm);
     });
@@ -928,7 +1028,7 @@ OverlayImpl::relay (protocol::TMProposeSet& m,
 
 void
 OverlayImpl::relay (protocol::TMValidation& m,
-    uint256 const& uid)
+    uint256 const& uid, PublicKey const& validator)
 {
     if (m.has_hops() && m.hops() >= maxTTL)
         return;
@@ -941,11 +1041,39 @@ OverlayImpl::relay (protocol::TMValidation& m,
     {
         if (toSkip->find(p->id()) != toSkip->end())
             return;
+        if (p->isSquelched(validator))
+            return;
         if (! m.has_hops() || p->hopsAware())
             p->send(sm);
     });
 }
 
+void
+OverlayImpl::relay (protocol::TMTransaction& m,
+    std::set<Peer::id_t> const& toSkip)
+{
+    std::shared_ptr<Message> sm;
+    std::shared_ptr<protocol::TMTransaction const> tx;
+    for_each([&](std::shared_ptr<PeerImp>&& p)
+    {
+        if (toSkip.find(p->id()) != toSkip.end())
+            return;
+        if (p->supportsTxBatch())
+        {
+            if (! tx)
+                tx = std::make_shared<protocol::TMTransaction const>(m);
+            p->sendTransaction(tx);
+        }
+        else
+        {
+            if (! sm)
+                sm = std::make_shared<Message>(
+                    m, protocol::mtTRANSACTION);
+            p->send(sm);
+        }
+    });
+}
+
 //------------------------------------------------------------------------------
 
 void
@@ -1038,6 +1166,9 @@ setup_Overlay (BasicConfig const& config)
     auto const& section = config.section("overlay");
     setup.context = make_SSLContext("");
     setup.expire = get<bool>(section, "expire", false);
+    setup.compression = get<bool>(section, "compression", true);
+    setup.squelch = get<bool>(section, "squelch", true);
+    setup.txBatch = get<bool>(section, "tx_batch", true);
 
     set (setup.ipLimit, "ip_limit", section);
     if (setup.ipLimit < 0)
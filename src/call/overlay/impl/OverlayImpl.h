@@ -38,6 +38,7 @@
 #include <call/app/main/Application.h>
 #include <call/core/Job.h>
 #include <call/overlay/Overlay.h>
+#include <call/overlay/impl/Squelch.h>
 #include <call/overlay/impl/TrafficCount.h>
 #include <call/server/Handoff.h>
 #include <call/rpc/ServerHandler.h>
@@ -134,6 +135,7 @@ private:
     Resolver& m_resolver;
     std::atomic <Peer::id_t> next_id_;
     int timer_count_;
+    squelch::Slots slots_;
 
     //--------------------------------------------------------------------------
 
@@ -197,11 +199,15 @@ public:
 
     void
     relay (protocol::TMProposeSet& m,
-        uint256 const& uid) override;
+        uint256 const& uid, PublicKey const& validator) override;
 
     void
     relay (protocol::TMValidation& m,
-        uint256 const& uid) override;
+        uint256 const& uid, PublicKey const& validator) override;
+
+    void
+    relay (protocol::TMTransaction& m,
+        std::set<Peer::id_t> const& toSkip) override;
 
     //--------------------------------------------------------------------------
     //
@@ -254,6 +260,13 @@ public:
     selectPeers (PeerSet& set, std::size_t limit, std::function<
         bool(std::shared_ptr<Peer> const&)> score) override;
 
+    /** Called when a peer delivers a valid message signed by a validator.
+        Selects the peers to receive the validator's messages from, and
+        squelches the rest.
+    */
+    void
+    updateSlots (PublicKey const& validator, PeerImp const& peer);
+
     // Called when TMManifests is received from a peer
     void
     onManifests (
@@ -264,6 +277,26 @@ public:
     bool
     isPeerUpgrade (http_request_type const& request);
 
+    /** Returns `true` if the handshake headers accept LZ4 messages. */
+    static
+    bool
+    acceptsCompression (beast::http::fields const& headers);
+
+    /** Returns `true` if the handshake headers accept squelches. */
+    static
+    bool
+    acceptsSquelch (beast::http::fields const& headers);
+
+    /** Returns `true` if the handshake headers accept transaction batches. */
+    static
+    bool
+    acceptsTxBatch (beast::http::fields const& headers);
+
+    /** Returns the value of the Reduce-Relay handshake header. */
+    static
+    std::string
+    makeReduceRelay (bool squelch, bool txBatch);
+
     template<class Body>
     static
     bool
@@ -314,7 +347,8 @@ public:
     reportTraffic (
         TrafficCount::category cat,
         bool isInbound,
-        int bytes);
+        int bytes,
+        int uncompressed);
 
 private:
     std::shared_ptr<Writer>
@@ -390,6 +424,10 @@ private:
 
     void
     sendEndpoints();
+
+    // Send squelches, and lift them, as the slots decided
+    void
+    squelch (std::vector<squelch::Slots::Action> const& actions);
 };
 
 } // call
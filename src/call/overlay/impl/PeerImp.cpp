@@ -39,6 +39,7 @@
 #include <call/app/ledger/InboundLedgers.h>
 #include <call/app/ledger/LedgerMaster.h>
 #include <call/app/ledger/InboundTransactions.h>
+#include <call/app/misc/BatchVerifier.h>
 #include <call/app/misc/HashRouter.h>
 #include <call/app/misc/LoadFeeTrack.h>
 #include <call/app/misc/NetworkOPs.h>
@@ -78,6 +79,7 @@ PeerImp::PeerImp (Application& app, id_t id, endpoint_type remote_endpoint,
     , stream_ (ssl_bundle_->stream)
     , strand_ (socket_.get_io_service())
     , timer_ (socket_.get_io_service())
+    , txBatchTimer_ (socket_.get_io_service())
     , remote_address_ (
         beast::IPAddressConversion::from_asio(remote_endpoint))
     , overlay_ (overlay)
@@ -93,6 +95,13 @@ PeerImp::PeerImp (Application& app, id_t id, endpoint_type remote_endpoint,
     , slot_ (slot)
     , request_(std::move(request))
     , headers_(request_)
+    , compressionEnabled_(overlay.setup().compression &&
+        OverlayImpl::acceptsCompression(headers_))
+    , squelchEnabled_(overlay.setup().squelch &&
+        OverlayImpl::acceptsSquelch(headers_))
+    , squelch_(stopwatch())
+    , txBatchEnabled_(overlay.setup().txBatch &&
+        OverlayImpl::acceptsTxBatch(headers_))
 {
 }
 
@@ -200,7 +209,8 @@ PeerImp::send (Message::pointer const& m)
 
     overlay_.reportTraffic (
         static_cast<TrafficCount::category>(m->getCategory()),
-        false, static_cast<int>(m->getBuffer().size()));
+        false, static_cast<int>(m->getBuffer(compressionEnabled_).size()),
+        static_cast<int>(m->getBuffer().size()));
 
     auto sendq_size = send_queue_.size();
 
@@ -224,10 +234,53 @@ PeerImp::send (Message::pointer const& m)
         return;
 
     boost::asio::async_write (stream_, boost::asio::buffer(
-        send_queue_.front()->getBuffer()), strand_.wrap(std::bind(
-            &PeerImp::onWriteMessage, shared_from_this(),
-                std::placeholders::_1,
-                    std::placeholders::_2)));
+        send_queue_.front()->getBuffer(compressionEnabled_)),
+            strand_.wrap(std::bind(
+                &PeerImp::onWriteMessage, shared_from_this(),
+                    std::placeholders::_1,
+                        std::placeholders::_2)));
+}
+
+void
+PeerImp::sendTransaction (
+    std::shared_ptr<protocol::TMTransaction const> const& m)
+{
+    if (! strand_.running_in_this_thread())
+        return strand_.post(std::bind (
+            &PeerImp::sendTransaction, shared_from_this(), m));
+    if(gracefulClose_)
+        return;
+    if(detaching_)
+        return;
+
+    auto const action = txBatch_.add (m);
+
+    if (action == txbatch::Batch::Action::send)
+        return flushTransactions();
+
+    if (action == txbatch::Batch::Action::none)
+        return;
+
+    error_code ec;
+    txBatchTimer_.expires_from_now (std::chrono::milliseconds(
+        Tuning::txBatchMilliseconds), ec);
+
+    if (ec)
+    {
+        JLOG(journal_.error()) << "sendTransaction: " << ec.message();
+        txBatch_.expired();
+        return flushTransactions();
+    }
+    txBatchTimer_.async_wait(strand_.wrap(std::bind(
+        &PeerImp::onTxBatchTimer, shared_from_this(),
+            std::placeholders::_1)));
+}
+
+void
+PeerImp::flushTransactions()
+{
+    if (auto const m = txBatch_.take())
+        send (m);
 }
 
 void
@@ -428,6 +481,8 @@ PeerImp::close()
         detaching_ = true; // DEPRECATED
         error_code ec;
         timer_.cancel(ec);
+        // Any transactions waiting in txBatch_ are dropped
+        txBatchTimer_.cancel(ec);
         socket_.close(ec);
         if(m_inbound)
         {
@@ -473,6 +528,9 @@ PeerImp::gracefulClose()
     assert(strand_.running_in_this_thread());
     assert(socket_.is_open());
     assert(! gracefulClose_);
+    // Transactions waiting to be batched go out before the
+    // shutdown. A hard close() drops them.
+    flushTransactions();
     gracefulClose_ = true;
 #if 0
     // Flush messages
@@ -577,6 +635,26 @@ PeerImp::onTimer (error_code const& ec)
     setTimer();
 }
 
+void
+PeerImp::onTxBatchTimer (error_code const& ec)
+{
+    txBatch_.expired();
+
+    if (! socket_.is_open())
+        return;
+
+    if (ec == boost::asio::error::operation_aborted)
+        return;
+
+    if (ec)
+    {
+        JLOG(journal_.error()) << "onTxBatchTimer: " << ec.message();
+        return close();
+    }
+
+    flushTransactions();
+}
+
 void
 PeerImp::onShutdown(error_code ec)
 {
@@ -665,6 +743,11 @@ PeerImp::makeResponse (bool crawl,
     resp.insert("Connect-As", "Peer");
     resp.insert("Server", BuildInfo::getFullVersionString());
     resp.insert("Crawl", crawl ? "public" : "private");
+    if (compressionEnabled_)
+        resp.insert("Accept-Encoding", "lz4");
+    if (squelchEnabled_ || txBatchEnabled_)
+        resp.insert("Reduce-Relay", OverlayImpl::makeReduceRelay(
+            squelchEnabled_, txBatchEnabled_));
     protocol::TMHello hello = buildHello(sharedValue,
         overlay_.setup().public_ip, remote, app_);
     appendHello(resp, hello);
@@ -757,7 +840,7 @@ PeerImp::onReadMessage (error_code ec, std::size_t bytes_transferred)
     {
         std::size_t bytes_consumed;
         std::tie(bytes_consumed, ec) = invokeProtocolMessage(
-            read_buffer_.data(), *this);
+            read_buffer_.data(), *this, compressionEnabled_);
         if (ec)
             return fail("onReadMessage", ec);
         if (! stream_.next_layer().is_open())
@@ -799,10 +882,11 @@ PeerImp::onWriteMessage (error_code ec, std::size_t bytes_transferred)
     {
         // Timeout on writes only
         return boost::asio::async_write (stream_, boost::asio::buffer(
-            send_queue_.front()->getBuffer()), strand_.wrap(std::bind(
-                &PeerImp::onWriteMessage, shared_from_this(),
-                    std::placeholders::_1,
-                        std::placeholders::_2)));
+            send_queue_.front()->getBuffer(compressionEnabled_)),
+                strand_.wrap(std::bind(
+                    &PeerImp::onWriteMessage, shared_from_this(),
+                        std::placeholders::_1,
+                            std::placeholders::_2)));
     }
 
     if (gracefulClose_)
@@ -830,13 +914,13 @@ PeerImp::onMessageUnknown (std::uint16_t type)
 PeerImp::error_code
 PeerImp::onMessageBegin (std::uint16_t type,
     std::shared_ptr <::google::protobuf::Message> const& m,
-    std::size_t size)
+    std::size_t size, std::size_t uncompressedSize)
 {
     load_event_ = app_.getJobQueue ().makeLoadEvent (
         jtPEER, protocolMessageName(type));
     fee_ = Resource::feeLightPeer;
     overlay_.reportTraffic (TrafficCount::categorize (*m, type, true),
-        true, static_cast<int>(size));
+        true, static_cast<int>(size), static_cast<int>(uncompressedSize));
     return error_code{};
 }
 
@@ -1117,14 +1201,25 @@ PeerImp::onMessage (std::shared_ptr <protocol::TMTransaction> const& m)
         }
         else
         {
-            app_.getJobQueue ().addJob (
-                jtTRANSACTION, "recvTransaction->checkTransaction",
-                [weak = std::weak_ptr<PeerImp>(shared_from_this()),
-                flags, checkSignature, stx] (Job&) {
-                    if (auto peer = weak.lock())
-                        peer->checkTransaction(flags,
-                            checkSignature, stx);
-                });
+            auto check = [&app = app_,
+                weak = std::weak_ptr<PeerImp>(shared_from_this()),
+                flags, checkSignature, stx] ()
+            {
+                app.getJobQueue ().addJob (
+                    jtTRANSACTION, "recvTransaction->checkTransaction",
+                    [weak, flags, checkSignature, stx] (Job&) {
+                        if (auto peer = weak.lock())
+                            peer->checkTransaction(flags,
+                                checkSignature, stx);
+                    });
+            };
+
+            // Verify the signature together with others that
+            // arrive around the same time, if we check it at all.
+            if (checkSignature)
+                app_.getBatchVerifier ().add (stx, std::move (check));
+            else
+                check ();
         }
     }
     catch (std::exception const&)
@@ -1258,6 +1353,7 @@ PeerImp::onMessage (std::shared_ptr <protocol::TMProposeSet> const& m)
     if (! app_.getHashRouter ().addSuppressionPeer (suppression, id_))
     {
         JLOG(p_journal_.trace()) << "Proposal: duplicate";
+        overlay_.updateSlots (publicKey, *this);
         return;
     }
 
@@ -1595,6 +1691,7 @@ PeerImp::onMessage (std::shared_ptr <protocol::TMValidation> const& m)
             sha512Half(makeSlice(m->validation())), id_))
         {
             JLOG(p_journal_.trace()) << "Validation: duplicate";
+            overlay_.updateSlots (val->getSignerPublic(), *this);
             return;
         }
 
@@ -1763,6 +1860,69 @@ PeerImp::onMessage (std::shared_ptr <protocol::TMGetObjectByHash> const& m)
     }
 }
 
+void
+PeerImp::onMessage (std::shared_ptr <protocol::TMTransactions> const& m)
+{
+    // Handle each transaction, and charge for it, as if it
+    // had arrived in its own message.
+    auto const accepted = txbatch::unpack (*m, txBatchEnabled_,
+        [this](std::shared_ptr<protocol::TMTransaction> const& tx)
+        {
+            onMessage (tx);
+        },
+        [this]()
+        {
+            charge (fee_);
+            if (! socket_.is_open())
+                return false;
+            fee_ = Resource::feeLightPeer;
+            return true;
+        });
+
+    if (! accepted)
+    {
+        JLOG(p_journal_.warn()) << "Transactions: rejected";
+        fee_ = Resource::feeInvalidRequest;
+    }
+}
+
+void
+PeerImp::onMessage (std::shared_ptr <protocol::TMSquelch> const& m)
+{
+    if (! squelchEnabled_)
+    {
+        JLOG(p_journal_.debug()) << "Squelch: not negotiated";
+        return;
+    }
+
+    Slice const key = makeSlice (m->validatorpubkey());
+    if (! publicKeyType (key))
+    {
+        JLOG(p_journal_.warn()) << "Squelch: malformed";
+        fee_ = Resource::feeBadData;
+        return;
+    }
+
+    PublicKey const validator (key);
+
+    // We always relay our own messages
+    if (validator == app_.getValidationPublicKey())
+        return;
+
+    if (! m->squelch())
+    {
+        squelch_.remove (validator);
+        return;
+    }
+
+    if (! squelch_.add (validator,
+            std::chrono::seconds{m->squelchduration()}))
+    {
+        JLOG(p_journal_.warn()) << "Squelch: bad duration";
+        fee_ = Resource::feeBadData;
+    }
+}
+
 //--------------------------------------------------------------------------
 
 void
@@ -1914,6 +2074,7 @@ PeerImp::checkPropose (Job& job,
 
     if (isTrusted)
     {
+        overlay_.updateSlots (peerPos.publicKey(), *this);
         app_.getOPs ().processTrustedProposal (
             peerPos, packet, calcNodeID (publicKey_));
     }
@@ -1924,7 +2085,8 @@ PeerImp::checkPropose (Job& job,
             // relay untrusted proposal
             JLOG(p_journal_.trace()) <<
                 "relaying UNTRUSTED proposal";
-            overlay_.relay(set, peerPos.suppressionID());
+            overlay_.relay(set, peerPos.suppressionID(),
+                peerPos.publicKey());
         }
         else
         {
@@ -1950,9 +2112,12 @@ PeerImp::checkValidation (STValidation::pointer val,
             return;
         }
 
+        if (isTrusted)
+            overlay_.updateSlots (val->getSignerPublic(), *this);
+
         if (app_.getOPs ().recvValidation(
                 val, std::to_string(id())))
-            overlay_.relay(*packet, signingHash);
+            overlay_.relay(*packet, signingHash, val->getSignerPublic());
     }
     catch (std::exception const&)
     {
@@ -2288,19 +2453,20 @@ PeerImp::getLedger (std::shared_ptr<protocol::TMGetLedger> const& m)
         }
 
         std::vector<SHAMapNodeID> nodeIDs;
-        std::vector< Blob > rawNodes;
+        std::vector<std::shared_ptr<Blob>> rawNodes;
 
         try
         {
             // We are guaranteed that map is non-null, but we need to check
             // to keep the compiler happy.
-            if (map && map->getNodeFat (mn, nodeIDs, rawNodes, fatLeaves, depth))
+            if (map && map->getNodeFat (mn, nodeIDs, rawNodes, fatLeaves,
+                depth, app_.getWireNodeCache ()))
             {
                 assert (nodeIDs.size () == rawNodes.size ());
                 JLOG(p_journal_.trace()) <<
                     "GetLedger: getNodeFat got " << rawNodes.size () << " nodes";
                 std::vector<SHAMapNodeID>::iterator nodeIDIterator;
-                std::vector< Blob >::iterator rawNodeIterator;
+                std::vector<std::shared_ptr<Blob>>::iterator rawNodeIterator;
 
                 for (nodeIDIterator = nodeIDs.begin (),
                         rawNodeIterator = rawNodes.begin ();
@@ -2311,8 +2477,8 @@ PeerImp::getLedger (std::shared_ptr<protocol::TMGetLedger> const& m)
                     nodeIDIterator->addIDRaw (nID);
                     protocol::TMLedgerNode* node = reply.add_nodes ();
                     node->set_nodeid (nID.getDataPtr (), nID.getLength ());
-                    node->set_nodedata (&rawNodeIterator->front (),
-                        rawNodeIterator->size ());
+                    node->set_nodedata ((*rawNodeIterator)->data (),
+                        (*rawNodeIterator)->size ());
                 }
             }
             else
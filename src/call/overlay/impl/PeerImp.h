@@ -41,6 +41,8 @@
 #include <call/beast/utility/WrappedSink.h>
 #include <call/overlay/impl/ProtocolMessage.h>
 #include <call/overlay/impl/OverlayImpl.h>
+#include <call/overlay/impl/Squelch.h>
+#include <call/overlay/impl/TxBatch.h>
 #include <call/protocol/Protocol.h>
 #include <call/protocol/STTx.h>
 #include <call/protocol/STValidation.h>
@@ -116,6 +118,8 @@ private:
     boost::asio::io_service::strand strand_;
     boost::asio::basic_waitable_timer<
         std::chrono::steady_clock> timer_;
+    boost::asio::basic_waitable_timer<
+        std::chrono::steady_clock> txBatchTimer_;
 
     //Type type_ = Type::legacy;
 
@@ -160,6 +164,11 @@ private:
     http_request_type request_;
     http_response_type response_;
     beast::http::fields const& headers_;
+    bool const compressionEnabled_;
+    bool const squelchEnabled_;
+    squelch::Squelch squelch_;
+    bool const txBatchEnabled_;
+    txbatch::Batch txBatch_;
     beast::multi_buffer write_buffer_;
     std::queue<Message::pointer> send_queue_;
     bool gracefulClose_ = false;
@@ -222,6 +231,13 @@ public:
     void
     send (Message::pointer const& m) override;
 
+    /** Relay a transaction, batched with others if the peer accepts
+        TMTransactions.
+    */
+    void
+    sendTransaction (
+        std::shared_ptr<protocol::TMTransaction const> const& m);
+
     /** Send a set of PeerFinder endpoints as a protocol message. */
     template <class FwdIt, class = typename std::enable_if_t<std::is_same<
         typename std::iterator_traits<FwdIt>::value_type,
@@ -263,6 +279,29 @@ public:
         return hopsAware_;
     }
 
+    /** Returns `true` if the peer understands squelches. */
+    bool
+    supportsSquelch() const
+    {
+        return squelchEnabled_;
+    }
+
+    /** Returns `true` if the peer accepts batched transactions. */
+    bool
+    supportsTxBatch() const
+    {
+        return txBatchEnabled_;
+    }
+
+    /** Returns `true` if the peer asked us not to relay the
+        validator's messages.
+    */
+    bool
+    isSquelched (PublicKey const& validator)
+    {
+        return squelchEnabled_ && squelch_.squelched (validator);
+    }
+
     void
     check();
 
@@ -361,6 +400,14 @@ private:
     void
     onShutdown (error_code ec);
 
+    // Send the transactions waiting to be relayed
+    void
+    flushTransactions();
+
+    // Called when the transaction batch wait completes
+    void
+    onTxBatchTimer (error_code const& ec);
+
     void
     doAccept();
 
@@ -409,7 +456,7 @@ public:
     error_code
     onMessageBegin (std::uint16_t type,
         std::shared_ptr <::google::protobuf::Message> const& m,
-        std::size_t size);
+        std::size_t size, std::size_t uncompressedSize);
 
     void
     onMessageEnd (std::uint16_t type,
@@ -423,6 +470,7 @@ public:
     void onMessage (std::shared_ptr <protocol::TMPeers> const& m);
     void onMessage (std::shared_ptr <protocol::TMEndpoints> const& m);
     void onMessage (std::shared_ptr <protocol::TMTransaction> const& m);
+    void onMessage (std::shared_ptr <protocol::TMTransactions> const& m);
     void onMessage (std::shared_ptr <protocol::TMGetLedger> const& m);
     void onMessage (std::shared_ptr <protocol::TMLedgerData> const& m);
     void onMessage (std::shared_ptr <protocol::TMProposeSet> const& m);
@@ -430,6 +478,7 @@ public:
     void onMessage (std::shared_ptr <protocol::TMHaveTransactionSet> const& m);
     void onMessage (std::shared_ptr <protocol::TMValidation> const& m);
     void onMessage (std::shared_ptr <protocol::TMGetObjectByHash> const& m);
+    void onMessage (std::shared_ptr <protocol::TMSquelch> const& m);
 
 private:
     State state() const
@@ -494,6 +543,7 @@ PeerImp::PeerImp (Application& app, std::unique_ptr<beast::asio::ssl_bundle>&& s
     , stream_ (ssl_bundle_->stream)
     , strand_ (socket_.get_io_service())
     , timer_ (socket_.get_io_service())
+    , txBatchTimer_ (socket_.get_io_service())
     , remote_address_ (slot->remote_endpoint())
     , overlay_ (overlay)
     , m_inbound (false)
@@ -508,6 +558,13 @@ PeerImp::PeerImp (Application& app, std::unique_ptr<beast::asio::ssl_bundle>&& s
     , slot_ (std::move(slot))
     , response_(std::move(response))
     , headers_(response_)
+    , compressionEnabled_(overlay.setup().compression &&
+        OverlayImpl::acceptsCompression(headers_))
+    , squelchEnabled_(overlay.setup().squelch &&
+        OverlayImpl::acceptsSquelch(headers_))
+    , squelch_(stopwatch())
+    , txBatchEnabled_(overlay.setup().txBatch &&
+        OverlayImpl::acceptsTxBatch(headers_))
 {
     read_buffer_.commit (boost::asio::buffer_copy(read_buffer_.prepare(
         boost::asio::buffer_size(buffers)), buffers));
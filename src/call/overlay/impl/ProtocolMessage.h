@@ -37,12 +37,16 @@
 
 #include "call.pb.h"
 #include <call/overlay/Message.h>
+#include <call/overlay/impl/Compression.h>
+#include <call/overlay/impl/Tuning.h>
 #include <call/overlay/impl/ZeroCopyStream.h>
 #include <boost/asio/buffer.hpp>
 #include <boost/asio/buffers_iterator.hpp>
 #include <boost/system/error_code.hpp>
+#include <algorithm>
 #include <cassert>
 #include <cstdint>
+#include <cstring>
 #include <memory>
 #include <type_traits>
 #include <vector>
@@ -63,8 +67,10 @@ protocolMessageName (int type)
     case protocol::mtCLUSTER:           return "cluster";
     case protocol::mtGET_PEERS:         return "get_peers";
     case protocol::mtPEERS:             return "peers";
+    case protocol::mtSQUELCH:           return "squelch";
     case protocol::mtENDPOINTS:         return "endpoints";
     case protocol::mtTRANSACTION:       return "tx";
+    case protocol::mtTRANSACTIONS:      return "txs";
     case protocol::mtGET_LEDGER:        return "get_ledger";
     case protocol::mtLEDGER_DATA:       return "ledger_data";
     case protocol::mtPROPOSE_LEDGER:    return "propose";
@@ -80,6 +86,29 @@ protocolMessageName (int type)
 
 namespace detail {
 
+// Decompresses the payload of a compressed message into out
+template <class Buffers>
+bool
+decompress (Buffers const& buffers, std::vector<std::uint8_t>& out)
+{
+    std::vector<std::uint8_t> in (Message::size (buffers));
+    ZeroCopyInputStream<Buffers> stream(buffers);
+    stream.Skip(Message::kHeaderBytes);
+    std::size_t copied = 0;
+    void const* data;
+    int size;
+    while (copied < in.size() && stream.Next(&data, &size))
+    {
+        auto const n = std::min<std::size_t>(size, in.size() - copied);
+        std::memcpy(&in[copied], data, n);
+        copied += n;
+    }
+    if (copied != in.size())
+        return false;
+    return compression::lz4Decompress (in.data(), in.size(),
+        out, Tuning::maxDecompressedBytes);
+}
+
 template <class T, class Buffers, class Handler>
 std::enable_if_t<std::is_base_of<
     ::google::protobuf::Message, T>::value,
@@ -87,14 +116,28 @@ std::enable_if_t<std::is_base_of<
 invoke (int type, Buffers const& buffers,
     Handler& handler)
 {
-    ZeroCopyInputStream<Buffers> stream(buffers);
-    stream.Skip(Message::kHeaderBytes);
     auto const m (std::make_shared<T>());
-    if (! m->ParseFromZeroCopyStream(&stream))
-        return boost::system::errc::make_error_code(
-            boost::system::errc::invalid_argument);
+    auto const size = Message::kHeaderBytes + Message::size (buffers);
+    auto uncompressedSize = size;
+    if (Message::compressed (buffers))
+    {
+        std::vector<std::uint8_t> payload;
+        if (! decompress (buffers, payload) ||
+                ! m->ParseFromArray(payload.data(), payload.size()))
+            return boost::system::errc::make_error_code(
+                boost::system::errc::invalid_argument);
+        uncompressedSize = Message::kHeaderBytes + payload.size();
+    }
+    else
+    {
+        ZeroCopyInputStream<Buffers> stream(buffers);
+        stream.Skip(Message::kHeaderBytes);
+        if (! m->ParseFromZeroCopyStream(&stream))
+            return boost::system::errc::make_error_code(
+                boost::system::errc::invalid_argument);
+    }
     auto ec = handler.onMessageBegin (type, m,
-       Message::kHeaderBytes + Message::size (buffers));
+       size, uncompressedSize);
     if (! ec)
     {
         handler.onMessage (m);
@@ -110,11 +153,16 @@ invoke (int type, Buffers const& buffers,
     If there is insufficient data to produce a complete protocol
     message, zero is returned for the number of bytes consumed.
 
+    @param compressionEnabled Whether compression was negotiated with
+                              the peer. If not, compressed messages
+                              are rejected without being decompressed.
+
     @return The number of bytes consumed, or the error code if any.
 */
 template <class Buffers, class Handler>
 std::pair <std::size_t, boost::system::error_code>
-invokeProtocolMessage (Buffers const& buffers, Handler& handler)
+invokeProtocolMessage (Buffers const& buffers, Handler& handler,
+    bool compressionEnabled)
 {
     std::pair<std::size_t,boost::system::error_code> result = { 0, {} };
     boost::system::error_code& ec = result.second;
@@ -126,6 +174,13 @@ invokeProtocolMessage (Buffers const& buffers, Handler& handler)
     if (boost::asio::buffer_size(buffers) < size)
         return result;
 
+    if (Message::compressed (buffers) && ! compressionEnabled)
+    {
+        ec = boost::system::errc::make_error_code(
+            boost::system::errc::invalid_argument);
+        return result;
+    }
+
     switch (type)
     {
     case protocol::mtHELLO:         ec = detail::invoke<protocol::TMHello> (type, buffers, handler); break;
@@ -134,8 +189,10 @@ invokeProtocolMessage (Buffers const& buffers, Handler& handler)
     case protocol::mtCLUSTER:       ec = detail::invoke<protocol::TMCluster> (type, buffers, handler); break;
     case protocol::mtGET_PEERS:     ec = detail::invoke<protocol::TMGetPeers> (type, buffers, handler); break;
     case protocol::mtPEERS:         ec = detail::invoke<protocol::TMPeers> (type, buffers, handler); break;
+    case protocol::mtSQUELCH:       ec = detail::invoke<protocol::TMSquelch> (type, buffers, handler); break;
     case protocol::mtENDPOINTS:     ec = detail::invoke<protocol::TMEndpoints> (type, buffers, handler); break;
     case protocol::mtTRANSACTION:   ec = detail::invoke<protocol::TMTransaction> (type, buffers, handler); break;
+    case protocol::mtTRANSACTIONS:  ec = detail::invoke<protocol::TMTransactions> (type, buffers, handler); break;
     case protocol::mtGET_LEDGER:    ec = detail::invoke<protocol::TMGetLedger> (type, buffers, handler); break;
     case protocol::mtLEDGER_DATA:   ec = detail::invoke<protocol::TMLedgerData> (type, buffers, handler); break;
     case protocol::mtPROPOSE_LEDGER:ec = detail::invoke<protocol::TMProposeSet> (type, buffers, handler); break;
@@ -0,0 +1,236 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of calld: https://github.com/callchain/calld
+    Copyright (c) 2018, 2019 Callchain Fundation.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <call/overlay/impl/Squelch.h>
+#include <call/overlay/impl/Tuning.h>
+#include <call/basics/random.h>
+#include <algorithm>
+
+namespace call {
+namespace squelch {
+
+Squelch::Squelch (Stopwatch& clock)
+    : clock_ (clock)
+{
+}
+
+bool
+Squelch::add (PublicKey const& validator, std::chrono::seconds duration)
+{
+    if (duration <= std::chrono::seconds{0} ||
+            duration > std::chrono::seconds{Tuning::maxSquelchSeconds})
+        return false;
+
+    std::lock_guard<std::mutex> lock (mutex_);
+    squelched_[validator] = clock_.now() + duration;
+    return true;
+}
+
+void
+Squelch::remove (PublicKey const& validator)
+{
+    std::lock_guard<std::mutex> lock (mutex_);
+    squelched_.erase (validator);
+}
+
+bool
+Squelch::squelched (PublicKey const& validator)
+{
+    std::lock_guard<std::mutex> lock (mutex_);
+    auto const it = squelched_.find (validator);
+    if (it == squelched_.end())
+        return false;
+    if (it->second > clock_.now())
+        return true;
+    squelched_.erase (it);
+    return false;
+}
+
+//------------------------------------------------------------------------------
+
+Slots::Slots (Stopwatch& clock)
+    : clock_ (clock)
+{
+}
+
+bool
+Slots::isSelected (Slot const& slot, id_t peer)
+{
+    return std::find (slot.selected.begin(), slot.selected.end(), peer) !=
+        slot.selected.end();
+}
+
+auto
+Slots::update (PublicKey const& validator, id_t peer, bool canSquelch) ->
+    std::vector<Action>
+{
+    using namespace std::chrono;
+
+    std::vector<Action> actions;
+    auto const now = clock_.now();
+
+    std::lock_guard<std::mutex> lock (mutex_);
+    auto& slot = slots_[validator];
+    auto& info = slot.peers[peer];
+    slot.last = now;
+    info.last = now;
+    info.canSquelch = canSquelch;
+
+    if (slot.reselect)
+    {
+        // A peer that joined, or ignored us, since the sources were
+        // chosen. Squelch it for the rest of the round.
+        if (canSquelch && ! info.squelched && ! isSelected (slot, peer))
+        {
+            info.squelched = true;
+            actions.push_back ({validator, peer, std::max (seconds{1},
+                duration_cast<seconds> (*slot.reselect - now))});
+        }
+        return actions;
+    }
+
+    if (++info.count == Tuning::squelchMessageThreshold)
+    {
+        slot.selected.push_back (peer);
+        if (slot.selected.size() == Tuning::squelchMaxSelected)
+            select (validator, slot, actions);
+    }
+    return actions;
+}
+
+void
+Slots::select (PublicKey const& validator, Slot& slot,
+    std::vector<Action>& actions)
+{
+    std::chrono::seconds const duration {rand_int (
+        int{Tuning::minSquelchSeconds}, int{Tuning::maxSquelchSeconds})};
+
+    slot.reselect = clock_.now() + duration;
+    for (auto& p : slot.peers)
+    {
+        if (p.second.canSquelch && ! isSelected (slot, p.first))
+        {
+            p.second.squelched = true;
+            actions.push_back ({validator, p.first, duration});
+        }
+    }
+}
+
+void
+Slots::reset (PublicKey const& validator, Slot& slot, bool lift,
+    std::vector<Action>& actions)
+{
+    for (auto& p : slot.peers)
+    {
+        if (lift && p.second.squelched)
+            actions.push_back ({validator, p.first, std::chrono::seconds{0}});
+        p.second.squelched = false;
+        p.second.count = 0;
+    }
+    slot.selected.clear();
+    slot.reselect = boost::none;
+}
+
+auto
+Slots::deletePeer (id_t peer) -> std::vector<Action>
+{
+    std::vector<Action> actions;
+
+    std::lock_guard<std::mutex> lock (mutex_);
+    for (auto& s : slots_)
+    {
+        auto& slot = s.second;
+        if (slot.peers.erase (peer) == 0)
+            continue;
+
+        auto const it = std::find (
+            slot.selected.begin(), slot.selected.end(), peer);
+        if (it == slot.selected.end())
+            continue;
+
+        if (slot.reselect)
+            reset (s.first, slot, true, actions);
+        else
+            slot.selected.erase (it);
+    }
+    return actions;
+}
+
+auto
+Slots::expire () -> std::vector<Action>
+{
+    using namespace std::chrono;
+
+    std::vector<Action> actions;
+    auto const now = clock_.now();
+
+    std::lock_guard<std::mutex> lock (mutex_);
+    for (auto it = slots_.begin(); it != slots_.end();)
+    {
+        auto& slot = it->second;
+        if (now - slot.last > seconds{Tuning::squelchSlotIdleSeconds})
+        {
+            reset (it->first, slot, true, actions);
+            it = slots_.erase (it);
+            continue;
+        }
+
+        if (slot.reselect)
+        {
+            if (now >= *slot.reselect)
+            {
+                // The peers lift their squelches themselves
+                reset (it->first, slot, false, actions);
+            }
+            else
+            {
+                auto const behind = std::any_of (
+                    slot.selected.begin(), slot.selected.end(),
+                    [&](id_t id)
+                    {
+                        return slot.last - slot.peers[id].last >
+                            seconds{Tuning::squelchIdleSeconds};
+                    });
+                if (behind)
+                    reset (it->first, slot, true, actions);
+            }
+        }
+        ++it;
+    }
+    return actions;
+}
+
+} // squelch
+} // call
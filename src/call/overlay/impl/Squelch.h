@@ -0,0 +1,173 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of calld: https://github.com/callchain/calld
+    Copyright (c) 2018, 2019 Callchain Fundation.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef CALL_OVERLAY_SQUELCH_H_INCLUDED
+#define CALL_OVERLAY_SQUELCH_H_INCLUDED
+
+#include <call/basics/chrono.h>
+#include <call/protocol/PublicKey.h>
+#include <boost/optional.hpp>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <vector>
+
+namespace call {
+namespace squelch {
+
+/** The validators a peer asked us not to relay messages from.
+
+    Each squelch lasts until it runs out or the peer lifts it.
+*/
+class Squelch
+{
+public:
+    explicit
+    Squelch (Stopwatch& clock);
+
+    /** Stop relaying the validator's messages for a while.
+
+        @return `false` if the duration is out of bounds.
+    */
+    bool
+    add (PublicKey const& validator, std::chrono::seconds duration);
+
+    /** Resume relaying the validator's messages. */
+    void
+    remove (PublicKey const& validator);
+
+    /** Returns `true` if the validator's messages must not be relayed. */
+    bool
+    squelched (PublicKey const& validator);
+
+private:
+    Stopwatch& clock_;
+    std::mutex mutex_;
+    std::map<PublicKey, Stopwatch::time_point> squelched_;
+};
+
+//------------------------------------------------------------------------------
+
+/** Chooses the peers we receive each validator's messages from.
+
+    Every delivery of a validator's proposal or validation by a peer,
+    first or duplicate, is counted. The first peers to deliver enough
+    messages are selected as sources, and the other peers are asked to
+    stop relaying that validator's messages to us for a random time.
+    When that time is up the counting starts over, so the sources
+    rotate. If a source falls behind or disconnects, the squelches are
+    lifted at once.
+
+    The functions return the squelches to send, so the caller can send
+    them without holding the lock.
+*/
+class Slots
+{
+public:
+    using id_t = std::uint32_t;
+
+    /** A squelch to send to a peer. A zero duration lifts it. */
+    struct Action
+    {
+        PublicKey validator;
+        id_t peer;
+        std::chrono::seconds duration;
+    };
+
+    explicit
+    Slots (Stopwatch& clock);
+
+    /** Record that a peer delivered a message signed by a validator.
+
+        @param canSquelch Whether the peer understands squelches.
+    */
+    std::vector<Action>
+    update (PublicKey const& validator, id_t peer, bool canSquelch);
+
+    /** Forget a peer that disconnected. */
+    std::vector<Action>
+    deletePeer (id_t peer);
+
+    /** Rotate the sources of squelches that ran out and forget idle
+        validators. Called periodically.
+    */
+    std::vector<Action>
+    expire ();
+
+private:
+    struct PeerInfo
+    {
+        std::size_t count = 0;
+        Stopwatch::time_point last;
+        bool canSquelch = false;
+        bool squelched = false;
+    };
+
+    struct Slot
+    {
+        std::map<id_t, PeerInfo> peers;
+
+        // The first peers to reach the threshold, in order
+        std::vector<id_t> selected;
+
+        Stopwatch::time_point last;
+
+        // When the squelches run out, if any were sent
+        boost::optional<Stopwatch::time_point> reselect;
+    };
+
+    static
+    bool
+    isSelected (Slot const& slot, id_t peer);
+
+    void
+    select (PublicKey const& validator, Slot& slot,
+        std::vector<Action>& actions);
+
+    // Start counting again, lifting the squelches if `lift` is set
+    static
+    void
+    reset (PublicKey const& validator, Slot& slot, bool lift,
+        std::vector<Action>& actions);
+
+    Stopwatch& clock_;
+    std::mutex mutex_;
+    std::map<PublicKey, Slot> slots_;
+};
+
+} // squelch
+} // call
+
+#endif
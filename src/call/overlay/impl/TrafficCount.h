@@ -58,8 +58,17 @@ public:
         count_t messagesIn;
         count_t messagesOut;
 
+        // Bytes on the wire, and before compression, of the
+        // messages that were sent or received compressed
+        count_t compressedBytesIn;
+        count_t compressedBytesOut;
+        count_t uncompressedBytesIn;
+        count_t uncompressedBytesOut;
+
         TrafficStats() : bytesIn(0), bytesOut(0),
-            messagesIn(0), messagesOut(0)
+            messagesIn(0), messagesOut(0),
+            compressedBytesIn(0), compressedBytesOut(0),
+            uncompressedBytesIn(0), uncompressedBytesOut(0)
         { ; }
 
         TrafficStats(const TrafficStats& ts)
@@ -67,6 +76,10 @@ public:
             , bytesOut (ts.bytesOut.load())
             , messagesIn (ts.messagesIn.load())
             , messagesOut (ts.messagesOut.load())
+            , compressedBytesIn (ts.compressedBytesIn.load())
+            , compressedBytesOut (ts.compressedBytesOut.load())
+            , uncompressedBytesIn (ts.uncompressedBytesIn.load())
+            , uncompressedBytesOut (ts.uncompressedBytesOut.load())
         { ; }
 
         operator bool () const
@@ -96,17 +109,35 @@ public:
         ::google::protobuf::Message const& message,
         int type, bool inbound);
 
-    void addCount (category cat, bool inbound, int number)
+    /** Account for a message.
+
+        @param number The size of the message on the wire.
+        @param uncompressed The size of the message before compression,
+                            equal to `number` if it was not compressed.
+    */
+    void addCount (category cat, bool inbound, int number,
+        int uncompressed)
     {
+        auto& stats = counts_[cat];
         if (inbound)
         {
-            counts_[cat].bytesIn += number;
-            ++counts_[cat].messagesIn;
+            stats.bytesIn += number;
+            ++stats.messagesIn;
+            if (number != uncompressed)
+            {
+                stats.compressedBytesIn += number;
+                stats.uncompressedBytesIn += uncompressed;
+            }
         }
         else
         {
-            counts_[cat].bytesOut += number;
-            ++counts_[cat].messagesOut;
+            stats.bytesOut += number;
+            ++stats.messagesOut;
+            if (number != uncompressed)
+            {
+                stats.compressedBytesOut += number;
+                stats.uncompressedBytesOut += uncompressed;
+            }
         }
     }
 
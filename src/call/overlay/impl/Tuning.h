@@ -89,6 +89,43 @@ enum
 
     /** How often to log send queue size */
     sendQueueLogFreq    =    64,
+
+    /** Smallest message payload we try to compress */
+    compressionThreshold =  256,
+
+    /** Largest payload we accept after decompressing a message */
+    maxDecompressedBytes = 64 * 1024 * 1024,
+
+    /** How many peers we keep receiving a validator's messages from
+        when the others are squelched */
+    squelchMaxSelected  =    5,
+
+    /** How many of a validator's messages a peer must deliver before
+        it can be selected as a source */
+    squelchMessageThreshold = 20,
+
+    /** Bounds on how long peers are squelched (seconds) */
+    minSquelchSeconds   =  300,
+    maxSquelchSeconds   =  600,
+
+    /** How long a selected source may fall behind the others before
+        the squelches are lifted (seconds) */
+    squelchIdleSeconds  =    8,
+
+    /** How long without a message before we forget a validator's
+        sources (seconds) */
+    squelchSlotIdleSeconds = 300,
+
+    /** How long a transaction may wait to be relayed together with
+        others (milliseconds) */
+    txBatchMilliseconds =   20,
+
+    /** Payload size at which a batch of transactions is sent
+        without waiting */
+    txBatchMaxBytes     = 64 * 1024,
+
+    /** Most transactions we send, or accept, in one message */
+    txBatchMaxCount     =  256,
 };
 
 } // Tuning
@@ -0,0 +1,108 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of calld: https://github.com/callchain/calld
+    Copyright (c) 2018, 2019 Callchain Fundation.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <call/overlay/impl/TxBatch.h>
+#include <call/overlay/impl/Tuning.h>
+
+namespace call {
+namespace txbatch {
+
+auto
+Batch::add (std::shared_ptr<protocol::TMTransaction const> const& tx) ->
+    Action
+{
+    txs_.push_back (tx);
+    bytes_ += tx->ByteSize();
+
+    if (txs_.size() >= Tuning::txBatchMaxCount ||
+            bytes_ >= Tuning::txBatchMaxBytes)
+        return Action::send;
+
+    if (waiting_)
+        return Action::none;
+
+    waiting_ = true;
+    return Action::wait;
+}
+
+std::shared_ptr<Message>
+Batch::take ()
+{
+    std::shared_ptr<Message> m;
+
+    if (txs_.size() == 1)
+    {
+        m = std::make_shared<Message> (
+            *txs_.front(), protocol::mtTRANSACTION);
+    }
+    else if (! txs_.empty())
+    {
+        protocol::TMTransactions batch;
+        for (auto const& tx : txs_)
+            *batch.add_transactions() = *tx;
+        m = std::make_shared<Message> (
+            batch, protocol::mtTRANSACTIONS);
+    }
+
+    txs_.clear();
+    bytes_ = 0;
+    return m;
+}
+
+bool
+unpack (protocol::TMTransactions& batch, bool negotiated,
+    std::function<void (std::shared_ptr<protocol::TMTransaction> const&)>
+        const& handle,
+    std::function<bool ()> const& next)
+{
+    if (! negotiated)
+        return false;
+
+    if (batch.transactions_size() > Tuning::txBatchMaxCount)
+        return false;
+
+    for (int i = 0; i < batch.transactions_size(); ++i)
+    {
+        if (i != 0 && ! next ())
+            break;
+        handle (std::make_shared<protocol::TMTransaction> (
+            std::move (*batch.mutable_transactions(i))));
+    }
+
+    return true;
+}
+
+} // txbatch
+} // call
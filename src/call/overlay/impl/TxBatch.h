@@ -0,0 +1,121 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of calld: https://github.com/callchain/calld
+    Copyright (c) 2018, 2019 Callchain Fundation.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef CALL_OVERLAY_TXBATCH_H_INCLUDED
+#define CALL_OVERLAY_TXBATCH_H_INCLUDED
+
+#include <call/overlay/Message.h>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace call {
+namespace txbatch {
+
+/** The transactions waiting to be relayed to a peer together.
+
+    A batch is sent once Tuning::txBatchMilliseconds have passed since
+    its first transaction was added, or at once when it reaches
+    Tuning::txBatchMaxCount transactions or Tuning::txBatchMaxBytes.
+    The caller owns the timer; the batch tracks whether it is running.
+*/
+class Batch
+{
+public:
+    enum class Action
+    {
+        none,   // the timer is already running
+        wait,   // start the timer
+        send    // send the batch now
+    };
+
+    /** Add a transaction and return what the caller must do next. */
+    Action
+    add (std::shared_ptr<protocol::TMTransaction const> const& tx);
+
+    /** Note that the timer completed or could not be started. */
+    void
+    expired ()
+    {
+        waiting_ = false;
+    }
+
+    /** Returns the message holding the waiting transactions.
+
+        A single transaction is sent as a TMTransaction, several as a
+        TMTransactions. The batch is left empty.
+
+        @return `nullptr` if there are no transactions.
+    */
+    std::shared_ptr<Message>
+    take ();
+
+    std::size_t
+    size () const
+    {
+        return txs_.size();
+    }
+
+    std::size_t
+    bytes () const
+    {
+        return bytes_;
+    }
+
+private:
+    std::vector<std::shared_ptr<protocol::TMTransaction const>> txs_;
+    std::size_t bytes_ = 0;
+    bool waiting_ = false;
+};
+
+/** Handle each transaction of a received batch as if it arrived alone.
+
+    @param negotiated Whether the peer may send batches.
+    @param handle Called with each transaction.
+    @param next Called between two transactions, to charge for the
+                first. Returning `false` stops the batch.
+    @return `false` if the batch is rejected, in which case none of
+            its transactions are handled.
+*/
+bool
+unpack (protocol::TMTransactions& batch, bool negotiated,
+    std::function<void (std::shared_ptr<protocol::TMTransaction> const&)>
+        const& handle,
+    std::function<bool ()> const& next);
+
+} // txbatch
+} // call
+
+#endif
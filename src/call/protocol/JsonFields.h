@@ -98,6 +98,9 @@ JSS ( alternatives );               // out: PathRequest, CallPathFind
 JSS ( amendment_blocked );          // out: NetworkOPs
 JSS ( amendments );                 // in: AccountObjects, out: NetworkOPs
 JSS ( amount );                     // out: AccountChannels
+JSS ( apply_arena_allocs );         // out: GetCounts
+JSS ( apply_arena_blocks );         // out: GetCounts
+JSS ( apply_arena_kb );             // out: GetCounts
 JSS ( asks );                       // out: Subscribe
 JSS ( assets );                     // out: GatewayBalances
 JSS ( authorized );                 // out: AccountLines
@@ -123,6 +126,7 @@ JSS ( channel_id );                 // out: AccountChannels
 JSS ( channels );                   // out: AccountChannels
 JSS ( check_nodes );                // in: LedgerCleaner
 JSS ( clear );                      // in/out: FetchInfo
+JSS ( client_io_latency_ms );       // out: NetworkOPs
 JSS ( close_flags );                // out: LedgerToJson
 JSS ( close_time );                 // in: Application, out: NetworkOPs,
                                     //      RCLCxPeerPos, LedgerToJson
@@ -138,10 +142,12 @@ JSS ( code );                       // out: errors
 JSS ( command );                    // in: RPCHandler
 JSS ( complete );                   // out: NetworkOPs, InboundLedger
 JSS ( complete_ledgers );           // out: NetworkOPs, PeerImp
+JSS ( complete_shards );            // out: NetworkOPs
 JSS ( consensus );                  // out: NetworkOPs, LedgerConsensus
 JSS ( converge_time );              // out: NetworkOPs
 JSS ( converge_time_s );            // out: NetworkOPs
 JSS ( count );                      // in: AccountTx*, ValidatorList
+JSS ( created );                    // out: StateDiff
 JSS ( currency );                   // in: paths/PathRequest, STAmount
                                     // out: paths/Node, STPathSet, STAmount
 JSS ( current );                    // out: OwnerInfo
@@ -153,6 +159,7 @@ JSS ( dbKBLedger );                 // out: getCounts
 JSS ( dbKBTotal );                  // out: getCounts
 JSS ( dbKBTransaction );            // out: getCounts
 JSS ( debug_signing );              // in: TransactionSign
+JSS ( deleted );                    // out: StateDiff
 JSS ( delivered_amount );           // out: addPaymentDeliveredAmount
 JSS ( deprecated );                 // out: WalletSeed
 JSS ( descending );                 // in: AccountTx*
@@ -303,6 +310,7 @@ JSS ( min_ledger );                 // in: LedgerCleaner
 JSS ( minimum_fee );                // out: TxQ
 JSS ( minimum_level );              // out: TxQ
 JSS ( missingCommand );             // error
+JSS ( modified );                   // out: StateDiff
 JSS ( name );                       // out: AmendmentTableImpl, PeerImp
 JSS ( needed_state_hashes );        // out: InboundLedger
 JSS ( needed_transaction_hashes );  // out: InboundLedger
@@ -341,6 +349,7 @@ JSS ( payment_channel );            // in: LedgerEntry
 JSS ( peer );                       // in: AccountLines
 JSS ( peer_authorized );            // out: AccountLines
 JSS ( peer_id );                    // out: RCLCxPeerPos
+JSS ( peer_io_latency_ms );         // out: NetworkOPs
 JSS ( peers );                      // out: InboundLedger, handlers/Peers, Overlay
 JSS ( port );                       // in: Connect
 JSS ( previous_ledger );            // out: LedgerPropose
@@ -443,6 +452,7 @@ JSS ( transactions );               // out: LedgerToJson,
                                     // in: AccountTx*, Unsubscribe
 JSS ( transitions );                // out: NetworkOPs
 JSS ( treenode_cache_size );        // out: GetCounts
+JSS ( treenode_kb_saved );          // out: GetCounts
 JSS ( treenode_track_size );        // out: GetCounts
 JSS ( trusted );                    // out: UnlList
 JSS ( trusted_validator_keys );     // out: ValidatorList
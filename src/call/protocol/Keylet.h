@@ -65,6 +65,10 @@ struct Keylet
     /** Returns true if the SLE matches the type */
     bool
     check (STLedgerEntry const&) const;
+
+    /** Returns true if an entry of the given type matches */
+    bool
+    check (LedgerEntryType type) const;
 };
 
 }
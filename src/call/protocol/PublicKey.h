@@ -46,6 +46,7 @@
 #include <cstring>
 #include <ostream>
 #include <utility>
+#include <vector>
 
 namespace call {
 
@@ -257,6 +258,26 @@ verify (PublicKey const& publicKey,
     Slice const& sig,
     bool mustBeFullyCanonical = true);
 
+/** A signature on a message, to be verified as part of a batch. */
+struct SignedMessage
+{
+    PublicKey publicKey;
+    Slice message;
+    Slice signature;
+    bool mustBeFullyCanonical;
+};
+
+/** Verify several signatures at once.
+    Ed25519 signatures are checked together. When a batch fails, its
+    items are checked individually; when it passes, each signature is
+    still confirmed with verify, since the batch equation accepts some
+    signatures verify rejects. Other signatures are always checked
+    individually.
+    @return The result of verify for each item, in the same order.
+*/
+std::vector<bool>
+verifyBatch (std::vector<SignedMessage> const& items);
+
 /** Calculate the 160-bit node ID from a node public key. */
 NodeID
 calcNodeID (PublicKey const&);
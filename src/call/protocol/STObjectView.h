@@ -0,0 +1,234 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of calld: https://github.com/callchain/calld
+    Copyright (c) 2018, 2019 Callchain Fundation.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef CALL_PROTOCOL_STOBJECTVIEW_H_INCLUDED
+#define CALL_PROTOCOL_STOBJECTVIEW_H_INCLUDED
+
+#include <call/basics/Slice.h>
+#include <call/protocol/STAccount.h>
+#include <call/protocol/STBitString.h>
+#include <call/protocol/STBlob.h>
+#include <call/protocol/STInteger.h>
+#include <call/protocol/STObject.h>
+#include <boost/optional.hpp>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace call {
+
+/** A read-only, lazily parsed view of a serialized object.
+
+    Deserializing an STObject builds every field, even when the caller
+    only wants one or two of them. A view instead keeps the serialized
+    bytes, indexes where each field starts the first time a field is
+    asked for, and deserializes only the fields that are read.
+
+    A view can also wrap an object which is already deserialized, for
+    example an entry modified in an open ledger; the accessors then
+    simply forward to it.
+
+    Accessors follow the rules of the corresponding STObject members:
+    an absent field from the template yields a default value, a field
+    outside the template throws. The bytes are trusted to be a valid
+    object, as they are for entries of a ledger's state map, and are
+    not checked against the template.
+
+    @note A view is cheap to copy, but not safe to use from several
+          threads at once.
+*/
+class STObjectView
+{
+public:
+    /** Create a view of serialized bytes.
+
+        @param data The serialized fields, without an end of object marker.
+        @param owner Keeps the bytes alive for the life of the view.
+        @param type The template of the object, if known.
+    */
+    STObjectView (Slice data, std::shared_ptr<void const> owner,
+        SOTemplate const* type = nullptr);
+
+    /** Create a view of a deserialized object. */
+    STObjectView (std::shared_ptr<STObject const> object);
+
+    /** Set the template used to tell absent fields from unknown ones. */
+    void
+    setTemplate (SOTemplate const& type)
+    {
+        type_ = &type;
+    }
+
+    bool isFieldPresent (SField const& field) const;
+
+    std::uint32_t getFlags () const;
+
+    bool
+    isFlag (std::uint32_t f) const
+    {
+        return (getFlags () & f) == f;
+    }
+
+    unsigned char getFieldU8 (SField const& field) const;
+    std::uint16_t getFieldU16 (SField const& field) const;
+    std::uint32_t getFieldU32 (SField const& field) const;
+    std::uint64_t getFieldU64 (SField const& field) const;
+    uint128 getFieldH128 (SField const& field) const;
+    uint160 getFieldH160 (SField const& field) const;
+    uint256 getFieldH256 (SField const& field) const;
+    AccountID getAccountID (SField const& field) const;
+    Blob getFieldVL (SField const& field) const;
+    STAmount getFieldAmount (SField const& field) const;
+    STVector256 getFieldV256 (SField const& field) const;
+
+    /** Return the value of a field, as STObject::operator[] does.
+
+        Throws if the field is optional and absent.
+    */
+    template <class T>
+    std::decay_t<typename T::value_type>
+    operator[] (TypedField<T> const& f) const;
+
+    /** Return the value of a field, or boost::none if it is absent. */
+    template <class T>
+    boost::optional<std::decay_t<typename T::value_type>>
+    operator[] (OptionaledField<T> const& of) const;
+
+private:
+    struct Entry
+    {
+        int code;
+        std::uint32_t offset;
+        std::uint32_t size;
+    };
+
+    // Bytes of a field's value, or boost::none if it is absent
+    boost::optional<Slice>
+    find (SField const& field) const;
+
+    void
+    buildIndex () const;
+
+    // Throws missing_field_error unless an absent field may default
+    void
+    requireKnown (SField const& field) const;
+
+    template <class T, class V = typename T::value_type>
+    V
+    getFieldByValue (SField const& field) const
+    {
+        static_assert (! std::is_reference<V>::value, "");
+
+        auto const data = find (field);
+        if (! data)
+        {
+            if (type_ && type_->getIndex (field) == -1)
+                Throw<std::runtime_error> ("Field not found");
+            return V ();
+        }
+        SerialIter sit (*data);
+        return T (sit, field).value ();
+    }
+
+    template <class T>
+    T
+    getFieldObject (SField const& field) const
+    {
+        auto const data = find (field);
+        if (! data)
+        {
+            if (type_ && type_->getIndex (field) == -1)
+                Throw<std::runtime_error> ("Field not found");
+            return T ();
+        }
+        SerialIter sit (*data);
+        return T (sit, field);
+    }
+
+    std::shared_ptr<STObject const> object_;
+    std::shared_ptr<void const> owner_;
+    Slice data_;
+    SOTemplate const* type_ = nullptr;
+    mutable std::vector<Entry> index_;
+    mutable bool indexed_ = false;
+};
+
+//------------------------------------------------------------------------------
+
+template <class T>
+std::decay_t<typename T::value_type>
+STObjectView::operator[] (TypedField<T> const& f) const
+{
+    static_assert (! std::is_same<T, STBlob>::value,
+        "use getFieldVL: a blob value would refer to a temporary");
+
+    if (object_)
+        return (*object_)[f];
+
+    auto const data = find (f);
+    if (! data)
+    {
+        requireKnown (f);
+        return std::decay_t<typename T::value_type>{};
+    }
+    SerialIter sit (*data);
+    return T (sit, f).value ();
+}
+
+template <class T>
+boost::optional<std::decay_t<typename T::value_type>>
+STObjectView::operator[] (OptionaledField<T> const& of) const
+{
+    static_assert (! std::is_same<T, STBlob>::value,
+        "use getFieldVL: a blob value would refer to a temporary");
+
+    if (object_)
+        return (*object_)[of];
+
+    auto const data = find (*of.f);
+    if (! data)
+    {
+        if (! type_ || type_->getIndex (*of.f) == -1 ||
+                type_->style (*of.f) == SOE_OPTIONAL)
+            return boost::none;
+        return std::decay_t<typename T::value_type>{};
+    }
+    SerialIter sit (*data);
+    return T (sit, *of.f).value ();
+}
+
+} // call
+
+#endif
@@ -172,6 +172,17 @@ private:
 
 bool passesLocalChecks (STObject const& st, std::string&);
 
+/** Check the signatures of several transactions.
+
+    Single-signed Ed25519 transactions are verified together, the rest
+    one at a time.
+
+    @return The result of STTx::checkSign for each transaction, in order.
+*/
+std::vector<std::pair<bool, std::string>>
+checkSignBatch (std::vector<std::shared_ptr<STTx const>> const& txs,
+    bool allowMultiSign);
+
 /** Sterilize a transaction.
 
     The transaction is serialized and then deserialized,
@@ -40,6 +40,12 @@ namespace call {
 
 bool
 Keylet::check (SLE const& sle) const
+{
+    return check (sle.getType());
+}
+
+bool
+Keylet::check (LedgerEntryType entryType) const
 {
     if (type == ltANY)
         return true;
@@ -47,11 +53,11 @@ Keylet::check (SLE const& sle) const
         return false;
     if (type == ltCHILD)
     {
-        assert(sle.getType() != ltDIR_NODE);
-        return sle.getType() != ltDIR_NODE;
+        assert(entryType != ltDIR_NODE);
+        return entryType != ltDIR_NODE;
     }
-    assert(sle.getType() == type);
-    return sle.getType() == type;
+    assert(entryType == type);
+    return entryType == type;
 }
 
 } // call
@@ -319,6 +319,60 @@ verify (PublicKey const& publicKey,
     return false;
 }
 
+std::vector<bool>
+verifyBatch (std::vector<SignedMessage> const& items)
+{
+    std::vector<bool> result (items.size(), false);
+
+    // The Ed25519 signatures, in the form the batch API wants them
+    std::vector<std::size_t> index;
+    std::vector<unsigned char const*> m;
+    std::vector<std::size_t> mlen;
+    std::vector<unsigned char const*> pk;
+    std::vector<unsigned char const*> rs;
+
+    for (std::size_t i = 0; i < items.size(); ++i)
+    {
+        auto const& item = items[i];
+
+        if (publicKeyType(item.publicKey) != KeyType::ed25519)
+        {
+            result[i] = verify (item.publicKey, item.message,
+                item.signature, item.mustBeFullyCanonical);
+        }
+        else if (ed25519Canonical(item.signature))
+        {
+            index.push_back (i);
+            m.push_back (item.message.data());
+            mlen.push_back (item.message.size());
+            // Strip our 0xED prefix, as in verify
+            pk.push_back (item.publicKey.data() + 1);
+            rs.push_back (item.signature.data());
+        }
+    }
+
+    if (! index.empty())
+    {
+        std::vector<int> valid (index.size());
+        ed25519_sign_open_batch (m.data(), mlen.data(),
+            pk.data(), rs.data(), index.size(), valid.data());
+
+        // The batch equation cannot see a difference of small order
+        // between R and [S]B - [h]A, nor a non-canonical encoding of R,
+        // both of which verify rejects. A signature the batch accepts
+        // is therefore confirmed on its own; one it rejects was already
+        // checked individually by ed25519-donna.
+        for (std::size_t i = 0; i < index.size(); ++i)
+        {
+            auto const& item = items[index[i]];
+            result[index[i]] = (valid[i] == 1) && verify (item.publicKey,
+                item.message, item.signature, item.mustBeFullyCanonical);
+        }
+    }
+
+    return result;
+}
+
 NodeID
 calcNodeID (PublicKey const& pk)
 {
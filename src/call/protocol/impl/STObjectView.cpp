@@ -0,0 +1,291 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of calld: https://github.com/callchain/calld
+    Copyright (c) 2018, 2019 Callchain Fundation.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <call/basics/contract.h>
+#include <call/protocol/STObjectView.h>
+
+namespace call {
+
+namespace {
+
+// Advance past the value of a field of the given type
+void
+skipValue (SerialIter& sit, int type, int depth)
+{
+    if (depth > 10)
+        Throw<std::runtime_error> ("Maximum nesting depth of object exceeded");
+
+    switch (type)
+    {
+    case STI_UINT8:     sit.skip (1); return;
+    case STI_UINT16:    sit.skip (2); return;
+    case STI_UINT32:    sit.skip (4); return;
+    case STI_UINT64:    sit.skip (8); return;
+    case STI_HASH128:   sit.skip (16); return;
+    case STI_HASH160:   sit.skip (20); return;
+    case STI_HASH256:   sit.skip (32); return;
+
+    case STI_AMOUNT:
+        // Non-native amounts carry a currency and an issuer
+        if (sit.get64 () & STAmount::cNotNative)
+            sit.skip (40);
+        return;
+
+    case STI_VL:
+    case STI_ACCOUNT:
+    case STI_VECTOR256:
+        sit.skip (sit.getVLDataLength ());
+        return;
+
+    case STI_PATHSET:
+        for (;;)
+        {
+            auto const iType = sit.get8 ();
+
+            if (iType == STPathElement::typeNone)
+                return;
+
+            if (iType == STPathElement::typeBoundary)
+                continue;
+
+            if (iType & STPathElement::typeAccount)
+                sit.skip (20);
+            if (iType & STPathElement::typeCurrency)
+                sit.skip (20);
+            if (iType & STPathElement::typeIssuer)
+                sit.skip (20);
+        }
+
+    case STI_OBJECT:
+    case STI_ARRAY:
+        for (;;)
+        {
+            int innerType;
+            int innerName;
+            sit.getFieldID (innerType, innerName);
+
+            // End of object or end of array marker
+            if (innerType == type && innerName == 1)
+                return;
+
+            if (innerType == STI_ARRAY && innerName == 1)
+                Throw<std::runtime_error> ("Illegal terminator in object");
+
+            skipValue (sit, innerType, depth + 1);
+        }
+
+    default:
+        Throw<std::runtime_error> ("Unknown object type");
+    }
+}
+
+}
+
+STObjectView::STObjectView (Slice data,
+        std::shared_ptr<void const> owner, SOTemplate const* type)
+    : owner_ (std::move (owner))
+    , data_ (data)
+    , type_ (type)
+{
+}
+
+STObjectView::STObjectView (std::shared_ptr<STObject const> object)
+    : object_ (std::move (object))
+{
+}
+
+void
+STObjectView::buildIndex () const
+{
+    SerialIter sit (data_);
+    index_.clear ();
+
+    while (! sit.empty ())
+    {
+        int type;
+        int name;
+        sit.getFieldID (type, name);
+
+        auto const offset = data_.size () - sit.getBytesLeft ();
+        skipValue (sit, type, 0);
+
+        index_.push_back ({ (type << 16) | name,
+            static_cast<std::uint32_t> (offset),
+            static_cast<std::uint32_t> (
+                data_.size () - sit.getBytesLeft () - offset) });
+    }
+
+    indexed_ = true;
+}
+
+boost::optional<Slice>
+STObjectView::find (SField const& field) const
+{
+    if (! indexed_)
+        buildIndex ();
+
+    for (auto const& e : index_)
+    {
+        if (e.code == field.fieldCode)
+            return Slice (data_.data () + e.offset, e.size);
+    }
+
+    return boost::none;
+}
+
+void
+STObjectView::requireKnown (SField const& field) const
+{
+    if (! type_)
+        Throw<missing_field_error> (field);
+
+    auto const index = type_->getIndex (field);
+    if (index == -1 || type_->style (field) == SOE_OPTIONAL)
+        Throw<missing_field_error> (field);
+}
+
+bool
+STObjectView::isFieldPresent (SField const& field) const
+{
+    if (object_)
+        return object_->isFieldPresent (field);
+
+    return static_cast<bool> (find (field));
+}
+
+std::uint32_t
+STObjectView::getFlags () const
+{
+    if (object_)
+        return object_->getFlags ();
+
+    auto const data = find (sfFlags);
+    if (! data)
+        return 0;
+    SerialIter sit (*data);
+    return sit.get32 ();
+}
+
+unsigned char
+STObjectView::getFieldU8 (SField const& field) const
+{
+    if (object_)
+        return object_->getFieldU8 (field);
+    return getFieldByValue <STUInt8> (field);
+}
+
+std::uint16_t
+STObjectView::getFieldU16 (SField const& field) const
+{
+    if (object_)
+        return object_->getFieldU16 (field);
+    return getFieldByValue <STUInt16> (field);
+}
+
+std::uint32_t
+STObjectView::getFieldU32 (SField const& field) const
+{
+    if (object_)
+        return object_->getFieldU32 (field);
+    return getFieldByValue <STUInt32> (field);
+}
+
+std::uint64_t
+STObjectView::getFieldU64 (SField const& field) const
+{
+    if (object_)
+        return object_->getFieldU64 (field);
+    return getFieldByValue <STUInt64> (field);
+}
+
+uint128
+STObjectView::getFieldH128 (SField const& field) const
+{
+    if (object_)
+        return object_->getFieldH128 (field);
+    return getFieldByValue <STHash128> (field);
+}
+
+uint160
+STObjectView::getFieldH160 (SField const& field) const
+{
+    if (object_)
+        return object_->getFieldH160 (field);
+    return getFieldByValue <STHash160> (field);
+}
+
+uint256
+STObjectView::getFieldH256 (SField const& field) const
+{
+    if (object_)
+        return object_->getFieldH256 (field);
+    return getFieldByValue <STHash256> (field);
+}
+
+AccountID
+STObjectView::getAccountID (SField const& field) const
+{
+    if (object_)
+        return object_->getAccountID (field);
+    return getFieldByValue <STAccount> (field);
+}
+
+Blob
+STObjectView::getFieldVL (SField const& field) const
+{
+    if (object_)
+        return object_->getFieldVL (field);
+
+    auto const b = getFieldObject <STBlob> (field);
+    return Blob (b.data (), b.data () + b.size ());
+}
+
+STAmount
+STObjectView::getFieldAmount (SField const& field) const
+{
+    if (object_)
+        return object_->getFieldAmount (field);
+    return getFieldObject <STAmount> (field);
+}
+
+STVector256
+STObjectView::getFieldV256 (SField const& field) const
+{
+    if (object_)
+        return object_->getFieldV256 (field);
+    return getFieldObject <STVector256> (field);
+}
+
+} // call
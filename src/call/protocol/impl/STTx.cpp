@@ -399,6 +399,70 @@ std::pair<bool, std::string> STTx::checkMultiSign () const
     return {true, ""};
 }
 
+std::vector<std::pair<bool, std::string>>
+checkSignBatch (std::vector<std::shared_ptr<STTx const>> const& txs,
+    bool allowMultiSign)
+{
+    std::vector<std::pair<bool, std::string>> result (txs.size());
+
+    struct Pending
+    {
+        std::size_t index;
+        PublicKey publicKey;
+        Blob data;
+        Blob signature;
+        bool fullyCanonical;
+    };
+
+    std::vector<Pending> pending;
+    pending.reserve (txs.size());
+
+    for (std::size_t i = 0; i < txs.size(); ++i)
+    {
+        auto const& tx = *txs[i];
+        try
+        {
+            // Only single-signed Ed25519 transactions can be batched
+            auto const spk = tx.getFieldVL (sfSigningPubKey);
+            if (publicKeyType (makeSlice(spk)) == KeyType::ed25519 &&
+                ! tx.isFieldPresent (sfSigners))
+            {
+                pending.push_back ({i, PublicKey (makeSlice(spk)),
+                    getSigningData (tx), tx.getFieldVL (sfTxnSignature),
+                        (tx.getFlags() & tfFullyCanonicalSig) != 0});
+                continue;
+            }
+        }
+        catch (std::exception const&)
+        {
+        }
+
+        result[i] = tx.checkSign (allowMultiSign);
+    }
+
+    if (pending.empty())
+        return result;
+
+    std::vector<SignedMessage> items;
+    items.reserve (pending.size());
+    for (auto const& p : pending)
+    {
+        items.push_back ({p.publicKey, makeSlice(p.data),
+            makeSlice(p.signature), p.fullyCanonical});
+    }
+
+    auto const valid = verifyBatch (items);
+    for (std::size_t i = 0; i < pending.size(); ++i)
+    {
+        if (valid[i])
+            result[pending[i].index] = {true, ""};
+        else
+            result[pending[i].index] = {false, "Invalid signature."};
+    }
+
+    return result;
+}
+
 //------------------------------------------------------------------------------
 
 static
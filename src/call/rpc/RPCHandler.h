@@ -39,6 +39,11 @@
 #include <call/net/InfoSub.h>
 #include <call/rpc/Context.h>
 #include <call/rpc/Status.h>
+#include <functional>
+
+namespace Json {
+class Object;
+}
 
 namespace call {
 namespace RPC {
@@ -48,6 +53,24 @@ struct Context;
 /** Execute an RPC command and store the results in a Json::Value. */
 Status doCommand (RPC::Context&, Json::Value&);
 
+/** Returns the object a streamed result is written to.
+
+    It is called once, with the status of the checks on the request,
+    before anything is written. An error status is injected into the
+    returned object.
+*/
+using ResultOpener = std::function <Json::Object& (Status const&)>;
+
+/** Execute an RPC command and write the results as they are produced.
+
+    Handlers which cannot write incrementally build their result as a
+    Json::Value first, and it is copied into the object.
+*/
+Status doCommand (RPC::Context&, ResultOpener const&);
+
+/** Returns true if the handler for a method writes incrementally. */
+bool isStreaming (std::string const& method);
+
 Role roleRequired (std::string const& method );
 
 } // RPC
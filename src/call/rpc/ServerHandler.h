@@ -57,8 +57,14 @@ setup_ServerHandler (
     Config const& c,
     std::ostream&& log);
 
+/** Create the server handler.
+
+    Ports carrying the peer protocol are served by the second io_service,
+    so that peer connections handed off to the overlay stay on it.
+*/
 std::unique_ptr <ServerHandler>
 make_ServerHandler (Application& app, Stoppable& parent, boost::asio::io_service&,
+    boost::asio::io_service& peerIOService,
     JobQueue&, NetworkOPs&, Resource::Manager&,
         CollectorManager& cm);
 
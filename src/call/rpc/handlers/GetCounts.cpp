@@ -42,11 +42,13 @@
 #include <call/core/DatabaseCon.h>
 #include <call/json/json_value.h>
 #include <call/ledger/CachedSLEs.h>
+#include <call/ledger/OpenView.h>
 #include <call/net/RPCErr.h>
 #include <call/nodestore/Database.h>
 #include <call/protocol/ErrorCodes.h>
 #include <call/protocol/JsonFields.h>
 #include <call/rpc/Context.h>
+#include <call/shamap/SHAMapTreeNode.h>
 
 namespace call {
 
@@ -124,6 +126,8 @@ Json::Value doGetCounts (RPC::Context& context)
     ret[jss::fullbelow_size] = static_cast<int>(context.app.family().fullbelow().size());
     ret[jss::treenode_cache_size] = context.app.family().treecache().getCacheSize();
     ret[jss::treenode_track_size] = context.app.family().treecache().getTrackSize();
+    ret[jss::treenode_kb_saved] = static_cast<int>(
+        SHAMapInnerNode::getBytesSaved () / 1024);
 
     std::string uptime;
     int s = UptimeTimer::getInstance ().getElapsedSeconds ();
@@ -140,6 +144,16 @@ Json::Value doGetCounts (RPC::Context& context)
     ret[jss::node_written_bytes] = context.app.getNodeStore().getStoreSize();
     ret[jss::node_read_bytes] = context.app.getNodeStore().getFetchSize();
 
+    {
+        auto const& stats = OpenView::applyArenaStats();
+        ret[jss::apply_arena_allocs] = static_cast<Json::UInt> (
+            stats.allocations.load());
+        ret[jss::apply_arena_kb] = static_cast<Json::UInt> (
+            stats.bytes.load() / 1024);
+        ret[jss::apply_arena_blocks] = static_cast<Json::UInt> (
+            stats.blocks.load());
+    }
+
     return ret;
 }
 
@@ -35,6 +35,7 @@
 #ifndef CALL_RPC_HANDLERS_HANDLERS_H_INCLUDED
 #define CALL_RPC_HANDLERS_HANDLERS_H_INCLUDED
 
+#include <call/rpc/handlers/LedgerData.h>
 #include <call/rpc/handlers/LedgerHandler.h>
 
 namespace call {
@@ -64,7 +65,7 @@ Json::Value doLedgerAccept          (RPC::Context&);
 Json::Value doLedgerCleaner         (RPC::Context&);
 Json::Value doLedgerClosed          (RPC::Context&);
 Json::Value doLedgerCurrent         (RPC::Context&);
-Json::Value doLedgerData            (RPC::Context&);
+Json::Value doLedgerDiff            (RPC::Context&);
 Json::Value doLedgerEntry           (RPC::Context&);
 Json::Value doLedgerHeader          (RPC::Context&);
 Json::Value doLedgerRequest         (RPC::Context&);
@@ -33,112 +33,61 @@
 //==============================================================================
 
 #include <BeastConfig.h>
-#include <call/app/ledger/LedgerToJson.h>
-#include <call/ledger/ReadView.h>
+#include <call/rpc/handlers/LedgerData.h>
 #include <call/protocol/ErrorCodes.h>
-#include <call/protocol/JsonFields.h>
 #include <call/protocol/LedgerFormats.h>
 #include <call/rpc/impl/RPCHelpers.h>
 #include <call/rpc/impl/Tuning.h>
-#include <call/rpc/Context.h>
-#include <call/rpc/Role.h>
 
 namespace call {
+namespace RPC {
 
-// Get state nodes from a ledger
-//   Inputs:
-//     limit:        integer, maximum number of entries
-//     marker:       opaque, resume point
-//     binary:       boolean, format
-//     type:         string // optional, defaults to all ledger node types
-//   Outputs:
-//     ledger_hash:  chosen ledger's hash
-//     ledger_index: chosen ledger's index
-//     state:        array of state nodes
-//     marker:       resume point, if any
-Json::Value doLedgerData (RPC::Context& context)
+LedgerDataHandler::LedgerDataHandler (Context& context) : context_ (context)
 {
-    std::shared_ptr<ReadView const> lpLedger;
-    auto const& params = context.params;
+}
+
+Status LedgerDataHandler::check ()
+{
+    auto const& params = context_.params;
 
-    auto jvResult = RPC::lookupLedger(lpLedger, context);
-    if (!lpLedger)
-        return jvResult;
+    if (auto s = lookupLedger (ledger_, context_, result_))
+        return s;
 
-    bool const isMarker = params.isMember (jss::marker);
-    ReadView::key_type key = ReadView::key_type();
-    if (isMarker)
+    isMarker_ = params.isMember (jss::marker);
+    if (isMarker_)
     {
         Json::Value const& jMarker = params[jss::marker];
-        if (! (jMarker.isString () && key.SetHex (jMarker.asString ())))
-            return RPC::expected_field_error (jss::marker, "valid");
+        if (! (jMarker.isString () && key_.SetHex (jMarker.asString ())))
+            return {rpcINVALID_PARAMS,
+                expected_field_message (jss::marker, "valid")};
     }
 
-    bool const isBinary = params[jss::binary].asBool();
+    isBinary_ = params[jss::binary].asBool();
 
-    int limit = -1;
     if (params.isMember (jss::limit))
     {
         Json::Value const& jLimit = params[jss::limit];
         if (!jLimit.isIntegral ())
-            return RPC::expected_field_error (jss::limit, "integer");
+            return {rpcINVALID_PARAMS,
+                expected_field_message (jss::limit, "integer")};
 
-        limit = jLimit.asInt ();
+        limit_ = jLimit.asInt ();
     }
 
-    auto maxLimit = RPC::Tuning::pageLength(isBinary);
-    if ((limit < 0) || ((limit > maxLimit) && (! isUnlimited (context.role))))
-        limit = maxLimit;
+    auto maxLimit = Tuning::pageLength(isBinary_);
+    if ((limit_ < 0) || ((limit_ > maxLimit) && (! isUnlimited (context_.role))))
+        limit_ = maxLimit;
 
-    jvResult[jss::ledger_hash] = to_string (lpLedger->info().hash);
-    jvResult[jss::ledger_index] = lpLedger->info().seq;
-
-    if (! isMarker)
-    {
-        // Return base ledger data on first query
-        jvResult[jss::ledger] = getJson (
-            LedgerFill (*lpLedger, isBinary ?
-                LedgerFill::Options::binary : 0));
-    }
-
-    auto type = RPC::chooseLedgerEntryType(params);
+    auto type = chooseLedgerEntryType(params);
     if (type.first)
-    {
-        jvResult.clear();
-        type.first.inject(jvResult);
-        return jvResult;
-    }
-    Json::Value& nodes = jvResult[jss::state];
+        return type.first;
+    type_ = type.second;
 
-    auto e = lpLedger->sles.end();
-    for (auto i = lpLedger->sles.upper_bound(key); i != e; ++i)
-    {
-        auto sle = lpLedger->read(keylet::unchecked((*i)->key()));
-        if (limit-- <= 0)
-        {
-            // Stop processing before the current key.
-            auto k = sle->key();
-            jvResult[jss::marker] = to_string(--k);
-            break;
-        }
-
-        if (type.second == ltINVALID || sle->getType () == type.second)
-        {
-            if (isBinary)
-            {
-                Json::Value& entry = nodes.append (Json::objectValue);
-                entry[jss::data] = serializeHex(*sle);
-                entry[jss::index] = to_string(sle->key());
-            }
-            else
-            {
-                Json::Value& entry = nodes.append (sle->getJson (0));
-                entry[jss::index] = to_string(sle->key());
-            }
-        }
-    }
+    result_[jss::ledger_hash] = to_string (ledger_->info().hash);
+    result_[jss::ledger_index] = ledger_->info().seq;
 
-    return jvResult;
+    return Status::OK;
 }
 
+} // RPC
 } // call
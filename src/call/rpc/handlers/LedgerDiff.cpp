@@ -0,0 +1,95 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of calld: https://github.com/callchain/calld
+    Copyright (c) 2018, 2019 Callchain Fundation.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <call/app/ledger/LedgerMaster.h>
+#include <call/app/ledger/StateDiff.h>
+#include <call/net/RPCErr.h>
+#include <call/protocol/ErrorCodes.h>
+#include <call/protocol/JsonFields.h>
+#include <call/resource/Fees.h>
+#include <call/rpc/Context.h>
+#include <call/rpc/impl/RPCHelpers.h>
+#include <call/rpc/impl/Tuning.h>
+#include <call/rpc/Role.h>
+
+namespace call {
+
+// Get the account state entries a closed ledger created, modified and
+// deleted, relative to its parent.
+// {
+//   ledger_hash : <ledger>
+//   ledger_index : <ledger_index>
+//   binary : true | false
+// }
+Json::Value doLedgerDiff (RPC::Context& context)
+{
+    // The parent may have to be loaded and both state maps walked
+    context.loadType = Resource::feeHighBurdenRPC;
+
+    std::shared_ptr<ReadView const> lpLedger;
+    auto jvResult = RPC::lookupLedger (lpLedger, context);
+
+    if (!lpLedger)
+        return jvResult;
+
+    auto const ledger = std::dynamic_pointer_cast<Ledger const> (lpLedger);
+    if (! ledger)
+        return RPC::make_error (rpcINVALID_PARAMS, "Ledger is not closed.");
+
+    auto const parent = context.ledgerMaster.getLedgerByHash (
+        ledger->info().parentHash);
+    if (! parent)
+        return rpcError (rpcLGR_NOT_FOUND);
+
+    // Only unlimited clients may request the largest diffs
+    auto const limit = isUnlimited (context.role) ?
+        RPC::Tuning::maxStateDiff : RPC::Tuning::maxStateDiffUser;
+
+    StateDiff const diff (*parent, *ledger, limit);
+    if (! diff.complete ())
+    {
+        return RPC::make_error (rpcLGR_NOT_FOUND,
+            "Ledger state diff is too large or incomplete.");
+    }
+
+    auto const binary = context.params.isMember (jss::binary) &&
+        context.params[jss::binary].asBool ();
+
+    jvResult[jss::parent_hash] = to_string (ledger->info().parentHash);
+    diff.addJson (jvResult, binary);
+    return jvResult;
+}
+
+} // call
@@ -145,6 +145,12 @@ Json::Value doSubscribe (RPC::Context& context)
             {
                 context.netOps.subLedger (ispSub, jvResult);
             }
+            else if (streamName == "ledger_state")
+            {
+                context.netOps.subLedgerState (ispSub,
+                    context.params.isMember (jss::binary) &&
+                        context.params[jss::binary].asBool ());
+            }
             else if (streamName == "manifests")
             {
                 context.netOps.subManifests (ispSub);
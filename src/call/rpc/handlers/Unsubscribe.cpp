@@ -92,6 +92,10 @@ Json::Value doUnsubscribe (RPC::Context& context)
             {
                 context.netOps.unsubLedger (ispSub->getSeq ());
             }
+            else if (streamName == "ledger_state")
+            {
+                context.netOps.unsubLedgerState (ispSub->getSeq ());
+            }
             else if (streamName == "manifests")
             {
                 context.netOps.unsubManifests (ispSub->getSeq ());
@@ -71,6 +71,21 @@ Status handle (Context& context, Object& object)
     return status;
 };
 
+/** Check a request, then write its result as it is produced. */
+template <class HandlerImpl>
+Status handleStream (Context& context, ResultOpener const& open)
+{
+    HandlerImpl handler (context);
+
+    auto status = handler.check ();
+    auto& object = open (status);
+    if (status)
+        status.inject (object);
+    else
+        handler.writeResult (object);
+    return status;
+}
+
 class HandlerTable {
   public:
     template<std::size_t N>
@@ -85,7 +100,8 @@ class HandlerTable {
         }
 
         // This is where the new-style handlers are added.
-        addHandler<LedgerHandler>();
+        addStreamingHandler<LedgerHandler>();
+        addStreamingHandler<LedgerDataHandler>();
         addHandler<VersionHandler>();
     }
 
@@ -110,6 +126,14 @@ class HandlerTable {
 
         table_[HandlerImpl::name()] = h;
     };
+
+    template <class HandlerImpl>
+    void addStreamingHandler()
+    {
+        addHandler<HandlerImpl>();
+        table_[HandlerImpl::name()].streamMethod_ =
+            &handleStream<HandlerImpl>;
+    }
 };
 
 Handler handlerArray[] {
@@ -140,7 +164,7 @@ Handler handlerArray[] {
     {   "ledger_cleaner",       byRef (&doLedgerCleaner),       Role::ADMIN,   NEEDS_NETWORK_CONNECTION  },
     {   "ledger_closed",        byRef (&doLedgerClosed),        Role::USER,  NO_CONDITION       },
     {   "ledger_current",       byRef (&doLedgerCurrent),       Role::USER,  NEEDS_CURRENT_LEDGER  },
-    {   "ledger_data",          byRef (&doLedgerData),          Role::USER,  NO_CONDITION       },
+    {   "ledger_diff",          byRef (&doLedgerDiff),          Role::USER,  NO_CONDITION       },
     {   "ledger_entry",         byRef (&doLedgerEntry),         Role::USER,  NO_CONDITION       },
     {   "ledger_header",        byRef (&doLedgerHeader),        Role::USER,  NO_CONDITION       },
     {   "ledger_request",       byRef (&doLedgerRequest),       Role::ADMIN,   NO_CONDITION     },
@@ -63,6 +63,9 @@ struct Handler
     Method<Json::Value> valueMethod_;
     Role role_;
     RPC::Condition condition_;
+
+    // Set for handlers which can write their result incrementally.
+    std::function <Status (Context&, ResultOpener const&)> streamMethod_;
 };
 
 const Handler* getHandler (std::string const&);
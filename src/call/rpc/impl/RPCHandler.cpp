@@ -286,6 +286,58 @@ Status doCommand (
     return rpcUNKNOWN_COMMAND;
 }
 
+Status doCommand (
+    RPC::Context& context, ResultOpener const& open)
+{
+    Handler const * handler = nullptr;
+    if (auto error = fillHandler (context, handler))
+    {
+        inject_error (error, open (error));
+        return error;
+    }
+
+    if (! handler->streamMethod_)
+    {
+        Json::Value result;
+        auto const status = callMethod (
+            context, handler->valueMethod_, handler->name_, result);
+        Json::copyFrom (open (status), result);
+        return status;
+    }
+
+    // Remember the result object, so that an error thrown part way
+    // through the result can still be reported in it.
+    Json::Object* object = nullptr;
+    auto const opener = [&] (Status const& status) -> Json::Object&
+    {
+        object = &open (status);
+        return *object;
+    };
+
+    try
+    {
+        auto v = context.app.getJobQueue().makeLoadEvent(
+            jtGENERIC, std::string ("cmd:") + handler->name_);
+        return handler->streamMethod_ (context, opener);
+    }
+    catch (std::exception& e)
+    {
+        JLOG (context.j.info()) << "Caught throw: " << e.what ();
+
+        if (context.loadType == Resource::feeReferenceRPC)
+            context.loadType = Resource::feeExceptionRPC;
+
+        inject_error (rpcINTERNAL, object ? *object : open (rpcINTERNAL));
+        return rpcINTERNAL;
+    }
+}
+
+bool isStreaming (std::string const& method)
+{
+    auto handler = RPC::getHandler(method);
+    return handler && handler->streamMethod_;
+}
+
 Role roleRequired (std::string const& method)
 {
     auto handler = RPC::getHandler(method);
@@ -38,6 +38,7 @@
 #include <call/beast/rfc2616.h>
 #include <call/beast/net/IPAddressConversion.h>
 #include <call/json/json_reader.h>
+#include <call/json/Object.h>
 #include <call/rpc/json_body.h>
 #include <call/rpc/ServerHandler.h>
 #include <call/server/Server.h>
@@ -124,7 +125,8 @@ authorized (
 
 
 ServerHandlerImp::ServerHandlerImp (Application& app, Stoppable& parent,
-    boost::asio::io_service& io_service, JobQueue& jobQueue,
+    boost::asio::io_service& io_service,
+        boost::asio::io_service& peerIOService, JobQueue& jobQueue,
         NetworkOPs& networkOPs, Resource::Manager& resourceManager,
             CollectorManager& cm)
     : Stoppable("ServerHandler", parent)
@@ -133,7 +135,7 @@ ServerHandlerImp::ServerHandlerImp (Application& app, Stoppable& parent,
     , m_journal (app_.journal("Server"))
     , m_networkOPs (networkOPs)
     , m_server (make_Server(
-        *this, io_service, app_.journal("Server")))
+        *this, io_service, peerIOService, app_.journal("Server")))
     , m_jobQueue (jobQueue)
 {
     auto const& group (cm.group ("rpc"));
@@ -272,6 +274,60 @@ Json::Output makeOutput (Session& session)
     };
 }
 
+namespace {
+
+// Gathers the many small writes of a streamed response
+// into pieces of a reasonable size for the connection.
+class PieceWriter
+{
+    std::function <void (std::string&&)> send_;
+    std::string piece_;
+    std::size_t size_ = 0;
+
+public:
+    explicit
+    PieceWriter (std::function <void (std::string&&)> send)
+        : send_ (std::move (send))
+    {
+    }
+
+    Json::Output
+    output ()
+    {
+        return [this](beast::string_view const& b)
+        {
+            write (b);
+        };
+    }
+
+    void
+    write (beast::string_view const& b)
+    {
+        piece_.append (b.data(), b.size());
+        size_ += b.size();
+        if (piece_.size() >= RPC::Tuning::streamPieceSize)
+            flush ();
+    }
+
+    void
+    flush ()
+    {
+        if (piece_.empty())
+            return;
+        send_ (std::move (piece_));
+        piece_.clear();
+    }
+
+    // Total bytes written
+    std::size_t
+    size () const
+    {
+        return size_;
+    }
+};
+
+} // namespace
+
 // HACK!
 static
 std::map<std::string, std::string>
@@ -378,6 +434,12 @@ ServerHandlerImp::onWSMessage(
         [this, session, jv = std::move(jv)]
         (std::shared_ptr<JobQueue::Coro> const& coro)
         {
+            if (this->streamSession(session, coro, jv))
+            {
+                session->complete();
+                return;
+            }
+
             auto const jr =
                 this->processSession(session, coro, jv);
             auto const s = to_string(jr);
@@ -517,6 +579,103 @@ ServerHandlerImp::processSession(
     return jr;
 }
 
+bool
+ServerHandlerImp::streamSession(
+    std::shared_ptr<WSSession> const& session,
+        std::shared_ptr<JobQueue::Coro> const& coro,
+            Json::Value const& jv)
+{
+    // Anything unusual about the request is left to processSession.
+    if (! jv.isMember(jss::command) ||
+        (jv.isMember(jss::method) &&
+            jv[jss::command].asString() != jv[jss::method].asString()))
+        return false;
+
+    auto const command = jv[jss::command].asString();
+    if (! RPC::isStreaming(command))
+        return false;
+
+    auto is = std::static_pointer_cast<WSInfoSub> (session->appDefined);
+    if (is->getConsumer().disconnect())
+        return false;
+
+    auto role = requestRole(
+        RPC::roleRequired(command),
+        session->port(),
+        jv,
+        beast::IP::from_asio(session->remote_endpoint().address()),
+        is->user());
+    if (Role::FORBID == role)
+        return false;
+
+    auto const msg = std::make_shared<StreamWSMsg>();
+    session->send(msg);
+
+    PieceWriter pieces (
+        [&msg](std::string&& piece)
+        {
+            msg->write(std::move(piece));
+        });
+    {
+        Json::Writer writer (pieces.output());
+        Json::Object::Root root (writer);
+        boost::optional<Json::Object> result;
+
+        Resource::Charge loadType = Resource::feeReferenceRPC;
+        RPC::Context context{
+            app_.journal("RPCHandler"),
+            jv,
+            app_,
+            loadType,
+            app_.getOPs(),
+            app_.getLedgerMaster(),
+            is->getConsumer(),
+            role,
+            coro,
+            is,
+            {is->user(), is->forwarded_for()}
+            };
+        auto const status = RPC::doCommand(context,
+            [&](RPC::Status const& checked) -> Json::Object&
+            {
+                // Errors are reported at the top level, as
+                // processSession does.
+                if (checked)
+                    return root;
+                result.emplace(Json::addObject(root, jss::result));
+                return *result;
+            });
+        result.reset();
+
+        is->getConsumer().charge(loadType);
+        if (status)
+        {
+            root[jss::status] = jss::error;
+            root[jss::request] = jv;
+        }
+        else
+        {
+            root[jss::status] = jss::success;
+            if (is->getConsumer().warn())
+                root[jss::warning] = jss::load;
+        }
+
+        if (jv.isMember(jss::id))
+            root[jss::id] = jv[jss::id];
+        if (jv.isMember(jss::jsonrpc))
+            root[jss::jsonrpc] = jv[jss::jsonrpc];
+        if (jv.isMember(jss::callrpc))
+            root[jss::callrpc] = jv[jss::callrpc];
+        root[jss::type] = jss::response;
+    }
+    pieces.flush();
+    msg->finish();
+
+    JLOG(m_journal.trace())
+        << "Websocket streamed " << pieces.size() << " bytes";
+    return true;
+}
+
 // Run as a coroutine.
 void
 ServerHandlerImp::processSession (std::shared_ptr<Session> const& session,
@@ -544,7 +703,8 @@ ServerHandlerImp::processSession (std::shared_ptr<Session> const& session,
             if(iter != session->request().end())
                 return iter->value().to_string();
             return std::string{};
-        }());
+        }(),
+        session->request().version >= 11);
 
     if(beast::rfc2616::is_keep_alive(session->request()))
         session->complete();
@@ -556,7 +716,7 @@ void
 ServerHandlerImp::processRequest (Port const& port,
     std::string const& request, beast::IP::Endpoint const& remoteIPAddress,
         Output&& output, std::shared_ptr<JobQueue::Coro> coro,
-        std::string forwardedFor, std::string user)
+        std::string forwardedFor, std::string user, bool chunked)
 {
     auto rpcJ = app_.journal ("RPC");
 
@@ -689,6 +849,75 @@ ServerHandlerImp::processRequest (Port const& port,
     RPC::Context context {m_journal, params, app_, loadType, m_networkOPs,
         app_.getLedgerMaster(), usage, role, coro, InfoSub::pointer(),
         {user, forwardedFor}};
+
+    auto const notify = [&](std::size_t size)
+    {
+        rpc_time_.notify (static_cast <beast::insight::Event::value_type> (
+            std::chrono::duration_cast <std::chrono::milliseconds> (
+                std::chrono::high_resolution_clock::now () - start)));
+        ++rpc_requests_;
+        rpc_size_.notify (static_cast <beast::insight::Event::value_type> (
+            size));
+    };
+
+    // Large results are sent as they are written
+    // instead of being built in memory first.
+    if (chunked && RPC::isStreaming (strMethod))
+    {
+        HTTPChunkedReply (output, rpcJ);
+
+        PieceWriter pieces (
+            [&output](std::string&& piece)
+            {
+                HTTPChunk (piece, output);
+            });
+        {
+            Json::Writer writer (pieces.output ());
+            Json::Object::Root reply (writer);
+            boost::optional<Json::Object> result;
+
+            auto const status = RPC::doCommand (context,
+                [&](RPC::Status const&) -> Json::Object&
+                {
+                    result.emplace (Json::addObject (reply, jss::result));
+                    return *result;
+                });
+
+            // Always report "status".  On an error report the request as received.
+            if (status)
+            {
+                (*result)[jss::status] = jss::error;
+                (*result)[jss::request] = params;
+                JLOG (m_journal.debug())  <<
+                    "rpcError: " << status.toString();
+            }
+            else
+            {
+                (*result)[jss::status] = jss::success;
+            }
+
+            usage.charge (loadType);
+            if (usage.warn())
+                (*result)[jss::warning] = jss::load;
+            result.reset ();
+
+            if (jsonRPC.isMember(jss::jsonrpc))
+                reply[jss::jsonrpc] = jsonRPC[jss::jsonrpc];
+            if (jsonRPC.isMember(jss::callrpc))
+                reply[jss::callrpc] = jsonRPC[jss::callrpc];
+            if (jsonRPC.isMember(jss::id))
+                reply[jss::id] = jsonRPC[jss::id];
+        }
+        pieces.write ("\n");
+        pieces.flush ();
+        HTTPChunk ({}, output);
+
+        notify (pieces.size () - 1);
+        JLOG (m_journal.debug()) << "Reply: streamed " <<
+            pieces.size () << " bytes";
+        return;
+    }
+
     Json::Value result;
     RPC::doCommand (context, result);
 
@@ -719,13 +948,7 @@ ServerHandlerImp::processRequest (Port const& port,
     if (jsonRPC.isMember(jss::id))
         reply[jss::id] = jsonRPC[jss::id];
     auto response = to_string (reply);
-
-    rpc_time_.notify (static_cast <beast::insight::Event::value_type> (
-        std::chrono::duration_cast <std::chrono::milliseconds> (
-            std::chrono::high_resolution_clock::now () - start)));
-    ++rpc_requests_;
-    rpc_size_.notify (static_cast <beast::insight::Event::value_type> (
-        response.size ()));
+    notify (response.size ());
 
     response += '\n';
 
@@ -990,12 +1213,13 @@ setup_ServerHandler(
 
 std::unique_ptr <ServerHandler>
 make_ServerHandler (Application& app, Stoppable& parent,
-    boost::asio::io_service& io_service, JobQueue& jobQueue,
-        NetworkOPs& networkOPs, Resource::Manager& resourceManager,
-            CollectorManager& cm)
+    boost::asio::io_service& io_service,
+        boost::asio::io_service& peerIOService, JobQueue& jobQueue,
+            NetworkOPs& networkOPs, Resource::Manager& resourceManager,
+                CollectorManager& cm)
 {
     return std::make_unique<ServerHandlerImp>(app, parent,
-        io_service, jobQueue, networkOPs, resourceManager, cm);
+        io_service, peerIOService, jobQueue, networkOPs, resourceManager, cm);
 }
 
 } // call
@@ -107,7 +107,8 @@ private:
 
 public:
     ServerHandlerImp (Application& app, Stoppable& parent,
-        boost::asio::io_service& io_service, JobQueue& jobQueue,
+        boost::asio::io_service& io_service,
+            boost::asio::io_service& peerIOService, JobQueue& jobQueue,
             NetworkOPs& networkOPs, Resource::Manager& resourceManager,
                 CollectorManager& cm);
 
@@ -170,6 +171,14 @@ private:
             std::shared_ptr<JobQueue::Coro> const& coro,
                 Json::Value const& jv);
 
+    // Send the response to a websocket request as it is written.
+    // Returns false, having done nothing, if it cannot be streamed.
+    bool
+    streamSession(
+        std::shared_ptr<WSSession> const& session,
+            std::shared_ptr<JobQueue::Coro> const& coro,
+                Json::Value const& jv);
+
     void
     processSession (std::shared_ptr<Session> const&,
         std::shared_ptr<JobQueue::Coro> coro);
@@ -178,7 +187,7 @@ private:
     processRequest (Port const& port, std::string const& request,
         beast::IP::Endpoint const& remoteIPAddress, Output&&,
         std::shared_ptr<JobQueue::Coro> coro,
-        std::string forwardedFor, std::string user);
+        std::string forwardedFor, std::string user, bool chunked);
 
     Handoff
     statusResponse(http_request_type const& request) const;
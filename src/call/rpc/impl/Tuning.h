@@ -74,6 +74,17 @@ using namespace std::chrono_literals;
 auto constexpr maxValidatedLedgerAge = 2min;
 static int const maxRequestSize = 1000000;
 
+/** Size of the pieces in which a streamed response is sent. */
+static int const streamPieceSize = 16 * 1024;
+
+/** Maximum number of changed entries in a ledger_diff response, or in
+    a ledger_state stream event. */
+static int const maxStateDiff = 100000;
+
+/** Maximum number of changed entries in a ledger_diff response to a
+    client that is not unlimited. */
+static int const maxStateDiffUser = 512;
+
 /** Maximum number of pages in one response from a binary LedgerData request. */
 static int const binaryPageLength = 2048;
 
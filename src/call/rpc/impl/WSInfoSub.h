@@ -101,6 +101,15 @@ public:
                 std::move(sb));
         sp->send(m);
     }
+
+    void
+    send(Event const& event, bool)
+    {
+        auto sp = ws_.lock();
+        if(! sp)
+            return;
+        sp->send(std::make_shared<SharedWSMsg>(event.text()));
+    }
 };
 
 } // call
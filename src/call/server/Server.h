@@ -50,7 +50,21 @@ make_Server(Handler& handler,
     boost::asio::io_service& io_service, beast::Journal journal)
 {
     return std::make_unique<ServerImpl<Handler>>(
-        handler, io_service, journal);
+        handler, io_service, io_service, journal);
+}
+
+/** Create the HTTP server using the specified handler.
+
+    Ports that carry the peer protocol are served by `peer_io_service`.
+*/
+template<class Handler>
+std::unique_ptr<Server>
+make_Server(Handler& handler,
+    boost::asio::io_service& io_service,
+    boost::asio::io_service& peer_io_service, beast::Journal journal)
+{
+    return std::make_unique<ServerImpl<Handler>>(
+        handler, io_service, peer_io_service, journal);
 }
 
 } // call
@@ -43,8 +43,11 @@
 #include <boost/asio/ip/tcp.hpp>
 #include <boost/logic/tribool.hpp>
 #include <algorithm>
+#include <deque>
 #include <functional>
 #include <memory>
+#include <mutex>
+#include <string>
 #include <utility>
 #include <vector>
 
@@ -121,6 +124,112 @@ public:
     }
 };
 
+/** A message whose bytes are shared with other messages.
+
+    The same immutable buffer can be queued on any number of
+    sessions; each message only tracks its own position.
+*/
+class SharedWSMsg : public WSMsg
+{
+    std::shared_ptr<std::string const> data_;
+    std::size_t pos_ = 0;
+    std::size_t n_ = 0;
+
+public:
+    explicit
+    SharedWSMsg(std::shared_ptr<std::string const> data)
+        : data_(std::move(data))
+    {
+    }
+
+    std::pair<boost::tribool,
+        std::vector<boost::asio::const_buffer>>
+    prepare(std::size_t bytes,
+        std::function<void(void)>) override
+    {
+        pos_ += n_;
+        auto const remaining = data_->size() - pos_;
+        if (remaining == 0)
+            return{true, {}};
+        n_ = std::min(bytes, remaining);
+        boost::tribool const done = n_ == remaining;
+        return{done, {boost::asio::const_buffer(data_->data() + pos_, n_)}};
+    }
+};
+
+/** A message which is sent while it is still being written.
+
+    The writer adds pieces from any thread and calls finish() after the
+    last one. Pieces go out as the connection is ready for them, as the
+    frames of one fragmented message.
+*/
+class StreamWSMsg : public WSMsg
+{
+    std::mutex mutex_;
+    std::deque<std::string> pieces_;
+    std::size_t pos_ = 0;
+    std::size_t n_ = 0;
+    bool finished_ = false;
+    std::function<void(void)> resume_;
+
+public:
+    /** Add a piece to the end of the message. */
+    void
+    write(std::string piece)
+    {
+        std::function<void(void)> resume;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            pieces_.push_back(std::move(piece));
+            resume.swap(resume_);
+        }
+        if(resume)
+            resume();
+    }
+
+    /** Indicate that the message is complete. */
+    void
+    finish()
+    {
+        std::function<void(void)> resume;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            finished_ = true;
+            resume.swap(resume_);
+        }
+        if(resume)
+            resume();
+    }
+
+    std::pair<boost::tribool,
+        std::vector<boost::asio::const_buffer>>
+    prepare(std::size_t bytes,
+        std::function<void(void)> resume) override
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        pos_ += n_;
+        n_ = 0;
+        while(! pieces_.empty() && pos_ == pieces_.front().size())
+        {
+            pieces_.pop_front();
+            pos_ = 0;
+        }
+        if(pieces_.empty())
+        {
+            if(finished_)
+                return{true, {}};
+            resume_ = std::move(resume);
+            return{boost::indeterminate, {}};
+        }
+        // Pieces added later never move the front one
+        auto const& piece = pieces_.front();
+        n_ = std::min(bytes, piece.size() - pos_);
+        boost::tribool const done = finished_ &&
+            pieces_.size() == 1 && pos_ + n_ == piece.size();
+        return{done, {boost::asio::const_buffer(piece.data() + pos_, n_)}};
+    }
+};
+
 struct WSSession
 {
     std::shared_ptr<void> appDefined;
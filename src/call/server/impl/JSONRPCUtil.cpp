@@ -40,6 +40,7 @@
 #include <call/protocol/SystemParameters.h>
 #include <call/json/to_string.h>
 #include <boost/algorithm/string.hpp>
+#include <sstream>
 
 namespace call {
 
@@ -133,4 +134,31 @@ void HTTPReply (
     output ("\r\n");
 }
 
+void HTTPChunkedReply (Json::Output const& output, beast::Journal j)
+{
+    JLOG (j.trace())
+        << "HTTP Reply 200 chunked";
+
+    output ("HTTP/1.1 200 OK\r\n");
+    output (getHTTPHeaderTimestamp ());
+    output ("Connection: Keep-Alive\r\n"
+            "Transfer-Encoding: chunked\r\n"
+            "Content-Type: application/json; charset=UTF-8\r\n");
+
+    output ("Server: " + systemName () + "-json-rpc/");
+    output (BuildInfo::getFullVersionString ());
+    output ("\r\n"
+            "\r\n");
+}
+
+void HTTPChunk (beast::string_view const& data, Json::Output const& output)
+{
+    std::ostringstream size;
+    size << std::hex << data.size () << "\r\n";
+    output (size.str ());
+    if (! data.empty ())
+        output (data);
+    output ("\r\n");
+}
+
 } // call
@@ -43,6 +43,16 @@ namespace call {
 void HTTPReply (
     int nStatus, std::string const& strMsg, Json::Output const&, beast::Journal j);
 
+/** Write the header of a successful reply whose body is sent in chunks.
+
+    The body follows as calls to HTTPChunk, ending with an empty chunk.
+    This requires an HTTP/1.1 client.
+*/
+void HTTPChunkedReply (Json::Output const&, beast::Journal j);
+
+/** Write one chunk of a reply body. An empty chunk ends the body. */
+void HTTPChunk (beast::string_view const& data, Json::Output const&);
+
 } // call
 
 #endif
@@ -105,6 +105,7 @@ private:
     Handler& handler_;
     beast::Journal j_;
     boost::asio::io_service& io_service_;
+    boost::asio::io_service& peer_io_service_;
     boost::asio::io_service::strand strand_;
     boost::optional <boost::asio::io_service::work> work_;
 
@@ -118,7 +119,8 @@ private:
 
 public:
     ServerImpl(Handler& handler,
-        boost::asio::io_service& io_service, beast::Journal journal);
+        boost::asio::io_service& io_service,
+        boost::asio::io_service& peer_io_service, beast::Journal journal);
 
     ~ServerImpl();
 
@@ -158,10 +160,12 @@ private:
 template<class Handler>
 ServerImpl<Handler>::
 ServerImpl(Handler& handler,
-        boost::asio::io_service& io_service, beast::Journal journal)
+        boost::asio::io_service& io_service,
+        boost::asio::io_service& peer_io_service, beast::Journal journal)
     : handler_(handler)
     , j_(journal)
     , io_service_(io_service)
+    , peer_io_service_(peer_io_service)
     , strand_(io_service_)
     , work_(io_service_)
 {
@@ -188,8 +192,12 @@ ports (std::vector<Port> const& ports)
     for(auto const& port : ports)
     {
         ports_.push_back(port);
+        // Peer connections accepted here are handed off to the
+        // overlay and keep running on the io_service of their door.
+        auto& ios = port.protocol.count("peer") ?
+            peer_io_service_ : io_service_;
         if(auto sp = ios_.emplace<Door<Handler>>(handler_,
-            io_service_, ports_.back(), j_))
+            ios, ports_.back(), j_))
         {
             list_.push_back(sp);
             sp->run();
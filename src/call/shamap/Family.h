@@ -39,8 +39,10 @@
 #include <call/shamap/FullBelowCache.h>
 #include <call/shamap/TreeNodeCache.h>
 #include <call/nodestore/Database.h>
+#include <call/nodestore/DatabaseShard.h>
 #include <call/beast/utility/Journal.h>
 #include <cstdint>
+#include <functional>
 
 namespace call {
 
@@ -84,6 +86,29 @@ public:
     virtual
     void
     missing_node (uint256 const& refHash) = 0;
+
+    /** Run work on another thread.
+        Used to flush independent subtrees of a SHAMap concurrently.
+        @return `false` if the work was not scheduled, in which case
+                the caller does it itself.
+    */
+    virtual
+    bool
+    dispatch (std::function<void()> work) = 0;
+
+    /** Number of nodes a full walk of a map reads ahead of its position.
+        Zero disables read ahead.
+    */
+    virtual
+    int
+    readAhead () const = 0;
+
+    /** The historical shards consulted when the node store misses,
+        or `nullptr` if there are none.
+    */
+    virtual
+    NodeStore::DatabaseShard*
+    shardStore () = 0;
 };
 
 } // call
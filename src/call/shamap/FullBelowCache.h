@@ -36,7 +36,7 @@
 #define CALL_SHAMAP_FULLBELOWCACHE_H_INCLUDED
 
 #include <call/basics/base_uint.h>
-#include <call/basics/KeyCache.h>
+#include <call/basics/PartitionedKeyCache.h>
 #include <call/beast/insight/Collector.h>
 #include <atomic>
 #include <string>
@@ -52,7 +52,7 @@ template <class Key>
 class BasicFullBelowCache
 {
 private:
-    using CacheType = KeyCache <Key>;
+    using CacheType = PartitionedKeyCache <Key>;
 
 public:
     enum
@@ -143,7 +143,7 @@ public:
     }
 
 private:
-    KeyCache <Key> m_cache;
+    CacheType m_cache;
     std::atomic <std::uint32_t> m_gen;
 };
 
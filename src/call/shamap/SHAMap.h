@@ -44,6 +44,7 @@
 #include <call/shamap/SHAMapSyncFilter.h>
 #include <call/shamap/SHAMapTreeNode.h>
 #include <call/shamap/TreeNodeCache.h>
+#include <call/shamap/WireNodeCache.h>
 #include <call/basics/UnorderedContainers.h>
 #include <call/nodestore/Database.h>
 #include <call/nodestore/NodeObject.h>
@@ -98,6 +99,7 @@ private:
     beast::Journal                  journal_;
     std::uint32_t                   seq_;
     std::uint32_t                   ledgerSeq_ = 0; // sequence number of ledger this is part of
+    std::uint32_t                   shardSeq_ = 0;  // ledger whose shard holds our nodes
     std::shared_ptr<SHAMapAbstractNode> root_;
     mutable SHAMapState             state_;
     SHAMapType                      type_;
@@ -167,6 +169,11 @@ public:
     */
     void setLedgerSeq (std::uint32_t lseq);
 
+    /*  Sets the ledger used to find nodes in the history shards
+        when the node store doesn't have them.
+    */
+    void setShardSeq (std::uint32_t lseq);
+
     bool fetchRoot (SHAMapHash const& hash, SHAMapSyncFilter * filter);
 
     // normal hash access functions
@@ -197,6 +204,12 @@ public:
         visitLeaves(
             std::function<void(std::shared_ptr<SHAMapItem const> const&)> const&) const;
 
+    /** Visit every node in this map that is not in `have`.
+        Subtrees shared with `have` are skipped without being read.
+        Visiting stops when `func` returns `false`.
+    */
+    void visitDifferences(SHAMap const* have, std::function<bool(SHAMapAbstractNode&)>) const;
+
     // comparison/sync functions
 
     /** Check for nodes in the SHAMap not available
@@ -217,6 +230,21 @@ public:
             std::vector<Blob>& rawNode,
                 bool fatLeaves, std::uint32_t depth) const;
 
+    /** Like getNodeFat, but shares the wire format of the nodes
+        through a cache, serializing only the nodes it lacks.
+    */
+    bool getNodeFat (SHAMapNodeID node,
+        std::vector<SHAMapNodeID>& nodeIDs,
+            std::vector<std::shared_ptr<Blob>>& rawNodes,
+                bool fatLeaves, std::uint32_t depth,
+                    WireNodeCache& cache) const;
+
+    /** Add the wire format of the nodes not in `have` to the cache.
+        @return The number of nodes visited.
+    */
+    std::size_t cacheWireNodes (WireNodeCache& cache,
+        SHAMap const* have) const;
+
     bool getRootNode (Serializer & s, SHANodeFormat format) const;
     std::vector<uint256> getNeededHashes (int max, SHAMapSyncFilter * filter);
     SHAMapAddNode addRootNode (SHAMapHash const& hash, Slice const& rootNode,
@@ -257,19 +285,45 @@ public:
     void invariants() const;
 
 private:
-    using SharedPtrNodeStack =
-        std::stack<std::pair<std::shared_ptr<SHAMapAbstractNode>, SHAMapNodeID>>;
+    // The nodes on the path from the root to a position in the map
+    class SharedPtrNodeStack
+        : public std::stack<std::pair<std::shared_ptr<SHAMapAbstractNode>, SHAMapNodeID>>
+    {
+    public:
+        // The entries from the root (front) to the top of the stack (back)
+        container_type const& path() const
+        {
+            return c;
+        }
+    };
+
+    // Reads issued ahead of a depth-first walk of the map
+    struct ReadAhead
+    {
+        explicit ReadAhead (std::size_t distance_)
+            : distance (distance_)
+        {
+        }
+
+        // The most nodes to read ahead of the walk
+        std::size_t const distance;
+
+        // Nodes read ahead that the walk has not reached yet
+        hash_set<uint256> pending;
+
+        // The inner node above the leaf an iterator last stopped at
+        std::shared_ptr<SHAMapAbstractNode> parent;
+    };
     using DeltaRef = std::pair<std::shared_ptr<SHAMapItem const> const&,
                                std::shared_ptr<SHAMapItem const> const&>;
 
-    void visitDifferences(SHAMap const* have, std::function<bool(SHAMapAbstractNode&)>) const;
-
      // tree node cache operations
     std::shared_ptr<SHAMapAbstractNode> getCache (SHAMapHash const& hash) const;
     void canonicalize (SHAMapHash const& hash, std::shared_ptr<SHAMapAbstractNode>&) const;
 
     // database operations
     std::shared_ptr<SHAMapAbstractNode> fetchNodeFromDB (SHAMapHash const& hash) const;
+    std::shared_ptr<NodeObject> fetchFromShard (SHAMapHash const& hash) const;
     std::shared_ptr<SHAMapAbstractNode> fetchNodeNT (SHAMapHash const& hash) const;
     std::shared_ptr<SHAMapAbstractNode> fetchNodeNT (
         SHAMapHash const& hash,
@@ -308,6 +362,28 @@ private:
     SHAMapTreeNode* firstBelow (std::shared_ptr<SHAMapAbstractNode>,
                                 SharedPtrNodeStack& stack, int branch = 0) const;
 
+    // Read ahead of a walk that will next visit the children of node
+    // starting at branch. Returns false once `distance` nodes are pending.
+    bool readAhead (ReadAhead& ra, SHAMapInnerNode& node, int branch) const;
+
+    // Read ahead of an iterator stopped at the leaf on top of the stack
+    void readAhead (ReadAhead& ra, SharedPtrNodeStack const& stack) const;
+
+    // Note that a walk reached the child with the given hash
+    static void readReached (ReadAhead& ra, SHAMapHash const& hash)
+    {
+        if (! ra.pending.empty ())
+            ra.pending.erase (hash.as_uint256 ());
+    }
+
+    std::shared_ptr<ReadAhead> makeReadAhead () const;
+
+    // Visit a node and its children to the given depth, as
+    // requested by a peer.
+    bool visitNodeFat (SHAMapNodeID const& wanted, bool fatLeaves,
+        std::uint32_t depth, std::function<void (SHAMapAbstractNode&,
+            SHAMapNodeID const&)> const& func) const;
+
     // Simple descent
     // Get a child of the specified node
     SHAMapAbstractNode* descend (SHAMapInnerNode*, int branch) const;
@@ -340,6 +416,21 @@ private:
                      std::shared_ptr<SHAMapItem const> const& otherMapItem,
                      bool isFirstMap, Delta & differences, int & maxCount) const;
     int walkSubTree (bool doWrite, NodeObjectType t, std::uint32_t seq);
+
+    /** Flush the dirty inner children of a node.
+        Each child subtree is handed to the Family to flush on another
+        thread. Does nothing unless there are at least two of them.
+        @return The number of nodes flushed.
+    */
+    int walkChildren (std::shared_ptr<SHAMapInnerNode> const& node,
+        bool doWrite, NodeObjectType t, std::uint32_t seq);
+
+    /** Flush the subtree below an inner node we own.
+        @return The shareable replacement for `node`.
+    */
+    std::shared_ptr<SHAMapInnerNode>
+        walkInner (std::shared_ptr<SHAMapInnerNode> node, bool doWrite,
+                   NodeObjectType t, std::uint32_t seq, int& flushed) const;
     bool isInconsistentNode(std::shared_ptr<SHAMapAbstractNode> const& node) const;
 
     // Structure to track information about call to
@@ -402,6 +493,14 @@ void
 SHAMap::setLedgerSeq (std::uint32_t lseq)
 {
     ledgerSeq_ = lseq;
+    shardSeq_ = lseq;
+}
+
+inline
+void
+SHAMap::setShardSeq (std::uint32_t lseq)
+{
+    shardSeq_ = lseq;
 }
 
 inline
@@ -470,6 +569,7 @@ private:
     SharedPtrNodeStack stack_;
     SHAMap const*      map_  = nullptr;
     pointer            item_ = nullptr;
+    std::shared_ptr<ReadAhead> readAhead_;
 
 public:
     const_iterator() = default;
@@ -493,10 +593,15 @@ inline
 SHAMap::const_iterator::const_iterator(SHAMap const* map)
     : map_(map)
     , item_(nullptr)
+    , readAhead_(map->makeReadAhead())
 {
     auto temp = map_->peekFirstItem(stack_);
     if (temp)
+    {
         item_ = temp->peekItem().get();
+        if (readAhead_)
+            map_->readAhead(*readAhead_, stack_);
+    }
 }
 
 inline
@@ -512,7 +617,10 @@ SHAMap::const_iterator::const_iterator(SHAMap const* map, pointer item,
     : stack_(std::move(stack))
     , map_(map)
     , item_(item)
+    , readAhead_(map->makeReadAhead())
 {
+    if (readAhead_)
+        map_->readAhead(*readAhead_, stack_);
 }
 
 inline
@@ -535,7 +643,11 @@ SHAMap::const_iterator::operator++()
 {
     auto temp = map_->peekNextItem(item_->key(), stack_);
     if (temp)
+    {
         item_ = temp->peekItem().get();
+        if (readAhead_)
+            map_->readAhead(*readAhead_, stack_);
+    }
     else
         item_ = nullptr;
     return *this;
@@ -40,6 +40,9 @@
 #include <call/basics/TaggedCache.h>
 #include <call/beast/utility/Journal.h>
 
+#include <array>
+#include <atomic>
+#include <bitset>
 #include <cstdint>
 #include <memory>
 #include <mutex>
@@ -162,16 +165,37 @@ class SHAMapInnerNodeV2;
 class SHAMapInnerNode
     : public SHAMapAbstractNode
 {
-    std::array<SHAMapHash, 16>          mHashes;
-    std::shared_ptr<SHAMapAbstractNode> mChildren[16];
+    // Most inner nodes deep in a tree have only a few children, so we
+    // only store the branches which are present. They are packed in
+    // branch order and located through the mIsBranch bitmask.
+    struct Branch
+    {
+        SHAMapHash                          hash;
+        std::shared_ptr<SHAMapAbstractNode> child;
+    };
+
+    std::unique_ptr<Branch[]>       mBranches;
     int                             mIsBranch = 0;
     std::uint32_t                   mFullBelowGen = 0;
 
     static std::mutex               childLock;
+    static SHAMapHash const         zeroHash;
+
+    static std::atomic<std::int64_t> nodeCount;
+    static std::atomic<std::int64_t> branchBytes;
+
 public:
     SHAMapInnerNode(std::uint32_t seq);
+    ~SHAMapInnerNode() override;
     std::shared_ptr<SHAMapAbstractNode> clone(std::uint32_t seq) const override;
 
+    /** Bytes saved by the sparse layout.
+
+        Computed across all live inner nodes, relative to storing all
+        sixteen hashes and children in every node.
+    */
+    static std::int64_t getBytesSaved ();
+
     bool isEmpty () const;
     bool isEmptyBranch (int m) const;
     int getBranchCount () const;
@@ -195,6 +219,14 @@ public:
     uint256 const& key() const override;
     void invariants(bool is_v2, bool is_root = false) const override;
 
+private:
+    int branchIndex (int m) const;
+    Branch& addBranch (int m);
+    void removeBranch (int m);
+    void setHashes (std::array<SHAMapHash, 16> const& hashes);
+    void copyBranches (SHAMapInnerNode const& other);
+    void relayout (int isBranch);
+
     friend std::shared_ptr<SHAMapAbstractNode>
         SHAMapAbstractNode::make(Slice const& rawNode, std::uint32_t seq,
              SHANodeFormat format, SHAMapHash const& hash, bool hashValid,
@@ -355,6 +387,15 @@ inline
 SHAMapInnerNode::SHAMapInnerNode(std::uint32_t seq)
     : SHAMapAbstractNode(tnINNER, seq)
 {
+    ++nodeCount;
+}
+
+inline
+int
+SHAMapInnerNode::branchIndex (int m) const
+{
+    return static_cast<int>(
+        std::bitset<16>(mIsBranch & ((1 << m) - 1)).count());
 }
 
 inline
@@ -369,7 +410,9 @@ SHAMapHash const&
 SHAMapInnerNode::getChildHash (int m) const
 {
     assert ((m >= 0) && (m < 16) && (getType() == tnINNER));
-    return mHashes[m];
+    if (isEmptyBranch (m))
+        return zeroHash;
+    return mBranches[branchIndex (m)].hash;
 }
 
 inline
@@ -35,14 +35,14 @@
 #ifndef CALL_SHAMAP_TREENODECACHE_H_INCLUDED
 #define CALL_SHAMAP_TREENODECACHE_H_INCLUDED
 
-#include <call/shamap/TreeNodeCache.h>
+#include <call/basics/PartitionedTaggedCache.h>
 #include <call/shamap/SHAMapTreeNode.h>
 
 namespace call {
 
 class SHAMapAbstractNode;
 
-using TreeNodeCache = TaggedCache <uint256, SHAMapAbstractNode>;
+using TreeNodeCache = PartitionedTaggedCache <uint256, SHAMapAbstractNode>;
 
 } // call
 
@@ -35,6 +35,11 @@
 #include <BeastConfig.h>
 #include <call/basics/contract.h>
 #include <call/shamap/SHAMap.h>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
 
 namespace call {
 
@@ -88,6 +93,7 @@ SHAMap::snapShot (bool isMutable) const
     newMap.seq_ = seq_ + 1;
     newMap.root_ = root_;
     newMap.backed_ = backed_;
+    newMap.shardSeq_ = shardSeq_;
 
     if ((state_ != SHAMapState::Immutable) || !isMutable)
     {
@@ -255,6 +261,17 @@ SHAMap::findKey(uint256 const& id) const
     return leaf;
 }
 
+std::shared_ptr<NodeObject>
+SHAMap::fetchFromShard (SHAMapHash const& hash) const
+{
+    if (shardSeq_ != 0)
+    {
+        if (auto const shards = f_.shardStore ())
+            return shards->fetch (hash.as_uint256 (), shardSeq_);
+    }
+    return {};
+}
+
 std::shared_ptr<SHAMapAbstractNode>
 SHAMap::fetchNodeFromDB (SHAMapHash const& hash) const
 {
@@ -263,6 +280,8 @@ SHAMap::fetchNodeFromDB (SHAMapHash const& hash) const
     if (backed_)
     {
         std::shared_ptr<NodeObject> obj = f_.db().fetch (hash.as_uint256());
+        if (! obj)
+            obj = fetchFromShard (hash);
         if (obj)
         {
             try
@@ -502,6 +521,8 @@ SHAMap::descendAsync (SHAMapInnerNode* parent, int branch,
                 pending = true;
                 return nullptr;
             }
+            if (!obj)
+                obj = fetchFromShard (hash);
             if (!obj)
                 return nullptr;
 
@@ -586,7 +607,7 @@ SHAMap::firstBelow(std::shared_ptr<SHAMapAbstractNode> node,
             }
             else
             {
-                stack.push({inner, stack.top().second.getChildNodeID(branch)});
+                stack.push({inner, stack.top().second.getChildNodeID(i)});
             }
             i = 0;  // scan all 16 branches of this new node
         }
@@ -596,6 +617,101 @@ SHAMap::firstBelow(std::shared_ptr<SHAMapAbstractNode> node,
     return nullptr;
 }
 
+std::shared_ptr<SHAMap::ReadAhead>
+SHAMap::makeReadAhead () const
+{
+    if (! backed_)
+        return {};
+    auto const distance = f_.readAhead ();
+    if (distance <= 0)
+        return {};
+    return std::make_shared<ReadAhead> (distance);
+}
+
+bool
+SHAMap::readAhead (ReadAhead& ra, SHAMapInnerNode& node, int branch) const
+{
+    for (; branch < 16; ++branch)
+    {
+        if (ra.pending.size () >= ra.distance)
+            return false;
+
+        if (node.isEmptyBranch (branch) || node.getChildPointer (branch))
+            continue;
+
+        auto const& hash = node.getChildHash (branch);
+        if (! ra.pending.insert (hash.as_uint256 ()).second)
+            continue;
+
+        // The read lands in the database cache, where the walk's own
+        // fetch of the node finds it.
+        std::shared_ptr<NodeObject> object;
+        if (! getCache (hash))
+            f_.db ().asyncFetch (hash.as_uint256 (), object);
+    }
+    return true;
+}
+
+void
+SHAMap::readAhead (ReadAhead& ra, SharedPtrNodeStack const& stack) const
+{
+    auto const& path = stack.path ();
+    if (path.size () < 2)
+        return;
+
+    readReached (ra, path.back ().first->getNodeHash ());
+
+    // Siblings of the leaf were read ahead when we reached its parent
+    auto const& parent = path[path.size () - 2].first;
+    if (parent == ra.parent)
+        return;
+
+    // Every node we passed since the last parent was reached through
+    // the nodes now on the path. Forget the reads still pending for
+    // them and their earlier siblings.
+    std::vector<SHAMapInnerNode*> inners;
+    std::vector<int> branches;
+    inners.reserve (path.size () - 1);
+    branches.reserve (path.size () - 1);
+    for (std::size_t i = 0; i + 1 < path.size (); ++i)
+    {
+        auto inner = static_cast<SHAMapInnerNode*> (path[i].first.get ());
+        auto const child = path[i + 1].first.get ();
+        int branch = 0;
+        while (branch < 16 && inner->getChildPointer (branch) != child)
+            ++branch;
+        assert (branch < 16);
+        for (int b = 0; b <= branch && b < 16; ++b)
+        {
+            if (! inner->isEmptyBranch (b))
+                readReached (ra, inner->getChildHash (b));
+        }
+        inners.push_back (inner);
+        branches.push_back (branch + 1);
+    }
+    if (ra.parent)
+    {
+        // The children of a node we left entirely
+        auto const old = static_cast<SHAMapInnerNode*> (ra.parent.get ());
+        if (std::find (inners.begin (), inners.end (), old) == inners.end ())
+        {
+            for (int b = 0; b < 16; ++b)
+            {
+                if (! old->isEmptyBranch (b))
+                    readReached (ra, old->getChildHash (b));
+            }
+        }
+    }
+    ra.parent = parent;
+
+    // The nearest upcoming siblings are the deepest
+    for (auto i = inners.size (); i-- > 0;)
+    {
+        if (! readAhead (ra, *inners[i], branches[i]))
+            break;
+    }
+}
+
 static const std::shared_ptr<SHAMapItem const> no_item;
 
 std::shared_ptr<SHAMapItem const> const&
@@ -1174,7 +1290,6 @@ int
 SHAMap::walkSubTree (bool doWrite, NodeObjectType t, std::uint32_t seq)
 {
     int flushed = 0;
-    Serializer s;
 
     if (!root_ || (root_->getSeq() == 0))
         return flushed;
@@ -1201,13 +1316,128 @@ SHAMap::walkSubTree (bool doWrite, NodeObjectType t, std::uint32_t seq)
         return 1;
     }
 
+    node = preFlushNode(std::move(node));
+
+    // Flush the inner children of the root concurrently, if we can.
+    // What remains is the root and its direct leaves.
+    flushed += walkChildren (node, doWrite, t, seq);
+
+    // Last inner node is the new root_
+    root_ = walkInner (std::move (node), doWrite, t, seq, flushed);
+
+    return flushed;
+}
+
+int
+SHAMap::walkChildren (std::shared_ptr<SHAMapInnerNode> const& node,
+    bool doWrite, NodeObjectType t, std::uint32_t seq)
+{
+    struct Task
+    {
+        int branch;
+        std::shared_ptr<SHAMapInnerNode> node;
+        int flushed = 0;
+        std::exception_ptr error;
+    };
+
+    struct State
+    {
+        std::vector<Task> tasks;
+        std::atomic<std::size_t> next {0};
+        std::mutex mutex;
+        std::condition_variable cv;
+        std::size_t done = 0;
+    };
+
+    std::array<int, 16> branches;
+    std::size_t count = 0;
+
+    for (int branch = 0; branch < 16; ++branch)
+    {
+        if (node->isEmptyBranch (branch))
+            continue;
+
+        auto const child = node->getChildPointer (branch);
+        if (child && child->getSeq() != 0 && child->isInner ())
+            branches[count++] = branch;
+    }
+
+    // Not worth scheduling anything for a single subtree
+    if (count < 2)
+        return 0;
+
+    auto state = std::make_shared<State>();
+    state->tasks.reserve (count);
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        auto child = std::static_pointer_cast<SHAMapInnerNode>(
+            node->getChild (branches[i]));
+        state->tasks.push_back ({branches[i], preFlushNode (std::move (child))});
+    }
+
+    // Subtrees are claimed one at a time by whoever gets to them first,
+    // including this thread, so we never wait on work that nobody has
+    // started. Helpers which start after everything is claimed do nothing.
+    auto work = [this, state, doWrite, t, seq]()
+    {
+        std::size_t i;
+        while ((i = state->next++) < state->tasks.size ())
+        {
+            auto& task = state->tasks[i];
+            try
+            {
+                task.node = walkInner (std::move (task.node),
+                    doWrite, t, seq, task.flushed);
+            }
+            catch (...)
+            {
+                task.error = std::current_exception ();
+            }
+
+            std::lock_guard<std::mutex> lock (state->mutex);
+            if (++state->done == state->tasks.size ())
+                state->cv.notify_all ();
+        }
+    };
+
+    for (std::size_t i = 1; i < count; ++i)
+    {
+        if (! f_.dispatch (work))
+            break;
+    }
+
+    work ();
+
+    {
+        std::unique_lock<std::mutex> lock (state->mutex);
+        state->cv.wait (lock,
+            [&state]{ return state->done == state->tasks.size (); });
+    }
+
+    // Hook the flushed subtrees back in branch order, so the result
+    // does not depend on which thread finished first
+    int flushed = 0;
+    for (auto& task : state->tasks)
+    {
+        if (task.error)
+            std::rethrow_exception (task.error);
+
+        node->shareChild (task.branch, std::move (task.node));
+        flushed += task.flushed;
+    }
+
+    return flushed;
+}
+
+std::shared_ptr<SHAMapInnerNode>
+SHAMap::walkInner (std::shared_ptr<SHAMapInnerNode> node,
+    bool doWrite, NodeObjectType t, std::uint32_t seq, int& flushed) const
+{
     // Stack of {parent,index,child} pointers representing
     // inner nodes we are in the process of flushing
     using StackEntry = std::pair <std::shared_ptr<SHAMapInnerNode>, int>;
     std::stack <StackEntry, std::vector<StackEntry>> stack;
 
-    node = preFlushNode(std::move(node));
-
     int pos = 0;
 
     // We can't flush an inner node until we flush its children
@@ -1288,10 +1518,7 @@ SHAMap::walkSubTree (bool doWrite, NodeObjectType t, std::uint32_t seq)
         ++pos;
     }
 
-    // Last inner node is the new root_
-    root_ = std::move (node);
-
-    return flushed;
+    return node;
 }
 
 void SHAMap::dump (bool hash) const
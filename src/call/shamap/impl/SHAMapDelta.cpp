@@ -248,25 +248,42 @@ void SHAMap::walkMap (std::vector<SHAMapMissingNode>& missingNodes, int maxMissi
         return;
 
     using StackEntry = std::shared_ptr<SHAMapInnerNode>;
-    std::stack <StackEntry, std::vector <StackEntry>> nodeStack;
+    std::vector <StackEntry> nodeStack;
 
-    nodeStack.push (std::static_pointer_cast<SHAMapInnerNode>(root_));
+    nodeStack.push_back (std::static_pointer_cast<SHAMapInnerNode>(root_));
+
+    auto ra = makeReadAhead ();
 
     while (!nodeStack.empty ())
     {
-        std::shared_ptr<SHAMapInnerNode> node = std::move (nodeStack.top());
-        nodeStack.pop ();
+        std::shared_ptr<SHAMapInnerNode> node = std::move (nodeStack.back());
+        nodeStack.pop_back ();
+
+        if (ra)
+        {
+            // The children of the nodes still on the stack come next,
+            // the most recently pushed first
+            if (readAhead (*ra, *node, 0))
+            {
+                for (auto it = nodeStack.rbegin ();
+                        it != nodeStack.rend () && readAhead (*ra, **it, 0);
+                        ++it)
+                    ;
+            }
+        }
 
         for (int i = 0; i < 16; ++i)
         {
             if (!node->isEmptyBranch (i))
             {
                 std::shared_ptr<SHAMapAbstractNode> nextNode = descendNoStore (node, i);
+                if (ra)
+                    readReached (*ra, node->getChildHash (i));
 
                 if (nextNode)
                 {
                     if (nextNode->isInner ())
-                        nodeStack.push(
+                        nodeStack.push_back(
                             std::static_pointer_cast<SHAMapInnerNode>(nextNode));
                 }
                 else
@@ -66,11 +66,28 @@ void SHAMap::visitNodes(std::function<bool (SHAMapAbstractNode&)> const& functio
         return;
 
     using StackEntry = std::pair <int, std::shared_ptr<SHAMapInnerNode>>;
-    std::stack <StackEntry, std::vector <StackEntry>> stack;
+    std::vector <StackEntry> stack;
 
     auto node = std::static_pointer_cast<SHAMapInnerNode>(root_);
     int pos = 0;
 
+    auto ra = makeReadAhead ();
+    auto const prefetch = [&]
+    {
+        // The nodes we visit next are the rest of this node's
+        // children, then the rest of each saved node's
+        if (readAhead (*ra, *node, pos))
+        {
+            for (auto it = stack.rbegin ();
+                    it != stack.rend () &&
+                        readAhead (*ra, *it->second, it->first);
+                    ++it)
+                ;
+        }
+    };
+    if (ra)
+        prefetch ();
+
     while (1)
     {
         while (pos < 16)
@@ -79,6 +96,8 @@ void SHAMap::visitNodes(std::function<bool (SHAMapAbstractNode&)> const& functio
             if (!node->isEmptyBranch (pos))
             {
                 std::shared_ptr<SHAMapAbstractNode> child = descendNoStore (node, pos);
+                if (ra)
+                    readReached (*ra, node->getChildHash (pos));
                 if (function (*child))
                     return;
 
@@ -93,12 +112,15 @@ void SHAMap::visitNodes(std::function<bool (SHAMapAbstractNode&)> const& functio
                     if (pos != 15)
                     {
                         // save next position to resume at
-                        stack.push (std::make_pair(pos + 1, std::move (node)));
+                        stack.emplace_back (pos + 1, std::move (node));
                     }
 
                     // descend to the child's first position
                     node = std::static_pointer_cast<SHAMapInnerNode>(child);
                     pos = 0;
+
+                    if (ra)
+                        prefetch ();
                 }
             }
             else
@@ -110,8 +132,8 @@ void SHAMap::visitNodes(std::function<bool (SHAMapAbstractNode&)> const& functio
         if (stack.empty ())
             break;
 
-        std::tie(pos, node) = stack.top ();
-        stack.pop ();
+        std::tie(pos, node) = stack.back ();
+        stack.pop_back ();
     }
 }
 
@@ -376,10 +398,9 @@ std::vector<uint256> SHAMap::getNeededHashes (int max, SHAMapSyncFilter* filter)
     return hashes;
 }
 
-bool SHAMap::getNodeFat (SHAMapNodeID wanted,
-    std::vector<SHAMapNodeID>& nodeIDs,
-        std::vector<Blob>& rawNodes, bool fatLeaves,
-            std::uint32_t depth) const
+bool SHAMap::visitNodeFat (SHAMapNodeID const& wanted, bool fatLeaves,
+    std::uint32_t depth, std::function<void (SHAMapAbstractNode&,
+        SHAMapNodeID const&)> const& func) const
 {
     // Gets a node and some of its children
     // to a specified depth
@@ -427,10 +448,7 @@ bool SHAMap::getNodeFat (SHAMapNodeID wanted,
         stack.pop ();
 
         // Add this node to the reply
-        Serializer s;
-        node->addRaw (s, snfWIRE);
-        nodeIDs.push_back (nodeID);
-        rawNodes.push_back (std::move (s.peekData()));
+        func (*node, nodeID);
 
         if (node->isInner())
         {
@@ -463,10 +481,7 @@ bool SHAMap::getNodeFat (SHAMapNodeID wanted,
                         else if (childNode->isInner() || fatLeaves)
                         {
                             // Just include this node
-                            Serializer ns;
-                            childNode->addRaw (ns, snfWIRE);
-                            nodeIDs.push_back (childID);
-                            rawNodes.push_back (std::move (ns.peekData ()));
+                            func (*childNode, childID);
                         }
                     }
                 }
@@ -477,6 +492,73 @@ bool SHAMap::getNodeFat (SHAMapNodeID wanted,
     return true;
 }
 
+bool SHAMap::getNodeFat (SHAMapNodeID wanted,
+    std::vector<SHAMapNodeID>& nodeIDs,
+        std::vector<Blob>& rawNodes, bool fatLeaves,
+            std::uint32_t depth) const
+{
+    return visitNodeFat (wanted, fatLeaves, depth,
+        [&](SHAMapAbstractNode& node, SHAMapNodeID const& nodeID)
+        {
+            Serializer s;
+            node.addRaw (s, snfWIRE);
+            nodeIDs.push_back (nodeID);
+            rawNodes.push_back (std::move (s.peekData ()));
+        });
+}
+
+// Get the wire format of a node, serializing it only if the
+// cache does not already hold it. Nodes whose hash has not been
+// computed yet are never cached.
+static
+std::shared_ptr<Blob>
+wireNode (SHAMapAbstractNode& node, WireNodeCache& cache)
+{
+    auto const& key = node.getNodeHash ().as_uint256 ();
+
+    if (key.isNonZero ())
+    {
+        if (auto blob = cache.fetch (key))
+            return blob;
+    }
+
+    Serializer s;
+    node.addRaw (s, snfWIRE);
+    auto blob = std::make_shared<Blob> (std::move (s.modData ()));
+    if (key.isNonZero ())
+        cache.canonicalize (key, blob);
+    return blob;
+}
+
+bool SHAMap::getNodeFat (SHAMapNodeID wanted,
+    std::vector<SHAMapNodeID>& nodeIDs,
+        std::vector<std::shared_ptr<Blob>>& rawNodes, bool fatLeaves,
+            std::uint32_t depth, WireNodeCache& cache) const
+{
+    return visitNodeFat (wanted, fatLeaves, depth,
+        [&](SHAMapAbstractNode& node, SHAMapNodeID const& nodeID)
+        {
+            nodeIDs.push_back (nodeID);
+            rawNodes.push_back (wireNode (node, cache));
+        });
+}
+
+std::size_t SHAMap::cacheWireNodes (WireNodeCache& cache,
+    SHAMap const* have) const
+{
+    std::size_t count = 0;
+
+    visitDifferences (have,
+        [&](SHAMapAbstractNode& node)
+        {
+            wireNode (node, cache);
+            ++count;
+            return true;
+        });
+
+    return count;
+}
+
 bool SHAMap::getRootNode (Serializer& s, SHANodeFormat format) const
 {
     root_->addRaw (s, format);
@@ -41,6 +41,7 @@
 #include <call/basics/StringUtilities.h>
 #include <call/protocol/HashPrefix.h>
 #include <call/beast/core/LexicalCast.h>
+#include <bitset>
 #include <mutex>
 
 #include <openssl/sha.h>
@@ -48,23 +49,112 @@
 namespace call {
 
 std::mutex SHAMapInnerNode::childLock;
+SHAMapHash const SHAMapInnerNode::zeroHash;
+std::atomic<std::int64_t> SHAMapInnerNode::nodeCount {0};
+std::atomic<std::int64_t> SHAMapInnerNode::branchBytes {0};
 
 SHAMapAbstractNode::~SHAMapAbstractNode() = default;
 
+SHAMapInnerNode::~SHAMapInnerNode()
+{
+    --nodeCount;
+    branchBytes -= getBranchCount () *
+        static_cast<std::int64_t>(sizeof (Branch));
+}
+
+std::int64_t
+SHAMapInnerNode::getBytesSaved ()
+{
+    // What every node would need with a fixed array of sixteen branches
+    return nodeCount * 16 * static_cast<std::int64_t>(sizeof (Branch)) -
+        branchBytes;
+}
+
+// Rebuild the packed branch array for the branches in isBranch, keeping
+// the hashes and children of branches present in both layouts.
+void
+SHAMapInnerNode::relayout (int isBranch)
+{
+    auto const count = static_cast<int>(std::bitset<16>(isBranch).count());
+
+    std::unique_ptr<Branch[]> branches;
+    if (count != 0)
+        branches = std::make_unique<Branch[]>(count);
+
+    for (int i = 0, from = 0, to = 0; i < 16; ++i)
+    {
+        bool const had = (mIsBranch & (1 << i)) != 0;
+        bool const has = (isBranch & (1 << i)) != 0;
+
+        if (had && has)
+            branches[to] = std::move (mBranches[from]);
+
+        from += had;
+        to += has;
+    }
+
+    branchBytes += (count - getBranchCount ()) *
+        static_cast<std::int64_t>(sizeof (Branch));
+    mBranches = std::move (branches);
+    mIsBranch = isBranch;
+}
+
+SHAMapInnerNode::Branch&
+SHAMapInnerNode::addBranch (int m)
+{
+    if (isEmptyBranch (m))
+        relayout (mIsBranch | (1 << m));
+    return mBranches[branchIndex (m)];
+}
+
+void
+SHAMapInnerNode::removeBranch (int m)
+{
+    if (!isEmptyBranch (m))
+        relayout (mIsBranch & ~(1 << m));
+}
+
+void
+SHAMapInnerNode::setHashes (std::array<SHAMapHash, 16> const& hashes)
+{
+    int isBranch = 0;
+    for (int i = 0; i < 16; ++i)
+    {
+        if (hashes[i].isNonZero ())
+            isBranch |= (1 << i);
+    }
+
+    relayout (isBranch);
+
+    for (int i = 0, j = 0; i < 16; ++i)
+    {
+        if (hashes[i].isNonZero ())
+            mBranches[j++].hash = hashes[i];
+    }
+}
+
+// The caller must hold childLock
+void
+SHAMapInnerNode::copyBranches (SHAMapInnerNode const& other)
+{
+    relayout (other.mIsBranch);
+
+    for (int i = 0, count = getBranchCount (); i < count; ++i)
+        mBranches[i] = other.mBranches[i];
+}
+
 std::shared_ptr<SHAMapAbstractNode>
 SHAMapInnerNode::clone(std::uint32_t seq) const
 {
     auto p = std::make_shared<SHAMapInnerNode>(seq);
     p->mHash = mHash;
-    p->mIsBranch = mIsBranch;
     p->mFullBelowGen = mFullBelowGen;
-    p->mHashes = mHashes;
     std::lock_guard <std::mutex> lock(childLock);
-    for (int i = 0; i < 16; ++i)
-    {
-        p->mChildren[i] = mChildren[i];
-        assert(std::dynamic_pointer_cast<SHAMapInnerNodeV2>(p->mChildren[i]) == nullptr);
-    }
+    p->copyBranches (*this);
+#ifndef NDEBUG
+    for (int i = 0, count = p->getBranchCount (); i < count; ++i)
+        assert(std::dynamic_pointer_cast<SHAMapInnerNodeV2>(p->mBranches[i].child) == nullptr);
+#endif
     return std::move(p);
 }
 
@@ -73,19 +163,20 @@ SHAMapInnerNodeV2::clone(std::uint32_t seq) const
 {
     auto p = std::make_shared<SHAMapInnerNodeV2>(seq);
     p->mHash = mHash;
-    p->mIsBranch = mIsBranch;
     p->mFullBelowGen = mFullBelowGen;
-    p->mHashes = mHashes;
     p->common_ = common_;
     p->depth_ = depth_;
     std::lock_guard <std::mutex> lock(childLock);
-    for (int i = 0; i < 16; ++i)
+    p->copyBranches (*this);
+#ifndef NDEBUG
+    for (int i = 0, count = p->getBranchCount (); i < count; ++i)
     {
-        p->mChildren[i] = mChildren[i];
-        if (p->mChildren[i] != nullptr)
-            assert(std::dynamic_pointer_cast<SHAMapInnerNodeV2>(p->mChildren[i]) != nullptr ||
-                   std::dynamic_pointer_cast<SHAMapTreeNode>(p->mChildren[i]) != nullptr);
+        auto const& child = p->mBranches[i].child;
+        if (child != nullptr)
+            assert(std::dynamic_pointer_cast<SHAMapInnerNodeV2>(child) != nullptr ||
+                   std::dynamic_pointer_cast<SHAMapTreeNode>(child) != nullptr);
     }
+#endif
     return std::move(p);
 }
 
@@ -163,13 +254,10 @@ SHAMapAbstractNode::make(Slice const& rawNode, std::uint32_t seq, SHANodeFormat
                 Throw<std::runtime_error> ("invalid FI node");
 
             auto ret = std::make_shared<SHAMapInnerNode>(seq);
+            std::array<SHAMapHash, 16> hashes;
             for (int i = 0; i < 16; ++i)
-            {
-                s.get256 (ret->mHashes[i].as_uint256(), i * 32);
-
-                if (ret->mHashes[i].isNonZero ())
-                    ret->mIsBranch |= (1 << i);
-            }
+                s.get256 (hashes[i].as_uint256(), i * 32);
+            ret->setHashes (hashes);
             if (hashValid)
                 ret->mHash = hash;
             else
@@ -180,6 +268,7 @@ SHAMapAbstractNode::make(Slice const& rawNode, std::uint32_t seq, SHANodeFormat
         {
             auto ret = std::make_shared<SHAMapInnerNode>(seq);
             // compressed inner
+            std::array<SHAMapHash, 16> hashes;
             for (int i = 0; i < (len / 33); ++i)
             {
                 int pos;
@@ -187,10 +276,9 @@ SHAMapAbstractNode::make(Slice const& rawNode, std::uint32_t seq, SHANodeFormat
                     Throw<std::runtime_error> ("short CI node");
                 if ((pos < 0) || (pos >= 16))
                     Throw<std::runtime_error> ("invalid CI node");
-                s.get256 (ret->mHashes[pos].as_uint256(), i * 33);
-                if (ret->mHashes[pos].isNonZero ())
-                    ret->mIsBranch |= (1 << pos);
+                s.get256 (hashes[pos].as_uint256(), i * 33);
             }
+            ret->setHashes (hashes);
             if (hashValid)
                 ret->mHash = hash;
             else
@@ -222,13 +310,10 @@ SHAMapAbstractNode::make(Slice const& rawNode, std::uint32_t seq, SHANodeFormat
                 Throw<std::runtime_error> ("invalid FI node");
 
             auto ret = std::make_shared<SHAMapInnerNodeV2>(seq);
+            std::array<SHAMapHash, 16> hashes;
             for (int i = 0; i < 16; ++i)
-            {
-                s.get256 (ret->mHashes[i].as_uint256(), i * 32);
-
-                if (ret->mHashes[i].isNonZero ())
-                    ret->mIsBranch |= (1 << i);
-            }
+                s.get256 (hashes[i].as_uint256(), i * 32);
+            ret->setHashes (hashes);
             ret->set_common(id.getDepth(), id.getNodeID());
             if (hashValid)
                 ret->mHash = hash;
@@ -240,6 +325,7 @@ SHAMapAbstractNode::make(Slice const& rawNode, std::uint32_t seq, SHANodeFormat
         {
             auto ret = std::make_shared<SHAMapInnerNodeV2>(seq);
             // compressed v2 inner
+            std::array<SHAMapHash, 16> hashes;
             for (int i = 0; i < (len / 33); ++i)
             {
                 int pos;
@@ -247,10 +333,9 @@ SHAMapAbstractNode::make(Slice const& rawNode, std::uint32_t seq, SHANodeFormat
                     Throw<std::runtime_error> ("short CI node");
                 if ((pos < 0) || (pos >= 16))
                     Throw<std::runtime_error> ("invalid CI node");
-                s.get256 (ret->mHashes[pos].as_uint256(), i * 33);
-                if (ret->mHashes[pos].isNonZero ())
-                    ret->mIsBranch |= (1 << pos);
+                s.get256 (hashes[pos].as_uint256(), i * 33);
             }
+            ret->setHashes (hashes);
             ret->set_common(id.getDepth(), id.getNodeID());
             if (hashValid)
                 ret->mHash = hash;
@@ -320,13 +405,10 @@ SHAMapAbstractNode::make(Slice const& rawNode, std::uint32_t seq, SHANodeFormat
             else
                 ret = std::make_shared<SHAMapInnerNode>(seq);
 
+            std::array<SHAMapHash, 16> hashes;
             for (int i = 0; i < 16; ++i)
-            {
-                s.get256 (ret->mHashes[i].as_uint256(), i * 32);
-
-                if (ret->mHashes[i].isNonZero ())
-                    ret->mIsBranch |= (1 << i);
-            }
+                s.get256 (hashes[i].as_uint256(), i * 32);
+            ret->setHashes (hashes);
 
             if (isV2)
             {
@@ -383,8 +465,8 @@ SHAMapInnerNode::updateHash()
         sha512_half_hasher h;
         using beast::hash_append;
         hash_append(h, HashPrefix::innerNode);
-        for(auto const& hh : mHashes)
-            hash_append(h, hh);
+        for (int i = 0; i < 16; ++i)
+            hash_append(h, getChildHash (i));
         nh = static_cast<typename
             sha512_half_hasher::result_type>(h);
     }
@@ -397,10 +479,11 @@ SHAMapInnerNode::updateHash()
 void
 SHAMapInnerNode::updateHashDeep()
 {
-    for (auto pos = 0; pos < 16; ++pos)
+    for (int i = 0, count = getBranchCount (); i < count; ++i)
     {
-        if (mChildren[pos] != nullptr)
-            mHashes[pos] = mChildren[pos]->getNodeHash();
+        auto& branch = mBranches[i];
+        if (branch.child != nullptr)
+            branch.hash = branch.child->getNodeHash();
     }
     updateHash();
 }
@@ -456,18 +539,18 @@ SHAMapInnerNode::addRaw(Serializer& s, SHANodeFormat format) const
         {
             s.add32 (HashPrefix::innerNode);
 
-            for (auto const& hh : mHashes)
-                s.add256 (hh.as_uint256());
+            for (int i = 0; i < 16; ++i)
+                s.add256 (getChildHash (i).as_uint256());
         }
         else  // format == snfWIRE
         {
             if (getBranchCount () < 12)
             {
                 // compressed node
-                for (int i = 0; i < mHashes.size(); ++i)
+                for (int i = 0; i < 16; ++i)
                     if (!isEmptyBranch (i))
                     {
-                        s.add256 (mHashes[i].as_uint256());
+                        s.add256 (getChildHash (i).as_uint256());
                         s.add8 (i);
                     }
 
@@ -475,8 +558,8 @@ SHAMapInnerNode::addRaw(Serializer& s, SHANodeFormat format) const
             }
             else
             {
-                for (auto const& hh : mHashes)
-                    s.add256 (hh.as_uint256());
+                for (int i = 0; i < 16; ++i)
+                    s.add256 (getChildHash (i).as_uint256());
 
                 s.add8 (2);
             }
@@ -494,7 +577,7 @@ SHAMapInnerNodeV2::addRaw(Serializer& s, SHANodeFormat format) const
         s.add32 (HashPrefix::innerNodeV2);
 
         for (int i = 0 ; i < 16; ++i)
-            s.add256 (mHashes[i].as_uint256());
+            s.add256 (getChildHash (i).as_uint256());
 
         s.add8(depth_);
 
@@ -607,13 +690,7 @@ bool SHAMapInnerNode::isEmpty () const
 int SHAMapInnerNode::getBranchCount () const
 {
     assert (isInner ());
-    int count = 0;
-
-    for (int i = 0; i < 16; ++i)
-        if (!isEmptyBranch (i))
-            ++count;
-
-    return count;
+    return static_cast<int>(std::bitset<16>(mIsBranch).count());
 }
 
 #ifdef BEAST_DEBUG
@@ -642,14 +719,14 @@ std::string
 SHAMapInnerNode::getString(const SHAMapNodeID & id) const
 {
     std::string ret = SHAMapAbstractNode::getString(id);
-    for (int i = 0; i < mHashes.size(); ++i)
+    for (int i = 0; i < 16; ++i)
     {
         if (!isEmptyBranch (i))
         {
             ret += "\nb";
             ret += beast::lexicalCastThrow <std::string> (i);
             ret += " = ";
-            ret += to_string (mHashes[i]);
+            ret += to_string (getChildHash (i));
         }
     }
     return ret;
@@ -685,13 +762,17 @@ SHAMapInnerNode::setChild(int m, std::shared_ptr<SHAMapAbstractNode> const& chil
     assert (mType == tnINNER);
     assert (mSeq != 0);
     assert (child.get() != this);
-    mHashes[m].zero();
     mHash.zero();
     if (child)
-        mIsBranch |= (1 << m);
+    {
+        auto& branch = addBranch (m);
+        branch.hash.zero();
+        branch.child = child;
+    }
     else
-        mIsBranch &= ~ (1 << m);
-    mChildren[m] = child;
+    {
+        removeBranch (m);
+    }
 }
 
 // finished modifying, now make shareable
@@ -702,8 +783,9 @@ void SHAMapInnerNode::shareChild (int m, std::shared_ptr<SHAMapAbstractNode> con
     assert (mSeq != 0);
     assert (child);
     assert (child.get() != this);
+    assert (!isEmptyBranch (m));
 
-    mChildren[m] = child;
+    mBranches[branchIndex (m)].child = child;
 }
 
 SHAMapAbstractNode*
@@ -713,7 +795,9 @@ SHAMapInnerNode::getChildPointer (int branch)
     assert (isInner());
 
     std::lock_guard <std::mutex> lock (childLock);
-    return mChildren[branch].get ();
+    if (isEmptyBranch (branch))
+        return nullptr;
+    return mBranches[branchIndex (branch)].child.get ();
 }
 
 std::shared_ptr<SHAMapAbstractNode>
@@ -723,7 +807,9 @@ SHAMapInnerNode::getChild (int branch)
     assert (isInner());
 
     std::lock_guard <std::mutex> lock (childLock);
-    return mChildren[branch];
+    if (isEmptyBranch (branch))
+        return {};
+    return mBranches[branchIndex (branch)].child;
 }
 
 std::shared_ptr<SHAMapAbstractNode>
@@ -732,20 +818,21 @@ SHAMapInnerNode::canonicalizeChild(int branch, std::shared_ptr<SHAMapAbstractNod
     assert (branch >= 0 && branch < 16);
     assert (isInner());
     assert (node);
-    assert (node->getNodeHash() == mHashes[branch]);
+    assert (node->getNodeHash() == getChildHash (branch));
 
     std::lock_guard <std::mutex> lock (childLock);
-    if (mChildren[branch])
+    auto& child = mBranches[branchIndex (branch)].child;
+    if (child)
     {
         // There is already a node hooked up, return it
-        node = mChildren[branch];
+        node = child;
     }
     else
     {
         // Hook this node up
         // node must not be a v2 inner node
         assert(std::dynamic_pointer_cast<SHAMapInnerNodeV2>(node) == nullptr);
-        mChildren[branch] = node;
+        child = node;
     }
     return node;
 }
@@ -756,13 +843,14 @@ SHAMapInnerNodeV2::canonicalizeChild(int branch, std::shared_ptr<SHAMapAbstractN
     assert (branch >= 0 && branch < 16);
     assert (isInner());
     assert (node);
-    assert (node->getNodeHash() == mHashes[branch]);
+    assert (node->getNodeHash() == getChildHash (branch));
 
     std::lock_guard <std::mutex> lock (childLock);
-    if (mChildren[branch])
+    auto& child = mBranches[branchIndex (branch)].child;
+    if (child)
     {
         // There is already a node hooked up, return it
-        node = mChildren[branch];
+        node = child;
     }
     else
     {
@@ -770,7 +858,7 @@ SHAMapInnerNodeV2::canonicalizeChild(int branch, std::shared_ptr<SHAMapAbstractN
         // node must not be a v1 inner node
         assert(std::dynamic_pointer_cast<SHAMapInnerNodeV2>(node) != nullptr ||
                std::dynamic_pointer_cast<SHAMapTreeNode>(node)    != nullptr);
-        mChildren[branch] = node;
+        child = node;
     }
     return node;
 }
@@ -842,10 +930,9 @@ SHAMapInnerNodeV2::setChildren(std::shared_ptr<SHAMapTreeNode> const& child1,
         b2 = *k2 >> 4;
         depth_ = 2*depth_;
     }
-    mChildren[b1] = child1;
-    mIsBranch |= 1 << b1;
-    mChildren[b2] = child2;
-    mIsBranch |= 1 << b2;
+    relayout (mIsBranch | (1 << b1) | (1 << b2));
+    mBranches[branchIndex (b1)].child = child1;
+    mBranches[branchIndex (b2)].child = child2;
 }
 
 void
@@ -883,11 +970,12 @@ SHAMapInnerNode::invariants(bool is_v2, bool is_root) const
     unsigned count = 0;
     for (int i = 0; i < 16; ++i)
     {
-        if (mHashes[i].isNonZero())
+        if (getChildHash(i).isNonZero())
         {
             assert((mIsBranch & (1 << i)) != 0);
-            if (mChildren[i] != nullptr)
-                mChildren[i]->invariants(is_v2);
+            auto const& child = mBranches[branchIndex(i)].child;
+            if (child != nullptr)
+                child->invariants(is_v2);
             ++count;
         }
         else
@@ -911,21 +999,22 @@ SHAMapInnerNodeV2::invariants(bool is_v2, bool is_root) const
     unsigned count = 0;
     for (int i = 0; i < 16; ++i)
     {
-        if (mHashes[i].isNonZero())
+        if (getChildHash(i).isNonZero())
         {
             assert((mIsBranch & (1 << i)) != 0);
-            if (mChildren[i] != nullptr)
+            auto const& child = mBranches[branchIndex(i)].child;
+            if (child != nullptr)
             {
-                assert(mHashes[i] == mChildren[i]->getNodeHash());
+                assert(getChildHash(i) == child->getNodeHash());
 #ifndef NDEBUG
-                auto const& childID = mChildren[i]->key();
+                auto const& childID = child->key();
 
                 // Make sure this child it attached to the correct branch
                 SHAMapNodeID nodeID {depth(), common()};
                 assert (i == nodeID.selectBranch(childID));
 #endif
                 assert(has_common_prefix(childID));
-                mChildren[i]->invariants(is_v2);
+                child->invariants(is_v2);
             }
             ++count;
         }
@@ -42,5 +42,6 @@
 #include <call/app/ledger/impl/LocalTxs.cpp>
 #include <call/app/ledger/impl/OpenLedger.cpp>
 #include <call/app/ledger/impl/LedgerToJson.cpp>
+#include <call/app/ledger/impl/StateDiff.cpp>
 #include <call/app/ledger/impl/TransactionAcquire.cpp>
 #include <call/app/ledger/impl/TransactionMaster.cpp>
@@ -34,8 +34,10 @@
 
 #include <BeastConfig.h>
 
+#include <call/app/misc/impl/AccountTxIndex.cpp>
 #include <call/app/misc/impl/AccountTxPaging.cpp>
 #include <call/app/misc/impl/AmendmentTable.cpp>
+#include <call/app/misc/impl/BatchVerifier.cpp>
 #include <call/app/misc/impl/LoadFeeTrack.cpp>
 #include <call/app/misc/impl/Manifest.cpp>
 #include <call/app/misc/impl/Transaction.cpp>
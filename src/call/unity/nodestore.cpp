@@ -43,9 +43,11 @@
 #include <call/nodestore/impl/BatchWriter.cpp>
 #include <call/nodestore/impl/DatabaseImp.h>
 #include <call/nodestore/impl/DatabaseRotatingImp.cpp>
+#include <call/nodestore/impl/DatabaseShardImp.cpp>
 #include <call/nodestore/impl/DummyScheduler.cpp>
 #include <call/nodestore/impl/DecodedBlob.cpp>
 #include <call/nodestore/impl/EncodedBlob.cpp>
 #include <call/nodestore/impl/ManagerImp.cpp>
 #include <call/nodestore/impl/NodeObject.cpp>
+#include <call/nodestore/impl/Shard.cpp>
 
@@ -36,8 +36,10 @@
 
 #include <call/overlay/impl/PeerImp.cpp>
 #include <call/overlay/impl/PeerSet.cpp>
+#include <call/overlay/impl/Squelch.cpp>
 #include <call/overlay/impl/TMHello.cpp>
 #include <call/overlay/impl/TrafficCount.cpp>
+#include <call/overlay/impl/TxBatch.cpp>
 
 #if DOXYGEN
 #include <call/overlay/README.md>
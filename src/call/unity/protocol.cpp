@@ -68,6 +68,7 @@
 #include <call/protocol/impl/STInteger.cpp>
 #include <call/protocol/impl/STLedgerEntry.cpp>
 #include <call/protocol/impl/STObject.cpp>
+#include <call/protocol/impl/STObjectView.cpp>
 #include <call/protocol/impl/STParsedJSON.cpp>
 #include <call/protocol/impl/InnerObjectFormats.cpp>
 #include <call/protocol/impl/STPathSet.cpp>
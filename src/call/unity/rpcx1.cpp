@@ -66,6 +66,7 @@
 #include <call/rpc/handlers/LedgerClosed.cpp>
 #include <call/rpc/handlers/LedgerCurrent.cpp>
 #include <call/rpc/handlers/LedgerData.cpp>
+#include <call/rpc/handlers/LedgerDiff.cpp>
 #include <call/rpc/handlers/LedgerEntry.cpp>
 #include <call/rpc/handlers/LedgerHeader.cpp>
 #include <call/rpc/handlers/LedgerRequest.cpp>
@@ -0,0 +1,189 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of calld: https://github.com/call/calld
+    Copyright (c) 2012, 2013 Call Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <call/app/misc/AccountTxIndex.h>
+#include <call/beast/unit_test.h>
+#include <call/beast/utility/temp_dir.h>
+#include <call/unity/rocksdb.h>
+
+namespace call {
+namespace test {
+
+class AccountTxIndex_test : public beast::unit_test::suite
+{
+    using Position = AccountTxIndex::Position;
+
+    static
+    AccountID
+    account (std::uint8_t n)
+    {
+        AccountID id;
+        id.zero ();
+        *id.begin () = n;
+        return id;
+    }
+
+    static
+    uint256
+    txID (std::uint32_t ledgerSeq, std::uint32_t txnSeq)
+    {
+        uint256 id;
+        id.zero ();
+        *id.begin () = static_cast<std::uint8_t> (ledgerSeq);
+        *(id.begin () + 1) = static_cast<std::uint8_t> (txnSeq);
+        return id;
+    }
+
+    // Every transaction of a ledger affects account 1, the even
+    // numbered ones account 2 as well.
+    static
+    std::vector<AccountTxIndex::Entry>
+    makeLedger (std::uint32_t ledgerSeq, std::uint32_t txCount)
+    {
+        std::vector<AccountTxIndex::Entry> entries;
+        for (std::uint32_t i = 0; i < txCount; ++i)
+        {
+            entries.push_back ({account (1), ledgerSeq, i, txID (ledgerSeq, i)});
+            if (i % 2 == 0)
+                entries.push_back (
+                    {account (2), ledgerSeq, i, txID (ledgerSeq, i)});
+        }
+        return entries;
+    }
+
+    static
+    std::vector<Position>
+    collect (AccountTxIndex const& index, AccountID const& id,
+        Position const& first, Position const& last, bool forward,
+        std::size_t limit = 1000)
+    {
+        std::vector<Position> result;
+        index.forEach (id, first, last, forward,
+            [&](AccountTxIndex::Entry const& e)
+            {
+                if (e.txID != txID (e.ledgerSeq, e.txnSeq))
+                    return false;
+                result.emplace_back (e.ledgerSeq, e.txnSeq);
+                return result.size () < limit;
+            });
+        return result;
+    }
+
+    void
+    testIndex (Section const& params)
+    {
+        testcase ("AccountTxIndex type=" + get<std::string> (params, "type"));
+
+        auto const maxSeq = std::numeric_limits<std::uint32_t>::max ();
+        Position const all {0, 0};
+        Position const end {maxSeq, maxSeq};
+
+        {
+            auto index = make_AccountTxIndex (params, beast::Journal ());
+            if (! BEAST_EXPECT(index))
+                return;
+
+            for (std::uint32_t seq = 3; seq <= 7; ++seq)
+                index->saveLedger (seq, makeLedger (seq, 4));
+
+            auto forward = collect (*index, account (1), all, end, true);
+            BEAST_EXPECT(forward.size () == 20);
+            BEAST_EXPECT(std::is_sorted (forward.begin (), forward.end ()));
+            BEAST_EXPECT(forward.front () == Position (3, 0));
+            BEAST_EXPECT(forward.back () == Position (7, 3));
+
+            auto backward = collect (*index, account (1), all, end, false);
+            std::reverse (backward.begin (), backward.end ());
+            BEAST_EXPECT(backward == forward);
+
+            BEAST_EXPECT(collect (*index, account (2), all, end, true).size ()
+                == 10);
+            BEAST_EXPECT(collect (*index, account (3), all, end, true).empty ());
+
+            // Bounds are inclusive on both ends, in both directions
+            auto const range = collect (
+                *index, account (1), {4, 2}, {6, 1}, true);
+            BEAST_EXPECT(range.size () == 8);
+            BEAST_EXPECT(range.front () == Position (4, 2));
+            BEAST_EXPECT(range.back () == Position (6, 1));
+
+            auto const page = collect (
+                *index, account (1), {4, 2}, {6, 1}, false, 3);
+            BEAST_EXPECT(page.size () == 3);
+            BEAST_EXPECT(page.front () == Position (6, 1));
+            BEAST_EXPECT(page.back () == Position (5, 3));
+
+            // Saving a ledger again replaces its entries
+            index->saveLedger (5, makeLedger (5, 1));
+            BEAST_EXPECT(collect (*index, account (1), {5, 0}, {5, maxSeq},
+                true).size () == 1);
+            BEAST_EXPECT(collect (*index, account (1), all, end,
+                true).size () == 17);
+
+            index->deleteBefore (5);
+            auto const remaining = collect (
+                *index, account (1), all, end, true);
+            BEAST_EXPECT(remaining.size () == 9);
+            BEAST_EXPECT(remaining.front () == Position (5, 0));
+            BEAST_EXPECT(collect (*index, account (2), all, end,
+                true).size () == 5);
+        }
+
+        if (get<std::string> (params, "type") == "memory")
+            return;
+
+        {
+            // The entries survive reopening the index
+            auto index = make_AccountTxIndex (params, beast::Journal ());
+            BEAST_EXPECT(collect (*index, account (1), all, end,
+                true).size () == 9);
+        }
+    }
+
+    void
+    run () override
+    {
+        {
+            Section params;
+            BEAST_EXPECT(! make_AccountTxIndex (params, beast::Journal ()));
+        }
+
+        {
+            Section params;
+            params.set ("type", "memory");
+            testIndex (params);
+        }
+
+#if CALL_ROCKSDB_AVAILABLE
+        {
+            beast::temp_dir tempDir;
+            Section params;
+            params.set ("type", "rocksdb");
+            params.set ("path", tempDir.path ());
+            testIndex (params);
+        }
+#endif
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(AccountTxIndex,app,call);
+
+} // test
+} // call
@@ -17,7 +17,11 @@
 */
 //==============================================================================
 #include <test/jtx.h>
+#include <call/app/misc/AccountTxIndex.h>
+#include <call/app/misc/Transaction.h>
+#include <call/app/misc/impl/AccountTxPaging.h>
 #include <call/beast/unit_test.h>
+#include <call/core/ConfigSections.h>
 #include <call/protocol/SField.h>
 #include <call/protocol/JsonFields.h>
 #include <cstdlib>
@@ -26,6 +30,51 @@ namespace call {
 
 class AccountTxPaging_test : public beast::unit_test::suite
 {
+    // Counts the entries visited in another index
+    class CountingIndex : public AccountTxIndex
+    {
+        AccountTxIndex const& index_;
+
+    public:
+        std::size_t mutable visited = 0;
+
+        explicit
+        CountingIndex (AccountTxIndex const& index)
+            : index_ (index)
+        {
+        }
+
+        std::string
+        getName () const override
+        {
+            return "counting";
+        }
+
+        void
+        saveLedger (std::uint32_t,
+            std::vector<Entry> const&) override
+        {
+        }
+
+        void
+        deleteBefore (std::uint32_t) override
+        {
+        }
+
+        void
+        forEach (AccountID const& account, Position const& first,
+            Position const& last, bool forward,
+            std::function<bool (Entry const&)> const& f) const override
+        {
+            index_.forEach (account, first, last, forward,
+                [&](Entry const& entry)
+                {
+                    ++visited;
+                    return f (entry);
+                });
+        }
+    };
+
     bool
     checkTransaction (Json::Value const& tx, int sequence, int ledger)
     {
@@ -56,12 +105,19 @@ class AccountTxPaging_test : public beast::unit_test::suite
     }
 
     void
-    testAccountTxPaging ()
+    testAccountTxPaging (bool withIndex)
     {
-        testcase("Paging for Single Account");
+        testcase(std::string("Paging for Single Account") +
+            (withIndex ? " with index" : ""));
         using namespace test::jtx;
 
-        Env env(*this);
+        Env env(*this, envconfig([withIndex](std::unique_ptr<Config> cfg)
+            {
+                if (withIndex)
+                    cfg->section(ConfigSection::accountTxIndex()).set(
+                        "type", "memory");
+                return cfg;
+            }));
         Account A1 {"A1"};
         Account A2 {"A2"};
         Account A3 {"A3"};
@@ -258,11 +314,147 @@ class AccountTxPaging_test : public beast::unit_test::suite
         }
     }
 
+    void
+    testBogusMarker (bool withIndex)
+    {
+        testcase(std::string("Bogus marker") +
+            (withIndex ? " with index" : ""));
+        using namespace test::jtx;
+
+        Env env(*this, envconfig([withIndex](std::unique_ptr<Config> cfg)
+            {
+                if (withIndex)
+                    cfg->section(ConfigSection::accountTxIndex()).set(
+                        "type", "memory");
+                return cfg;
+            }));
+        Account A1 {"A1"};
+        Account A2 {"A2"};
+
+        env.fund(CALL(10000), A1, A2);
+        env.close();
+
+        for (auto i = 0; i < 10; ++i)
+        {
+            env(pay(A1, A2, CALL(1)));
+            env(pay(A2, A1, CALL(1)));
+            env.close();
+        }
+
+        // A marker which matches no transaction gives an empty page
+        Json::Value bogus;
+        bogus[jss::ledger] = 5;
+        bogus[jss::seq] = 12345;
+        for (auto const forward : {true, false})
+        {
+            auto const jrr = next(env, A1, 2, 20, 2, forward, bogus);
+            BEAST_EXPECT(jrr[jss::transactions].isArray() &&
+                jrr[jss::transactions].size() == 0);
+            BEAST_EXPECT(! jrr[jss::marker]);
+        }
+
+        if (! withIndex)
+            return;
+
+        // Without reading the rest of the account's history
+        CountingIndex index (*env.app().getAccountTxIndex());
+        std::size_t found = 0;
+        auto page = [&](Json::Value& token, int limit)
+        {
+            index.visited = 0;
+            found = 0;
+            accountTxPage (index, env.app().getTxnDB(),
+                [](std::uint32_t) {},
+                [&](std::uint32_t, std::string const&,
+                    Blob const&, Blob const&) { ++found; },
+                A1.id(), 2, 20, true, token, limit, false, 200);
+        };
+
+        Json::Value token = bogus;
+        page (token, 2);
+        BEAST_EXPECT(found == 0);
+        BEAST_EXPECT(index.visited == 1);
+        BEAST_EXPECT(token.isNull());
+
+        // A real marker visits no more than the SQL query's LIMIT
+        token = Json::nullValue;
+        page (token, 3);
+        BEAST_EXPECT(found == 3);
+        BEAST_EXPECT(index.visited == 4);
+        if (! BEAST_EXPECT(token.isObject()))
+            return;
+        page (token, 3);
+        BEAST_EXPECT(found == 3);
+        BEAST_EXPECT(index.visited <= 5);
+        BEAST_EXPECT(token.isObject());
+    }
+
+    void
+    testOffset ()
+    {
+        testcase("Offset with index");
+        using namespace test::jtx;
+
+        Env env(*this, envconfig([](std::unique_ptr<Config> cfg)
+            {
+                cfg->section(ConfigSection::accountTxIndex()).set(
+                    "type", "memory");
+                return cfg;
+            }));
+        Account A1 {"A1"};
+        Account A2 {"A2"};
+
+        env.fund(CALL(10000), A1, A2);
+        env.close();
+
+        for (auto i = 0; i < 10; ++i)
+        {
+            env(pay(A1, A2, CALL(1)));
+            env.close();
+        }
+
+        // An offset gives the same transactions as skipping them
+        auto ids = [&](std::uint32_t offset, int limit)
+        {
+            std::vector<uint256> result;
+            for (auto const& tx : env.app().getOPs().getAccountTxs (
+                    A1.id(), -1, -1, false, offset, limit, false))
+                result.push_back (tx.first->getID());
+            return result;
+        };
+        auto const all = ids (0, 20);
+        if (! BEAST_EXPECT(all.size() >= 10))
+            return;
+        auto const page = ids (4, 3);
+        BEAST_EXPECT(page.size() == 3 &&
+            std::equal (page.begin(), page.end(), all.begin() + 4));
+        BEAST_EXPECT(ids (static_cast<std::uint32_t> (all.size()), 3).empty());
+
+        // Skipped entries are passed over in the index, and the walk
+        // stops after the page
+        CountingIndex index (*env.app().getAccountTxIndex());
+        std::size_t found = 0;
+        auto const maxSeq = std::numeric_limits<std::uint32_t>::max ();
+        forEachAccountTx (index, env.app().getTxnDB(), A1.id(),
+            {0, 0}, {maxSeq, maxSeq}, true, 4,
+            [&](std::uint32_t, std::uint32_t, std::string const&,
+                Blob const&, Blob const&)
+            {
+                return ++found != 3;
+            });
+        BEAST_EXPECT(found == 3);
+        BEAST_EXPECT(index.visited == 7);
+    }
+
 public:
     void
     run() override
     {
-        testAccountTxPaging();
+        testAccountTxPaging(false);
+        testAccountTxPaging(true);
+        testBogusMarker(false);
+        testBogusMarker(true);
+        testOffset();
     }
 };
 
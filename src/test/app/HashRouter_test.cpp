@@ -264,6 +264,44 @@ class HashRouter_test : public beast::unit_test::suite
         BEAST_EXPECT(!router.shouldRecover(key1));
     }
 
+    void
+    testShardedExpiration()
+    {
+        // Keys spread over every shard still expire together when any
+        // new key is inserted, as with a single table.
+        using namespace std::chrono_literals;
+        TestStopwatch stopwatch;
+        HashRouter router(stopwatch, 2s, 2);
+
+        auto const makeKey = [](int i)
+        {
+            uint256 key;
+            key.begin()[0] = static_cast<unsigned char>(i);
+            key.begin()[1] = 1;
+            return key;
+        };
+
+        // t=0
+        for (int i = 0; i < 32; ++i)
+            BEAST_EXPECT(router.setFlags(makeKey(i), 1 + i));
+
+        ++stopwatch;
+        // t=1, refresh the odd keys
+        for (int i = 1; i < 32; i += 2)
+            BEAST_EXPECT(router.getFlags(makeKey(i)) == 1 + i);
+
+        ++stopwatch;
+        // t=2, a single insertion expires the even keys in every shard
+        router.addSuppression(makeKey(0xff));
+        for (int i = 0; i < 32; ++i)
+        {
+            if (i % 2)
+                BEAST_EXPECT(router.getFlags(makeKey(i)) == 1 + i);
+            else
+                BEAST_EXPECT(router.getFlags(makeKey(i)) == 0);
+        }
+    }
+
 public:
 
     void
@@ -275,6 +313,7 @@ public:
         testSetFlags();
         testRelay();
         testRecover();
+        testShardedExpiration();
     }
 };
 
@@ -0,0 +1,452 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of calld: https://github.com/call/calld
+    Copyright (c) 2012, 2013 Call Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <test/jtx.h>
+#include <call/app/misc/NetworkOPs.h>
+#include <call/app/misc/Transaction.h>
+#include <call/basics/StringUtilities.h>
+#include <call/beast/unit_test.h>
+#include <call/beast/xor_shift_engine.h>
+#include <call/protocol/JsonFields.h>
+#include <call/protocol/TxFlags.h>
+#include <boost/algorithm/string.hpp>
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <numeric>
+
+namespace call {
+namespace test {
+
+/*  Replays a stream of transactions through the apply and close pipeline.
+
+    Each transaction is submitted the way a local client's would be, which
+    applies it to the open ledger, and each ledger is closed through
+    consensus in standalone mode, which builds, flushes and saves it.
+    The latency of every stage is collected into a histogram.
+
+    The stream is either generated, from a seed, or read from a file
+    written by an earlier run. Arguments, all optional, are given as
+    comma separated key=value pairs:
+
+        ledgers     Number of ledgers to generate          (default 100)
+        txs         Transactions in each generated ledger  (default 200)
+        accounts    Number of accounts to send from        (default 50)
+        seed        Seed for the generated stream          (default 42)
+        record      File to write the generated stream to
+        replay      File to read the stream from, instead of generating
+
+    For example:
+
+        calld --unittest=LedgerCloseBench --unittest-arg=ledgers=500,txs=1000
+*/
+class LedgerCloseBench_test : public beast::unit_test::suite
+{
+    using clock_type = std::chrono::steady_clock;
+
+    // Microsecond latencies of one stage
+    class Histogram
+    {
+        std::vector<std::uint64_t> samples_;
+
+    public:
+        void
+        add (std::uint64_t us)
+        {
+            samples_.push_back (us);
+        }
+
+        void
+        add (std::chrono::microseconds us)
+        {
+            add (static_cast<std::uint64_t> (us.count ()));
+        }
+
+        std::uint64_t
+        total () const
+        {
+            return std::accumulate (
+                samples_.begin (), samples_.end (), std::uint64_t (0));
+        }
+
+        void
+        report (std::ostream& os, std::string const& name)
+        {
+            if (samples_.empty ())
+                return;
+
+            std::sort (samples_.begin (), samples_.end ());
+            auto const at = [this](double q)
+            {
+                return samples_[std::min (samples_.size () - 1,
+                    static_cast<std::size_t> (q * samples_.size ()))];
+            };
+
+            os << name << ": n=" << samples_.size () <<
+                " mean=" << total () / samples_.size () << "us" <<
+                " p50=" << at (0.50) << "us" <<
+                " p90=" << at (0.90) << "us" <<
+                " p99=" << at (0.99) << "us" <<
+                " max=" << samples_.back () << "us" << std::endl;
+
+            // Power of two buckets
+            std::map<std::uint64_t, std::size_t> buckets;
+            for (auto const us : samples_)
+            {
+                std::uint64_t bound = 1;
+                while (bound <= us)
+                    bound <<= 1;
+                ++buckets[bound];
+            }
+
+            for (auto const& b : buckets)
+            {
+                os << "  < " << std::setw (9) << b.first << "us " <<
+                    std::setw (8) << b.second << " " <<
+                    std::string (std::max<std::size_t> (1,
+                        50 * b.second / samples_.size ()), '#') << std::endl;
+            }
+        }
+    };
+
+    struct Params
+    {
+        int ledgers = 100;
+        int txs = 200;
+        int accounts = 50;
+        std::uint64_t seed = 42;
+        std::string record;
+        std::string replay;
+    };
+
+    // The transactions of each ledger, in order
+    using Stream = std::vector<std::vector<std::shared_ptr<STTx const>>>;
+
+    Params
+    parseParams ()
+    {
+        Section section;
+        std::vector<std::string> lines;
+        boost::split (lines, arg (), boost::algorithm::is_any_of (","));
+        section.append (lines);
+
+        Params params;
+        get_if_exists (section, "ledgers", params.ledgers);
+        get_if_exists (section, "txs", params.txs);
+        get_if_exists (section, "accounts", params.accounts);
+        get_if_exists (section, "seed", params.seed);
+        get_if_exists (section, "record", params.record);
+        get_if_exists (section, "replay", params.replay);
+        return params;
+    }
+
+    static
+    Json::Value
+    issueSet (jtx::Account const& account,
+        STAmount const& total, std::uint32_t flags)
+    {
+        Json::Value jv;
+        jv[jss::Account] = account.human ();
+        jv[jss::TransactionType] = "IssueSet";
+        jv[sfTotal.fieldName] = total.getJson (0);
+        jv[jss::Flags] = flags;
+        return jv;
+    }
+
+    static
+    std::vector<jtx::Account>
+    makeAccounts (int count)
+    {
+        std::vector<jtx::Account> accounts;
+        for (int i = 0; i < count; ++i)
+            accounts.emplace_back ("bench" + std::to_string (i));
+        return accounts;
+    }
+
+    // Create the accounts and issues the stream relies on. The result
+    // only depends on the number of accounts, so a recorded stream can
+    // be replayed on top of it.
+    void
+    setup (jtx::Env& env, std::vector<jtx::Account> const& accounts)
+    {
+        using namespace jtx;
+
+        Account const gw ("gateway");
+        Account const nft ("nftissuer");
+        auto const USD = gw["USD"];
+        auto const NFT = nft["NFT"];
+
+        env.fund (CALL (1000000), gw, nft);
+        for (auto const& a : accounts)
+            env.fund (CALL (1000000), a);
+        env.close ();
+
+        env (issueSet (gw, USD (1000000000), tfEnaddition));
+        env (issueSet (nft, NFT (1000000000), tfNonFungible));
+        env.close ();
+
+        for (auto const& a : accounts)
+        {
+            env.trust (USD (1000000000), a);
+            env.trust (NFT (1000000000), a);
+        }
+        env.close ();
+
+        for (auto const& a : accounts)
+            env (pay (gw, a, USD (100000)));
+        env.close ();
+    }
+
+    // A mix of payments in CALL and in issued currency, invoice
+    // payments, IssueSet transactions and crossing offers.
+    Stream
+    generate (jtx::Env& env, Params const& params,
+        std::vector<jtx::Account> const& accounts)
+    {
+        using namespace jtx;
+
+        Account const gw ("gateway");
+        Account const nft ("nftissuer");
+        auto const USD = gw["USD"];
+        auto const NFT = nft["NFT"];
+
+        beast::xor_shift_engine rng (params.seed);
+        auto const pick = [&](std::uint64_t n)
+        {
+            return static_cast<std::size_t> (rng () % n);
+        };
+
+        std::map<AccountID, std::uint32_t> seqs;
+        auto const next = [&](Account const& a)
+        {
+            auto const it = seqs.emplace (a.id (), env.seq (a)).first;
+            return seq (it->second++);
+        };
+
+        auto const txFee = fee (STAmount (env.current ()->fees ().base));
+        std::uint32_t invoices = 0;
+        std::map<AccountID, int> issued;
+
+        Stream stream (params.ledgers);
+        for (auto& ledger : stream)
+        {
+            for (int i = 0; i < params.txs; ++i)
+            {
+                auto const& from = accounts[pick (accounts.size ())];
+                auto const& to = accounts[pick (accounts.size ())];
+                auto const kind = pick (100);
+
+                JTx jt;
+                if (kind < 40)
+                {
+                    jt = env.jt (pay (from, to, CALL (1)),
+                        next (from), txFee);
+                }
+                else if (kind < 65)
+                {
+                    jt = env.jt (pay (from, to, USD (1)),
+                        next (from), txFee);
+                }
+                else if (kind < 75)
+                {
+                    uint256 id;
+                    id = ++invoices;
+                    jt = env.jt (pay (nft, to, NFT (1)),
+                        json (sfInvoiceID.fieldName, to_string (id)),
+                        json (sfInvoice.fieldName,
+                            strHex (std::string ("invoice ") +
+                                std::to_string (invoices))),
+                        next (nft), txFee);
+                }
+                else if (kind < 80)
+                {
+                    auto const total = 1000 * ++issued[from.id ()];
+                    jt = env.jt (issueSet (from, from["ISU"] (total),
+                        tfEnaddition), next (from), txFee);
+                }
+                else if (kind < 90)
+                {
+                    jt = env.jt (offer (from, USD (1), CALL (100)),
+                        next (from), txFee);
+                }
+                else
+                {
+                    jt = env.jt (offer (from, CALL (100), USD (1)),
+                        next (from), txFee);
+                }
+
+                ledger.push_back (jt.stx);
+            }
+        }
+
+        return stream;
+    }
+
+    // One transaction per line in hex, with an empty line after each ledger
+    void
+    write (std::string const& path, Stream const& stream)
+    {
+        std::ofstream os (path);
+        for (auto const& ledger : stream)
+        {
+            for (auto const& tx : ledger)
+            {
+                Serializer s;
+                tx->add (s);
+                os << strHex (s.peekData ()) << '\n';
+            }
+            os << '\n';
+        }
+    }
+
+    Stream
+    read (std::string const& path)
+    {
+        std::ifstream is (path);
+        if (! BEAST_EXPECTS (is.is_open (), "Unable to open " + path))
+            return {};
+
+        Stream stream (1);
+        std::string line;
+        while (std::getline (is, line))
+        {
+            boost::algorithm::trim (line);
+            if (line.empty ())
+            {
+                if (! stream.back ().empty ())
+                    stream.emplace_back ();
+                continue;
+            }
+
+            auto const blob = strUnHex (line);
+            if (! BEAST_EXPECT (blob.second))
+                return {};
+            SerialIter sit (makeSlice (blob.first));
+            stream.back ().push_back (std::make_shared<STTx const> (sit));
+        }
+
+        if (stream.back ().empty ())
+            stream.pop_back ();
+        return stream;
+    }
+
+    void
+    replay (jtx::Env& env, Stream const& stream)
+    {
+        auto const elapsed = [](clock_type::time_point start)
+        {
+            return std::chrono::duration_cast<std::chrono::microseconds> (
+                clock_type::now () - start);
+        };
+
+        Histogram apply, close;
+        std::map<std::string, Histogram> stages;
+        std::map<std::string, std::size_t> results;
+        std::size_t count = 0;
+
+        auto const start = clock_type::now ();
+        for (auto const& ledger : stream)
+        {
+            for (auto const& stx : ledger)
+            {
+                std::string reason;
+                auto tx = std::make_shared<Transaction> (
+                    stx, reason, env.app ());
+
+                auto const t = clock_type::now ();
+                env.app ().getOPs ().processTransaction (
+                    tx, true, true, NetworkOPs::FailHard::no);
+                apply.add (elapsed (t));
+
+                ++results[transToken (tx->getResult ())];
+                ++count;
+            }
+
+            auto const t = clock_type::now ();
+            env.close ();
+            close.add (elapsed (t));
+
+            auto const timing = env.app ().getOPs ().getConsensusInfo ()[
+                "last_close_timing"];
+            for (auto const& name : timing.getMemberNames ())
+                stages[name].add (timing[name].asUInt ());
+        }
+        auto const wall = elapsed (start);
+
+        log << "Replayed " << count << " transactions in " <<
+            stream.size () << " ledgers" << std::endl;
+        for (auto const& r : results)
+            log << "  " << r.first << ": " << r.second << std::endl;
+
+        apply.report (log, "open ledger apply");
+        close.report (log, "ledger close");
+        for (auto& s : stages)
+            s.second.report (log, "  close stage " + s.first);
+
+        auto const seconds = wall.count () / 1e6;
+        log << "Throughput: " << count / seconds << " tx/s, " <<
+            stream.size () / seconds << " ledgers/s (" <<
+            seconds << "s)" << std::endl;
+
+        BEAST_EXPECT(count != 0);
+    }
+
+public:
+    void
+    run () override
+    {
+        using namespace jtx;
+
+        auto const params = parseParams ();
+        auto const accounts = makeAccounts (params.accounts);
+
+        // Keep fee escalation out of the measurements
+        Env env (*this, envconfig ([&params](std::unique_ptr<Config> cfg)
+            {
+                cfg->section ("transaction_queue").set (
+                    "minimum_txn_in_ledger_standalone",
+                    std::to_string (std::max (params.txs, 1000)));
+                return cfg;
+            }));
+
+        setup (env, accounts);
+
+        Stream stream;
+        if (! params.replay.empty ())
+        {
+            stream = read (params.replay);
+        }
+        else
+        {
+            stream = generate (env, params, accounts);
+            if (! params.record.empty ())
+                write (params.record, stream);
+        }
+
+        replay (env, stream);
+    }
+};
+
+BEAST_DEFINE_TESTSUITE_MANUAL(LedgerCloseBench,app,call);
+
+} // test
+} // call
@@ -0,0 +1,121 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of calld: https://github.com/call/calld
+    Copyright (c) 2012, 2013 Call Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <test/jtx.h>
+#include <call/app/ledger/LedgerMaster.h>
+#include <call/core/ConfigSections.h>
+#include <call/core/JobQueue.h>
+#include <call/nodestore/DatabaseShard.h>
+#include <call/beast/utility/temp_dir.h>
+
+namespace call {
+namespace test {
+
+class LedgerShards_test : public beast::unit_test::suite
+{
+    static std::uint32_t const ledgersPerShard = 4;
+
+    // Every node of the ledger can be read from its shard
+    static
+    bool
+    inShard (NodeStore::DatabaseShard& shards, Ledger const& ledger)
+    {
+        auto const seq = ledger.info().seq;
+        bool found = true;
+        auto const check = [&](SHAMapAbstractNode& node)
+        {
+            if (! shards.fetch (node.getNodeHash ().as_uint256 (), seq))
+                found = false;
+            return found;
+        };
+
+        ledger.stateMap().visitNodes (check);
+        ledger.txMap().visitNodes (check);
+        return found && shards.fetch (ledger.info().hash, seq);
+    }
+
+public:
+    void
+    testCopy ()
+    {
+        testcase ("copy to shards");
+
+        using namespace jtx;
+
+        beast::temp_dir dir;
+        Env env (*this, envconfig ([&dir](std::unique_ptr<Config> cfg)
+            {
+                auto& section = cfg->section (ConfigSection::shardDatabase ());
+                section.set ("path", dir.path ());
+                section.set ("ledgers_per_shard",
+                    std::to_string (ledgersPerShard));
+                return cfg;
+            }));
+
+        auto const shards = env.app ().getShardStore ();
+        if (! BEAST_EXPECT(shards))
+            return;
+
+        // Ledgers which change a little of the state each, spanning
+        // several shards
+        Account const alice ("alice");
+        env.fund (CALL(10000), alice);
+        env.close ();
+        for (int i = 0; i < 3 * ledgersPerShard; ++i)
+        {
+            env (pay (env.master, alice, CALL(1)));
+            env.close ();
+        }
+
+        // Each closed ledger starts the copy of what its shard lacks;
+        // a shard whose job is still running is picked up next time
+        auto& jobs = env.app ().getJobQueue ();
+        auto const last = env.closed ()->info().seq;
+        for (int i = 0; i < 4 && ! shards->hasLedger (last); ++i)
+        {
+            jobs.rendezvous ();
+            env.close ();
+            jobs.rendezvous ();
+        }
+
+        auto& ledgerMaster = env.app ().getLedgerMaster ();
+        for (std::uint32_t seq = 2; seq <= last; ++seq)
+        {
+            BEAST_EXPECT(shards->hasLedger (seq));
+
+            // The first ledger of a shard is copied whole, the others
+            // only where they differ from the one before
+            auto const ledger = ledgerMaster.getLedgerBySeq (seq);
+            if (BEAST_EXPECT(ledger))
+                BEAST_EXPECT(inShard (*shards, *ledger));
+        }
+    }
+
+    void
+    run () override
+    {
+        testCopy ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(LedgerShards,app,call);
+
+}
+}
@@ -0,0 +1,276 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of calld: https://github.com/call/calld
+    Copyright (c) 2012, 2013 Call Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <test/jtx.h>
+#include <call/app/ledger/OrderBookDB.h>
+#include <call/core/JobQueue.h>
+#include <call/core/Stoppable.h>
+#include <future>
+#include <set>
+#include <vector>
+
+namespace call {
+namespace test {
+
+class OrderBookDB_test : public beast::unit_test::suite
+{
+    using BookSets = std::vector<std::set<uint256>>;
+
+    // The books reachable from each issue, in order
+    static
+    BookSets
+    books (OrderBookDB& db, std::vector<Issue> const& issues)
+    {
+        BookSets result;
+        for (auto const& issue : issues)
+        {
+            result.emplace_back ();
+            for (auto const& book : db.getBooksByTakerPays (issue))
+                result.back ().insert (book->getBookBase ());
+        }
+        return result;
+    }
+
+    static
+    OrderBookDB::Setup
+    standalone (std::uint32_t fullUpdateInterval = 16384)
+    {
+        OrderBookDB::Setup setup;
+        setup.fullUpdateInterval = fullUpdateInterval;
+        setup.standalone = true;
+        return setup;
+    }
+
+    // The books found by a full walk of the ledger
+    static
+    BookSets
+    rebuilt (Application& app,
+        std::shared_ptr<ReadView const> const& ledger,
+            std::vector<Issue> const& issues)
+    {
+        RootStoppable parent ("TestRootStoppable");
+        OrderBookDB db (app, parent, standalone ());
+        db.setup (ledger);
+        return books (db, issues);
+    }
+
+public:
+    void
+    testIncremental ()
+    {
+        testcase ("incremental");
+
+        using namespace jtx;
+        Env env (*this);
+        auto const gw = Account ("gateway");
+        auto const alice = Account ("alice");
+        auto const USD = gw["USD"];
+        auto const EUR = gw["EUR"];
+
+        env.fund (CALL (10000), alice, gw);
+        env.trust (USD (1000), alice);
+        env.trust (EUR (1000), alice);
+        env (pay (gw, alice, USD (500)));
+        env (pay (gw, alice, EUR (500)));
+        env.close ();
+
+        std::vector<Issue> const issues {
+            callIssue (), USD.issue (), EUR.issue () };
+
+        RootStoppable parent ("TestRootStoppable");
+        OrderBookDB db (env.app (), parent, standalone ());
+        db.setup (env.closed ());
+        BEAST_EXPECT (books (db, issues) ==
+            rebuilt (env.app (), env.closed (), issues));
+        BEAST_EXPECT (db.getBookSize (USD.issue ()) == 0);
+
+        // Close a ledger, apply its changes and compare the result to a
+        // full rebuild from the same ledger
+        auto close = [&]
+        {
+            env.close ();
+            db.processLedger (env.closed ());
+            return books (db, issues) ==
+                rebuilt (env.app (), env.closed (), issues);
+        };
+
+        // A new book, with offers at two qualities
+        auto const first = env.seq (alice);
+        env (offer (alice, USD (10), CALL (100)));
+        env (offer (alice, USD (10), CALL (200)));
+        BEAST_EXPECT (close ());
+        BEAST_EXPECT (db.getBookSize (USD.issue ()) == 1);
+        BEAST_EXPECT (db.isBookToCALL (USD.issue ()));
+
+        // A book created and emptied within one ledger never appears
+        auto const transient = env.seq (alice);
+        env (offer (alice, CALL (100), EUR (10)));
+        env (offer_cancel (alice, transient));
+        BEAST_EXPECT (close ());
+        BEAST_EXPECT (db.getBookSize (callIssue ()) == 0);
+
+        // The book remains while a directory at any quality does
+        env (offer_cancel (alice, first));
+        BEAST_EXPECT (close ());
+        BEAST_EXPECT (db.getBookSize (USD.issue ()) == 1);
+
+        env (offer_cancel (alice, first + 1));
+        BEAST_EXPECT (close ());
+        BEAST_EXPECT (db.getBookSize (USD.issue ()) == 0);
+        BEAST_EXPECT (! db.isBookToCALL (USD.issue ()));
+
+        // A book whose only offer is consumed by crossing is removed
+        env (offer (alice, EUR (10), USD (10)));
+        BEAST_EXPECT (close ());
+        BEAST_EXPECT (db.getBookSize (EUR.issue ()) == 1);
+
+        env (offer (gw, USD (10), EUR (10)));
+        BEAST_EXPECT (close ());
+        BEAST_EXPECT (db.getBookSize (EUR.issue ()) == 0);
+        BEAST_EXPECT (db.getBookSize (USD.issue ()) == 0);
+    }
+
+    void
+    testReplay ()
+    {
+        testcase ("replay");
+
+        using namespace jtx;
+        Env env (*this);
+        auto const gw = Account ("gateway");
+        auto const alice = Account ("alice");
+        auto const USD = gw["USD"];
+        auto const EUR = gw["EUR"];
+
+        env.fund (CALL (10000), alice, gw);
+        env.trust (USD (1000), alice);
+        env.trust (EUR (1000), alice);
+        env (pay (gw, alice, USD (500)));
+        env (pay (gw, alice, EUR (500)));
+
+        std::vector<Issue> const issues {
+            callIssue (), USD.issue (), EUR.issue () };
+
+        auto const first = env.seq (alice);
+        env (offer (alice, USD (10), CALL (100)));
+        env.close ();
+        auto const start = env.closed ();
+
+        env (offer (alice, EUR (10), CALL (100)));
+        env.close ();
+        auto const added = env.closed ();
+
+        env (offer_cancel (alice, first));
+        env.close ();
+        auto const removed = env.closed ();
+
+        auto const expected = rebuilt (env.app (), removed, issues);
+        BEAST_EXPECT (rebuilt (env.app (), start, issues) != expected);
+
+        // Rebuild from the first ledger on the job queue
+        RootStoppable parent ("TestRootStoppable");
+        OrderBookDB db (env.app (), parent, OrderBookDB::Setup ());
+
+        // Hold the job queue so the rebuild is still in flight while
+        // the later ledgers are applied
+        std::promise<void> running;
+        std::promise<void> release;
+        auto const held = release.get_future ().share ();
+        env.app ().getJobQueue ().addJob (jtCLIENT, "OrderBookDB_test",
+            [&running, held](Job&)
+            {
+                running.set_value ();
+                held.wait ();
+            });
+        running.get_future ().wait ();
+
+        db.setup (start);
+        db.processLedger (added);
+        db.processLedger (removed);
+
+        release.set_value ();
+        env.app ().getJobQueue ().rendezvous ();
+
+        // The removal of the USD book is replayed over the rebuilt maps
+        BEAST_EXPECT (books (db, issues) == expected);
+        BEAST_EXPECT (db.getBookSize (USD.issue ()) == 0);
+        BEAST_EXPECT (db.getBookSize (EUR.issue ()) == 1);
+    }
+
+    void
+    testFullUpdate ()
+    {
+        testcase ("full update");
+
+        using namespace jtx;
+        Env env (*this);
+        auto const gw = Account ("gateway");
+        auto const alice = Account ("alice");
+        auto const USD = gw["USD"];
+        auto const EUR = gw["EUR"];
+
+        env.fund (CALL (10000), alice, gw);
+        env.trust (USD (1000), alice);
+        env (pay (gw, alice, USD (500)));
+        env.close ();
+
+        RootStoppable parent ("TestRootStoppable");
+        OrderBookDB db (env.app (), parent, standalone (4));
+        db.setup (env.closed ());
+
+        // A book missing from the ledger only goes away on a rebuild
+        Book const stale {EUR.issue (), callIssue ()};
+        db.addOrderBook (stale);
+
+        for (int i = 1; i < 4; ++i)
+        {
+            env.close ();
+            db.processLedger (env.closed ());
+            BEAST_EXPECT (db.getBookSize (EUR.issue ()) == 1);
+        }
+
+        // The fourth ledger reaches fullUpdateInterval
+        env.close ();
+        db.processLedger (env.closed ());
+        BEAST_EXPECT (db.getBookSize (EUR.issue ()) == 0);
+
+        // So does a skipped ledger, which also picks up its changes
+        db.addOrderBook (stale);
+        env (offer (alice, USD (10), CALL (100)));
+        env.close ();
+        env.close ();
+        db.processLedger (env.closed ());
+        BEAST_EXPECT (db.getBookSize (EUR.issue ()) == 0);
+        BEAST_EXPECT (db.getBookSize (USD.issue ()) == 1);
+    }
+
+    void
+    run () override
+    {
+        testIncremental ();
+        testReplay ();
+        testFullUpdate ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(OrderBookDB,app,call);
+
+} // test
+} // call
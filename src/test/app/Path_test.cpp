@@ -18,7 +18,9 @@
 //==============================================================================
 
 #include <BeastConfig.h>
+#include <call/app/ledger/LedgerMaster.h>
 #include <call/app/paths/AccountCurrencies.h>
+#include <call/app/paths/PathRequests.h>
 #include <call/basics/contract.h>
 #include <call/core/JobQueue.h>
 #include <call/json/json_reader.h>
@@ -1351,6 +1353,132 @@ public:
             stpath(IPE(G2["HKD"]), G2)));
     }
 
+    // Run legacy path requests through PathRequests::updateAll with at
+    // most `workers` jobs per pass and return each request's alternatives.
+    std::vector<Json::Value>
+    update_paths(jtx::Env& env, std::vector<Json::Value> const& params,
+        std::size_t workers)
+    {
+        using namespace std::chrono_literals;
+        auto& app = env.app();
+        auto& pathRequests = app.getPathRequests();
+        pathRequests.setMaxWorkers(workers);
+
+        Resource::Consumer c;
+        std::mutex mutex;
+        std::size_t completed = 0;
+        gate g;
+
+        std::vector<PathRequest::pointer> requests(params.size());
+        for (std::size_t i = 0; i < params.size(); ++i)
+        {
+            auto const result = pathRequests.makeLegacyPathRequest(
+                requests[i],
+                [&]
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    if (++completed == params.size())
+                        g.signal();
+                },
+                c, app.getLedgerMaster().getClosedLedger(), params[i]);
+            BEAST_EXPECT(requests[i]);
+            BEAST_EXPECT(! result.isMember(jss::error));
+        }
+
+        BEAST_EXPECT(g.wait_for(10s));
+
+        std::vector<Json::Value> alternatives;
+        for (std::size_t i = 0; i < params.size(); ++i)
+        {
+            if (! requests[i])
+            {
+                alternatives.emplace_back();
+                continue;
+            }
+            auto const status = requests[i]->doStatus(params[i]);
+            BEAST_EXPECT(! status.isMember(jss::error));
+            alternatives.push_back(status[jss::alternatives]);
+        }
+
+        pathRequests.setMaxWorkers(0);
+        return alternatives;
+    }
+
+    void
+    parallel_update()
+    {
+        testcase("parallel update matches serial update");
+        using namespace jtx;
+        Env env(*this);
+        auto const gw = Account("gateway");
+        auto const USD = gw["USD"];
+        auto const EUR = gw["EUR"];
+        auto const market = Account("market");
+        std::vector<Account> const users {
+            "alice", "bob", "carol", "dan", "edna", "fred"};
+
+        env.fund(CALL(10000), gw, market);
+        for (auto const& user : users)
+            env.fund(CALL(10000), user);
+        env.close();
+
+        env.trust(USD(10000), market);
+        env.trust(EUR(10000), market);
+        for (auto const& user : users)
+        {
+            env.trust(USD(1000), user);
+            env.trust(EUR(1000), user);
+        }
+        env.close();
+
+        env(pay(gw, market, USD(5000)));
+        env(pay(gw, market, EUR(5000)));
+        for (std::size_t i = 0; i < users.size(); ++i)
+            env(pay(gw, users[i], (i % 2 ? EUR : USD)(100)));
+        env.close();
+
+        env(offer(market, EUR(1000), USD(1000)));
+        env(offer(market, USD(1000), EUR(1000)));
+        env(offer(market, CALL(1000), USD(100)));
+        env.close();
+
+        // Every user asks to pay every other user, in both currencies
+        std::vector<Json::Value> params;
+        for (auto const& src : users)
+        {
+            for (auto const& dst : users)
+            {
+                if (src == dst)
+                    continue;
+                for (auto const& iou : {USD, EUR})
+                {
+                    Json::Value jv = Json::objectValue;
+                    jv[jss::command] = "call_path_find";
+                    jv[jss::source_account] = toBase58(src);
+                    jv[jss::destination_account] = toBase58(dst);
+                    jv[jss::destination_amount] =
+                        iou(5).value().getJson(0);
+                    params.push_back(std::move(jv));
+                }
+            }
+        }
+
+        auto const serial = update_paths(env, params, 1);
+        auto const parallel = update_paths(env, params, 4);
+
+        BEAST_EXPECT(serial.size() == params.size());
+        BEAST_EXPECT(parallel.size() == params.size());
+        std::size_t found = 0;
+        for (std::size_t i = 0; i < params.size(); ++i)
+        {
+            BEAST_EXPECT(parallel[i] == serial[i]);
+            if (serial[i].isArray() && serial[i].size() > 0)
+                ++found;
+        }
+        // The requests must exercise the pathfinder, not just fail
+        BEAST_EXPECT(found > 0);
+    }
+
     void
     run()
     {
@@ -1386,6 +1514,8 @@ public:
         path_find_04();
         path_find_05();
         path_find_06();
+
+        parallel_update();
     }
 };
 
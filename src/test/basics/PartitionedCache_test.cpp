@@ -0,0 +1,131 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of calld: https://github.com/call/calld
+    Copyright (c) 2012, 2013 Call Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <call/basics/chrono.h>
+#include <call/basics/PartitionedKeyCache.h>
+#include <call/basics/PartitionedTaggedCache.h>
+#include <call/beast/unit_test.h>
+#include <call/beast/clock/manual_clock.h>
+
+namespace call {
+
+class PartitionedCache_test : public beast::unit_test::suite
+{
+public:
+    void testTaggedCache ()
+    {
+        testcase ("PartitionedTaggedCache");
+
+        beast::Journal const j;
+
+        TestStopwatch clock;
+        clock.set (0);
+
+        using Key = int;
+        using Value = std::string;
+        using Cache = PartitionedTaggedCache <Key, Value>;
+
+        Cache c ("test", 64, 1, clock, j,
+            beast::insight::NullCollector::New (), 4);
+        BEAST_EXPECT(c.partitions () == 4);
+        BEAST_EXPECT(c.getTargetSize () == 64);
+
+        // Spread items over the partitions and read them back.
+        for (int i = 0; i < 32; ++i)
+            BEAST_EXPECT(! c.insert (i, std::to_string (i)));
+        BEAST_EXPECT(c.getCacheSize () == 32);
+        BEAST_EXPECT(c.getTrackSize () == 32);
+        BEAST_EXPECT(c.getKeys ().size () == 32);
+
+        for (int i = 0; i < 32; ++i)
+        {
+            std::string s;
+            BEAST_EXPECT(c.retrieve (i, s));
+            BEAST_EXPECT(s == std::to_string (i));
+        }
+        BEAST_EXPECT(! c.fetch (32));
+        BEAST_EXPECT(c.getHitsAndMisses () ==
+            std::make_pair (std::uint64_t{32}, std::uint64_t{1}));
+
+        // Keep a strong pointer to one item, age everything out, and
+        // check that the held item is still canonical.
+        {
+            Cache::mapped_ptr p1 (c.fetch (7));
+            BEAST_EXPECT(p1 != nullptr);
+
+            ++clock;
+            c.sweep ();
+            BEAST_EXPECT(c.getCacheSize () == 0);
+            BEAST_EXPECT(c.getTrackSize () == 1);
+
+            Cache::mapped_ptr p2 (std::make_shared <Value> ("7"));
+            BEAST_EXPECT(c.canonicalize (7, p2));
+            BEAST_EXPECT(p1.get () == p2.get ());
+        }
+
+        ++clock;
+        c.sweep ();
+        BEAST_EXPECT(c.getCacheSize () == 0);
+        BEAST_EXPECT(c.getTrackSize () == 0);
+    }
+
+    void testKeyCache ()
+    {
+        testcase ("PartitionedKeyCache");
+
+        TestStopwatch clock;
+        clock.set (0);
+
+        using Cache = PartitionedKeyCache <std::string>;
+
+        Cache c ("test", clock, beast::insight::NullCollector::New (),
+            0, 2, 4);
+        BEAST_EXPECT(c.partitions () == 4);
+
+        for (int i = 0; i < 32; ++i)
+            BEAST_EXPECT(c.insert (std::to_string (i)));
+        BEAST_EXPECT(! c.insert ("0"));
+        BEAST_EXPECT(c.size () == 32);
+        BEAST_EXPECT(c.touch_if_exists ("1"));
+        BEAST_EXPECT(! c.touch_if_exists ("32"));
+        BEAST_EXPECT(c.erase ("2"));
+        BEAST_EXPECT(c.size () == 31);
+
+        ++clock;
+        c.touch_if_exists ("1");
+        ++clock;
+        c.sweep ();
+        BEAST_EXPECT(c.size () == 1);
+        BEAST_EXPECT(c.exists ("1"));
+
+        c.clear ();
+        BEAST_EXPECT(c.size () == 0);
+    }
+
+    void run ()
+    {
+        testTaggedCache ();
+        testKeyCache ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(PartitionedCache,common,call);
+
+}
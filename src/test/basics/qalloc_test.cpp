@@ -0,0 +1,108 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of calld: https://github.com/call/calld
+    Copyright (c) 2012, 2013 Call Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <call/basics/qalloc.h>
+#include <call/beast/unit_test.h>
+#include <map>
+
+namespace call {
+
+class qalloc_test : public beast::unit_test::suite
+{
+    using map_type = std::map<int, int, std::less<int>,
+        qalloc_type<std::pair<int const, int>, true>>;
+
+    void
+    testStats ()
+    {
+        testcase ("stats");
+
+        qalloc_stats stats;
+        {
+            qalloc alloc (stats);
+            map_type m (alloc);
+            for (int i = 0; i < 100; ++i)
+                m.emplace (i, i);
+            BEAST_EXPECT (stats.blocks == 1);
+
+            // Allocations are reported when the arena goes away
+            BEAST_EXPECT (stats.allocations == 0);
+        }
+        BEAST_EXPECT (stats.allocations == 100);
+        BEAST_EXPECT (stats.bytes >= 100 * sizeof (int) * 2);
+    }
+
+    void
+    testReuse ()
+    {
+        testcase ("reuse");
+
+        // Containers which come and go on the same arena
+        // reuse its block instead of taking a new one.
+        qalloc_stats stats;
+        qalloc alloc (stats);
+        for (int n = 0; n < 10; ++n)
+        {
+            map_type m (alloc);
+            for (int i = 0; i < 100; ++i)
+                m.emplace (i, n);
+            BEAST_EXPECT (m.size () == 100);
+        }
+        BEAST_EXPECT (stats.blocks == 1);
+
+        // A larger allocation than a block gets its own
+        {
+            std::vector<char, qalloc_type<char, true>> v (alloc);
+            v.resize (detail::qalloc_impl<>::block_size * 2);
+        }
+        BEAST_EXPECT (stats.blocks == 2);
+    }
+
+    void
+    testHeap ()
+    {
+        testcase ("heap");
+
+        qalloc const alloc (nullptr);
+        map_type m (alloc);
+        for (int i = 0; i < 100; ++i)
+            m.emplace (i, i);
+        BEAST_EXPECT (m.size () == 100);
+        BEAST_EXPECT (m.get_allocator () == qalloc (nullptr));
+
+        map_type copy (m);
+        BEAST_EXPECT (copy == m);
+        m.clear ();
+        BEAST_EXPECT (copy.size () == 100);
+    }
+
+public:
+    void
+    run ()
+    {
+        testStats ();
+        testReuse ();
+        testHeap ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(qalloc,basics,call);
+
+} // call
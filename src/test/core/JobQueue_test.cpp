@@ -21,6 +21,9 @@
 #include <call/core/JobQueue.h>
 #include <call/beast/unit_test.h>
 #include <test/jtx/Env.h>
+#include <atomic>
+#include <mutex>
+#include <vector>
 
 namespace call {
 namespace test {
@@ -140,11 +143,58 @@ class JobQueue_test : public beast::unit_test::suite
         }
     }
 
+    void testPriority()
+    {
+        jtx::Env env {*this};
+
+        // A standalone Env runs the JobQueue with a single thread, so
+        // once that thread is busy the queued jobs run strictly in
+        // priority order, and FIFO within a type.
+        JobQueue& jQueue = env.app().getJobQueue();
+
+        std::atomic<bool> started {false};
+        std::atomic<bool> release {false};
+        BEAST_EXPECT (jQueue.addJob (jtCLIENT, "PriorityBlock",
+            [&] (Job&)
+            {
+                started = true;
+                while (! release);
+            }));
+        while (! started);
+
+        std::mutex m;
+        std::vector<int> order;
+        auto add = [&] (JobType type, int id)
+        {
+            return jQueue.addJob (type, "PriorityTest",
+                [&m, &order, id] (Job&)
+                {
+                    std::lock_guard<std::mutex> lock (m);
+                    order.push_back (id);
+                });
+        };
+
+        BEAST_EXPECT (add (jtCLIENT, 1));
+        BEAST_EXPECT (add (jtTRANSACTION, 2));
+        BEAST_EXPECT (add (jtCLIENT, 3));
+        BEAST_EXPECT (add (jtLEDGER_DATA, 4));
+        BEAST_EXPECT (add (jtTRANSACTION, 5));
+        BEAST_EXPECT (jQueue.getJobCount (jtCLIENT) == 2);
+        BEAST_EXPECT (jQueue.getJobCountTotal (jtCLIENT) == 3);
+
+        release = true;
+        jQueue.rendezvous();
+
+        BEAST_EXPECT ((order == std::vector<int>{2, 5, 1, 3, 4}));
+        BEAST_EXPECT (jQueue.getJobCountTotal (jtCLIENT) == 0);
+    }
+
 public:
     void run()
     {
         testAddJob();
         testPostCoro();
+        testPriority();
     }
 };
 
@@ -0,0 +1,184 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of calld: https://github.com/call/calld
+    Copyright (c) 2012, 2013 Call Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <call/app/ledger/AcquireScheduler.h>
+#include <call/basics/chrono.h>
+#include <call/beast/unit_test.h>
+#include <numeric>
+#include <set>
+
+namespace call {
+namespace test {
+
+class AcquireScheduler_test : public beast::unit_test::suite
+{
+    using Scheduler = AcquireScheduler<int>;
+
+    static
+    std::vector<int>
+    nodes (int count)
+    {
+        std::vector<int> v (count);
+        std::iota (v.begin(), v.end(), 0);
+        return v;
+    }
+
+    void
+    testAssign ()
+    {
+        testcase ("assign");
+
+        TestStopwatch clock;
+        Scheduler s (clock);
+        auto const candidates = nodes (1000);
+
+        // Peers are given different nodes
+        std::set<int> seen;
+        for (Scheduler::id_t peer = 1; peer <= 3; ++peer)
+        {
+            std::size_t requests = 0;
+            while (s.canRequest (peer))
+            {
+                auto const keys = s.assign (peer, candidates);
+                BEAST_EXPECT (keys.size() == acquire::initialRequestNodes);
+                for (auto k : keys)
+                    BEAST_EXPECT (seen.insert (k).second);
+                ++requests;
+            }
+            BEAST_EXPECT (requests == acquire::maxRequestsInFlight);
+        }
+        BEAST_EXPECT (s.outstanding() == seen.size());
+
+        // Nothing is left to give out
+        auto const few = nodes (10);
+        BEAST_EXPECT (s.assign (4, few).empty());
+        BEAST_EXPECT (s.canRequest (4));
+    }
+
+    void
+    testReceived ()
+    {
+        testcase ("received");
+
+        using namespace std::chrono;
+        TestStopwatch clock;
+        Scheduler s (clock);
+        auto const candidates = nodes (1000);
+
+        auto const first = s.assign (1, candidates);
+        auto const second = s.assign (1, candidates);
+        BEAST_EXPECT (s.outstanding() == 2 * acquire::initialRequestNodes);
+
+        // A partial reply to the second request frees all its nodes
+        clock.advance (milliseconds{50});
+        s.received (1, {second[0], second[1]});
+        BEAST_EXPECT (s.outstanding() == acquire::initialRequestNodes);
+        BEAST_EXPECT (s.assign (2, second).size() == second.size());
+
+        // Unknown nodes and peers are ignored
+        s.received (1, {-1});
+        s.received (9, {first[0]});
+        BEAST_EXPECT (s.outstanding() == 2 * acquire::initialRequestNodes);
+    }
+
+    void
+    testSizing ()
+    {
+        testcase ("sizing");
+
+        using namespace std::chrono;
+        TestStopwatch clock;
+        Scheduler s (clock);
+        auto const candidates = nodes (100000);
+
+        // A peer that answers quickly is asked for more
+        for (int i = 0; i < 20; ++i)
+        {
+            auto const keys = s.assign (1, candidates);
+            clock.advance (milliseconds{50});
+            s.received (1, keys);
+        }
+        BEAST_EXPECT (s.requestSize (1) == acquire::maxRequestNodes);
+
+        // But not more than it can answer in time
+        for (int i = 0; i < 20; ++i)
+        {
+            auto const keys = s.assign (1, candidates);
+            clock.advance (milliseconds{1500});
+            s.received (1, keys);
+        }
+        auto const size = s.requestSize (1);
+        BEAST_EXPECT (size < acquire::maxRequestNodes / 2);
+        BEAST_EXPECT (size > acquire::minRequestNodes);
+    }
+
+    void
+    testExpire ()
+    {
+        testcase ("expire");
+
+        using namespace std::chrono;
+        TestStopwatch clock;
+        Scheduler s (clock);
+        auto const candidates = nodes (1000);
+
+        std::vector<std::vector<int>> sent;
+        while (s.canRequest (1))
+            sent.push_back (s.assign (1, candidates));
+
+        clock.advance (acquire::maxRequestTimeout);
+        BEAST_EXPECT (s.expire() == 0);
+        ++clock;
+        BEAST_EXPECT (s.expire() == sent.size());
+        BEAST_EXPECT (s.outstanding() == 0);
+        BEAST_EXPECT (s.requestSize (1) == acquire::minRequestNodes);
+
+        // The work goes to another peer
+        BEAST_EXPECT (s.assign (2, sent[0]).size() == sent[0].size());
+
+        // The slow peer gets one small request at a time
+        BEAST_EXPECT (s.canRequest (1));
+        auto const keys = s.assign (1, candidates);
+        BEAST_EXPECT (keys.size() == acquire::minRequestNodes);
+        BEAST_EXPECT (! s.canRequest (1));
+
+        // Until it answers
+        clock.advance (milliseconds{100});
+        s.received (1, keys);
+        BEAST_EXPECT (s.canRequest (1));
+        s.assign (1, candidates);
+        BEAST_EXPECT (s.canRequest (1));
+    }
+
+public:
+    void
+    run () override
+    {
+        testAssign ();
+        testReceived ();
+        testSizing ();
+        testExpire ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(AcquireScheduler,ledger,call);
+
+} // test
+} // call
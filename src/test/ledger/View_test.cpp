@@ -27,6 +27,8 @@
 #include <call/core/ConfigSections.h>
 #include <call/protocol/Feature.h>
 #include <call/protocol/Protocol.h>
+#include <atomic>
+#include <thread>
 #include <type_traits>
 
 namespace call {
@@ -764,6 +766,62 @@ class View_test
         }
     }
 
+    // Sandboxes on a shared open view must not use its apply arena
+    void
+    testConcurrentSandboxes()
+    {
+        testcase ("concurrent sandboxes");
+
+        using namespace jtx;
+        Env env(*this);
+        wipe(env.app().openLedger());
+
+        auto const& stats = OpenView::applyArenaStats();
+        auto const before = stats.allocations.load();
+        {
+            // Shared between threads, like the published open ledger
+            OpenView const open (*env.current());
+            std::atomic<bool> ok {true};
+
+            auto work = [&](std::uint64_t first)
+            {
+                for (int i = 0; i < 200; ++i)
+                {
+                    PaymentSandbox sb (&open, tapNONE);
+                    for (auto id = first; id < first + 20; ++id)
+                        sb.insert (sle (id));
+                    for (auto id = first; id < first + 20; ++id)
+                        if (! sb.exists (k (id)))
+                            ok = false;
+
+                    PaymentSandbox child (&sb);
+                    child.erase (child.peek (k (first)));
+                    child.apply (sb);
+                    if (sb.exists (k (first)))
+                        ok = false;
+                }
+            };
+
+            std::thread t1 (work, 1000);
+            std::thread t2 (work, 2000);
+            t1.join();
+            t2.join();
+            BEAST_EXPECT(ok);
+        }
+        BEAST_EXPECT(stats.allocations.load() == before);
+
+        // The arena is used when it is passed explicitly
+        {
+            OpenView open (*env.current());
+            ApplyViewImpl v (&open, tapNONE, open.applyArena());
+            v.insert (sle (1));
+            Sandbox sb (&v);
+            sb.insert (sle (2));
+            BEAST_EXPECT(sb.exists (k (1)) && sb.exists (k (2)));
+        }
+        BEAST_EXPECT(stats.allocations.load() > before);
+    }
+
     void run()
     {
         // This had better work, or else
@@ -779,6 +837,7 @@ class View_test
         testTransferRate();
         testAreCompatible();
         testRegressions();
+        testConcurrentSandboxes();
     }
 };
 
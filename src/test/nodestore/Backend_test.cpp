@@ -21,6 +21,7 @@
 #include <call/unity/rocksdb.h>
 #include <test/nodestore/TestBase.h>
 #include <call/nodestore/DummyScheduler.h>
+#include <call/nodestore/GenerationalBackend.h>
 #include <call/nodestore/Manager.h>
 #include <call/beast/utility/temp_dir.h>
 #include <algorithm>
@@ -80,6 +81,13 @@ public:
                 fetchCopyOfBatch (*backend, &copy, batch);
                 BEAST_EXPECT(areBatchesEqual (batch, copy));
             }
+
+            {
+                // Read it back in with a batch fetch
+                Batch copy;
+                fetchBatchCopyOfBatch (*backend, &copy, batch);
+                BEAST_EXPECT(areBatchesEqual (batch, copy));
+            }
         }
 
         {
@@ -99,6 +107,113 @@ public:
 
     //--------------------------------------------------------------------------
 
+    void testGenerational (std::string const& type, std::uint64_t const seedValue)
+    {
+        DummyScheduler scheduler;
+
+        testcase ("Generational type=" + type);
+
+        Section params;
+        beast::temp_dir tempDir;
+        params.set ("type", type);
+        params.set ("path", tempDir.path());
+        params.set ("generational", "1");
+
+        beast::xor_shift_engine rng (seedValue);
+        auto const batch = createPredictableBatch (30, rng());
+
+        auto range = [&batch](std::size_t first, std::size_t last)
+        {
+            return Batch (batch.begin() + first, batch.begin() + last);
+        };
+        auto hashes = [](Batch const& objects)
+        {
+            std::vector<uint256> result;
+            for (auto const& object : objects)
+                result.push_back (object->getHash());
+            return result;
+        };
+        auto never = [] { return false; };
+
+        beast::Journal j;
+
+        {
+            std::unique_ptr <Backend> backend =
+                Manager::instance().make_Backend (params, scheduler, j);
+            auto generational =
+                dynamic_cast <GenerationalBackend*> (backend.get());
+            if (! BEAST_EXPECT(generational))
+                return;
+            BEAST_EXPECT(generational->getTracked() == 0);
+
+            // Ledger 1 holds the first ten objects in its state tree
+            generational->setGeneration (1);
+            backend->storeBatch (range (0, 10));
+            generational->recordChanges (1, hashes (range (0, 10)), {}, {});
+
+            // Ledger 3 is built before it is validated, so while the
+            // generation is still 2. It replaces objects 0-4 with 20-24
+            // and objects 10-14 are its header and transaction tree;
+            // objects 15-19 belong to a ledger that is never validated.
+            generational->setGeneration (2);
+            backend->storeBatch (range (10, 25));
+            generational->recordChanges (3, hashes (range (20, 25)),
+                hashes (range (0, 5)), hashes (range (10, 15)));
+
+            // Ledger 5 brings back object 3, adds 25-29 and drops 20-21
+            generational->setGeneration (4);
+            backend->storeBatch (range (3, 4));
+            backend->storeBatch (range (25, 30));
+            auto born = hashes (range (25, 30));
+            born.push_back (batch[3]->getHash());
+            generational->recordChanges (5, born, hashes (range (20, 22)), {});
+            BEAST_EXPECT(generational->getTracked() == 5);
+
+            // Object 15 is written again while ledger 6 is built
+            generational->setGeneration (6);
+            backend->storeBatch (range (15, 16));
+
+            // Only the unreferenced objects written before ledger 3 go;
+            // the header and transactions of ledger 3 are kept with it
+            BEAST_EXPECT(generational->erase (3, never) == 4);
+            fetchMissing (*backend, range (16, 20));
+            Batch copy;
+            fetchCopyOfBatch (*backend, &copy, range (0, 16));
+            fetchCopyOfBatch (*backend, &copy, range (20, 30));
+
+            // Nodes which left the state tree before ledger 6 go now,
+            // except the one which came back, and so does ledger 3
+            BEAST_EXPECT(generational->erase (6, never) == 11);
+            fetchMissing (*backend, range (0, 3));
+            fetchMissing (*backend, range (4, 5));
+            fetchMissing (*backend, range (10, 15));
+            fetchMissing (*backend, range (20, 22));
+            fetchCopyOfBatch (*backend, &copy, range (3, 4));
+            fetchCopyOfBatch (*backend, &copy, range (5, 10));
+            fetchCopyOfBatch (*backend, &copy, range (15, 16));
+            fetchCopyOfBatch (*backend, &copy, range (22, 30));
+
+            // Nothing is left to do for the same cutoff
+            BEAST_EXPECT(generational->erase (6, never) == 0);
+        }
+
+        {
+            // The tracked ledger survives a restart
+            std::unique_ptr <Backend> backend =
+                Manager::instance().make_Backend (params, scheduler, j);
+            auto generational =
+                dynamic_cast <GenerationalBackend*> (backend.get());
+            if (BEAST_EXPECT(generational))
+                BEAST_EXPECT(generational->getTracked() == 5);
+
+            // Object 15 was never part of a state tree
+            BEAST_EXPECT(generational->erase (7, never) == 1);
+            fetchMissing (*backend, range (15, 16));
+        }
+    }
+
+    //--------------------------------------------------------------------------
+
     void run ()
     {
         std::uint64_t const seedValue = 50;
@@ -107,6 +222,7 @@ public:
 
     #if CALL_ROCKSDB_AVAILABLE
         testBackend ("rocksdb", seedValue);
+        testGenerational ("rocksdb", seedValue);
     #endif
 
     #ifdef CALL_ENABLE_SQLITE_BACKEND_TESTS
@@ -0,0 +1,236 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of calld: https://github.com/call/calld
+    Copyright (c) 2012, 2013 Call Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <test/nodestore/TestBase.h>
+#include <call/nodestore/DatabaseShard.h>
+#include <call/nodestore/DummyScheduler.h>
+#include <call/nodestore/impl/Tuning.h>
+#include <call/beast/utility/temp_dir.h>
+#include <boost/filesystem.hpp>
+
+namespace call {
+namespace NodeStore {
+
+class DatabaseShard_test : public TestBase
+{
+    static std::uint32_t constexpr ledgersPerShard = 4;
+
+    // Object i belongs to ledger 1 + i % (2 * ledgersPerShard),
+    // which spreads the batch over the first two shards.
+    static std::uint32_t
+    seqOf (std::size_t i)
+    {
+        return 1 + i % (2 * ledgersPerShard);
+    }
+
+    std::unique_ptr<DatabaseShard>
+    makeStore (Section const& config, Scheduler& scheduler)
+    {
+        return make_DatabaseShard (config, scheduler, beast::Journal{});
+    }
+
+    void
+    storeBatch (DatabaseShard& db, Batch const& batch)
+    {
+        for (std::size_t i = 0; i < batch.size (); ++i)
+        {
+            Blob data (batch[i]->getData ());
+            db.store (batch[i]->getType (), std::move (data),
+                batch[i]->getHash (), seqOf (i));
+        }
+    }
+
+    bool
+    canFetch (DatabaseShard& db, Batch const& batch,
+        std::function<bool (std::size_t)> const& which)
+    {
+        for (std::size_t i = 0; i < batch.size (); ++i)
+        {
+            if (! which (i))
+                continue;
+            auto const object = db.fetch (batch[i]->getHash (), seqOf (i));
+            if (! object || ! isSame (batch[i], object))
+                return false;
+        }
+        return true;
+    }
+
+public:
+    void
+    testShards (std::uint64_t seedValue)
+    {
+        testcase ("shards");
+
+        DummyScheduler scheduler;
+        beast::temp_dir tempDir;
+
+        Section config;
+        config.set ("path", tempDir.path ());
+        config.set ("ledgers_per_shard", std::to_string (ledgersPerShard));
+
+        auto const batch = createPredictableBatch (
+            numObjectsToTest, seedValue);
+        auto const all = [](std::size_t) { return true; };
+
+        {
+            auto db = makeStore (config, scheduler);
+            BEAST_EXPECT(db->ledgersPerShard () == ledgersPerShard);
+            BEAST_EXPECT(db->seqToShardIndex (1) == 0);
+            BEAST_EXPECT(db->seqToShardIndex (4) == 0);
+            BEAST_EXPECT(db->seqToShardIndex (5) == 1);
+            BEAST_EXPECT(db->firstSeq (1) == 5);
+            BEAST_EXPECT(db->lastSeq (1) == 8);
+
+            storeBatch (*db, batch);
+            BEAST_EXPECT(canFetch (*db, batch, all));
+
+            // Objects are only found in the shard of their ledger
+            BEAST_EXPECT(! db->fetch (batch[0]->getHash (),
+                seqOf (0) + ledgersPerShard));
+            BEAST_EXPECT(! db->fetch (batch[0]->getHash (),
+                seqOf (0) + 2 * ledgersPerShard));
+
+            for (std::uint32_t seq = 1; seq <= ledgersPerShard; ++seq)
+                db->setStored (seq);
+            db->setStored (6);
+
+            BEAST_EXPECT(db->hasLedger (4));
+            BEAST_EXPECT(! db->hasLedger (5));
+            BEAST_EXPECT(db->hasLedger (6));
+            BEAST_EXPECT(! db->hasLedger (9));
+            BEAST_EXPECT(to_string (db->getStored ()) == "1-4,6");
+            BEAST_EXPECT(db->getCompleteShards () == "0");
+
+            // Progress is only recorded once the database has committed
+            // the ledger, which closing it does
+            BEAST_EXPECT(! boost::filesystem::exists (
+                boost::filesystem::path (tempDir.path ()) /
+                    "1" / "control.txt"));
+        }
+
+        BEAST_EXPECT(boost::filesystem::exists (
+            boost::filesystem::path (tempDir.path ()) / "0" / "complete"));
+        BEAST_EXPECT(boost::filesystem::exists (
+            boost::filesystem::path (tempDir.path ()) / "1" / "control.txt"));
+
+        {
+            // Progress and data survive a restart
+            auto db = makeStore (config, scheduler);
+            BEAST_EXPECT(to_string (db->getStored ()) == "1-4,6");
+            BEAST_EXPECT(db->getCompleteShards () == "0");
+            BEAST_EXPECT(canFetch (*db, batch, all));
+
+            // A finalized shard takes no more objects
+            auto const extra = createPredictableBatch (1, seedValue + 1);
+            Blob data (extra[0]->getData ());
+            db->store (extra[0]->getType (), std::move (data),
+                extra[0]->getHash (), 1);
+            BEAST_EXPECT(! db->fetch (extra[0]->getHash (), 1));
+
+            for (std::uint32_t seq = 5; seq <= 2 * ledgersPerShard; ++seq)
+                db->setStored (seq);
+            BEAST_EXPECT(db->getCompleteShards () == "0-1");
+        }
+
+        {
+            auto db = makeStore (config, scheduler);
+            BEAST_EXPECT(to_string (db->getStored ()) == "1-8");
+            BEAST_EXPECT(canFetch (*db, batch, all));
+        }
+
+        // The shard size can't change under existing shards
+        config.set ("ledgers_per_shard",
+            std::to_string (2 * ledgersPerShard));
+        try
+        {
+            makeStore (config, scheduler);
+            fail ("ledgers_per_shard change accepted");
+        }
+        catch (std::runtime_error const&)
+        {
+            pass ();
+        }
+    }
+
+    void
+    testCheckpoint (std::uint64_t seedValue)
+    {
+        testcase ("checkpoint");
+
+        DummyScheduler scheduler;
+        beast::temp_dir tempDir;
+
+        std::uint32_t const interval = shardCheckpointInterval;
+
+        Section config;
+        config.set ("path", tempDir.path ());
+        config.set ("ledgers_per_shard", std::to_string (2 * interval));
+
+        auto const control =
+            boost::filesystem::path (tempDir.path ()) / "0" / "control.txt";
+        auto const batch = createPredictableBatch (
+            numObjectsToTest, seedValue);
+
+        {
+            auto db = makeStore (config, scheduler);
+            for (auto const& object : batch)
+            {
+                Blob data (object->getData ());
+                db->store (object->getType (), std::move (data),
+                    object->getHash (), 1);
+            }
+
+            for (std::uint32_t seq = 1; seq < interval; ++seq)
+                db->setStored (seq);
+            BEAST_EXPECT(! boost::filesystem::exists (control));
+
+            // The database is committed and reopened, then the
+            // progress so far is recorded
+            db->setStored (interval);
+            BEAST_EXPECT(boost::filesystem::exists (control));
+            for (auto const& object : batch)
+            {
+                auto const fetched = db->fetch (object->getHash (), 1);
+                BEAST_EXPECT(fetched && isSame (object, fetched));
+            }
+
+            db->setStored (interval + 1);
+        }
+
+        {
+            auto db = makeStore (config, scheduler);
+            BEAST_EXPECT(to_string (db->getStored ()) ==
+                "1-" + std::to_string (interval + 1));
+            BEAST_EXPECT(db->getCompleteShards () == "empty");
+        }
+    }
+
+    void
+    run () override
+    {
+        testShards (50);
+        testCheckpoint (50);
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(DatabaseShard,NodeStore,call);
+
+}
+}
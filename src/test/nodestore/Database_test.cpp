@@ -141,6 +141,17 @@ public:
 
         if (testPersistence)
         {
+            {
+                // Re-open the database without the ephemeral DB
+                std::unique_ptr <Database> db = Manager::instance().make_Database (
+                    "test", scheduler, 2, parent, nodeParams, j);
+
+                // Read it back in with a cold cache
+                Batch copy;
+                fetchBatchCopyOfBatch (*db, &copy, batch);
+                BEAST_EXPECT(areBatchesEqual (batch, copy));
+            }
+
             {
                 // Re-open the database without the ephemeral DB
                 std::unique_ptr <Database> db = Manager::instance().make_Database (
@@ -168,6 +168,20 @@ public:
         }
     }
 
+    // Get a copy of a batch in a backend using a single batch fetch
+    void fetchBatchCopyOfBatch (Backend& backend, Batch* pCopy, Batch const& batch)
+    {
+        std::vector<void const*> keys;
+        keys.reserve (batch.size ());
+        for (auto const& object : batch)
+            keys.push_back (object->getHash ().cbegin ());
+
+        *pCopy = backend.fetchBatch (keys.size (), keys.data ());
+        BEAST_EXPECT(pCopy->size () == batch.size ());
+        for (auto const& object : *pCopy)
+            BEAST_EXPECT(object != nullptr);
+    }
+
     void fetchMissing(Backend& backend, Batch const& batch)
     {
         for (int i = 0; i < batch.size (); ++i)
@@ -212,6 +226,24 @@ public:
                 pCopy->push_back (object);
         }
     }
+
+    // Fetch all the hashes in one batch with a single batch fetch.
+    static void fetchBatchCopyOfBatch (Database& db,
+                                       Batch* pCopy,
+                                       Batch const& batch)
+    {
+        std::vector<uint256> hashes;
+        hashes.reserve (batch.size ());
+        for (auto const& object : batch)
+            hashes.push_back (object->getHash ());
+
+        pCopy->clear ();
+        for (auto const& object : db.fetchBatch (hashes))
+        {
+            if (object != nullptr)
+                pCopy->push_back (object);
+        }
+    }
 };
 
 }
@@ -0,0 +1,215 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of calld: https://github.com/call/calld
+    Copyright (c) 2012, 2013 Call Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <call/overlay/Message.h>
+#include <call/overlay/impl/ProtocolMessage.h>
+#include <call/beast/unit_test.h>
+#include <boost/asio/buffer.hpp>
+#include <string>
+
+namespace call {
+
+class compression_test : public beast::unit_test::suite
+{
+    // Receives the messages decoded by invokeProtocolMessage
+    struct Handler
+    {
+        std::shared_ptr<protocol::TMGetObjectByHash> message;
+        std::size_t size = 0;
+        std::size_t uncompressedSize = 0;
+
+        boost::system::error_code
+        onMessageBegin (std::uint16_t type,
+            std::shared_ptr <::google::protobuf::Message> const& m,
+            std::size_t size, std::size_t uncompressedSize)
+        {
+            this->size = size;
+            this->uncompressedSize = uncompressedSize;
+            return {};
+        }
+
+        void
+        onMessage (std::shared_ptr<protocol::TMGetObjectByHash> const& m)
+        {
+            message = m;
+        }
+
+        template <class T>
+        void
+        onMessage (std::shared_ptr<T> const&)
+        {
+        }
+
+        void
+        onMessageEnd (std::uint16_t,
+            std::shared_ptr <::google::protobuf::Message> const&)
+        {
+        }
+
+        boost::system::error_code
+        onMessageUnknown (std::uint16_t)
+        {
+            return boost::system::errc::make_error_code(
+                boost::system::errc::invalid_argument);
+        }
+    };
+
+    static
+    protocol::TMGetObjectByHash
+    makeReply (int count)
+    {
+        protocol::TMGetObjectByHash reply;
+        reply.set_type (protocol::TMGetObjectByHash::otTRANSACTION_NODE);
+        reply.set_query (false);
+        for (int i = 0; i < count; ++i)
+        {
+            auto& obj = *reply.add_objects ();
+            obj.set_hash (std::string (32, static_cast<char>(i)));
+            obj.set_data (std::string (100, 'x') + std::to_string (i));
+            obj.set_ledgerseq (i);
+        }
+        return reply;
+    }
+
+public:
+    void
+    testRoundTrip ()
+    {
+        testcase ("round trip");
+
+        auto const reply = makeReply (64);
+        Message const m (reply, protocol::mtGET_OBJECTS);
+
+        auto const& raw = m.getBuffer ();
+        auto const& compressed = m.getBuffer (true);
+        BEAST_EXPECT (! Message::compressed (
+            boost::asio::buffer (raw)));
+        BEAST_EXPECT (Message::compressed (
+            boost::asio::buffer (compressed)));
+        BEAST_EXPECT (compressed.size () < raw.size ());
+        BEAST_EXPECT (&m.getBuffer (true) == &compressed);
+        BEAST_EXPECT (Message::getType (compressed) ==
+            protocol::mtGET_OBJECTS);
+        BEAST_EXPECT (Message::getLength (compressed) +
+            Message::kHeaderBytes == compressed.size ());
+        BEAST_EXPECT (Message::size (boost::asio::buffer (compressed)) +
+            Message::kHeaderBytes == compressed.size ());
+
+        for (auto const buf : { &raw, &compressed })
+        {
+            Handler h;
+            auto const result = invokeProtocolMessage (
+                boost::asio::buffer (*buf), h, true);
+            BEAST_EXPECT (! result.second);
+            BEAST_EXPECT (result.first == buf->size ());
+            BEAST_EXPECT (h.size == buf->size ());
+            BEAST_EXPECT (h.uncompressedSize == raw.size ());
+            if (BEAST_EXPECT (h.message))
+                BEAST_EXPECT (h.message->SerializeAsString () ==
+                    reply.SerializeAsString ());
+        }
+    }
+
+    void
+    testNotNegotiated ()
+    {
+        testcase ("not negotiated");
+
+        Message const m (makeReply (64), protocol::mtGET_OBJECTS);
+
+        // Uncompressed messages are accepted either way
+        {
+            Handler h;
+            auto const& raw = m.getBuffer ();
+            auto const result = invokeProtocolMessage (
+                boost::asio::buffer (raw), h, false);
+            BEAST_EXPECT (! result.second);
+            BEAST_EXPECT (result.first == raw.size ());
+            BEAST_EXPECT (h.message);
+        }
+
+        // A compressed message is bad data if compression was not
+        // negotiated, and is never decompressed
+        {
+            Handler h;
+            auto const result = invokeProtocolMessage (
+                boost::asio::buffer (m.getBuffer (true)), h, false);
+            BEAST_EXPECT (result.second);
+            BEAST_EXPECT (result.first == 0);
+            BEAST_EXPECT (! h.message);
+            BEAST_EXPECT (h.size == 0);
+        }
+    }
+
+    void
+    testThreshold ()
+    {
+        testcase ("threshold");
+
+        // Too small to be worth compressing
+        Message const small (makeReply (1), protocol::mtGET_OBJECTS);
+        BEAST_EXPECT (&small.getBuffer (true) == &small.getBuffer ());
+
+        // Not a type we compress
+        protocol::TMGetLedger request;
+        request.set_itype (protocol::liAS_NODE);
+        for (int i = 0; i < 64; ++i)
+            request.add_nodeids (std::string (33, 'x'));
+        Message const other (request, protocol::mtGET_LEDGER);
+        BEAST_EXPECT (&other.getBuffer (true) == &other.getBuffer ());
+    }
+
+    void
+    testMalformed ()
+    {
+        testcase ("malformed");
+
+        Message const m (makeReply (64), protocol::mtGET_OBJECTS);
+        auto buf = m.getBuffer (true);
+
+        // Claim a larger uncompressed size than the block holds
+        buf[Message::kHeaderBytes] = 0x01;
+        Handler h;
+        auto const result = invokeProtocolMessage (
+            boost::asio::buffer (buf), h, true);
+        BEAST_EXPECT (result.second);
+        BEAST_EXPECT (! h.message);
+
+        // Partial messages are not consumed
+        auto const& whole = m.getBuffer (true);
+        std::vector<std::uint8_t> part (whole.begin (), whole.end () - 1);
+        auto const partial = invokeProtocolMessage (
+            boost::asio::buffer (part), h, true);
+        BEAST_EXPECT (partial.first == 0 && ! partial.second);
+    }
+
+    void
+    run () override
+    {
+        testRoundTrip ();
+        testNotNegotiated ();
+        testThreshold ();
+        testMalformed ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(compression,overlay,call);
+
+}
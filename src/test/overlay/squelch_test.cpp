@@ -0,0 +1,257 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of calld: https://github.com/call/calld
+    Copyright (c) 2012, 2013 Call Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <call/overlay/impl/Squelch.h>
+#include <call/overlay/impl/Tuning.h>
+#include <call/protocol/SecretKey.h>
+#include <call/beast/unit_test.h>
+#include <set>
+
+namespace call {
+namespace test {
+
+class squelch_test : public beast::unit_test::suite
+{
+    using Slots = squelch::Slots;
+    using Actions = std::vector<Slots::Action>;
+
+    // The peers the actions squelch, or unsquelch
+    static
+    std::set<Slots::id_t>
+    peers (Actions const& actions, bool squelch)
+    {
+        std::set<Slots::id_t> result;
+        for (auto const& a : actions)
+            if ((a.duration.count() != 0) == squelch)
+                result.insert (a.peer);
+        return result;
+    }
+
+    // Peers 1 through 7 deliver each message in turn, peer 8 cannot
+    // be squelched. Returns the actions once the sources are chosen.
+    Actions
+    select (Slots& slots, PublicKey const& validator)
+    {
+        Actions actions;
+        for (int i = 0; i < Tuning::squelchMessageThreshold; ++i)
+        {
+            for (Slots::id_t peer = 1; peer <= 8; ++peer)
+            {
+                auto const a = slots.update (validator, peer, peer != 8);
+                actions.insert (actions.end(), a.begin(), a.end());
+            }
+        }
+        return actions;
+    }
+
+    void
+    testSelection ()
+    {
+        testcase ("selection");
+
+        using namespace std::chrono;
+        TestStopwatch clock;
+        Slots slots (clock);
+        auto const validator = randomKeyPair(KeyType::secp256k1).first;
+
+        auto const actions = select (slots, validator);
+        BEAST_EXPECT (peers (actions, true) ==
+            std::set<Slots::id_t>({6, 7}));
+        BEAST_EXPECT (peers (actions, false).empty());
+        for (auto const& a : actions)
+        {
+            BEAST_EXPECT (a.validator == validator);
+            BEAST_EXPECT (a.duration >= seconds{Tuning::minSquelchSeconds});
+            BEAST_EXPECT (a.duration <= seconds{Tuning::maxSquelchSeconds});
+        }
+
+        // Sources and squelched peers send nothing more
+        BEAST_EXPECT (slots.update (validator, 1, true).empty());
+        BEAST_EXPECT (slots.update (validator, 6, true).empty());
+        BEAST_EXPECT (slots.expire().empty());
+
+        // A newcomer is squelched for the rest of the round
+        clock.advance (seconds{10});
+        auto const late = slots.update (validator, 9, true);
+        BEAST_EXPECT (peers (late, true) == std::set<Slots::id_t>({9}));
+        BEAST_EXPECT (late.size() == 1 &&
+            late[0].duration + seconds{10} == actions[0].duration);
+
+        // Other validators are counted separately
+        auto const other = randomKeyPair(KeyType::ed25519).first;
+        BEAST_EXPECT (slots.update (other, 6, true).empty());
+    }
+
+    void
+    testRotation ()
+    {
+        testcase ("rotation");
+
+        using namespace std::chrono;
+        TestStopwatch clock;
+        Slots slots (clock);
+        auto const validator = randomKeyPair(KeyType::secp256k1).first;
+
+        auto const duration = select (slots, validator).front().duration;
+
+        // The sources keep delivering until the squelches run out
+        for (auto i = 0; i < duration.count(); ++i)
+        {
+            ++clock;
+            for (Slots::id_t peer = 1; peer <= 5; ++peer)
+                slots.update (validator, peer, true);
+            auto const actions = slots.expire();
+            BEAST_EXPECT (actions.empty());
+        }
+
+        // Counting starts over, and the first to deliver are chosen
+        Actions actions;
+        for (int i = 0; i < Tuning::squelchMessageThreshold; ++i)
+        {
+            for (Slots::id_t peer = 8; peer >= 1; --peer)
+            {
+                auto const a = slots.update (validator, peer, true);
+                actions.insert (actions.end(), a.begin(), a.end());
+            }
+        }
+        BEAST_EXPECT (peers (actions, true) ==
+            std::set<Slots::id_t>({1, 2, 3}));
+    }
+
+    void
+    testLagging ()
+    {
+        testcase ("lagging source");
+
+        using namespace std::chrono;
+        TestStopwatch clock;
+        Slots slots (clock);
+        auto const validator = randomKeyPair(KeyType::secp256k1).first;
+        select (slots, validator);
+
+        // Peer 5 stops delivering
+        for (auto i = 0; i < Tuning::squelchIdleSeconds; ++i)
+        {
+            ++clock;
+            for (Slots::id_t peer = 1; peer <= 4; ++peer)
+                slots.update (validator, peer, true);
+            BEAST_EXPECT (slots.expire().empty());
+        }
+        ++clock;
+        for (Slots::id_t peer = 1; peer <= 4; ++peer)
+            slots.update (validator, peer, true);
+
+        auto const actions = slots.expire();
+        BEAST_EXPECT (peers (actions, false) ==
+            std::set<Slots::id_t>({6, 7}));
+        BEAST_EXPECT (peers (actions, true).empty());
+    }
+
+    void
+    testDeletePeer ()
+    {
+        testcase ("delete peer");
+
+        TestStopwatch clock;
+        Slots slots (clock);
+        auto const validator = randomKeyPair(KeyType::secp256k1).first;
+        select (slots, validator);
+
+        // Losing a squelched peer changes nothing
+        BEAST_EXPECT (slots.deletePeer (6).empty());
+
+        // Losing a source lifts the squelches
+        auto const actions = slots.deletePeer (2);
+        BEAST_EXPECT (peers (actions, false) ==
+            std::set<Slots::id_t>({7}));
+
+        // And the sources are chosen again
+        BEAST_EXPECT (peers (select (slots, validator), true) ==
+            std::set<Slots::id_t>({6, 7}));
+    }
+
+    void
+    testIdle ()
+    {
+        testcase ("idle validator");
+
+        using namespace std::chrono;
+        TestStopwatch clock;
+        Slots slots (clock);
+        auto const validator = randomKeyPair(KeyType::secp256k1).first;
+        select (slots, validator);
+
+        clock.advance (seconds{Tuning::squelchSlotIdleSeconds + 1});
+        auto const actions = slots.expire();
+        BEAST_EXPECT (peers (actions, false) ==
+            std::set<Slots::id_t>({6, 7}));
+        BEAST_EXPECT (slots.expire().empty());
+
+        // The validator's slot was forgotten
+        BEAST_EXPECT (slots.deletePeer (1).empty());
+    }
+
+    void
+    testSquelch ()
+    {
+        testcase ("squelch");
+
+        using namespace std::chrono;
+        TestStopwatch clock;
+        squelch::Squelch squelch (clock);
+        auto const validator = randomKeyPair(KeyType::secp256k1).first;
+        auto const other = randomKeyPair(KeyType::secp256k1).first;
+
+        BEAST_EXPECT (! squelch.add (validator, seconds{0}));
+        BEAST_EXPECT (! squelch.add (validator,
+            seconds{Tuning::maxSquelchSeconds + 1}));
+        BEAST_EXPECT (! squelch.squelched (validator));
+
+        BEAST_EXPECT (squelch.add (validator, seconds{30}));
+        BEAST_EXPECT (squelch.squelched (validator));
+        BEAST_EXPECT (! squelch.squelched (other));
+
+        clock.advance (seconds{29});
+        BEAST_EXPECT (squelch.squelched (validator));
+        ++clock;
+        BEAST_EXPECT (! squelch.squelched (validator));
+
+        BEAST_EXPECT (squelch.add (validator, seconds{30}));
+        squelch.remove (validator);
+        BEAST_EXPECT (! squelch.squelched (validator));
+    }
+
+public:
+    void
+    run () override
+    {
+        testSelection ();
+        testRotation ();
+        testLagging ();
+        testDeletePeer ();
+        testIdle ();
+        testSquelch ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(squelch,overlay,call);
+
+} // test
+} // call
@@ -0,0 +1,276 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of calld: https://github.com/call/calld
+    Copyright (c) 2012, 2013 Call Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <call/overlay/Message.h>
+#include <call/overlay/impl/ProtocolMessage.h>
+#include <call/overlay/impl/TrafficCount.h>
+#include <call/overlay/impl/Tuning.h>
+#include <call/overlay/impl/TxBatch.h>
+#include <call/beast/unit_test.h>
+#include <boost/asio/buffer.hpp>
+#include <string>
+
+namespace call {
+
+class tx_batch_test : public beast::unit_test::suite
+{
+    using Batch = txbatch::Batch;
+
+    // Receives the messages decoded by invokeProtocolMessage
+    struct Handler
+    {
+        std::shared_ptr<protocol::TMTransactions> batch;
+        std::shared_ptr<protocol::TMTransaction> single;
+
+        boost::system::error_code
+        onMessageBegin (std::uint16_t type,
+            std::shared_ptr <::google::protobuf::Message> const& m,
+            std::size_t size, std::size_t uncompressedSize)
+        {
+            return {};
+        }
+
+        void
+        onMessage (std::shared_ptr<protocol::TMTransactions> const& m)
+        {
+            batch = m;
+        }
+
+        void
+        onMessage (std::shared_ptr<protocol::TMTransaction> const& m)
+        {
+            single = m;
+        }
+
+        template <class T>
+        void
+        onMessage (std::shared_ptr<T> const&)
+        {
+        }
+
+        void
+        onMessageEnd (std::uint16_t,
+            std::shared_ptr <::google::protobuf::Message> const&)
+        {
+        }
+
+        boost::system::error_code
+        onMessageUnknown (std::uint16_t)
+        {
+            return boost::system::errc::make_error_code(
+                boost::system::errc::invalid_argument);
+        }
+    };
+
+    static
+    std::shared_ptr<protocol::TMTransaction const>
+    makeTx (int i, std::size_t size = 120)
+    {
+        auto tx = std::make_shared<protocol::TMTransaction>();
+        tx->set_rawtransaction (std::string (size, 't') + std::to_string (i));
+        tx->set_status (protocol::tsNEW);
+        tx->set_receivetimestamp (i);
+        return tx;
+    }
+
+    static
+    Handler
+    decode (std::shared_ptr<Message> const& m, bool compressed)
+    {
+        Handler h;
+        invokeProtocolMessage (
+            boost::asio::buffer (m->getBuffer (compressed)), h, true);
+        return h;
+    }
+
+public:
+    void
+    testWindow ()
+    {
+        testcase ("window");
+
+        Batch b;
+        BEAST_EXPECT (! b.take ());
+
+        // The first transaction starts the timer, later ones wait for it
+        BEAST_EXPECT (b.add (makeTx (0)) == Batch::Action::wait);
+        for (int i = 1; i < 32; ++i)
+            BEAST_EXPECT (b.add (makeTx (i)) == Batch::Action::none);
+        BEAST_EXPECT (b.size () == 32);
+
+        // When it completes, they go out as one message
+        b.expired ();
+        auto const m = b.take ();
+        if (! BEAST_EXPECT (m))
+            return;
+        BEAST_EXPECT (b.size () == 0 && b.bytes () == 0);
+        BEAST_EXPECT (m->getCategory () == static_cast<int>(
+            TrafficCount::category::CT_transaction));
+        BEAST_EXPECT (m->getBuffer (true).size () < m->getBuffer ().size ());
+
+        for (auto const compressed : { false, true })
+        {
+            auto const h = decode (m, compressed);
+            BEAST_EXPECT (! h.single);
+            if (! BEAST_EXPECT (h.batch) ||
+                    ! BEAST_EXPECT (h.batch->transactions_size () == 32))
+                continue;
+            for (int i = 0; i < 32; ++i)
+                BEAST_EXPECT (h.batch->transactions (i).SerializeAsString () ==
+                    makeTx (i)->SerializeAsString ());
+        }
+
+        // The next transaction starts the timer again
+        BEAST_EXPECT (b.add (makeTx (32)) == Batch::Action::wait);
+    }
+
+    void
+    testSingle ()
+    {
+        testcase ("single");
+
+        // A lone transaction is sent as a plain TMTransaction
+        Batch b;
+        BEAST_EXPECT (b.add (makeTx (7)) == Batch::Action::wait);
+        b.expired ();
+        auto const m = b.take ();
+        if (! BEAST_EXPECT (m))
+            return;
+        auto const h = decode (m, false);
+        BEAST_EXPECT (! h.batch);
+        if (BEAST_EXPECT (h.single))
+            BEAST_EXPECT (h.single->SerializeAsString () ==
+                makeTx (7)->SerializeAsString ());
+    }
+
+    void
+    testLimits ()
+    {
+        testcase ("limits");
+
+        // A full batch is sent without waiting for the timer
+        {
+            Batch b;
+            BEAST_EXPECT (b.add (makeTx (0)) == Batch::Action::wait);
+            for (int i = 1; i < Tuning::txBatchMaxCount - 1; ++i)
+                BEAST_EXPECT (b.add (makeTx (i)) == Batch::Action::none);
+            BEAST_EXPECT (b.add (makeTx (0)) == Batch::Action::send);
+            auto const m = b.take ();
+            if (BEAST_EXPECT (m))
+            {
+                auto const h = decode (m, false);
+                BEAST_EXPECT (h.batch && h.batch->transactions_size () ==
+                    Tuning::txBatchMaxCount);
+            }
+
+            // The timer is still running for the next batch
+            BEAST_EXPECT (b.add (makeTx (1)) == Batch::Action::none);
+        }
+
+        // So is a batch that reaches the byte limit
+        {
+            std::size_t const size = Tuning::txBatchMaxBytes / 4;
+            Batch b;
+            BEAST_EXPECT (b.add (makeTx (0, size)) == Batch::Action::wait);
+            BEAST_EXPECT (b.add (makeTx (1, size)) == Batch::Action::none);
+            BEAST_EXPECT (b.add (makeTx (2, size)) == Batch::Action::none);
+            BEAST_EXPECT (b.bytes () < Tuning::txBatchMaxBytes);
+            BEAST_EXPECT (b.add (makeTx (3, size)) == Batch::Action::send);
+            BEAST_EXPECT (b.bytes () >= Tuning::txBatchMaxBytes);
+            auto const m = b.take ();
+            BEAST_EXPECT (m && decode (m, false).batch);
+        }
+    }
+
+    void
+    testUnpack ()
+    {
+        testcase ("unpack");
+
+        auto makeBatch = [](int count)
+        {
+            protocol::TMTransactions batch;
+            for (int i = 0; i < count; ++i)
+                *batch.add_transactions () = *makeTx (i);
+            return batch;
+        };
+
+        std::vector<std::string> handled;
+        int charged = 0;
+        auto handle = [&](std::shared_ptr<protocol::TMTransaction> const& tx)
+        {
+            handled.push_back (tx->rawtransaction ());
+        };
+
+        // Each transaction is handled, and all but the last charged
+        // between them; the caller charges for the last
+        {
+            auto batch = makeBatch (5);
+            BEAST_EXPECT (txbatch::unpack (batch, true, handle,
+                [&]{ ++charged; return true; }));
+            BEAST_EXPECT (charged == 4);
+            if (BEAST_EXPECT (handled.size () == 5))
+                for (int i = 0; i < 5; ++i)
+                    BEAST_EXPECT (handled[i] ==
+                        makeTx (i)->rawtransaction ());
+        }
+
+        // A charge that disconnects the peer ends the batch
+        {
+            handled.clear ();
+            charged = 0;
+            auto batch = makeBatch (5);
+            BEAST_EXPECT (txbatch::unpack (batch, true, handle,
+                [&]{ return ++charged < 2; }));
+            BEAST_EXPECT (handled.size () == 2);
+        }
+
+        // Batches are rejected if not negotiated or too large
+        {
+            handled.clear ();
+            charged = 0;
+            auto batch = makeBatch (3);
+            BEAST_EXPECT (! txbatch::unpack (batch, false, handle,
+                [&]{ ++charged; return true; }));
+            auto big = makeBatch (Tuning::txBatchMaxCount + 1);
+            BEAST_EXPECT (! txbatch::unpack (big, true, handle,
+                [&]{ ++charged; return true; }));
+            BEAST_EXPECT (handled.empty () && charged == 0);
+
+            auto full = makeBatch (Tuning::txBatchMaxCount);
+            BEAST_EXPECT (txbatch::unpack (full, true, handle,
+                [&]{ ++charged; return true; }));
+            BEAST_EXPECT (handled.size () == Tuning::txBatchMaxCount);
+        }
+    }
+
+    void
+    run () override
+    {
+        testWindow ();
+        testSingle ();
+        testLimits ();
+        testUnpack ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(tx_batch,overlay,call);
+
+}
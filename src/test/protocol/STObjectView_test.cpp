@@ -0,0 +1,237 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of calld: https://github.com/call/calld
+    Copyright (c) 2012, 2013 Call Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <call/protocol/Indexes.h>
+#include <call/protocol/LedgerFormats.h>
+#include <call/protocol/STLedgerEntry.h>
+#include <call/protocol/STObjectView.h>
+#include <call/protocol/st.h>
+#include <call/beast/unit_test.h>
+
+namespace call {
+
+class STObjectView_test : public beast::unit_test::suite
+{
+    static
+    std::shared_ptr<Blob>
+    serialize (STObject const& object)
+    {
+        Serializer s;
+        object.add (s);
+        return std::make_shared<Blob> (s.begin (), s.end ());
+    }
+
+    static
+    STObjectView
+    makeView (std::shared_ptr<Blob> const& data,
+        SOTemplate const* type = nullptr)
+    {
+        return STObjectView (makeSlice (*data), data, type);
+    }
+
+    std::shared_ptr<SLE>
+    makeLine (AccountID const& low, AccountID const& high)
+    {
+        Currency const usd = to_currency ("USD");
+        auto sle = std::make_shared<SLE> (keylet::line (low, high, usd));
+        sle->setFieldAmount (sfBalance, STAmount (Issue (usd, noAccount ()), 25));
+        sle->setFieldAmount (sfLowLimit, STAmount (Issue (usd, low), 100));
+        sle->setFieldAmount (sfHighLimit, STAmount (Issue (usd, high), 0));
+        sle->setFieldH256 (sfPreviousTxnID, uint256 (7));
+        sle->setFieldU32 (sfPreviousTxnLgrSeq, 42);
+        sle->setFieldU64 (sfLowNode, 3);
+        sle->setFieldU32 (sfFlags, lsfLowReserve | lsfHighNoCall);
+        return sle;
+    }
+
+    void
+    checkLine (STObjectView const& view, SLE const& sle)
+    {
+        BEAST_EXPECT (view.getFieldAmount (sfBalance) ==
+            sle.getFieldAmount (sfBalance));
+        BEAST_EXPECT (view.getFieldAmount (sfLowLimit).getIssuer () ==
+            sle.getFieldAmount (sfLowLimit).getIssuer ());
+        BEAST_EXPECT (view[sfHighLimit] == sle[sfHighLimit]);
+        BEAST_EXPECT (view.getFieldH256 (sfPreviousTxnID) == uint256 (7));
+        BEAST_EXPECT (view[sfPreviousTxnLgrSeq] == 42);
+        BEAST_EXPECT (view.getFieldU64 (sfLowNode) == 3);
+        BEAST_EXPECT (view.getFlags () == (lsfLowReserve | lsfHighNoCall));
+        BEAST_EXPECT (view.isFlag (lsfLowReserve));
+        BEAST_EXPECT (! view.isFlag (lsfHighReserve));
+        BEAST_EXPECT (view.getFieldU16 (sfLedgerEntryType) == ltCALL_STATE);
+
+        // Absent optional fields default, or are boost::none
+        BEAST_EXPECT (! view.isFieldPresent (sfLowQualityIn));
+        BEAST_EXPECT (view.getFieldU32 (sfLowQualityIn) == 0);
+        BEAST_EXPECT (! view[~sfLowQualityIn]);
+        BEAST_EXPECT (view[~sfLowNode] == std::uint64_t (3));
+
+        try
+        {
+            view[sfHighNode];
+            fail ("absent optional field");
+        }
+        catch (std::exception const&)
+        {
+            pass ();
+        }
+
+        // Fields outside the template throw
+        try
+        {
+            view.getFieldU32 (sfOwnerCount);
+            fail ("field outside the template");
+        }
+        catch (std::exception const&)
+        {
+            pass ();
+        }
+    }
+
+    void
+    testLedgerEntry ()
+    {
+        testcase ("ledger entry");
+
+        AccountID const low (1);
+        AccountID const high (2);
+        auto const sle = makeLine (low, high);
+        auto const type = &LedgerFormats::getInstance ().findByType (
+            ltCALL_STATE)->elements;
+
+        checkLine (makeView (serialize (*sle), type), *sle);
+        checkLine (STObjectView (sle), *sle);
+
+        // The template can be set once the type is known
+        auto view = makeView (serialize (*sle));
+        BEAST_EXPECT (view.getFieldU32 (sfOwnerCount) == 0);
+        view.setTemplate (*type);
+        checkLine (view, *sle);
+    }
+
+    void
+    testAccountRoot ()
+    {
+        testcase ("account root");
+
+        AccountID const id (5);
+        Blob const domain { 'c', 'a', 'l', 'l' };
+        auto sle = std::make_shared<SLE> (keylet::account (id));
+        sle->setAccountID (sfAccount, id);
+        sle->setFieldU32 (sfSequence, 9);
+        sle->setFieldAmount (sfBalance, STAmount (1000000));
+        sle->setFieldU32 (sfOwnerCount, 4);
+        sle->setFieldVL (sfDomain, domain);
+        sle->setFieldH128 (sfEmailHash, uint128 (11));
+
+        auto const view = makeView (serialize (*sle),
+            &LedgerFormats::getInstance ().findByType (
+                ltACCOUNT_ROOT)->elements);
+
+        BEAST_EXPECT (view.getAccountID (sfAccount) == id);
+        BEAST_EXPECT (view[sfAccount] == id);
+        BEAST_EXPECT (view[sfSequence] == 9);
+        BEAST_EXPECT (view.getFieldAmount (sfBalance) == STAmount (1000000));
+        BEAST_EXPECT (view[sfOwnerCount] == 4);
+        BEAST_EXPECT (view.getFieldVL (sfDomain) == domain);
+        BEAST_EXPECT (view.getFieldH128 (sfEmailHash) == uint128 (11));
+        BEAST_EXPECT (! view.isFieldPresent (sfTransferRate));
+        BEAST_EXPECT (view.getFieldU32 (sfTransferRate) == 0);
+        BEAST_EXPECT (! view[~sfRegularKey]);
+    }
+
+    void
+    testFreeObject ()
+    {
+        testcase ("free object");
+
+        // Every kind of field the index has to skip over
+        STObject object (sfGeneric);
+        object.setFieldU8 (sfTickSize, 5);
+
+        STArray entries (sfSignerEntries);
+        for (std::uint16_t i = 1; i < 3; ++i)
+        {
+            entries.push_back (STObject (sfSignerEntry));
+            entries.back ().setAccountID (sfAccount, AccountID (i));
+            entries.back ().setFieldU16 (sfSignerWeight, i);
+        }
+        object.setFieldArray (sfSignerEntries, entries);
+
+        auto paths = std::make_unique<STPathSet> (sfPaths);
+        STPath path;
+        path.push_back (STPathElement (AccountID (3), to_currency ("EUR"),
+            AccountID (4)));
+        path.push_back (STPathElement (STPathElement::typeCurrency,
+            AccountID (), to_currency ("USD"), AccountID ()));
+        paths->push_back (path);
+        paths->push_back (path);
+        object.set (std::move (paths));
+
+        STVector256 indexes;
+        indexes.push_back (uint256 (1));
+        indexes.push_back (uint256 (2));
+        object.setFieldV256 (sfIndexes, indexes);
+
+        object.setFieldH160 (sfTakerPaysCurrency, to_currency ("GBP"));
+        object.setFieldAmount (sfAmount,
+            STAmount (Issue (to_currency ("USD"), AccountID (3)), 12));
+        object.setFieldU32 (sfSequence, 77);
+
+        auto const view = makeView (serialize (object));
+
+        BEAST_EXPECT (view.getFieldU8 (sfTickSize) == 5);
+        BEAST_EXPECT (view.isFieldPresent (sfSignerEntries));
+        BEAST_EXPECT (view.isFieldPresent (sfPaths));
+        BEAST_EXPECT (view.getFieldV256 (sfIndexes) == indexes);
+        BEAST_EXPECT (view.getFieldH160 (sfTakerPaysCurrency) ==
+            object.getFieldH160 (sfTakerPaysCurrency));
+        BEAST_EXPECT (view.getFieldAmount (sfAmount) ==
+            object.getFieldAmount (sfAmount));
+        BEAST_EXPECT (view[sfSequence] == 77);
+
+        // Without a template, absent fields are simply absent
+        BEAST_EXPECT (! view.isFieldPresent (sfFlags));
+        BEAST_EXPECT (view.getFlags () == 0);
+        BEAST_EXPECT (! view[~sfOwnerCount]);
+        try
+        {
+            view[sfOwnerCount];
+            fail ("absent field");
+        }
+        catch (std::exception const&)
+        {
+            pass ();
+        }
+    }
+
+public:
+    void
+    run ()
+    {
+        testLedgerEntry ();
+        testAccountRoot ();
+        testFreeObject ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(STObjectView,protocol,call);
+
+} // call
@@ -24,6 +24,8 @@
 #include <call/protocol/types.h>
 #include <call/json/to_string.h>
 #include <call/beast/unit_test.h>
+#include <memory>
+#include <vector>
 
 namespace call {
 
@@ -37,6 +39,42 @@ public:
 
         testcase ("ed25519 signatures");
         testSTTx (KeyType::ed25519);
+
+        testcase ("batch signatures");
+        testBatch ();
+    }
+
+    void testBatch()
+    {
+        std::vector<std::shared_ptr<STTx const>> txs;
+        for (int i = 0; i < 12; ++i)
+        {
+            auto const keypair = randomKeyPair (
+                (i % 3 == 0) ? KeyType::secp256k1 : KeyType::ed25519);
+
+            auto tx = std::make_shared<STTx> (ttACCOUNT_SET,
+                [&keypair, i](auto& obj)
+                {
+                    obj.setAccountID (sfAccount, calcAccountID(keypair.first));
+                    obj.setFieldVL (sfSigningPubKey, keypair.first.slice());
+                    obj.setFieldU32 (sfSequence, i);
+                });
+            tx->sign (keypair.first, keypair.second);
+
+            // Changing a signed field invalidates the signature
+            if (i % 4 == 1)
+                tx->setFieldU32 (sfSequence, i + 100);
+
+            txs.push_back (std::move (tx));
+        }
+
+        auto const results = checkSignBatch (txs, true);
+        BEAST_EXPECT(results.size() == txs.size());
+        for (std::size_t i = 0; i < txs.size(); ++i)
+        {
+            BEAST_EXPECT(results[i].first == txs[i]->checkSign (true).first);
+            BEAST_EXPECT(results[i].first == (i % 4 != 1));
+        }
     }
 
     void testSTTx(KeyType keyType)
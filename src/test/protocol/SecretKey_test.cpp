@@ -19,12 +19,15 @@
 
 #include <BeastConfig.h>
 #include <call/crypto/csprng.h>
+#include <call/crypto/impl/openssl.h>
+#include <call/protocol/digest.h>
 #include <call/protocol/PublicKey.h>
 #include <call/protocol/SecretKey.h>
 #include <call/protocol/Seed.h>
 #include <call/beast/unit_test.h>
 #include <call/beast/utility/rngfill.h>
 #include <algorithm>
+#include <array>
 #include <string>
 #include <vector>
 
@@ -309,6 +312,189 @@ public:
         }
     }
 
+    void testBatchSigning ()
+    {
+        testcase ("batch verification");
+
+        std::vector<std::pair<PublicKey, SecretKey>> keys;
+        std::vector<std::vector<std::uint8_t>> data;
+        std::vector<Buffer> sigs;
+
+        // Mostly Ed25519, with some secp256k1 mixed in, and enough
+        // items to span more than one batch inside ed25519-donna.
+        for (std::size_t i = 0; i < 150; ++i)
+        {
+            keys.push_back (randomKeyPair (
+                (i % 5 == 0) ? KeyType::secp256k1 : KeyType::ed25519));
+
+            data.emplace_back (64 + i);
+            beast::rngfill (data.back().data(), data.back().size(),
+                crypto_prng());
+
+            sigs.push_back (sign (keys.back().first, keys.back().second,
+                makeSlice (data.back())));
+        }
+
+        auto check = [&]()
+        {
+            std::vector<SignedMessage> items;
+            for (std::size_t i = 0; i < keys.size(); ++i)
+            {
+                items.push_back ({keys[i].first, makeSlice (data[i]),
+                    Slice (sigs[i].data(), sigs[i].size()), true});
+            }
+
+            auto const valid = verifyBatch (items);
+            BEAST_EXPECT(valid.size() == items.size());
+            for (std::size_t i = 0; i < items.size(); ++i)
+            {
+                BEAST_EXPECT(valid[i] == verify (items[i].publicKey,
+                    items[i].message, items[i].signature, true));
+            }
+            return valid;
+        };
+
+        // All good
+        for (auto const v : check ())
+            BEAST_EXPECT(v);
+
+        // A few bad signatures only fail their own items
+        for (std::size_t i = 3; i < sigs.size(); i += 37)
+            sigs[i].data()[i % sigs[i].size()]++;
+
+        auto const valid = check ();
+        for (std::size_t i = 0; i < valid.size(); ++i)
+            BEAST_EXPECT(valid[i] == ((i < 3) || ((i - 3) % 37 != 0)));
+
+        BEAST_EXPECT(verifyBatch ({}).empty());
+    }
+
+    // Sign with a chosen R whose discrete log is zero or of small order:
+    // S = H(R,A,m) a mod l, so [S]B - [H(R,A,m)]A is the neutral point.
+    // verify only accepts this when R is the canonical neutral point.
+    static
+    Buffer
+    forgeEd25519 (std::pair<PublicKey, SecretKey> const& keys,
+        Slice const& m, std::array<std::uint8_t, 32> const& r)
+    {
+        // Scalars are little-endian; openssl wants them big-endian
+        auto toBignum = [](std::uint8_t const* data, std::size_t size)
+        {
+            std::vector<std::uint8_t> be (data, data + size);
+            std::reverse (be.begin(), be.end());
+            return openssl::bignum (be.data(), be.size());
+        };
+
+        std::array<std::uint8_t, 32> const order {{
+            0x10, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+            0x14, 0xde, 0xf9, 0xde, 0xa2, 0xf7, 0x9c, 0xd6,
+            0x58, 0x12, 0x63, 0x1a, 0x5c, 0xf5, 0xd3, 0xed }};
+        openssl::bignum const l (order.data(), order.size());
+
+        // The secret scalar, as ed25519-donna derives it
+        sha512_hasher ha;
+        ha (keys.second.data(), keys.second.size());
+        auto ext = static_cast<sha512_hasher::result_type>(ha);
+        ext[0] &= 248;
+        ext[31] &= 127;
+        ext[31] |= 64;
+        auto const a = toBignum (ext.data(), 32);
+
+        // Our public keys carry a 0xED prefix which is not signed
+        sha512_hasher hh;
+        hh (r.data(), r.size());
+        hh (keys.first.data() + 1, keys.first.size() - 1);
+        hh (m.data(), m.size());
+        auto const hram = static_cast<sha512_hasher::result_type>(hh);
+        auto const h = toBignum (hram.data(), hram.size());
+
+        openssl::bn_ctx ctx;
+        openssl::bignum s;
+        BN_mod_mul (s.get(), h.get(), a.get(), l.get(), ctx.get());
+
+        std::array<std::uint8_t, 64> sig {};
+        std::copy (r.begin(), r.end(), sig.begin());
+        BN_bn2bin (s.get(), sig.data() + 64 - BN_num_bytes (s.get()));
+        std::reverse (sig.begin() + 32, sig.end());
+        return Buffer (sig.data(), sig.size());
+    }
+
+    void testBatchForgeries ()
+    {
+        testcase ("batch verification of small order forgeries");
+
+        auto const keys = randomKeyPair (KeyType::ed25519);
+
+        // The neutral point (0, 1) and the point (0, -1) of order 2
+        std::array<std::uint8_t, 32> neutral {{ 0x01 }};
+        std::array<std::uint8_t, 32> order2;
+        order2.fill (0xff);
+        order2[0] = 0xec;
+        order2[31] = 0x7f;
+
+        // The neutral point with the sign bit of x set: not canonical
+        auto nonCanonical = neutral;
+        nonCanonical[31] |= 0x80;
+
+        std::vector<std::vector<std::uint8_t>> data;
+        std::vector<Buffer> sigs;
+        for (std::size_t i = 0; i < 4; ++i)
+        {
+            data.emplace_back (32 + i);
+            beast::rngfill (data.back().data(), data.back().size(),
+                crypto_prng());
+            sigs.push_back (sign (keys.first, keys.second,
+                makeSlice (data.back())));
+        }
+
+        // Batches only form with more than three signatures, so each
+        // forgery is checked alongside the good ones
+        auto check = [&](Slice const& m, Buffer const& forged)
+        {
+            std::vector<SignedMessage> items;
+            for (std::size_t i = 0; i < sigs.size(); ++i)
+            {
+                items.push_back ({keys.first, makeSlice (data[i]),
+                    Slice (sigs[i].data(), sigs[i].size()), true});
+            }
+            items.push_back ({keys.first, m,
+                Slice (forged.data(), forged.size()), true});
+
+            auto const valid = verifyBatch (items);
+            for (std::size_t i = 0; i < sigs.size(); ++i)
+                BEAST_EXPECT(valid[i]);
+            return valid.back();
+        };
+
+        std::string const message = "forged";
+        auto const m = makeSlice (message);
+
+        // The construction is sound: with the canonical neutral point
+        // it is a valid signature, and both paths agree
+        {
+            auto const sig = forgeEd25519 (keys, m, neutral);
+            BEAST_EXPECT(verify (keys.first, m, sig, true));
+            BEAST_EXPECT(check (m, sig));
+        }
+
+        // The batch equation sees the same point for both encodings
+        {
+            auto const sig = forgeEd25519 (keys, m, nonCanonical);
+            BEAST_EXPECT(! verify (keys.first, m, sig, true));
+            BEAST_EXPECT(! check (m, sig));
+        }
+
+        // The batch equation misses the point of order 2 whenever its
+        // random coefficient is even; repeat so that this would show
+        {
+            auto const sig = forgeEd25519 (keys, m, order2);
+            BEAST_EXPECT(! verify (keys.first, m, sig, true));
+            for (int i = 0; i < 32; ++i)
+                BEAST_EXPECT(! check (m, sig));
+        }
+    }
+
     void testBase58 ()
     {
         testcase ("Base58");
@@ -458,6 +644,9 @@ public:
 
         testcase ("ed25519");
         testSigning(KeyType::ed25519);
+
+        testBatchSigning();
+        testBatchForgeries();
     }
 };
 
@@ -18,8 +18,13 @@
 //==============================================================================
 
 #include <call/basics/StringUtilities.h>
+#include <call/json/json_reader.h>
+#include <call/json/Object.h>
 #include <call/protocol/Feature.h>
 #include <call/protocol/JsonFields.h>
+#include <call/resource/Fees.h>
+#include <call/rpc/Context.h>
+#include <call/rpc/RPCHandler.h>
 #include <test/jtx.h>
 
 namespace call {
@@ -426,6 +431,76 @@ public:
         }
     }
 
+    void testStreaming()
+    {
+        testcase("streaming");
+        using namespace test::jtx;
+        Env env { *this };
+        Account const gw { "gateway" };
+        env.fund(CALL(100000), gw);
+        for (auto i = 0; i < 10; i++)
+        {
+            Account const bob { std::string("bob") + std::to_string(i) };
+            env.fund(CALL(1000), bob);
+        }
+        env.close();
+
+        BEAST_EXPECT( RPC::isStreaming ("ledger_data") );
+        BEAST_EXPECT( ! RPC::isStreaming ("account_info") );
+
+        auto& app = env.app();
+        Resource::Charge loadType = Resource::feeReferenceRPC;
+        Resource::Consumer c;
+        RPC::Context context {beast::Journal(), {}, app, loadType,
+            app.getOPs(), app.getLedgerMaster(), c, Role::USER, {}};
+
+        // writing the result incrementally must produce exactly what the
+        // in-memory path builds
+        auto streamed = [&](Json::Value const& params)
+        {
+            context.params = params;
+            context.params[jss::command] = "ledger_data";
+
+            Json::Value expected;
+            RPC::doCommand (context, expected);
+
+            std::string text;
+            {
+                Json::Writer writer (Json::stringOutput (text));
+                Json::Object::Root root (writer);
+                RPC::doCommand (context,
+                    [&root](RPC::Status const&) -> Json::Object&
+                    {
+                        return root;
+                    });
+            }
+
+            Json::Value result;
+            BEAST_EXPECT( Json::Reader().parse (text, result) );
+            BEAST_EXPECT( result == expected );
+            return result;
+        };
+
+        Json::Value jvParams;
+        jvParams[jss::ledger_index] = "closed";
+        jvParams[jss::limit] = 5;
+        auto jrr = streamed (jvParams);
+        BEAST_EXPECT( checkMarker(jrr) );
+        BEAST_EXPECT( checkArraySize(jrr[jss::state], 5) );
+        BEAST_EXPECT( jrr.isMember(jss::ledger) );
+
+        jvParams[jss::marker] = jrr[jss::marker];
+        jvParams[jss::binary] = true;
+        jrr = streamed (jvParams);
+        BEAST_EXPECT( checkArraySize(jrr[jss::state], 5) );
+        BEAST_EXPECT( ! jrr.isMember(jss::ledger) );
+
+        jvParams[jss::marker] = "NOT_A_MARKER";
+        jrr = streamed (jvParams);
+        BEAST_EXPECT( jrr[jss::error] == "invalidParams" );
+        BEAST_EXPECT( ! jrr.isMember(jss::state) );
+    }
+
     void run()
     {
         testCurrentLedgerToLimits(true);
@@ -435,6 +510,7 @@ public:
         testMarkerFollow();
         testLedgerHeader();
         testLedgerType();
+        testStreaming();
     }
 };
 
@@ -19,7 +19,12 @@
 #include <call/app/misc/LoadFeeTrack.h>
 #include <call/app/misc/NetworkOPs.h>
 #include <call/core/ConfigSections.h>
+#include <call/core/JobQueue.h>
+#include <call/json/json_reader.h>
+#include <call/json/to_string.h>
+#include <call/net/InfoSub.h>
 #include <call/protocol/JsonFields.h>
+#include <call/rpc/impl/Tuning.h>
 #include <test/jtx/WSClient.h>
 #include <test/jtx/envconfig.h>
 #include <test/jtx.h>
@@ -30,6 +35,66 @@ namespace test {
 
 class Subscribe_test : public beast::unit_test::suite
 {
+    // Keeps the text of each event it is sent. On its first event it
+    // unsubscribes the given listeners from the ledger stream.
+    class Recorder : public InfoSub
+    {
+    public:
+        explicit Recorder (Source& source)
+            : InfoSub (source)
+            , source_ (source)
+        {
+        }
+
+        void
+        send (Json::Value const&, bool) override
+        {
+            std::lock_guard<std::mutex> lock (mutex_);
+            ++jsonSends_;
+        }
+
+        void
+        send (Event const& event, bool) override
+        {
+            std::vector<std::uint64_t> unsubscribe;
+            {
+                std::lock_guard<std::mutex> lock (mutex_);
+                texts_.push_back (event.text ());
+                unsubscribe.swap (unsubscribe_);
+            }
+            for (auto const seq : unsubscribe)
+                source_.unsubLedger (seq);
+        }
+
+        void
+        unsubscribeOnSend (std::vector<std::uint64_t> seqs)
+        {
+            std::lock_guard<std::mutex> lock (mutex_);
+            unsubscribe_ = std::move (seqs);
+        }
+
+        std::vector<std::shared_ptr<std::string const>>
+        texts ()
+        {
+            std::lock_guard<std::mutex> lock (mutex_);
+            return texts_;
+        }
+
+        int
+        jsonSends ()
+        {
+            std::lock_guard<std::mutex> lock (mutex_);
+            return jsonSends_;
+        }
+
+    private:
+        Source& source_;
+        std::mutex mutex_;
+        std::vector<std::shared_ptr<std::string const>> texts_;
+        std::vector<std::uint64_t> unsubscribe_;
+        int jsonSends_ = 0;
+    };
+
 public:
     void testServer()
     {
@@ -636,10 +701,183 @@ public:
 
     }
 
+    void testLedgerState()
+    {
+        using namespace std::chrono_literals;
+        using namespace jtx;
+        Env env(*this);
+        auto wsc = makeWSClient(env.app().config());
+        Account const alice {"alice"};
+
+        Json::Value stream;
+        stream[jss::streams] = Json::arrayValue;
+        stream[jss::streams].append("ledger_state");
+        BEAST_EXPECT(wsc->invoke("subscribe", stream)
+            [jss::result].isObject());
+
+        env.fund(CALL(10000), alice);
+        env.close();
+
+        auto const isAlice = [&](Json::Value const& entry)
+        {
+            return entry[sfLedgerEntryType.jsonName] == "AccountRoot" &&
+                entry[sfAccount.jsonName] == alice.human();
+        };
+        auto const holds = [&](Json::Value const& entries)
+        {
+            for (auto const& entry : entries)
+                if (isAlice (entry))
+                    return true;
+            return false;
+        };
+
+        // The new account shows up as a created entry
+        auto const msg = wsc->findMsg(5s,
+            [&](auto const& jv)
+            {
+                return jv[jss::type] == "ledgerState" &&
+                    jv[jss::ledger_index] == 3;
+            });
+        if (BEAST_EXPECT(msg))
+        {
+            auto const& jv = *msg;
+            BEAST_EXPECT(jv[jss::complete].asBool());
+            BEAST_EXPECT(holds(jv[jss::created]));
+            BEAST_EXPECT(! holds(jv[jss::modified]));
+            BEAST_EXPECT(jv[jss::deleted].size() == 0);
+
+            // The RPC reports the same change
+            Json::Value params;
+            params[jss::ledger_index] = 3;
+            auto const jr = env.rpc("json", "ledger_diff",
+                to_string(params))[jss::result];
+            BEAST_EXPECT(jr[jss::created] == jv[jss::created]);
+            BEAST_EXPECT(jr[jss::modified] == jv[jss::modified]);
+            BEAST_EXPECT(jr[jss::parent_hash] == jv[jss::parent_hash]);
+        }
+
+        // Binary subscribers get serialized entries
+        stream[jss::binary] = true;
+        BEAST_EXPECT(wsc->invoke("subscribe", stream)
+            [jss::result].isObject());
+        env(noop(alice));
+        env.close();
+        BEAST_EXPECT(wsc->findMsg(5s,
+            [&](auto const& jv)
+            {
+                if (jv[jss::type] != "ledgerState" ||
+                        jv[jss::ledger_index] != 4)
+                    return false;
+                auto const& modified = jv[jss::modified];
+                return modified.size() > 0 &&
+                    modified[0u].isMember(jss::data) &&
+                    ! modified[0u].isMember(sfLedgerEntryType.jsonName);
+            }));
+
+        // A ledger that isn't closed has no diff
+        {
+            Json::Value params;
+            params[jss::ledger_index] = "current";
+            auto const jr = env.rpc("json", "ledger_diff",
+                to_string(params))[jss::result];
+            BEAST_EXPECT(jr[jss::error] == "invalidParams");
+        }
+
+        auto jv = wsc->invoke("unsubscribe", stream);
+        BEAST_EXPECT(jv[jss::status] == "success");
+    }
+
+    void testLedgerDiffLimit()
+    {
+        using namespace jtx;
+        Env env(*this, envconfig(no_admin));
+
+        auto const diff = [&]
+        {
+            Json::Value params;
+            params[jss::ledger_index] = env.closed()->info().seq;
+            return env.rpc("json", "ledger_diff",
+                to_string(params))[jss::result];
+        };
+
+        // Clients that are not unlimited can't request large diffs
+        for (int i = 0; i < RPC::Tuning::maxStateDiffUser; ++i)
+            env.fund(CALL(1000),
+                nocall(Account {"bob" + std::to_string(i)}));
+        env.close();
+        BEAST_EXPECT(diff()[jss::error] == "lgrNotFound");
+
+        // Smaller ones are still served
+        env.fund(CALL(1000), Account {"alice"});
+        env.close();
+        auto const jr = diff();
+        BEAST_EXPECT(! jr.isMember(jss::error));
+        BEAST_EXPECT(jr[jss::created].size() == 1);
+    }
+
+    void testFanOut()
+    {
+        testcase("shared events");
+
+        using namespace jtx;
+        Env env(*this);
+        auto& ops = env.app().getOPs();
+        auto& jobs = env.app().getJobQueue();
+
+        std::vector<std::shared_ptr<Recorder>> subs;
+        for (int i = 0; i < 4; ++i)
+        {
+            subs.push_back(std::make_shared<Recorder>(ops));
+            Json::Value result;
+            BEAST_EXPECT(ops.subLedger(subs.back(), result));
+        }
+
+        // The third subscriber drops itself and the fourth while the
+        // first event is being sent
+        subs[2]->unsubscribeOnSend({subs[2]->getSeq(), subs[3]->getSeq()});
+
+        auto const sent = [&subs](std::size_t i)
+        {
+            return subs[i]->texts().size();
+        };
+
+        env.close();
+        jobs.rendezvous();
+
+        // Everyone collected before the send gets the event, and all of
+        // them share one serialization
+        for (std::size_t i = 0; i < subs.size(); ++i)
+        {
+            if (! BEAST_EXPECT(sent(i) == 1))
+                return;
+            BEAST_EXPECT(subs[i]->texts()[0] == subs[0]->texts()[0]);
+            BEAST_EXPECT(subs[i]->jsonSends() == 0);
+        }
+
+        Json::Value jv;
+        BEAST_EXPECT(Json::Reader().parse(*subs[0]->texts()[0], jv));
+        BEAST_EXPECT(jv[jss::type] == "ledgerClosed");
+        BEAST_EXPECT(jv[jss::ledger_index] == env.closed()->info().seq);
+
+        env.close();
+        jobs.rendezvous();
+
+        // The next event only goes to those still subscribed
+        BEAST_EXPECT(sent(0) == 2);
+        BEAST_EXPECT(sent(1) == 2);
+        BEAST_EXPECT(sent(2) == 1);
+        BEAST_EXPECT(sent(3) == 1);
+        BEAST_EXPECT(subs[0]->texts()[1] == subs[1]->texts()[1]);
+        BEAST_EXPECT(subs[0]->texts()[1] != subs[0]->texts()[0]);
+    }
+
     void run() override
     {
         testServer();
         testLedger();
+        testFanOut();
+        testLedgerState();
+        testLedgerDiffLimit();
         testTransactions();
         testManifests();
         testValidations();
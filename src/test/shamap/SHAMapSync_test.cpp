@@ -89,6 +89,100 @@ public:
 
         log << "Run, version 2\n" << std::endl;
         run(SHAMap::version{2});
+
+        testWireNodeCache(1);
+        testWireNodeCache(2);
+    }
+
+    void testWireNodeCache(int version)
+    {
+        testcase ("wire node cache, version " + std::to_string (version));
+
+        beast::Journal const j;
+        TestFamily f(j), f2(j);
+        TestStopwatch clock;
+        WireNodeCache cache ("WireNodeCache", 65536, 60, clock, j);
+
+        SHAMap::version const v{version};
+        SHAMap source (SHAMapType::FREE, f, v);
+        for (int i = 0; i < 1000; ++i)
+            source.addItem (std::move(*makeRandomAS ()), false, false);
+        source.getHash ();
+        source.setImmutable ();
+
+        auto const cached = [&cache]
+        {
+            return static_cast<std::size_t> (cache.getCacheSize ());
+        };
+
+        // Every node of a new map is cached, once
+        auto const count = source.cacheWireNodes (cache, nullptr);
+        BEAST_EXPECT(count > 1000);
+        BEAST_EXPECT(cached () == count);
+        BEAST_EXPECT(source.cacheWireNodes (cache, nullptr) == count);
+        BEAST_EXPECT(cached () == count);
+
+        // Only the nodes that changed are added for the next map
+        auto next = source.snapShot (true);
+        BEAST_EXPECT(next->addItem (std::move(*makeRandomAS ()), false, false));
+        next->getHash ();
+        next->setImmutable ();
+
+        auto const changed = next->cacheWireNodes (cache, &source);
+        BEAST_EXPECT(changed > 0 && changed < 10);
+        BEAST_EXPECT(cached () == count + changed);
+
+        // Replies served from the cache match freshly serialized nodes
+        // and sync a map without adding to the cache.
+        SHAMap destination (SHAMapType::FREE, f2, v);
+        destination.setSynching ();
+
+        {
+            std::vector<SHAMapNodeID> nodeIDs;
+            std::vector<std::shared_ptr<Blob>> nodes;
+            BEAST_EXPECT(next->getNodeFat (
+                SHAMapNodeID (), nodeIDs, nodes, false, 0, cache));
+            BEAST_EXPECT(nodes.size () == 1);
+            BEAST_EXPECT(destination.addRootNode (
+                next->getHash(), makeSlice(*nodes.front ()),
+                    snfWIRE, nullptr).isGood());
+        }
+
+        do
+        {
+            auto nodesMissing = destination.getMissingNodes (2048, nullptr);
+
+            if (nodesMissing.empty ())
+                break;
+
+            std::vector<SHAMapNodeID> nodeIDs, plainIDs;
+            std::vector<std::shared_ptr<Blob>> nodes;
+            std::vector<Blob> plainNodes;
+
+            for (auto& it : nodesMissing)
+            {
+                BEAST_EXPECT(next->getNodeFat (
+                    it.first, nodeIDs, nodes, true, 1, cache));
+                BEAST_EXPECT(next->getNodeFat (
+                    it.first, plainIDs, plainNodes, true, 1));
+            }
+
+            BEAST_EXPECT(nodeIDs == plainIDs);
+            BEAST_EXPECT(nodes.size () == plainNodes.size ());
+
+            for (std::size_t i = 0; i < nodes.size (); ++i)
+            {
+                BEAST_EXPECT(*nodes[i] == plainNodes[i]);
+                destination.addKnownNode (
+                    nodeIDs[i], makeSlice(*nodes[i]), nullptr);
+            }
+        }
+        while (true);
+
+        destination.clearSynching ();
+
+        BEAST_EXPECT(next->deepCompare (destination));
+        BEAST_EXPECT(cached () == count + changed);
     }
 
     void run(SHAMap::version v)
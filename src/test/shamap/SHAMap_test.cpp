@@ -22,8 +22,14 @@
 #include <test/shamap/common.h>
 #include <call/basics/Blob.h>
 #include <call/basics/StringUtilities.h>
+#include <call/nodestore/DatabaseShard.h>
+#include <call/nodestore/DummyScheduler.h>
+#include <call/protocol/digest.h>
 #include <call/beast/unit_test.h>
 #include <call/beast/utility/Journal.h>
+#include <call/beast/utility/temp_dir.h>
+#include <algorithm>
+#include <mutex>
 
 namespace call {
 namespace tests {
@@ -105,6 +111,205 @@ inline bool operator!= (SHAMapItem const& a, SHAMapItem const& b) { return a.key
 inline bool operator== (SHAMapItem const& a, uint256 const& b) { return a.key() == b; }
 inline bool operator!= (SHAMapItem const& a, uint256 const& b) { return a.key() != b; }
 
+// Forwards to a node store, recording the nodes read ahead of a walk
+// and which of those the walk went on to fetch.
+class ReadAheadDatabase : public NodeStore::Database
+{
+private:
+    NodeStore::Database& db_;
+    std::mutex mutable mutex_;
+    hash_set<uint256> issued_;
+    hash_set<uint256> used_;
+
+    void
+    fetched (uint256 const& hash)
+    {
+        std::lock_guard<std::mutex> lock (mutex_);
+        if (issued_.count (hash))
+            used_.insert (hash);
+    }
+
+public:
+    ReadAheadDatabase (NodeStore::Database& db, Stoppable& parent)
+        : Database ("ReadAheadDatabase", parent)
+        , db_ (db)
+    {
+    }
+
+    void
+    reset ()
+    {
+        std::lock_guard<std::mutex> lock (mutex_);
+        issued_.clear ();
+        used_.clear ();
+    }
+
+    hash_set<uint256>
+    issued () const
+    {
+        std::lock_guard<std::mutex> lock (mutex_);
+        return issued_;
+    }
+
+    hash_set<uint256>
+    used () const
+    {
+        std::lock_guard<std::mutex> lock (mutex_);
+        return used_;
+    }
+
+    std::string
+    getName () const override
+    {
+        return db_.getName ();
+    }
+
+    std::shared_ptr<NodeObject>
+    fetch (uint256 const& hash) override
+    {
+        fetched (hash);
+        return db_.fetch (hash);
+    }
+
+    std::vector<std::shared_ptr<NodeObject>>
+    fetchBatch (std::vector<uint256> const& hashes) override
+    {
+        for (auto const& hash : hashes)
+            fetched (hash);
+        return db_.fetchBatch (hashes);
+    }
+
+    bool
+    asyncFetch (uint256 const& hash,
+        std::shared_ptr<NodeObject>& object) override
+    {
+        {
+            std::lock_guard<std::mutex> lock (mutex_);
+            issued_.insert (hash);
+        }
+        return db_.asyncFetch (hash, object);
+    }
+
+    void
+    waitReads () override
+    {
+        db_.waitReads ();
+    }
+
+    int
+    getDesiredAsyncReadCount () override
+    {
+        return db_.getDesiredAsyncReadCount ();
+    }
+
+    void
+    store (NodeObjectType type, Blob&& data, uint256 const& hash) override
+    {
+        db_.store (type, std::move (data), hash);
+    }
+
+    void
+    for_each (std::function <void(std::shared_ptr<NodeObject>)> f) override
+    {
+        db_.for_each (std::move (f));
+    }
+
+    void
+    import (Database& source) override
+    {
+        db_.import (source);
+    }
+
+    std::int32_t
+    getWriteLoad () const override
+    {
+        return db_.getWriteLoad ();
+    }
+
+    float
+    getCacheHitRate () override
+    {
+        return db_.getCacheHitRate ();
+    }
+
+    void
+    tune (int size, int age) override
+    {
+        db_.tune (size, age);
+    }
+
+    void
+    sweep () override
+    {
+        db_.sweep ();
+    }
+
+    std::uint32_t
+    getStoreCount () const override
+    {
+        return db_.getStoreCount ();
+    }
+
+    std::uint32_t
+    getFetchTotalCount () const override
+    {
+        return db_.getFetchTotalCount ();
+    }
+
+    std::uint32_t
+    getFetchHitCount () const override
+    {
+        return db_.getFetchHitCount ();
+    }
+
+    std::uint32_t
+    getStoreSize () const override
+    {
+        return db_.getStoreSize ();
+    }
+
+    std::uint32_t
+    getFetchSize () const override
+    {
+        return db_.getFetchSize ();
+    }
+
+    int
+    fdlimit () const override
+    {
+        return db_.fdlimit ();
+    }
+};
+
+// A TestFamily whose walks go through a ReadAheadDatabase
+class ReadAheadFamily : public TestFamily
+{
+private:
+    RootStoppable parent_;
+    ReadAheadDatabase db_;
+
+public:
+    explicit
+    ReadAheadFamily (beast::Journal j)
+        : TestFamily (j)
+        , parent_ ("TestRootStoppable")
+        , db_ (TestFamily::db (), parent_)
+    {
+    }
+
+    ReadAheadDatabase&
+    db () override
+    {
+        return db_;
+    }
+
+    ReadAheadDatabase const&
+    db () const override
+    {
+        return db_;
+    }
+};
+
 class SHAMap_test : public beast::unit_test::suite
 {
 public:
@@ -124,6 +329,254 @@ public:
         run (false, SHAMap::version{1});
         run (true,  SHAMap::version{2});
         run (false, SHAMap::version{2});
+        testParallelFlush (SHAMap::version{1});
+        testParallelFlush (SHAMap::version{2});
+        testSparseInner (SHAMap::version{1});
+        testSparseInner (SHAMap::version{2});
+        testReadAhead (SHAMap::version{1});
+        testReadAhead (SHAMap::version{2});
+        testShardFallback (SHAMap::version{1});
+        testShardFallback (SHAMap::version{2});
+    }
+
+    void testShardFallback (SHAMap::version v)
+    {
+        testcase ("shard fallback");
+
+        beast::Journal const j;
+        beast::temp_dir dir;
+        NodeStore::DummyScheduler scheduler;
+
+        Section config;
+        config.set ("path", dir.path ());
+        config.set ("ledgers_per_shard", "4");
+        auto const shards = NodeStore::make_DatabaseShard (
+            config, scheduler, j);
+
+        // Two consecutive states, kept out of the node store
+        tests::TestFamily source (j);
+        SHAMap first (SHAMapType::STATE, source, v);
+        for (int k = 0; k < 500; ++k)
+        {
+            BEAST_EXPECT(first.addItem (
+                SHAMapItem{sha512Half (k, 5), IntToVUC (k)}, false, false));
+        }
+        first.getHash ();
+        first.setImmutable ();
+
+        auto second = first.snapShot (true);
+        for (int k = 0; k < 500; k += 10)
+            BEAST_EXPECT(second->delItem (sha512Half (k, 5)));
+        for (int k = 500; k < 550; ++k)
+        {
+            BEAST_EXPECT(second->addItem (
+                SHAMapItem{sha512Half (k, 5), IntToVUC (k)}, false, false));
+        }
+        second->getHash ();
+        second->setImmutable ();
+
+        // Store them the way ledgers go into their shard: all of the
+        // first ledger, then only what changed in the next one
+        auto store = [&shards](std::uint32_t seq, std::size_t& count)
+        {
+            return [&shards, seq, &count](SHAMapAbstractNode& node)
+            {
+                Serializer s;
+                node.addRaw (s, snfPREFIX);
+                shards->store (hotACCOUNT_NODE, std::move (s.modData ()),
+                    node.getNodeHash ().as_uint256 (), seq);
+                ++count;
+                return true;
+            };
+        };
+        std::size_t full = 0;
+        std::size_t changed = 0;
+        first.visitDifferences (nullptr, store (1, full));
+        second->visitDifferences (&first, store (2, changed));
+        BEAST_EXPECT(changed > 0 && changed < full);
+
+        // Load the map with only the shards behind the node store
+        auto load = [&](SHAMap const& map, std::uint32_t seq)
+        {
+            tests::TestFamily f (j);
+            f.setShardStore (shards.get ());
+            SHAMap copy (SHAMapType::STATE, f, v);
+            copy.setShardSeq (seq);
+            if (! copy.fetchRoot (map.getHash (), nullptr))
+                return false;
+
+            // Inner nodes are read asynchronously here
+            if (! copy.getMissingNodes (16, nullptr).empty ())
+                return false;
+
+            std::size_t leaves = 0;
+            copy.visitLeaves (
+                [&leaves](std::shared_ptr<SHAMapItem const> const&)
+                {
+                    ++leaves;
+                });
+            // Both states hold 500 items
+            return leaves == 500;
+        };
+
+        BEAST_EXPECT(load (first, 1));
+        BEAST_EXPECT(load (*second, 2));
+
+        // Nodes are only looked for in the shard of their ledger
+        BEAST_EXPECT(! load (first, 5));
+        BEAST_EXPECT(! load (first, 0));
+    }
+
+    void testReadAhead (SHAMap::version v)
+    {
+        testcase ("read ahead");
+
+        beast::Journal const j;
+        ReadAheadFamily f (j);
+
+        std::vector<uint256> keys;
+        SHAMap source (SHAMapType::FREE, f, v);
+        for (int k = 0; k < 2000; ++k)
+        {
+            keys.push_back (sha512Half (k));
+            BEAST_EXPECT(source.addItem (
+                SHAMapItem{keys.back (), IntToVUC (k)}, false, false));
+        }
+        std::sort (keys.begin (), keys.end ());
+        source.flushDirty (hotACCOUNT_NODE, 1);
+        auto const hash = source.getHash ();
+
+        for (int distance : { 0, 1, 16, 256 })
+        {
+            f.setReadAhead (distance);
+
+            // Every walk starts from the database
+            auto const load = [&]
+            {
+                f.treecache ().clear ();
+                f.db ().reset ();
+                auto m = std::make_unique<SHAMap> (
+                    SHAMapType::STATE, hash.as_uint256 (), f, v);
+                BEAST_EXPECT(m->fetchRoot (hash, nullptr));
+                return m;
+            };
+
+            // Reads are issued ahead of the walk only when enabled, and
+            // the walk goes on to fetch every node read ahead
+            auto const readAhead = [&]
+            {
+                auto const issued = f.db ().issued ();
+                if (distance == 0)
+                    return issued.empty ();
+                return ! issued.empty () && f.db ().used () == issued;
+            };
+
+            {
+                auto const m = load ();
+                std::vector<uint256> seen;
+                for (auto const& item : *m)
+                    seen.push_back (item.key ());
+                BEAST_EXPECT(seen == keys);
+                BEAST_EXPECT(readAhead ());
+            }
+
+            {
+                auto const m = load ();
+                auto const from = keys[keys.size () / 3];
+                std::vector<uint256> seen;
+                for (auto it = m->upper_bound (from); it != m->end (); ++it)
+                    seen.push_back (it->key ());
+                BEAST_EXPECT(seen.size () == keys.size () - keys.size () / 3 - 1);
+                BEAST_EXPECT(std::equal (seen.begin (), seen.end (),
+                    keys.end () - seen.size ()));
+                BEAST_EXPECT(readAhead ());
+            }
+
+            {
+                auto const m = load ();
+                std::vector<uint256> seen;
+                m->visitLeaves (
+                    [&seen](std::shared_ptr<SHAMapItem const> const& item)
+                    {
+                        seen.push_back (item->key ());
+                    });
+                BEAST_EXPECT(seen == keys);
+                BEAST_EXPECT(readAhead ());
+            }
+
+            {
+                auto const m = load ();
+                std::vector<SHAMapMissingNode> missing;
+                m->walkMap (missing, 32);
+                BEAST_EXPECT(missing.empty ());
+                BEAST_EXPECT(readAhead ());
+            }
+        }
+    }
+
+    void testSparseInner (SHAMap::version v)
+    {
+        testcase ("sparse inner nodes");
+
+        beast::Journal const j;
+        tests::TestFamily f (j);
+
+        auto const before = SHAMapInnerNode::getBytesSaved ();
+        {
+            SHAMap m1 (SHAMapType::FREE, f, v);
+            SHAMap m2 (SHAMapType::FREE, f, v);
+
+            // m1 gets every item, m2 only the ones m1 keeps
+            for (int k = 0; k < 200; ++k)
+            {
+                uint256 const key = sha512Half (k);
+                BEAST_EXPECT(m1.addItem (SHAMapItem{key, IntToVUC (k)}, false, false));
+                if (k % 3 != 0)
+                    BEAST_EXPECT(m2.addItem (SHAMapItem{key, IntToVUC (k)}, false, false));
+            }
+
+            // Few inner nodes have all sixteen children
+            BEAST_EXPECT(SHAMapInnerNode::getBytesSaved () > before);
+
+            // Removing branches repacks the remaining ones
+            for (int k = 0; k < 200; k += 3)
+                BEAST_EXPECT(m1.delItem (sha512Half (k)));
+
+            BEAST_EXPECT(m1.getHash () == m2.getHash ());
+            for (int k = 0; k < 200; ++k)
+                BEAST_EXPECT(m1.hasItem (sha512Half (k)) == (k % 3 != 0));
+        }
+        BEAST_EXPECT(SHAMapInnerNode::getBytesSaved () == before);
+    }
+
+    void testParallelFlush (SHAMap::version v)
+    {
+        testcase ("parallel flush");
+
+        beast::Journal const j;
+        tests::TestFamily serial (j);
+        tests::TestFamily parallel (j, true);
+
+        SHAMap m1 (SHAMapType::FREE, serial, v);
+        SHAMap m2 (SHAMapType::FREE, parallel, v);
+
+        for (int k = 0; k < 1000; ++k)
+        {
+            uint256 const key = sha512Half (k);
+            BEAST_EXPECT(m1.addItem (SHAMapItem{key, IntToVUC (k)}, false, false));
+            BEAST_EXPECT(m2.addItem (SHAMapItem{key, IntToVUC (k)}, false, false));
+        }
+
+        // Flushing on several threads must produce the same tree
+        BEAST_EXPECT(m1.flushDirty (hotACCOUNT_NODE, 1) ==
+            m2.flushDirty (hotACCOUNT_NODE, 1));
+        BEAST_EXPECT(m1.getHash () == m2.getHash ());
+
+        // Every node, including the root, was written out
+        BEAST_EXPECT(parallel.db ().fetch (
+            m2.getHash ().as_uint256 ()) != nullptr);
+        for (int k = 0; k < 1000; ++k)
+            BEAST_EXPECT(m2.hasItem (sha512Half (k)));
     }
 
     void run (bool backed, SHAMap::version v)
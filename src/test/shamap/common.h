@@ -25,6 +25,7 @@
 #include <call/nodestore/DummyScheduler.h>
 #include <call/nodestore/Manager.h>
 #include <call/shamap/Family.h>
+#include <thread>
 
 namespace call {
 namespace tests {
@@ -39,13 +40,17 @@ private:
     RootStoppable parent_;
     std::unique_ptr<NodeStore::Database> db_;
     beast::Journal j_;
+    bool parallel_;
+    int readAhead_ = 0;
+    NodeStore::DatabaseShard* shards_ = nullptr;
 
 public:
-    TestFamily (beast::Journal j)
+    TestFamily (beast::Journal j, bool parallel = false)
         : treecache_ ("TreeNodeCache", 65536, 60, clock_, j)
         , fullbelow_ ("full_below", clock_)
         , parent_ ("TestRootStoppable")
         , j_ (j)
+        , parallel_ (parallel)
     {
         Section testSection;
         testSection.set("type", "memory");
@@ -113,6 +118,40 @@ public:
     {
         Throw<std::runtime_error> ("missing node");
     }
+
+    bool
+    dispatch (std::function<void()> work) override
+    {
+        if (! parallel_)
+            return false;
+
+        std::thread (std::move (work)).detach ();
+        return true;
+    }
+
+    int
+    readAhead () const override
+    {
+        return readAhead_;
+    }
+
+    void
+    setReadAhead (int distance)
+    {
+        readAhead_ = distance;
+    }
+
+    NodeStore::DatabaseShard*
+    shardStore () override
+    {
+        return shards_;
+    }
+
+    void
+    setShardStore (NodeStore::DatabaseShard* shards)
+    {
+        shards_ = shards;
+    }
 };
 
 } // tests
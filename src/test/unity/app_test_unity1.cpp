@@ -18,6 +18,7 @@
 */
 //==============================================================================
 
+#include <test/app/AccountTxIndex_test.cpp>
 #include <test/app/AccountTxPaging_test.cpp>
 #include <test/app/AmendmentTable_test.cpp>
 #include <test/app/CrossingLimits_test.cpp>
@@ -27,10 +28,13 @@
 #include <test/app/Flow_test.cpp>
 #include <test/app/Freeze_test.cpp>
 #include <test/app/HashRouter_test.cpp>
+#include <test/app/LedgerCloseBench_test.cpp>
 #include <test/app/LedgerLoad_test.cpp>
+#include <test/app/LedgerShards_test.cpp>
 #include <test/app/LoadFeeTrack_test.cpp>
 #include <test/app/Manifest_test.cpp>
 #include <test/app/MultiSign_test.cpp>
 #include <test/app/OfferStream_test.cpp>
 #include <test/app/Offer_test.cpp>
+#include <test/app/OrderBookDB_test.cpp>
 #include <test/app/OversizeMeta_test.cpp>
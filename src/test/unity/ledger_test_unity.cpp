@@ -18,6 +18,7 @@
 */
 //==============================================================================
 
+#include <test/ledger/AcquireScheduler_test.cpp>
 #include <test/ledger/BookDirs_test.cpp>
 #include <test/ledger/CashDiff_test.cpp>
 #include <test/ledger/Directory_test.cpp>
@@ -30,6 +30,7 @@
 #include <test/protocol/STAccount_test.cpp>
 #include <test/protocol/STAmount_test.cpp>
 #include <test/protocol/STObject_test.cpp>
+#include <test/protocol/STObjectView_test.cpp>
 #include <test/protocol/STTx_test.cpp>
 #include <test/protocol/TER_test.cpp>
 #include <test/protocol/types_test.cpp>